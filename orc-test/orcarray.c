@@ -33,6 +33,16 @@
 OrcArray *
 orc_array_new (int n, int m, int element_size, int misalignment,
     int alignment)
+{
+  return orc_array_new_with_stride (n, m, element_size, 0, misalignment,
+      alignment);
+}
+
+/* A stride of 0 picks the default, which leaves room around each row to
+ * catch out of bounds writes. */
+OrcArray *
+orc_array_new_with_stride (int n, int m, int element_size, int stride,
+    int misalignment, int alignment)
 {
   OrcArray *ar;
   void *data;
@@ -53,8 +63,13 @@ orc_array_new (int n, int m, int element_size, int misalignment,
   ar->m = m;
   ar->element_size = element_size;
 
-  ar->stride = (n*element_size + EXTEND_STRIDE);
-  ar->stride = (ar->stride + (ALIGNMENT-1)) & (~(ALIGNMENT-1));
+  if (stride > 0) {
+    ORC_ASSERT (stride >= n*element_size);
+    ar->stride = stride;
+  } else {
+    ar->stride = (n*element_size + EXTEND_STRIDE);
+    ar->stride = (ar->stride + (ALIGNMENT-1)) & (~(ALIGNMENT-1));
+  }
   ar->alloc_len = ar->stride * (m+2*EXTEND_ROWS) + (ALIGNMENT * element_size);
   ar->alloc_len = (ar->alloc_len + 4095) & (~4095);
 
@@ -228,7 +243,7 @@ orc_array_compare (OrcArray *array1, OrcArray *array2, int flags)
           if (isnan(a[i]) && isnan(b[i])) continue;
           if (a[i] == b[i]) continue;
           if ((a[i] < 0.0) == (b[i] < 0.0) &&
-              abs((orc_int32)(*(orc_uint32 *)&a[i] - *(orc_uint32 *)&b[i])) <= 2)
+              abs((orc_int32)(*(orc_uint32 *)&a[i] - *(orc_uint32 *)&b[i])) <= ORC_TEST_FLOAT_ULPS)
             continue;
           return FALSE;
         }
@@ -247,18 +262,19 @@ orc_array_compare (OrcArray *array1, OrcArray *array2, int flags)
           if (isnan(a[i]) && isnan(b[i])) continue;
           if (a[i] == b[i]) continue;
           if ((a[i] < 0.0) == (b[i] < 0.0) &&
-              llabs((orc_int64)(*(orc_uint64 *)&a[i] - *(orc_uint64 *)&b[i])) <= 2)
+              llabs((orc_int64)(*(orc_uint64 *)&a[i] - *(orc_uint64 *)&b[i])) <= ORC_TEST_FLOAT_ULPS)
             continue;
           return FALSE;
         }
       }
       return TRUE;
     }
-  } else {
-    if (memcmp (array1->aligned_data, array2->aligned_data,
-          array1->alloc_len) == 0) {
-      return TRUE;
-    }
+  }
+
+  /* integer arrays, including those of a float program */
+  if (memcmp (array1->aligned_data, array2->aligned_data,
+        array1->alloc_len) == 0) {
+    return TRUE;
   }
 
   return FALSE;
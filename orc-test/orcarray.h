@@ -32,6 +32,10 @@ ORC_TEST_API
 OrcArray *orc_array_new (int n, int m, int element_size, int misalignment,
     int alignment);
 
+ORC_TEST_API
+OrcArray *orc_array_new_with_stride (int n, int m, int element_size,
+    int stride, int misalignment, int alignment);
+
 ORC_TEST_API
 void orc_array_free (OrcArray *array);
 
@@ -39,6 +39,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#if defined(__aarch64__) && defined(__linux__)
+#include <sys/prctl.h>
+#endif
 
 #ifdef _MSC_VER
 #define snprintf _snprintf
@@ -73,6 +76,18 @@ orc_test_init (void)
 #endif
 #endif
 
+#if defined(__aarch64__) && defined(__linux__) && defined(PR_SVE_SET_VL)
+  {
+    /* vector length in bytes for the sve target, so that the code can
+     * be checked with the lengths the hardware doesn't have */
+    const char *vl = getenv ("ORC_TEST_SVE_VL");
+
+    if (vl && prctl (PR_SVE_SET_VL, atoi (vl)) < 0) {
+      ORC_WARNING ("could not set the SVE vector length to %s", vl);
+    }
+  }
+#endif
+
 }
 
 
@@ -308,6 +323,196 @@ orc_test_gcc_compile_neon (OrcProgram *p)
   return ORC_TEST_OK;
 }
 
+#define SVE_PREFIX "aarch64-linux-gnu-"
+
+OrcTestResult
+orc_test_gcc_compile_sve (OrcProgram *p)
+{
+  char cmd[400];
+  char *base;
+  char source_filename[100];
+  char obj_filename[100];
+  char dis_filename[100];
+  char dump_filename[100];
+  char dump_dis_filename[100];
+  int ret;
+  FILE *file;
+  OrcCompileResult result;
+  OrcTarget *target;
+  unsigned int flags;
+
+  base = "temp-orc-test";
+
+  sprintf(source_filename, "%s-source.s", base);
+  sprintf(obj_filename, "%s.o", base);
+  sprintf(dis_filename, "%s-source.dis", base);
+  sprintf(dump_filename, "%s-dump.bin", base);
+  sprintf(dump_dis_filename, "%s-dump.dis", base);
+
+  target = orc_target_get_by_name ("sve");
+  flags = orc_target_get_default_flags (target);
+  flags |= ORC_TARGET_CLEAN_COMPILE;
+
+  result = orc_program_compile_full (p, target, flags);
+  if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL(result)) {
+    /* printf ("  no code generated: %s\n", orc_program_get_error (p)); */
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  fflush (stdout);
+
+  file = fopen (source_filename, "w");
+  fprintf(file, "%s", orc_program_get_asm_code (p));
+  fclose (file);
+
+  file = fopen (dump_filename, "w");
+  ret = fwrite(p->orccode->code, p->orccode->code_size, 1, file);
+  fclose (file);
+
+  sprintf (cmd, SVE_PREFIX "gcc -march=armv8-a+sve2 -Wall "
+      "-c %s -o %s", source_filename, obj_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    ORC_ERROR ("aarch64 gcc failed");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, SVE_PREFIX "objdump -dr %s >%s", obj_filename, dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    ORC_ERROR ("objdump failed");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, SVE_PREFIX "objcopy -I binary "
+      "-O elf64-littleaarch64 -B aarch64 "
+      "--rename-section .data=.text "
+      "--redefine-sym _binary_temp_orc_test_dump_bin_start=%s "
+      "%s %s", p->name, dump_filename, obj_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("objcopy failed\n");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, SVE_PREFIX "objdump -Dr %s >%s", obj_filename, dump_dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("objdump failed\n");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, "diff -u %s %s", dis_filename, dump_dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("diff failed\n");
+    return ORC_TEST_FAILED;
+  }
+
+  remove (source_filename);
+  remove (obj_filename);
+  remove (dis_filename);
+  remove (dump_filename);
+  remove (dump_dis_filename);
+
+  return ORC_TEST_OK;
+}
+
+#define LOONGARCH_PREFIX "loongarch64-linux-gnu-"
+
+OrcTestResult
+orc_test_gcc_compile_loongarch (OrcProgram *p, const char *target_name)
+{
+  char cmd[400];
+  char *base;
+  char source_filename[100];
+  char obj_filename[100];
+  char dis_filename[100];
+  char dump_filename[100];
+  char dump_dis_filename[100];
+  int ret;
+  FILE *file;
+  OrcCompileResult result;
+  OrcTarget *target;
+  unsigned int flags;
+
+  base = "temp-orc-test";
+
+  sprintf(source_filename, "%s-source.s", base);
+  sprintf(obj_filename, "%s.o", base);
+  sprintf(dis_filename, "%s-source.dis", base);
+  sprintf(dump_filename, "%s-dump.bin", base);
+  sprintf(dump_dis_filename, "%s-dump.dis", base);
+
+  target = orc_target_get_by_name (target_name);
+  flags = orc_target_get_default_flags (target);
+  flags |= ORC_TARGET_CLEAN_COMPILE;
+
+  result = orc_program_compile_full (p, target, flags);
+  if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL(result)) {
+    /* printf ("  no code generated: %s\n", orc_program_get_error (p)); */
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  fflush (stdout);
+
+  file = fopen (source_filename, "w");
+  fprintf(file, "%s", orc_program_get_asm_code (p));
+  fclose (file);
+
+  file = fopen (dump_filename, "w");
+  ret = fwrite(p->orccode->code, p->orccode->code_size, 1, file);
+  fclose (file);
+
+  sprintf (cmd, LOONGARCH_PREFIX "gcc -march=loongarch64 -mlasx -Wall "
+      "-c %s -o %s", source_filename, obj_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    ORC_ERROR ("loongarch64 gcc failed");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, LOONGARCH_PREFIX "objdump -dr %s >%s", obj_filename, dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    ORC_ERROR ("objdump failed");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, LOONGARCH_PREFIX "objcopy -I binary "
+      "-O elf64-loongarch -B loongarch "
+      "--rename-section .data=.text "
+      "--redefine-sym _binary_temp_orc_test_dump_bin_start=%s "
+      "%s %s", p->name, dump_filename, obj_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("objcopy failed\n");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, LOONGARCH_PREFIX "objdump -Dr %s >%s", obj_filename, dump_dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("objdump failed\n");
+    return ORC_TEST_INDETERMINATE;
+  }
+
+  sprintf (cmd, "diff -u %s %s", dis_filename, dump_dis_filename);
+  ret = system (cmd);
+  if (ret != 0) {
+    printf("diff failed\n");
+    return ORC_TEST_FAILED;
+  }
+
+  remove (source_filename);
+  remove (obj_filename);
+  remove (dis_filename);
+  remove (dump_filename);
+  remove (dump_dis_filename);
+
+  return ORC_TEST_OK;
+}
+
 #define C64X_PREFIX "/opt/TI/TI_CGT_C6000_6.1.12/bin/"
 
 OrcTestResult
@@ -619,9 +824,21 @@ print_param_val_float (const int *const var, const int *const var2,
   }
 }
 
+static int
+float_compare_single (const void *ptr1, const void *ptr2, int ulps)
+{
+  if (isnan(*(float *)ptr1) && isnan(*(float *)ptr2)) return TRUE;
+  if (*(float *)ptr1 == *(float *)ptr2) return TRUE;
+  if ((*(float *)ptr1 < 0.0) == (*(float *)ptr2 < 0.0) &&
+      abs((orc_int32)(*(orc_uint32 *)ptr1 - *(orc_uint32 *)ptr2)) <= ulps)
+    return TRUE;
+  return FALSE;
+}
+
 int
-float_compare (OrcArray *array1, OrcArray *array2, int i, int j)
+float_compare (OrcArray *array1, OrcArray *array2, int i, int j, int flags)
 {
+  const int ulps = ORC_TEST_FLOAT_ULPS;
   void *ptr1 = ORC_PTR_OFFSET (array1->data,
       i*array1->element_size + j*array1->stride);
   void *ptr2 = ORC_PTR_OFFSET (array2->data,
@@ -629,17 +846,18 @@ float_compare (OrcArray *array1, OrcArray *array2, int i, int j)
 
   switch (array1->element_size) {
     case 4:
-      if (isnan(*(float *)ptr1) && isnan(*(float *)ptr2)) return TRUE;
-      if (*(float *)ptr1 == *(float *)ptr2) return TRUE;
-      if ((*(float *)ptr1 < 0.0) == (*(float *)ptr2 < 0.0) &&
-          abs((orc_int32)(*(orc_uint32 *)ptr1 - *(orc_uint32 *)ptr2)) <= 2)
-        return TRUE;
-      return FALSE;
+      return float_compare_single (ptr1, ptr2, ulps);
     case 8:
+      /* 8-byte values are (re,im) float pairs in complex programs */
+      if (flags & ORC_TEST_FLAGS_COMPLEX) {
+        return float_compare_single (ptr1, ptr2, ulps) &&
+          float_compare_single (ORC_PTR_OFFSET (ptr1, 4),
+              ORC_PTR_OFFSET (ptr2, 4), ulps);
+      }
       if (isnan(*(double *)ptr1) && isnan(*(double *)ptr2)) return TRUE;
       if (*(double *)ptr1 == *(double *)ptr2) return TRUE;
       if ((*(double *)ptr1 < 0.0) == (*(double *)ptr2 < 0.0) &&
-          llabs((orc_int64)(*(orc_uint64 *)ptr1 - *(orc_uint64 *)ptr2)) <= 2)
+          llabs((orc_int64)(*(orc_uint64 *)ptr1 - *(orc_uint64 *)ptr2)) <= ulps)
         return TRUE;
       return FALSE;
   }
@@ -704,12 +922,26 @@ orc_test_compare_output_full_for_target (OrcProgram *program, int flags, const c
 
   ORC_DEBUG ("got here");
 
+  /* The emulator runs the instructions of the compiled code, so the
+   * multiply-adds contracted for fast math are emulated with fmaf()
+   * and fma() and the results are held to the usual tolerance */
+  if (program->is_fast_math) {
+    flags |= ORC_TEST_FLAGS_FLOAT;
+  }
+  for(i=0;i<program->n_insns;i++){
+    if (program->insns[i].opcode->flags & ORC_STATIC_OPCODE_COMPLEX) {
+      flags |= ORC_TEST_FLAGS_FLOAT | ORC_TEST_FLAGS_COMPLEX;
+    }
+  }
+
   {
     OrcTarget *target;
     unsigned int flags;
 
     target = orc_target_get_by_name (target_name);
     flags = orc_target_get_default_flags (target);
+    /* each program has to go through the compiler */
+    flags |= ORC_TARGET_PRIVATE_CODE;
 
     result = orc_program_compile_full (program, target, flags);
     if (ORC_COMPILE_RESULT_IS_FATAL(result)) {
@@ -884,7 +1116,7 @@ orc_test_compare_output_full_for_target (OrcProgram *program, int flags, const c
             if (flags & ORC_TEST_FLAGS_FLOAT) {
               print_array_val_float (dest_emul[l-ORC_VAR_D1], i, j);
               print_array_val_float (dest_exec[l-ORC_VAR_D1], i, j);
-              if (!float_compare (dest_emul[l-ORC_VAR_D1], dest_exec[l-ORC_VAR_D1], i, j)) {
+              if (!float_compare (dest_emul[l-ORC_VAR_D1], dest_exec[l-ORC_VAR_D1], i, j, flags)) {
                 line_bad = TRUE;
                 n_lines_bad++;
               }
@@ -1014,6 +1246,10 @@ orc_test_get_program_for_opcode (OrcStaticOpcode *opcode)
       orc_program_add_source (p, opcode->src_size[0], "s1");
     args[n_args++] =
       orc_program_add_source (p, opcode->src_size[1], "s2");
+    if (opcode->src_size[2] != 0) {
+      args[n_args++] =
+        orc_program_add_source (p, opcode->src_size[2], "s3");
+    }
   }
 
   if ((opcode->flags & ORC_STATIC_OPCODE_FLOAT_SRC) ||
@@ -1158,6 +1394,7 @@ orc_test_performance_full (OrcProgram *program, int flags,
     unsigned int flags;
 
     flags = orc_target_get_default_flags (target);
+    flags |= ORC_TARGET_PRIVATE_CODE;
 
     result = orc_program_compile_full (program, target, flags);
     if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL(result)) {
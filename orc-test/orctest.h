@@ -23,6 +23,11 @@ typedef enum {
 #define ORC_TEST_FLAGS_FLOAT (1<<1)
 #define ORC_TEST_FLAGS_EMULATE (1<<2)
 #define ORC_TEST_SKIP_RESET (1 << 3)
+#define ORC_TEST_FLAGS_COMPLEX (1 << 5)
+
+/* Float results may differ from emulation by this many units in the
+ * last place */
+#define ORC_TEST_FLOAT_ULPS 2
 
 ORC_TEST_API
 void          orc_test_init (void);
@@ -33,6 +38,13 @@ OrcTestResult orc_test_gcc_compile (OrcProgram *p);
 ORC_TEST_API
 OrcTestResult orc_test_gcc_compile_neon (OrcProgram *p);
 
+ORC_TEST_API
+OrcTestResult orc_test_gcc_compile_sve (OrcProgram *p);
+
+ORC_TEST_API
+OrcTestResult orc_test_gcc_compile_loongarch (OrcProgram *p,
+    const char *target_name);
+
 ORC_TEST_API
 OrcTestResult orc_test_gcc_compile_c64x (OrcProgram *p);
 
@@ -1,4 +1,5 @@
 UNARY_SB(absb, "ORC_ABS(%s)")
+BINARY_UB(absdiffub, "ORC_ABS((orc_int32)(orc_uint8)%s - (orc_int32)(orc_uint8)%s)")
 BINARY_SB(addb, "%s + %s")
 BINARY_SB(addssb, "ORC_CLAMP_SB(%s + %s)")
 BINARY_UB(addusb, "ORC_CLAMP_UB((orc_uint8)%s + (orc_uint8)%s)")
@@ -27,6 +28,7 @@ BINARY_UB(subusb, "ORC_CLAMP_UB((orc_uint8)%s - (orc_uint8)%s)")
 BINARY_SB(xorb, "%s ^ %s")
 
 UNARY_SW(absw, "ORC_ABS(%s)")
+BINARY_UW(absdiffuw, "ORC_ABS((orc_int32)(orc_uint16)%s - (orc_int32)(orc_uint16)%s)")
 BINARY_SW(addw, "%s + %s")
 BINARY_SW(addssw, "ORC_CLAMP_SW(%s + %s)")
 BINARY_UW(addusw, "ORC_CLAMP_UW((orc_uint16)%s + (orc_uint16)%s)")
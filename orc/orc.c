@@ -47,6 +47,7 @@ orc_init (void)
 
       _orc_debug_init();
       _orc_compiler_init();
+      _orc_code_epoch_init();
       orc_opcode_init();
       orc_c_init();
 #ifdef ENABLE_BACKEND_C64X
@@ -66,6 +67,14 @@ orc_init (void)
 #endif
 #ifdef ENABLE_BACKEND_ARM
       orc_arm_init();
+#endif
+      /* the last executable target is the default; sve doesn't cover
+       * float opcodes yet, so it comes before neon and is used only
+       * when selected with ORC_BACKEND=sve.  lsx and lasx have nothing
+       * to come before, so they mark themselves non-executable unless
+       * selected with ORC_BACKEND */
+#ifdef ENABLE_BACKEND_SVE
+      orc_sve_init();
 #endif
 #ifdef ENABLE_BACKEND_NEON
       orc_neon_init();
@@ -73,6 +82,12 @@ orc_init (void)
 #ifdef ENABLE_BACKEND_MIPS
       orc_mips_init();
 #endif
+#ifdef ENABLE_BACKEND_LSX
+      orc_lsx_init();
+#endif
+#ifdef ENABLE_BACKEND_LASX
+      orc_lasx_init();
+#endif
 
       inited = TRUE;
     }
@@ -8,6 +8,8 @@
 #include <orc/orconce.h>
 #include <orc/orcparse.h>
 #include <orc/orccpu.h>
+#include <orc/orccolorspace.h>
+#include <orc/orcstats.h>
 
 ORC_API void orc_init (void);
 ORC_API const char * orc_version_string (void);
@@ -1130,10 +1130,12 @@ orc_arm64_emit_am (OrcCompiler *p, OrcArm64RegBits bits, OrcArm64DP opcode,
         }
         /** its width is determined by extend; '0bx11' ==> 64-bit reg */
         snprintf (opt_rm, ARM64_MAX_OP_LEN, ", %s, %s #%u",
-            orc_arm64_reg_name (Rm, extend & 0x3 ? ORC_ARM64_REG_64 : ORC_ARM64_REG_32),
+            orc_arm64_reg_name (Rm, (extend & 0x3) == 0x3 ? ORC_ARM64_REG_64 : ORC_ARM64_REG_32),
             extend_names[extend], imm);
       } else
-        snprintf (opt_rm, ARM64_MAX_OP_LEN, ", %s", orc_arm64_reg_name (Rm, bits));
+        snprintf (opt_rm, ARM64_MAX_OP_LEN, ", %s, %s",
+            orc_arm64_reg_name (Rm, (extend & 0x3) == 0x3 ? ORC_ARM64_REG_64 : ORC_ARM64_REG_32),
+            extend_names[extend]);
 
       code = arm64_code_arith_ext(bits, opcode, Rm, extend, imm, Rn, Rd);
       break;
@@ -1799,22 +1801,22 @@ orc_arm64_emit_mem (OrcCompiler *p, OrcArm64RegBits bits, OrcArm64Mem opcode,
         }
 
         if (is_signed == 1) { /** pre index */
-          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, bits));
+          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, ORC_ARM64_REG_64));
           snprintf (opt_rm, ARM64_MAX_OP_LEN, ", #%d]!", imm);
 
           code = arm64_code_mem_signed (bits, opcode, imm, 1, Rn, Rt);
         } else {              /** post index */
-          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s]", orc_arm64_reg_name(Rn, bits));
+          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s]", orc_arm64_reg_name(Rn, ORC_ARM64_REG_64));
           snprintf (opt_rm, ARM64_MAX_OP_LEN, ", #%d", imm);
 
           code = arm64_code_mem_signed (bits, opcode, imm, 0, Rn, Rt);
         }
       } else {  /** unsigned offset */
         if (imm != 0) {
-          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, bits));
+          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, ORC_ARM64_REG_64));
           snprintf (opt_rm, ARM64_MAX_OP_LEN, ", #%d]", imm);
         } else {
-          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s]", orc_arm64_reg_name(Rn, bits));
+          snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s]", orc_arm64_reg_name(Rn, ORC_ARM64_REG_64));
         }
 
         if (bits == ORC_ARM64_REG_64) {
@@ -1839,7 +1841,7 @@ orc_arm64_emit_mem (OrcCompiler *p, OrcArm64RegBits bits, OrcArm64Mem opcode,
         return;
       }
 
-      snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, bits));
+      snprintf (opt_rn, ARM64_MAX_OP_LEN, ", [%s", orc_arm64_reg_name(Rn, ORC_ARM64_REG_64));
 
       amount = val;
       if (amount > 0) {
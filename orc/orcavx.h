@@ -146,6 +146,7 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
 #define orc_avx_emit_pmuludq(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pmuludq, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_psadbw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_psadbw, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_psadbw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_psadbw, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_phminposuw(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_phminposuw, 32, s1, 0, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_sse_emit_psubb(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_psubb, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_psubb(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_psubb, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_psubw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_psubw, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
@@ -160,6 +161,14 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
 #define orc_avx_emit_paddw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_paddw, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_paddd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_paddd, 16, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_paddd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_paddd, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_pmaddwd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pmaddwd, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_pmaddwd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pmaddwd, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_pmaddubsw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pmaddubsw, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_pmaddubsw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pmaddubsw, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_phaddw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_phaddw, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_phaddw(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_phaddw, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_phaddd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_phaddd, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_phaddd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_phaddd, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_pshufb(p,mask,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pshufb, 32, mask, s1, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_pshufb(p,mask,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pshufb, 32, mask, s1, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_pabsb(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pabsb, 32, s1, 0, d, ORC_X86_AVX_VEX128_PREFIX)
@@ -222,6 +231,14 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
 #define orc_avx_emit_subps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_subps, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_mulps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_mulps, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_mulps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_mulps, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_addsubps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_addsubps, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_addsubps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_addsubps, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_haddps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_haddps, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_haddps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_haddps, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_movsldup(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_movsldup, 32, s1, 0, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_movsldup(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_movsldup, 32, s1, 0, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_movshdup(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_movshdup, 32, s1, 0, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_movshdup(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_movshdup, 32, s1, 0, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_divps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_divps, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_emit_divps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_divps, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_sse_emit_sqrtps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_sqrtps, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
@@ -328,6 +345,7 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
 
 #define orc_avx_sse_emit_pinsrw_register(p,imm,s1,s2,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_pinsrw, imm, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
 #define orc_avx_sse_emit_movd_load_register(p,a,b) orc_vex_emit_cpuinsn_size(p, ORC_X86_movd_load, 4, a, 0, b, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_sse_emit_movd_store_register(p,a,b) orc_vex_emit_cpuinsn_size(p, ORC_X86_movd_store, 4, a, 0, b, ORC_X86_AVX_VEX128_PREFIX)
 
 
 #define orc_avx_emit_permute2f128(p,imm,s1,s2,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_permute2f128_avx, imm, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
@@ -339,6 +357,7 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
 #define orc_avx_emit_pbroadcastq(p,s1,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_pbroadcastq_avx, 8, s1, 0, d, ORC_X86_AVX_VEX256_PREFIX)
 
 #define orc_avx_sse_emit_shufps_imm(p,imm,s1,s2,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_shufps_imm, imm, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_shufps_imm(p,imm,s1,s2,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_shufps_imm, imm, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_emit_insertf128_si256(p,imm,s1,s2,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_insertf128_avx, imm, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
 #define orc_avx_emit_extractf128_si256(p,imm,s1,d) orc_vex_emit_cpuinsn_imm(p, ORC_X86_extractf128_avx, imm, s1, 0, d, ORC_X86_AVX_VEX256_PREFIX)
 
@@ -357,6 +376,16 @@ ORC_API void orc_avx_restore_mxcsr (OrcCompiler *compiler);
   orc_vex_emit_cpuinsn_imm (p, ORC_X86_pinsrd, imm, s1, s2, d, \
       ORC_X86_AVX_VEX128_PREFIX)
 
+/* FMA3: 213 computes d = s1 * d + s2, 231 computes d = s1 * s2 + d */
+#define orc_avx_sse_emit_fmadd213ps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd213ps_avx, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_fmadd213ps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd213ps_avx, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_fmadd213pd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd213pd_avx, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_fmadd213pd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd213pd_avx, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_fmadd231ps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd231ps_avx, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_fmadd231ps(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd231ps_avx, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+#define orc_avx_sse_emit_fmadd231pd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd231pd_avx, 32, s1, s2, d, ORC_X86_AVX_VEX128_PREFIX)
+#define orc_avx_emit_fmadd231pd(p,s1,s2,d) orc_vex_emit_cpuinsn_size(p, ORC_X86_fmadd231pd_avx, 32, s1, s2, d, ORC_X86_AVX_VEX256_PREFIX)
+
 
 #endif
 
@@ -5,6 +5,7 @@
 
 #include <orc/orc.h>
 #include <orc/orcbytecode.h>
+#include <orc/orcinternal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,8 +39,8 @@ orc_bytecode_free (OrcBytecode *bytecode)
   free (bytecode);
 }
 
-OrcBytecode *
-orc_bytecode_from_program (OrcProgram *p)
+static OrcBytecode *
+orc_bytecode_from_program_full (OrcProgram *p, orc_bool with_name)
 {
   OrcBytecode *bytecode = orc_bytecode_new ();
   int i;
@@ -73,7 +74,10 @@ orc_bytecode_from_program (OrcProgram *p)
       bytecode_append_int (bytecode, p->constant_m);
     }
   }
-  if (p->name) {
+  if (p->is_fast_math) {
+    bytecode_append_code (bytecode, ORC_BC_SET_FAST_MATH);
+  }
+  if (p->name && with_name) {
     bytecode_append_code (bytecode, ORC_BC_SET_NAME);
     bytecode_append_string (bytecode, p->name);
   }
@@ -183,6 +187,20 @@ orc_bytecode_from_program (OrcProgram *p)
   return bytecode;
 }
 
+OrcBytecode *
+orc_bytecode_from_program (OrcProgram *p)
+{
+  return orc_bytecode_from_program_full (p, TRUE);
+}
+
+/* The bytecode of the program without its name, two programs with the
+ * same body compile to the same code. */
+OrcBytecode *
+orc_bytecode_from_program_body (OrcProgram *p)
+{
+  return orc_bytecode_from_program_full (p, FALSE);
+}
+
 void
 bytecode_append_byte (OrcBytecode *bytecode, int byte)
 {
@@ -228,7 +246,7 @@ bytecode_append_code (OrcBytecode *bytecode, int code)
       "ADD_PARAMETER_DOUBLE",
       "ADD_TEMPORARY",
       "RESERVED_21",
-      "RESERVED_22",
+      "SET_FAST_MATH",
       "RESERVED_23",
       "RESERVED_24",
       "RESERVED_25",
@@ -372,8 +390,24 @@ orc_bytecode_parse_get_uint64 (OrcBytecodeParse *parse)
   return value;
 }
 
+static int orc_bytecode_parse_function_internal (OrcProgram *program,
+    const orc_uint8 *bytecode);
+
 int
 orc_bytecode_parse_function (OrcProgram *program, const orc_uint8 *bytecode)
+{
+  orc_uint64 start = orc_stats_get_time ();
+  int ret;
+
+  ret = orc_bytecode_parse_function_internal (program, bytecode);
+  orc_stats_add_phase (ORC_STATS_PHASE_BYTECODE_PARSE, start);
+
+  return ret;
+}
+
+static int
+orc_bytecode_parse_function_internal (OrcProgram *program,
+    const orc_uint8 *bytecode)
 {
   OrcBytecodeParse _parse;
   OrcBytecodeParse *parse = &_parse;
@@ -416,6 +450,9 @@ orc_bytecode_parse_function (OrcProgram *program, const orc_uint8 *bytecode)
         case ORC_BC_SET_2D:
           program->is_2d = TRUE;
           break;
+        case ORC_BC_SET_FAST_MATH:
+          program->is_fast_math = TRUE;
+          break;
         case ORC_BC_SET_CONSTANT_M:
           program->constant_m = orc_bytecode_parse_get_int (parse);
           break;
@@ -26,7 +26,7 @@ typedef enum {
   ORC_BC_ADD_PARAMETER_DOUBLE,
   ORC_BC_ADD_TEMPORARY,
   ORC_BC_INSTRUCTION_FLAGS,
-  ORC_BC_RESERVED_22,
+  ORC_BC_SET_FAST_MATH,
   ORC_BC_RESERVED_23,
   ORC_BC_RESERVED_24,
   ORC_BC_RESERVED_25,
@@ -13,18 +13,430 @@
 #include <windows.h>
 #endif
 
+#if defined(HAVE_THREAD_PTHREAD)
+#include <pthread.h>
+#elif defined(HAVE_THREAD_WIN32)
+#include <windows.h>
+#endif
+
+/* Libraries in one process often carry identical programs under different
+ * names.  Code compiled for the JIT is kept in a table keyed by the
+ * bytecode of the program without its name, the target and the flags, so
+ * that compiling an identical program takes a reference to the existing
+ * code instead of generating it again. */
+
+#define ORC_N_SHARED_BUCKETS 64
+
+typedef struct _OrcSharedCode OrcSharedCode;
+
+struct _OrcSharedCode {
+  OrcSharedCode *next;
+  orc_uint32 hash;
+  OrcTarget *target;
+  unsigned int flags;
+  orc_uint8 *bytecode;
+  int length;
+  OrcCode *code;
+  char *asm_code;
+};
+
+static OrcSharedCode *shared_codes[ORC_N_SHARED_BUCKETS];
+
+/* FNV-1a */
+static orc_uint32
+orc_code_hash (OrcBytecode *bytecode, OrcTarget *target, unsigned int flags)
+{
+  orc_uint32 hash = 2166136261U;
+  const char *name = target->name;
+  int i;
+
+  for (i = 0; i < bytecode->length; i++) {
+    hash = (hash ^ bytecode->bytecode[i]) * 16777619U;
+  }
+  for (i = 0; name[i]; i++) {
+    hash = (hash ^ (orc_uint8)name[i]) * 16777619U;
+  }
+  for (i = 0; i < 4; i++) {
+    hash = (hash ^ ((flags >> (i * 8)) & 0xff)) * 16777619U;
+  }
+
+  return hash;
+}
+
+static OrcSharedCode *
+orc_code_find_shared (OrcBytecode *bytecode, orc_uint32 hash,
+    OrcTarget *target, unsigned int flags)
+{
+  OrcSharedCode *shared;
+
+  for (shared = shared_codes[hash % ORC_N_SHARED_BUCKETS]; shared;
+      shared = shared->next) {
+    if (shared->hash == hash && shared->target == target &&
+        shared->flags == flags && shared->length == bytecode->length &&
+        memcmp (shared->bytecode, bytecode->bytecode, bytecode->length) == 0) {
+      return shared;
+    }
+  }
+
+  return NULL;
+}
+
+/* Returns a new reference to the code compiled for a program with the same
+ * body, or NULL.  program gets a copy of the assembly of the code. */
+OrcCode *
+orc_code_lookup_shared (OrcProgram *program, OrcTarget *target,
+    unsigned int flags)
+{
+  OrcBytecode *bytecode;
+  OrcSharedCode *shared;
+  OrcCode *code = NULL;
+  orc_uint32 hash;
+
+  bytecode = orc_bytecode_from_program_body (program);
+  hash = orc_code_hash (bytecode, target, flags);
+
+  orc_global_mutex_lock ();
+  shared = orc_code_find_shared (bytecode, hash, target, flags);
+  if (shared) {
+    code = shared->code;
+    code->refcount++;
+    if (shared->asm_code) {
+      program->asm_code = strdup (shared->asm_code);
+    }
+  }
+  orc_global_mutex_unlock ();
+
+  orc_bytecode_free (bytecode);
+
+  return code;
+}
+
+/* Makes code that was just compiled for program available to identical
+ * programs.  If another thread added code for the same body in the
+ * meantime, code stays private to program. */
+void
+orc_code_add_shared (OrcCode *code, OrcProgram *program, OrcTarget *target,
+    unsigned int flags)
+{
+  OrcBytecode *bytecode;
+  OrcSharedCode *shared;
+  orc_uint32 hash;
+
+  bytecode = orc_bytecode_from_program_body (program);
+  hash = orc_code_hash (bytecode, target, flags);
+
+  orc_global_mutex_lock ();
+  if (orc_code_find_shared (bytecode, hash, target, flags) == NULL) {
+    shared = malloc (sizeof(OrcSharedCode));
+    shared->hash = hash;
+    shared->target = target;
+    shared->flags = flags;
+    shared->bytecode = bytecode->bytecode;
+    shared->length = bytecode->length;
+    shared->code = code;
+    shared->asm_code = program->asm_code ? strdup (program->asm_code) : NULL;
+    shared->next = shared_codes[hash % ORC_N_SHARED_BUCKETS];
+    shared_codes[hash % ORC_N_SHARED_BUCKETS] = shared;
+
+    code->shared = shared;
+    bytecode->bytecode = NULL;
+  }
+  orc_global_mutex_unlock ();
+
+  orc_bytecode_free (bytecode);
+}
+
+/* Must be called with orc_global_mutex_lock() */
+static void
+orc_code_remove_shared (OrcCode *code)
+{
+  OrcSharedCode *shared = code->shared;
+  OrcSharedCode **link;
+
+  for (link = &shared_codes[shared->hash % ORC_N_SHARED_BUCKETS];
+      *link != shared; link = &(*link)->next);
+  *link = shared->next;
+
+  free (shared->bytecode);
+  free (shared->asm_code);
+  free (shared);
+  code->shared = NULL;
+}
+
+/* Tiered compilation.  Programs are first compiled to baseline code,
+ * without the optional optimisation passes.  The exec function of the
+ * code then counts calls and elements, and once the program is hot it is
+ * recompiled with all optimisations, in a separate thread when threads
+ * are available.  The optimised code replaces the baseline code with
+ * orc_code_replace(). */
+
+#define ORC_TIER_CALLS 100
+#define ORC_TIER_ELEMENTS (1 << 20)
+
+enum {
+  ORC_TIER_BASELINE,
+  ORC_TIER_COMPILING,
+  ORC_TIER_DONE
+};
+
+typedef struct _OrcCodeTier OrcCodeTier;
+
+struct _OrcCodeTier {
+  /* the function currently called through OrcCode.exec */
+  OrcExecutorFunc exec;
+  /* changed under orc_global_mutex_lock(), read without it */
+  int state;
+  /* only decide when to tier up, so they are added to without ordering
+   * and calls counted after the switch has started don't matter */
+  int n_calls;
+  int n_elements;
+
+  OrcTarget *target;
+  unsigned int flags;
+  OrcBytecode *bytecode;
+};
+
+/* Recompiles the program with the optimisations and switches to the new
+ * code.  Narrowing is left out, so the optimised code computes the same
+ * as the baseline code it replaces.  Runs with a reference to code that
+ * it drops at the end. */
+static void
+orc_code_tier_compile (OrcCode *code)
+{
+  OrcCodeTier *tier = code->tier;
+  OrcProgram *program;
+  OrcCompileResult result;
+
+  program = orc_program_new ();
+  if (orc_bytecode_parse_function (program, tier->bytecode->bytecode) == 0) {
+    result = orc_program_compile_full (program, tier->target,
+        tier->flags | ORC_TARGET_PRIVATE_CODE | ORC_TARGET_NO_NARROW);
+    if (ORC_COMPILE_RESULT_IS_SUCCESSFUL (result) &&
+        program->code_exec != (void *)orc_executor_emulate) {
+      orc_global_mutex_lock ();
+      /* unless the code was replaced in the meantime */
+      if (orc_atomic_load (&tier->state) == ORC_TIER_COMPILING) {
+        orc_global_mutex_unlock ();
+        ORC_INFO ("program \"%s\" is hot, switching to optimised code",
+            program->name);
+        orc_code_replace (code, orc_program_take_code (program));
+      } else {
+        orc_global_mutex_unlock ();
+      }
+    }
+  }
+  orc_program_free (program);
+
+  orc_atomic_store (&tier->state, ORC_TIER_DONE);
+  orc_code_free (code);
+}
+
+#if defined(HAVE_THREAD_PTHREAD)
+static void *
+orc_code_tier_thread (void *data)
+{
+  orc_code_tier_compile (data);
+  return NULL;
+}
+#elif defined(HAVE_THREAD_WIN32)
+static DWORD WINAPI
+orc_code_tier_thread (LPVOID data)
+{
+  orc_code_tier_compile (data);
+  return 0;
+}
+#endif
+
+static void
+orc_code_tier_up (OrcCode *code)
+{
+  OrcCodeTier *tier = code->tier;
+
+  orc_global_mutex_lock ();
+  if (orc_atomic_load (&tier->state) != ORC_TIER_BASELINE) {
+    orc_global_mutex_unlock ();
+    return;
+  }
+  orc_atomic_store (&tier->state, ORC_TIER_COMPILING);
+  code->refcount++;
+  orc_global_mutex_unlock ();
+
+#if defined(HAVE_THREAD_PTHREAD)
+  {
+    pthread_t thread;
+    pthread_attr_t attr;
+    int ret;
+
+    pthread_attr_init (&attr);
+    pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED);
+    ret = pthread_create (&thread, &attr, orc_code_tier_thread, code);
+    pthread_attr_destroy (&attr);
+    if (ret == 0) return;
+  }
+#elif defined(HAVE_THREAD_WIN32)
+  {
+    HANDLE thread;
+
+    thread = CreateThread (NULL, 0, orc_code_tier_thread, code, 0, NULL);
+    if (thread) {
+      CloseHandle (thread);
+      return;
+    }
+  }
+#endif
+  orc_code_tier_compile (code);
+}
+
+static void
+orc_code_exec_tiered (OrcExecutor *ex)
+{
+  OrcCode *code = NULL;
+  OrcCodeTier *tier;
+  OrcExecutorFunc func;
+  orc_int64 n_elements;
+
+  /* code generated by orcc passes the code in A2 without a program,
+   * callers with a program may leave A2 unset */
+  if (ex->program) code = ex->program->orccode;
+  if (code == NULL) code = ex->arrays[ORC_VAR_A2];
+  tier = code->tier;
+
+  if (orc_atomic_load (&tier->state) == ORC_TIER_BASELINE) {
+    n_elements = (orc_int64)ex->n * (code->is_2d ? ORC_EXECUTOR_M(ex) : 1);
+    if (orc_atomic_add (&tier->n_calls, 1) >= ORC_TIER_CALLS ||
+        orc_atomic_add (&tier->n_elements,
+          (int)MIN (n_elements, ORC_TIER_ELEMENTS)) >= ORC_TIER_ELEMENTS) {
+      orc_code_tier_up (code);
+    }
+  }
+
+  /* the baseline code is only ever called from here, so that it can be
+   * freed once it is replaced */
+  orc_code_enter ();
+  func = orc_atomic_load (&tier->exec);
+  func (ex);
+  orc_code_leave ();
+}
+
+/* Turns code compiled with ORC_TARGET_BASELINE for program into tiered
+ * code, flags are the ones to recompile with */
+void
+orc_code_start_tiering (OrcCode *code, OrcProgram *program, OrcTarget *target,
+    unsigned int flags)
+{
+  OrcCodeTier *tier;
+
+  tier = malloc (sizeof(OrcCodeTier));
+  memset (tier, 0, sizeof(OrcCodeTier));
+  tier->exec = code->exec;
+  tier->state = ORC_TIER_BASELINE;
+  tier->target = target;
+  tier->flags = flags;
+  tier->bytecode = orc_bytecode_from_program (program);
+
+  code->tier = tier;
+  code->exec = orc_code_exec_tiered;
+}
+
+static void
+orc_code_tier_free (OrcCodeTier *tier)
+{
+  orc_bytecode_free (tier->bytecode);
+  free (tier);
+}
+
+static void
+orc_code_unregister_unwind (orc_uint8 *code)
+{
+#if defined(_WIN64) && defined(ORC_SUPPORTS_BACKTRACE_FROM_JIT)
+  DWORD64 dyn_base = 0;
+  PRUNTIME_FUNCTION p =
+      RtlLookupFunctionEntry((DWORD64)code, &dyn_base, NULL);
+  if (p != NULL) {
+    RtlDeleteFunctionTable((PRUNTIME_FUNCTION)((DWORD64)code | 0x3));
+  }
+#endif
+}
+
+/**
+ * orc_code_replace:
+ * @code: the OrcCode to update
+ * @replacement: code compiled for the same program
+ *
+ * Switches @code to the machine code of @replacement, which is consumed.
+ * OrcCode.exec is updated atomically, so that other threads calling the
+ * code keep running either the old or the new function, and the old
+ * machine code is freed once no thread runs it anymore.  This needs the
+ * callers to be inside orc_code_enter() and orc_code_leave(), which
+ * orc_executor_run() takes care of.
+ *
+ * @replacement must not be shared or tiered, that is, it has to be
+ * compiled with ORC_TARGET_PRIVATE_CODE.
+ */
+void
+orc_code_replace (OrcCode *code, OrcCode *replacement)
+{
+  OrcCodeChunk *old_chunk;
+  orc_uint8 *old_code;
+
+  orc_global_mutex_lock ();
+  if (replacement->shared || replacement->tier || replacement->refcount != 1) {
+    orc_global_mutex_unlock ();
+    ORC_ERROR ("replacement code is shared, compile it with "
+        "ORC_TARGET_PRIVATE_CODE");
+    return;
+  }
+  old_chunk = code->chunk;
+  old_code = code->code;
+  code->chunk = replacement->chunk;
+  code->code = replacement->code;
+  code->code_size = replacement->code_size;
+  if (code->tier) {
+    OrcCodeTier *tier = code->tier;
+
+    orc_atomic_store (&tier->exec, replacement->exec);
+    orc_atomic_store (&tier->state, ORC_TIER_DONE);
+  }
+  orc_atomic_store (&code->exec, replacement->exec);
+  orc_global_mutex_unlock ();
+
+  if (old_chunk) {
+    orc_code_unregister_unwind (old_code);
+    orc_code_chunk_retire (old_chunk);
+  }
+
+  replacement->chunk = NULL;
+  orc_code_free (replacement);
+}
+
 OrcCode *
 orc_code_new (void)
 {
   OrcCode *code;
   code = malloc(sizeof(OrcCode));
   memset (code, 0, sizeof(OrcCode));
+  code->refcount = 1;
   return code;
 }
 
 void
 orc_code_free (OrcCode *code)
 {
+  orc_global_mutex_lock ();
+  code->refcount--;
+  if (code->refcount > 0) {
+    orc_global_mutex_unlock ();
+    return;
+  }
+  if (code->shared) {
+    orc_code_remove_shared (code);
+  }
+  orc_global_mutex_unlock ();
+
+  if (code->tier) {
+    orc_code_tier_free (code->tier);
+    code->tier = NULL;
+  }
   if (code->insns) {
     free (code->insns);
     code->insns = NULL;
@@ -34,14 +446,7 @@ orc_code_free (OrcCode *code)
     code->vars = NULL;
   }
   if (code->chunk) {
-#if defined(_WIN64) && defined(ORC_SUPPORTS_BACKTRACE_FROM_JIT)
-  DWORD64 dyn_base = 0;
-  PRUNTIME_FUNCTION p =
-      RtlLookupFunctionEntry((DWORD64)code->code, &dyn_base, NULL);
-  if (p != NULL) {
-    RtlDeleteFunctionTable((PRUNTIME_FUNCTION)((DWORD64)code->code | 0x3));
-  }
-#endif
+    orc_code_unregister_unwind (code->code);
     orc_code_chunk_free (code->chunk);
     code->chunk = NULL;
   }
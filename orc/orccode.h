@@ -38,6 +38,16 @@ struct _OrcCode {
   int is_2d;
   int constant_n;
   int constant_m;
+
+  /* for sharing between identical programs */
+  int refcount;
+  void *shared;
+
+  /* for tiered compilation */
+  void *tier;
+
+  /* the backend, for tracing */
+  const char *target_name;
 };
 
 
@@ -46,6 +56,10 @@ ORC_API void orc_code_allocate_codemem (OrcCode *code, int size);
 ORC_API OrcCode * orc_code_new (void);
 ORC_API void      orc_code_free (OrcCode *code);
 
+ORC_API void      orc_code_replace (OrcCode *code, OrcCode *replacement);
+ORC_API void      orc_code_enter (void);
+ORC_API void      orc_code_leave (void);
+
 ORC_END_DECLS
 
 #endif
@@ -27,6 +27,12 @@
   #endif
 #endif
 
+#if defined(HAVE_THREAD_PTHREAD)
+#include <pthread.h>
+#elif defined(HAVE_THREAD_WIN32) && !defined(HAVE_CODEMEM_VIRTUALALLOC)
+#include <windows.h>
+#endif
+
 #include <orc/orcinternal.h>
 #include <orc/orcprogram.h>
 #include <orc/orcdebug.h>
@@ -57,11 +63,55 @@ struct _OrcCodeChunk {
 };
 
 
+/* Code that is replaced while other threads may be running it is freed
+ * with epoch based reclamation.  Threads running Orc code announce it
+ * with orc_code_enter() and orc_code_leave(), which record the global
+ * epoch in a record of the thread.  The epoch advances once every thread
+ * inside has entered in the current epoch, and a chunk retired in an
+ * epoch is freed two epochs later, when no thread can still run it. */
+
+typedef struct _OrcEpochThread OrcEpochThread;
+typedef struct _OrcRetiredChunk OrcRetiredChunk;
+
+struct _OrcEpochThread {
+  OrcEpochThread *next;
+  int in_use;
+  int nesting;
+  /* twice the epoch the thread entered in plus one, 0 outside */
+  unsigned int state;
+};
+
+struct _OrcRetiredChunk {
+  OrcRetiredChunk *next;
+  OrcCodeChunk *chunk;
+  unsigned int epoch;
+};
+
 static int orc_code_region_allocate_codemem (OrcCodeRegion *region);
+static void orc_code_reclaim_chunks (void);
 
 static OrcCodeRegion **orc_code_regions;
 static int orc_code_n_regions;
 
+static unsigned int orc_epoch;
+static OrcEpochThread *orc_epoch_threads;
+static OrcRetiredChunk *orc_retired_chunks;
+
+#if defined(HAVE_THREAD_PTHREAD)
+static pthread_key_t orc_epoch_key;
+#define orc_epoch_get_record() \
+  ((OrcEpochThread *)pthread_getspecific (orc_epoch_key))
+#define orc_epoch_set_record(t) pthread_setspecific (orc_epoch_key, (t))
+#elif defined(HAVE_THREAD_WIN32)
+static DWORD orc_epoch_key = FLS_OUT_OF_INDEXES;
+#define orc_epoch_get_record() ((OrcEpochThread *)FlsGetValue (orc_epoch_key))
+#define orc_epoch_set_record(t) FlsSetValue (orc_epoch_key, (t))
+#else
+static OrcEpochThread *orc_epoch_record;
+#define orc_epoch_get_record() orc_epoch_record
+#define orc_epoch_set_record(t) (orc_epoch_record = (t))
+#endif
+
 
 OrcCodeRegion *
 orc_code_region_alloc (void)
@@ -101,6 +151,8 @@ orc_code_region_new (void)
 
   region->chunks = chunk;
 
+  ORC_PROBE2 (region_new, region->exec_ptr, region->size);
+
   return region;
 }
 
@@ -188,8 +240,13 @@ orc_code_allocate_codemem (OrcCode *code, int size)
   OrcCodeChunk *chunk;
   int aligned_size =
       (size + _orc_codemem_alignment) & (~_orc_codemem_alignment);
+  orc_uint64 start = orc_stats_get_time ();
+  OrcStats stats;
+  int n_regions;
 
   orc_global_mutex_lock ();
+  orc_code_reclaim_chunks ();
+  n_regions = orc_code_n_regions;
   chunk = orc_code_region_get_free_chunk (aligned_size);
   if (!chunk) {
     orc_global_mutex_unlock ();
@@ -213,7 +270,61 @@ orc_code_allocate_codemem (OrcCode *code, int size)
   code->code_size = size;
   /* compiler->codeptr = ORC_PTR_OFFSET(region->write_ptr, chunk->offset); */
 
+  memset (&stats, 0, sizeof(OrcStats));
+  stats.n_regions = orc_code_n_regions - n_regions;
   orc_global_mutex_unlock ();
+
+  orc_stats_add_time (&stats, ORC_STATS_PHASE_CODEMEM, start);
+  orc_stats_merge (&stats);
+}
+
+/* Must be called with orc_global_mutex_lock() */
+static void
+orc_code_chunk_release (OrcCodeChunk *chunk)
+{
+  chunk->used = FALSE;
+  if (chunk->next && !chunk->next->used) {
+    orc_code_chunk_merge (chunk);
+  }
+  if (chunk->prev && !chunk->prev->used) {
+    orc_code_chunk_merge (chunk->prev);
+  }
+}
+
+/* Advances the epoch if possible and frees the chunks that no thread can
+ * run anymore.  Must be called with orc_global_mutex_lock() */
+static void
+orc_code_reclaim_chunks (void)
+{
+  OrcEpochThread *t;
+  OrcRetiredChunk **link;
+  OrcRetiredChunk *retired;
+  unsigned int epoch = orc_epoch;
+
+  if (orc_retired_chunks == NULL) return;
+
+  /* the code pointers were replaced before the threads are checked */
+  orc_atomic_fence ();
+  for (t = orc_epoch_threads; t; t = t->next) {
+    unsigned int state = orc_atomic_load (&t->state);
+
+    if (state != 0 && (state >> 1) != epoch) break;
+  }
+  if (t == NULL) {
+    epoch++;
+    orc_atomic_store (&orc_epoch, epoch);
+  }
+
+  link = &orc_retired_chunks;
+  while ((retired = *link) != NULL) {
+    if (epoch - retired->epoch >= 2) {
+      *link = retired->next;
+      orc_code_chunk_release (retired->chunk);
+      free (retired);
+    } else {
+      link = &retired->next;
+    }
+  }
 }
 
 void
@@ -225,30 +336,213 @@ orc_code_chunk_free (OrcCodeChunk *chunk)
   }
 
   orc_global_mutex_lock ();
-  chunk->used = FALSE;
-  if (chunk->next && !chunk->next->used) {
-    orc_code_chunk_merge (chunk);
+  orc_code_chunk_release (chunk);
+  orc_global_mutex_unlock ();
+}
+
+/* Frees a chunk that other threads may still be running, once they are
+ * done with it */
+void
+orc_code_chunk_retire (OrcCodeChunk *chunk)
+{
+  OrcRetiredChunk *retired;
+
+  if (_orc_compiler_flag_debug || !ORC_HAVE_ATOMICS) {
+    /* without atomics nothing tells when the chunk is unused, so it is
+     * never freed */
+    return;
   }
-  if (chunk->prev && !chunk->prev->used) {
-    orc_code_chunk_merge (chunk->prev);
+
+  retired = malloc (sizeof(OrcRetiredChunk));
+  orc_global_mutex_lock ();
+  retired->chunk = chunk;
+  retired->epoch = orc_epoch;
+  retired->next = orc_retired_chunks;
+  orc_retired_chunks = retired;
+  orc_code_reclaim_chunks ();
+  orc_global_mutex_unlock ();
+}
+
+#if defined(HAVE_THREAD_PTHREAD)
+static void
+orc_epoch_thread_exit (void *data)
+#elif defined(HAVE_THREAD_WIN32)
+static VOID WINAPI
+orc_epoch_thread_exit (PVOID data)
+#else
+static void
+orc_epoch_thread_exit (void *data)
+#endif
+{
+  OrcEpochThread *t = data;
+
+  if (t == NULL) return;
+  orc_global_mutex_lock ();
+  t->nesting = 0;
+  orc_atomic_store (&t->state, 0);
+  t->in_use = FALSE;
+  orc_global_mutex_unlock ();
+}
+
+void
+_orc_code_epoch_init (void)
+{
+#if defined(HAVE_THREAD_PTHREAD)
+  pthread_key_create (&orc_epoch_key, orc_epoch_thread_exit);
+#elif defined(HAVE_THREAD_WIN32)
+  orc_epoch_key = FlsAlloc (orc_epoch_thread_exit);
+#endif
+}
+
+static OrcEpochThread *
+orc_epoch_get_thread (void)
+{
+  OrcEpochThread *t = orc_epoch_get_record ();
+
+  if (ORC_LIKELY (t != NULL)) return t;
+
+  orc_global_mutex_lock ();
+  for (t = orc_epoch_threads; t; t = t->next) {
+    if (!t->in_use) break;
   }
+  if (t == NULL) {
+    t = malloc (sizeof(OrcEpochThread));
+    memset (t, 0, sizeof(OrcEpochThread));
+    t->next = orc_epoch_threads;
+    orc_epoch_threads = t;
+  }
+  t->in_use = TRUE;
   orc_global_mutex_unlock ();
+
+  orc_epoch_set_record (t);
+
+  return t;
+}
+
+/**
+ * orc_code_enter:
+ *
+ * Marks the calling thread as running Orc code until the matching call
+ * to orc_code_leave().  Code replaced with orc_code_replace() in the
+ * meantime is not freed before the thread leaves.  orc_executor_run()
+ * does this itself; callers that call OrcCode.exec directly have to do
+ * it when the code may be replaced.  Calls can be nested.
+ */
+void
+orc_code_enter (void)
+{
+#if ORC_HAVE_ATOMICS
+  OrcEpochThread *t = orc_epoch_get_thread ();
+
+  if (t->nesting++ == 0) {
+    orc_atomic_store (&t->state, orc_atomic_load (&orc_epoch) * 2 + 1);
+    /* the state is visible before any code pointer is read */
+    orc_atomic_fence ();
+  }
+#endif
+}
+
+/**
+ * orc_code_leave:
+ *
+ * Ends a section started with orc_code_enter().
+ */
+void
+orc_code_leave (void)
+{
+#if ORC_HAVE_ATOMICS
+  OrcEpochThread *t = orc_epoch_get_record ();
+
+  if (--t->nesting == 0) {
+    orc_atomic_store (&t->state, 0);
+  }
+#endif
 }
 
 #ifdef HAVE_CODEMEM_MMAP
 static int
-orc_code_region_allocate_codemem_dual_map (OrcCodeRegion *region,
-    const char *dir, int force_unlink)
+orc_code_region_map_fd (OrcCodeRegion *region, int fd, const char *name)
 {
-  int fd;
   int n;
-  char *filename;
-  mode_t mask;
   int exec_prot = PROT_READ | PROT_EXEC;
 
   if (_orc_compiler_flag_debug)
     exec_prot |= PROT_WRITE;
 
+  n = ftruncate (fd, SIZE);
+  if (n < 0) {
+    ORC_WARNING("failed to expand file to size");
+    return FALSE;
+  }
+
+  region->exec_ptr = mmap (NULL, SIZE, exec_prot, MAP_SHARED, fd, 0);
+  if (region->exec_ptr == MAP_FAILED) {
+    ORC_WARNING("failed to create exec map '%s'. err=%i", name, errno);
+    return FALSE;
+  }
+  region->write_ptr = mmap (NULL, SIZE, PROT_READ|PROT_WRITE,
+      MAP_SHARED, fd, 0);
+  if (region->write_ptr == MAP_FAILED) {
+    ORC_WARNING ("failed to create write map '%s'. err=%i", name, errno);
+    munmap (region->exec_ptr, SIZE);
+    return FALSE;
+  }
+  region->size = SIZE;
+
+  return TRUE;
+}
+
+#ifdef HAVE_MEMFD_CREATE
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+#ifndef MFD_EXEC
+#define MFD_EXEC 0x0010U
+#endif
+
+/* Set once memfd_create() has failed, so that every following region
+ * goes straight to the file based fallbacks. */
+static int orc_code_memfd_unusable;
+
+static int
+orc_code_region_allocate_codemem_memfd (OrcCodeRegion *region)
+{
+  int fd;
+  int ret;
+
+  if (orc_code_memfd_unusable)
+    return FALSE;
+
+  /* Kernels with vm.memfd_noexec support need MFD_EXEC to allow PROT_EXEC
+   * mappings, older kernels reject the unknown flag with EINVAL. */
+  fd = memfd_create ("orcexec", MFD_CLOEXEC | MFD_EXEC);
+  if (fd == -1 && errno == EINVAL)
+    fd = memfd_create ("orcexec", MFD_CLOEXEC);
+  if (fd == -1) {
+    ORC_INFO ("failed to create memfd. err=%i", errno);
+    orc_code_memfd_unusable = TRUE;
+    return FALSE;
+  }
+
+  ret = orc_code_region_map_fd (region, fd, "memfd:orcexec");
+  if (!ret)
+    orc_code_memfd_unusable = TRUE;
+
+  close (fd);
+  return ret;
+}
+#endif
+
+static int
+orc_code_region_allocate_codemem_dual_map (OrcCodeRegion *region,
+    const char *dir, int force_unlink)
+{
+  int fd;
+  int ret;
+  char *filename;
+  mode_t mask;
+
   filename = malloc (strlen ("/orcexec..") +
       strlen (dir) + 6 + 1);
 
@@ -268,35 +562,11 @@ orc_code_region_allocate_codemem_dual_map (OrcCodeRegion *region,
     unlink (filename);
   }
 
-  n = ftruncate (fd, SIZE);
-  if (n < 0) {
-    ORC_WARNING("failed to expand file to size");
-    close (fd);
-    free (filename);
-    return FALSE;
-  }
-
-  region->exec_ptr = mmap (NULL, SIZE, exec_prot, MAP_SHARED, fd, 0);
-  if (region->exec_ptr == MAP_FAILED) {
-    ORC_WARNING("failed to create exec map '%s'. err=%i", filename, errno);
-    close (fd);
-    free (filename);
-    return FALSE;
-  }
-  region->write_ptr = mmap (NULL, SIZE, PROT_READ|PROT_WRITE,
-      MAP_SHARED, fd, 0);
-  if (region->write_ptr == MAP_FAILED) {
-    ORC_WARNING ("failed to create write map '%s'. err=%i", filename, errno);
-    free (filename);
-    munmap (region->exec_ptr, SIZE);
-    close (fd);
-    return FALSE;
-  }
-  region->size = SIZE;
+  ret = orc_code_region_map_fd (region, fd, filename);
 
   free (filename);
   close (fd);
-  return TRUE;
+  return ret;
 }
 
 #ifndef MAP_ANONYMOUS
@@ -326,6 +596,14 @@ orc_code_region_allocate_codemem (OrcCodeRegion *region)
 {
   const char *tmpdir;
 
+#ifdef HAVE_MEMFD_CREATE
+  /* An anonymous memfd needs no writable+exec filesystem and leaves nothing
+   * behind to clean up.  In debug mode the named temp file is kept so
+   * that tools can find the generated code. */
+  if (!_orc_compiler_flag_debug &&
+      orc_code_region_allocate_codemem_memfd (region)) return TRUE;
+#endif
+
   tmpdir = getenv ("XDG_RUNTIME_DIR");
   if (tmpdir && orc_code_region_allocate_codemem_dual_map (region,
         tmpdir, FALSE)) return TRUE;
@@ -351,6 +629,7 @@ orc_code_region_allocate_codemem (OrcCodeRegion *region)
   ORC_ERROR(
       "Failed to create write+exec mappings. This "
       "is probably because SELinux execmem check is enabled (good), "
+      "memfd_create() is unavailable or sealed noexec, "
       "$XDG_RUNTIME_DIR, $HOME, $TMPDIR, $HOME and /tmp are mounted noexec (good), "
       "and anonymous mappings cannot be created (really bad)."
       );
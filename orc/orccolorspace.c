@@ -0,0 +1,1305 @@
+
+#include "config.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcdebug.h>
+#include <orc/orccolorspace.h>
+
+/**
+ * SECTION:orccolorspace
+ * @title: OrcColorConverter
+ * @short_description: Conversions between YUV and RGB formats
+ *
+ * An #OrcColorConverter converts images between a YUV and an RGB format
+ * with the BT.601, BT.709 or BT.2020 matrix.  The conversion is done by
+ * one or two Orc programs that are generated for the pair of formats and
+ * the requested precision, and compiled when the converter is created.
+ * The programs can be retrieved with orc_color_converter_get_program(),
+ * for example to write them out as Orc source and compile them ahead of
+ * time with orcc; their parameters then have to be passed the values
+ * returned by orc_color_converter_get_param().
+ *
+ * RGB is always full range, the range only applies to the YUV side.
+ * Packed pixels are split as laid out on little endian hosts.
+ * Chroma is repeated when converting from a subsampled format and
+ * averaged over the pixels it covers when converting to one, in which
+ * case the width (and for 4:2:0 the height) of the image has to be even.
+ */
+
+typedef struct _OrcColorFormatInfo OrcColorFormatInfo;
+struct _OrcColorFormatInfo {
+  const char *name;
+  int is_yuv;
+  int n_planes;
+  int bytes;            /* per component */
+  int depth;
+  int h_shift;
+  int v_shift;
+  int alpha;            /* position of alpha in packed pixels, or -1 */
+  int pos[3];           /* position (packed) or plane of Y,U,V or R,G,B */
+};
+
+static const OrcColorFormatInfo formats[ORC_COLOR_FORMAT_N_FORMATS] = {
+  { "AYUV", TRUE, 1, 1, 8, 0, 0, 0, { 1, 2, 3 } },
+  { "AYUV64", TRUE, 1, 2, 16, 0, 0, 0, { 1, 2, 3 } },
+  { "Y444", TRUE, 3, 1, 8, 0, 0, -1, { 0, 1, 2 } },
+  { "Y42B", TRUE, 3, 1, 8, 1, 0, -1, { 0, 1, 2 } },
+  { "I420", TRUE, 3, 1, 8, 1, 1, -1, { 0, 1, 2 } },
+  { "Y444_10", TRUE, 3, 2, 10, 0, 0, -1, { 0, 1, 2 } },
+  { "I422_10", TRUE, 3, 2, 10, 1, 0, -1, { 0, 1, 2 } },
+  { "I420_10", TRUE, 3, 2, 10, 1, 1, -1, { 0, 1, 2 } },
+  { "Y444_16", TRUE, 3, 2, 16, 0, 0, -1, { 0, 1, 2 } },
+  { "ARGB", FALSE, 1, 1, 8, 0, 0, 0, { 1, 2, 3 } },
+  { "BGRA", FALSE, 1, 1, 8, 0, 0, 3, { 2, 1, 0 } },
+  { "RGBA", FALSE, 1, 1, 8, 0, 0, 3, { 0, 1, 2 } },
+  { "ABGR", FALSE, 1, 1, 8, 0, 0, 0, { 3, 2, 1 } },
+  { "ARGB64", FALSE, 1, 2, 16, 0, 0, 0, { 1, 2, 3 } },
+  { "GBR", FALSE, 3, 1, 8, 0, 0, -1, { 2, 0, 1 } },
+  { "GBR_10", FALSE, 3, 2, 10, 0, 0, -1, { 2, 0, 1 } },
+  { "GBR_16", FALSE, 3, 2, 16, 0, 0, -1, { 2, 0, 1 } },
+};
+
+struct _OrcColorConverter {
+  OrcColorFormat in_format;
+  OrcColorFormat out_format;
+  OrcColorPrecision precision;
+  int n_programs;
+  OrcProgram *programs[2];
+  int params[2][ORC_MAX_PARAM_VARS];
+};
+
+/* what a program generated from RGB writes */
+enum {
+  CS_OUTPUT_YUV,
+  CS_OUTPUT_Y,
+  CS_OUTPUT_UV
+};
+
+#define CS_MAX_PRODUCTS 3
+
+typedef struct _CsBuilder CsBuilder;
+struct _CsBuilder {
+  OrcProgram *program;
+  OrcColorPrecision precision;
+  int *params;
+  int error;
+
+  /* what the compiler will make of the program */
+  int n_insns;
+  int n_vars;
+  int loaded[ORC_N_VARIABLES];
+
+  /* 2 when the pixels of a pair are handled by X2 instructions, with
+   * temporaries twice as large */
+  int lanes;
+
+  int temps[ORC_MAX_TEMP_VARS];
+  int temp_busy[ORC_MAX_TEMP_VARS];
+  int n_temps;
+
+  /* quantized matrix, as the bits of the constants */
+  int coef[3][3];
+  int zero[3][3];
+  int bias[3];
+  int shift;
+  /* deep inputs are shifted up and multiplied with mulhsl */
+  int pre_shift;
+  int coef_shift;
+
+  /* products shared by the outputs of one pixel */
+  int share_products;
+  int product_in[CS_MAX_PRODUCTS];
+  int product_coef[CS_MAX_PRODUCTS];
+  int product_var[CS_MAX_PRODUCTS];
+  int n_products;
+};
+
+/* The compiler gives each load, store, constant and rewrite of a
+ * temporary a variable of its own and adds the loads and stores to the
+ * instructions.  Programs are kept within its limits here. */
+#define CS_MAX_VARS (ORC_N_COMPILER_VARIABLES - ORC_VAR_T1)
+
+static void
+cs_emit (CsBuilder *b, const char *opcode, int arg0, int arg1, int arg2,
+    int arg3)
+{
+  OrcProgram *p = b->program;
+  OrcStaticOpcode *op;
+  int args[4] = { arg0, arg1, arg2, arg3 };
+  int n_dest = 0;
+  int i;
+
+  op = orc_opcode_find_by_name (opcode);
+  if (op == NULL || p->n_insns >= ORC_N_INSNS) {
+    b->error = TRUE;
+    return;
+  }
+  orc_program_append_2 (p, opcode,
+      b->lanes == 2 ? ORC_INSTRUCTION_FLAG_X2 : 0, arg0, arg1, arg2, arg3);
+
+  b->n_insns++;
+  for (i = 0; i < ORC_STATIC_OPCODE_N_DEST; i++) {
+    OrcVariable *var;
+
+    if (op->dest_size[i] == 0) continue;
+    var = p->vars + args[n_dest++];
+    if (var->vartype == ORC_VAR_TYPE_DEST) b->n_insns++;
+    b->n_vars++;
+  }
+  for (i = 0; i < ORC_STATIC_OPCODE_N_SRC && n_dest + i < 4; i++) {
+    int v = args[n_dest + i];
+
+    if (op->src_size[i] == 0) continue;
+    if (i > 0 && (op->flags & ORC_STATIC_OPCODE_SCALAR)) continue;
+    switch (p->vars[v].vartype) {
+      case ORC_VAR_TYPE_CONST:
+      case ORC_VAR_TYPE_PARAM:
+        if (b->loaded[v] & (1 << (op->src_size[i] * b->lanes))) break;
+        b->loaded[v] |= 1 << (op->src_size[i] * b->lanes);
+        /* fall through */
+      case ORC_VAR_TYPE_SRC:
+      case ORC_VAR_TYPE_DEST:
+        b->n_insns++;
+        b->n_vars++;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (b->n_insns > ORC_N_INSNS || b->n_vars > CS_MAX_VARS) b->error = TRUE;
+}
+
+static int
+cs_get_temp (CsBuilder *b, int size)
+{
+  char name[16];
+  int i;
+
+  size *= b->lanes;
+  for (i = 0; i < b->n_temps; i++) {
+    if (!b->temp_busy[i] && b->program->vars[b->temps[i]].size == size) {
+      b->temp_busy[i] = TRUE;
+      return b->temps[i];
+    }
+  }
+  if (b->n_temps == ORC_MAX_TEMP_VARS) {
+    b->error = TRUE;
+    return b->temps[0];
+  }
+
+  sprintf (name, "t%d", b->n_temps + 1);
+  b->temps[b->n_temps] = orc_program_add_temporary (b->program, size, name);
+  b->temp_busy[b->n_temps] = TRUE;
+  return b->temps[b->n_temps++];
+}
+
+/* sources and constants are passed around like temporaries, releasing
+ * them does nothing */
+static void
+cs_release (CsBuilder *b, int var)
+{
+  int i;
+
+  for (i = 0; i < b->n_temps; i++) {
+    if (b->temps[i] == var) b->temp_busy[i] = FALSE;
+  }
+}
+
+/* a constant with the given bits, or a parameter once the constants are
+ * used up */
+static int
+cs_get_value (CsBuilder *b, int size, orc_int64 bits, int is_float)
+{
+  OrcProgram *p = b->program;
+  char name[16];
+  int var;
+  int i;
+
+  for (i = 0; i < p->n_const_vars; i++) {
+    var = ORC_VAR_C1 + i;
+    if (p->vars[var].size == size && p->vars[var].value.i == bits)
+      return var;
+  }
+  for (i = 0; i < p->n_param_vars && size < 8; i++) {
+    var = ORC_VAR_P1 + i;
+    if (p->vars[var].size == size && b->params[i] == bits &&
+        (p->vars[var].param_type == ORC_PARAM_TYPE_FLOAT) == is_float)
+      return var;
+  }
+
+  if (p->n_const_vars < ORC_MAX_CONST_VARS) {
+    sprintf (name, "c%d", p->n_const_vars + 1);
+    return orc_program_add_constant_int64 (p, size, bits, name);
+  }
+  if (p->n_param_vars < ORC_MAX_PARAM_VARS && size < 8) {
+    sprintf (name, "p%d", p->n_param_vars + 1);
+    b->params[p->n_param_vars] = bits;
+    if (is_float) {
+      return orc_program_add_parameter_float (p, size, name);
+    }
+    return orc_program_add_parameter (p, size, name);
+  }
+
+  b->error = TRUE;
+  return ORC_VAR_C1;
+}
+
+/* size of the values the matrix is applied to */
+static int
+cs_work_size (CsBuilder *b)
+{
+  return b->precision == ORC_COLOR_PRECISION_FAST ? 2 : 4;
+}
+
+/* Puts component c of a packed pixel in place.  Components are merged
+ * into halves, and the halves into dest, as soon as both are there so
+ * that fewer of them stay live; comp and half start out as -1. */
+static void
+cs_pack_component (CsBuilder *b, const OrcColorFormatInfo *f, int dest,
+    int comp[4], int half[2], int c, int value)
+{
+  int h = c / 2;
+
+  comp[c] = value;
+  if (comp[2 * h] < 0 || comp[2 * h + 1] < 0) return;
+
+  half[h] = cs_get_temp (b, 2 * f->bytes);
+  cs_emit (b, f->bytes == 1 ? "mergebw" : "mergewl", half[h], comp[2 * h],
+      comp[2 * h + 1], -1);
+  cs_release (b, comp[2 * h]);
+  cs_release (b, comp[2 * h + 1]);
+  if (half[0] < 0 || half[1] < 0) return;
+
+  cs_emit (b, f->bytes == 1 ? "mergewl" : "mergelq", dest, half[0], half[1],
+      -1);
+  cs_release (b, half[0]);
+  cs_release (b, half[1]);
+}
+
+/* the name of an opcode for operands of size bytes, as in "addl" */
+static const char *
+cs_sized (char name[16], const char *op, int size)
+{
+  sprintf (name, "%s%c", op, "?bw?l???q"[size]);
+  return name;
+}
+
+/* Spreads the samples of var, of bytes each, to lanes twice as wide: the
+ * samples at even positions go to *even and the others to *odd. */
+static void
+cs_spread (CsBuilder *b, int var, int bytes, int *even, int *odd)
+{
+  int size = b->program->vars[var].size;
+  orc_int64 mask = bytes == 1 ? ORC_UINT64_C (0x00ff00ff00ff00ff) :
+      ORC_UINT64_C (0x0000ffff0000ffff);
+  char name[16];
+
+  if (size < 8) mask &= (ORC_UINT64_C (1) << (8 * size)) - 1;
+  *even = cs_get_temp (b, size);
+  *odd = cs_get_temp (b, size);
+  cs_emit (b, cs_sized (name, "and", size), *even, var,
+      cs_get_value (b, size, mask, FALSE), -1);
+  cs_emit (b, cs_sized (name, "shru", size), *odd, var,
+      cs_get_value (b, 4, 8 * bytes, FALSE), -1);
+  if (size > 2 * bytes) {
+    cs_emit (b, cs_sized (name, "and", size), *odd, *odd,
+        cs_get_value (b, size, mask, FALSE), -1);
+  }
+}
+
+/* adds t to *acc, or makes it the accumulator */
+static void
+cs_add (CsBuilder *b, int *acc, int t)
+{
+  char name[16];
+
+  if (*acc < 0) {
+    *acc = t;
+    return;
+  }
+  cs_emit (b, cs_sized (name, "add", b->program->vars[t].size / b->lanes),
+      *acc, *acc, t, -1);
+  cs_release (b, t);
+}
+
+/* Sums n_pixels packed pixels over n_rows rows starting at source src.
+ * The components end up in comp, as 16 bit sums of 8 bit samples or 32
+ * bit sums of 16 bit samples.  The lanes of the pixels are summed before
+ * they are split up. */
+static void
+cs_fetch_packed (CsBuilder *b, const OrcColorFormatInfo *f, int src,
+    int n_rows, int n_pixels, int comp[4])
+{
+  static const char *split[] = { NULL, "splitlw", "splitql" };
+  int lanes[2] = { -1, -1 };
+  int r, i;
+
+  for (r = 0; r < n_rows; r++) {
+    int even, odd;
+
+    cs_spread (b, src + r, f->bytes, &even, &odd);
+    cs_add (b, &lanes[0], even);
+    cs_add (b, &lanes[1], odd);
+  }
+
+  for (i = 0; i < 2; i++) {
+    if (n_pixels == 2) {
+      int first = cs_get_temp (b, 4);
+      int second = cs_get_temp (b, 4);
+
+      cs_emit (b, "splitql", second, first, lanes[i], -1);
+      cs_release (b, lanes[i]);
+      cs_emit (b, "addl", first, first, second, -1);
+      cs_release (b, second);
+      lanes[i] = first;
+    }
+    comp[i] = cs_get_temp (b, 2 * f->bytes);
+    comp[i + 2] = cs_get_temp (b, 2 * f->bytes);
+    cs_emit (b, split[f->bytes], comp[i + 2], comp[i], lanes[i], -1);
+    cs_release (b, lanes[i]);
+  }
+}
+
+/* Sums n_pixels samples of a plane over n_rows rows, the rows being
+ * step sources apart.  The sums are made like in cs_fetch_packed(), pairs
+ * are widened with an X2 conversion and added up at the end. */
+static int
+cs_fetch_planar (CsBuilder *b, int bytes, int src, int step, int n_rows,
+    int n_pixels)
+{
+  static const char *split[] = { NULL, "splitlw", "splitql" };
+  int lanes = b->lanes;
+  int acc = -1;
+  int first, second;
+  int r;
+
+  for (r = 0; r < n_rows; r++) {
+    int t;
+
+    b->lanes = lanes * n_pixels;
+    t = cs_get_temp (b, 2 * bytes);
+    cs_emit (b, bytes == 1 ? "convubw" : "convuwl", t, src + r * step, -1, -1);
+    b->lanes = lanes;
+    cs_add (b, &acc, t);
+  }
+  if (n_pixels == 1) return acc;
+
+  first = cs_get_temp (b, 2 * bytes);
+  second = cs_get_temp (b, 2 * bytes);
+  cs_emit (b, split[bytes], second, first, acc, -1);
+  cs_release (b, acc);
+  cs_add (b, &first, second);
+  return first;
+}
+
+/* converts a sum of 1 << log2_k samples to what the matrix is applied to:
+ * for FAST the average in 16 bits with 6 fractional bits, otherwise the
+ * sum as a 32 bit integer or float */
+static int
+cs_convert_sum (CsBuilder *b, int acc, int log2_k)
+{
+  int t;
+
+  if (b->precision == ORC_COLOR_PRECISION_FAST) {
+    cs_emit (b, "shlw", acc, acc, cs_get_value (b, 2, 6 - log2_k, FALSE), -1);
+    return acc;
+  }
+
+  if (b->program->vars[acc].size == 2 * b->lanes) {
+    t = cs_get_temp (b, 4);
+    cs_emit (b, "convuwl", t, acc, -1, -1);
+    cs_release (b, acc);
+    acc = t;
+  }
+  if (b->pre_shift) {
+    cs_emit (b, "shll", acc, acc, cs_get_value (b, 4, b->pre_shift, FALSE), -1);
+  }
+  if (b->precision == ORC_COLOR_PRECISION_FLOAT) {
+    cs_emit (b, "convlf", acc, acc, -1, -1);
+  }
+  return acc;
+}
+
+static void
+cs_clear_products (CsBuilder *b)
+{
+  int i;
+
+  for (i = 0; i < b->n_products; i++) {
+    cs_release (b, b->product_var[i]);
+  }
+  b->n_products = 0;
+}
+
+static int
+cs_product (CsBuilder *b, int in, int coef)
+{
+  static const char *mul[] = { "mulhsw", "mulll", "mulf" };
+  const char *opcode = mul[b->precision];
+  int t;
+  int i;
+
+  for (i = 0; i < b->n_products; i++) {
+    if (b->product_in[i] == in && b->product_coef[i] == coef)
+      return b->product_var[i];
+  }
+
+  if (b->pre_shift) opcode = "mulhsl";
+  t = cs_get_temp (b, cs_work_size (b));
+  cs_emit (b, opcode, t, in,
+      cs_get_value (b, cs_work_size (b), coef,
+        b->precision == ORC_COLOR_PRECISION_FLOAT), -1);
+  if (b->share_products && b->n_products < CS_MAX_PRODUCTS) {
+    b->product_in[b->n_products] = in;
+    b->product_coef[b->n_products] = coef;
+    b->product_var[b->n_products] = t;
+    b->n_products++;
+  }
+  return t;
+}
+
+/* Adds the terms of output o for the inputs in mask to partial, or to
+ * the bias if partial is -1.  Returns a new temporary. */
+static int
+cs_add_terms (CsBuilder *b, int o, const int in[3], int mask, int partial)
+{
+  static const char *add[] = { "addw", "addl", "addf" };
+  int acc;
+  int j;
+
+  acc = cs_get_temp (b, cs_work_size (b));
+  if (partial < 0) {
+    partial = cs_get_value (b, cs_work_size (b), b->bias[o],
+        b->precision == ORC_COLOR_PRECISION_FLOAT);
+  }
+  for (j = 0; j < 3; j++) {
+    int t;
+
+    if (!(mask & (1 << j)) || b->zero[o][j]) continue;
+    t = cs_product (b, in[j], b->coef[o][j]);
+    cs_emit (b, add[b->precision], acc, partial, t, -1);
+    if (!b->share_products) cs_release (b, t);
+    partial = acc;
+  }
+  if (partial != acc) {
+    cs_emit (b, b->precision == ORC_COLOR_PRECISION_FAST ? "copyw" : "copyl",
+        acc, partial, -1, -1);
+  }
+  return acc;
+}
+
+/* Scales acc back to integer samples and saturates them to the output
+ * depth, into dest if it is not -1.  Returns the sample. */
+static int
+cs_store_sample (CsBuilder *b, int acc, int depth, int dest)
+{
+  int bytes = depth > 8 ? 2 : 1;
+  int t;
+
+  if (dest < 0) dest = cs_get_temp (b, bytes);
+
+  if (b->precision == ORC_COLOR_PRECISION_FAST) {
+    cs_emit (b, "shrsw", acc, acc, cs_get_value (b, 2, 2, FALSE), -1);
+    cs_emit (b, "convsuswb", dest, acc, -1, -1);
+    cs_release (b, acc);
+    return dest;
+  }
+
+  if (b->precision == ORC_COLOR_PRECISION_FLOAT) {
+    cs_emit (b, "convfl", acc, acc, -1, -1);
+  } else {
+    cs_emit (b, "shrsl", acc, acc, cs_get_value (b, 4, b->shift, FALSE), -1);
+  }
+  if (depth == 16) {
+    cs_emit (b, "convsuslw", dest, acc, -1, -1);
+  } else {
+    t = cs_get_temp (b, 2);
+    cs_emit (b, "convsuslw", t, acc, -1, -1);
+    if (depth == 8) {
+      cs_emit (b, "convuuswb", dest, t, -1, -1);
+    } else {
+      cs_emit (b, "minuw", dest, t,
+          cs_get_value (b, 2, (1 << depth) - 1, FALSE), -1);
+    }
+    cs_release (b, t);
+  }
+  cs_release (b, acc);
+  return dest;
+}
+
+/* alpha of an output pixel, from the widened input alpha or opaque */
+static int
+cs_get_alpha (CsBuilder *b, const OrcColorFormatInfo *in, int alpha,
+    const OrcColorFormatInfo *out)
+{
+  int t, w;
+
+  if (alpha < 0) {
+    return cs_get_value (b, out->bytes, (1 << out->depth) - 1, FALSE);
+  }
+  if (in->bytes == 1 && out->bytes == 2) {
+    cs_emit (b, "mullw", alpha, alpha, cs_get_value (b, 2, 257, FALSE), -1);
+    return alpha;
+  }
+
+  t = cs_get_temp (b, out->bytes);
+  if (in->bytes == 1) {
+    cs_emit (b, "convwb", t, alpha, -1, -1);
+  } else if (out->bytes == 2) {
+    cs_emit (b, "convlw", t, alpha, -1, -1);
+  } else {
+    w = cs_get_temp (b, 2);
+    cs_emit (b, "convlw", w, alpha, -1, -1);
+    cs_emit (b, "convhwb", t, w, -1, -1);
+    cs_release (b, w);
+  }
+  cs_release (b, alpha);
+  return t;
+}
+
+/* Quantizes the matrix for the tier of the builder.  k is the number of
+ * samples summed for each input, outputs the mask of outputs computed.
+ * Returns FALSE if the coefficients don't fit. */
+static int
+cs_setup_matrix (CsBuilder *b, const double m[3][3], const double bias[3],
+    const int log2_k[3], int in_depth, int outputs)
+{
+  double max_in = (1 << in_depth) - 1;
+  double bound = 1;
+  int o, j;
+
+  for (o = 0; o < 3; o++) {
+    double sum = fabs (bias[o]);
+
+    for (j = 0; j < 3; j++) sum += fabs (m[o][j]) * max_in;
+    if (outputs & (1 << o)) bound = MAX (bound, sum);
+  }
+  b->shift = floor (log2 ((double)(1 << 30) / bound));
+  b->shift = MIN (b->shift, 24);
+  b->pre_shift = 0;
+  b->coef_shift = b->shift;
+
+  /* with mulll the coefficients of 16 bit inputs only get about 12 bits,
+   * the high half of a 64 bit product lets them use 31 */
+  if (b->precision == ORC_COLOR_PRECISION_EXACT && in_depth > 10) {
+    double max_c = 0;
+
+    for (o = 0; o < 3; o++) {
+      for (j = 0; j < 3; j++) max_c = MAX (max_c, fabs (m[o][j]));
+    }
+    b->pre_shift = 30 - in_depth - log2_k[0];
+    b->coef_shift = floor (log2 (2147483647.0 / max_c));
+    if (b->pre_shift + b->coef_shift - 32 > b->shift) {
+      b->coef_shift = b->shift + 32 - b->pre_shift;
+    }
+    b->shift = b->pre_shift + b->coef_shift - 32;
+  }
+
+  for (o = 0; o < 3; o++) {
+    int n_terms = 0;
+
+    for (j = 0; j < 3; j++) {
+      double c = m[o][j];
+      orc_union32 u;
+
+      b->zero[o][j] = (c == 0);
+      if (c == 0) continue;
+      n_terms++;
+
+      switch (b->precision) {
+        case ORC_COLOR_PRECISION_FAST:
+          b->coef[o][j] = lrint (c * 4096);
+          if (abs (b->coef[o][j]) > 32767) return FALSE;
+          break;
+        case ORC_COLOR_PRECISION_EXACT:
+          b->coef[o][j] = lrint (ldexp (c, b->coef_shift - log2_k[j]));
+          break;
+        default:
+          u.f = ldexp (c, -log2_k[j]);
+          b->coef[o][j] = u.i;
+          break;
+      }
+    }
+
+    switch (b->precision) {
+      case ORC_COLOR_PRECISION_FAST:
+        /* mulhsw rounds down, half a unit is lost per term on average;
+         * the sums have 2 fractional bits */
+        b->bias[o] = lrint (bias[o] * 4 + 2 + 0.5 * n_terms);
+        if ((outputs & (1 << o)) && bound * 4 + 2 > 32767) return FALSE;
+        break;
+      case ORC_COLOR_PRECISION_EXACT:
+        b->bias[o] = lrint (ldexp (bias[o], b->shift)) + (1 << (b->shift - 1));
+        break;
+      default:
+        {
+          orc_union32 u;
+
+          u.f = bias[o] + 0.5;
+          b->bias[o] = u.i;
+        }
+        break;
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+cs_add_arrays (CsBuilder *b, const OrcColorFormatInfo *f, int pixels,
+    int is_dest, int n_rows, int first_plane, int n_planes)
+{
+  char name[16];
+  int r, i;
+
+  for (r = 0; r < n_rows; r++) {
+    for (i = first_plane; i < first_plane + n_planes; i++) {
+      int size;
+
+      if (f->n_planes == 1) {
+        size = 4 * f->bytes * pixels;
+      } else if (f->is_yuv && i > 0) {
+        size = f->bytes;
+      } else {
+        size = f->bytes * pixels;
+      }
+      if (is_dest) {
+        sprintf (name, "d%d", b->program->n_dest_vars + 1);
+        orc_program_add_destination (b->program, size, name);
+      } else {
+        sprintf (name, "s%d", b->program->n_src_vars + 1);
+        orc_program_add_source (b->program, size, name);
+      }
+    }
+  }
+}
+
+/* One program from YUV: a row of pixels, two at a time for chroma
+ * subsampled formats, in which case the pair is computed with X2
+ * instructions and the chroma is repeated in both lanes.  Vertical
+ * subsampling is done by running the program twice. */
+static void
+cs_build_from_yuv (CsBuilder *b, const OrcColorFormatInfo *in,
+    const OrcColorFormatInfo *out)
+{
+  int n_pixels = 1 << in->h_shift;
+  int luma[3] = { -1, -1, -1 }, uv[3] = { -1, -1, -1 };
+  int partial[3];
+  int comp[4];
+  int half[2] = { -1, -1 };
+  int alpha = -1;
+  int o;
+
+  cs_add_arrays (b, out, n_pixels, TRUE, 1, 0, out->n_planes);
+  cs_add_arrays (b, in, n_pixels, FALSE, 1, 0, in->n_planes);
+
+  if (in->n_planes == 1) {
+    cs_fetch_packed (b, in, ORC_VAR_S1, 1, 1, comp);
+    for (o = 0; o < 3; o++) {
+      uv[o] = cs_convert_sum (b, comp[in->pos[o]], 0);
+    }
+    if (out->alpha >= 0) {
+      alpha = comp[in->alpha];
+    } else {
+      cs_release (b, comp[in->alpha]);
+    }
+  } else {
+    for (o = 1; o < 3; o++) {
+      uv[o] = cs_convert_sum (b,
+          cs_fetch_planar (b, in->bytes, ORC_VAR_S1 + o, 0, 1, 1), 0);
+    }
+  }
+
+  b->lanes = n_pixels;
+  if (in->n_planes == 1) {
+    luma[0] = uv[0];
+  } else {
+    luma[0] = cs_convert_sum (b,
+        cs_fetch_planar (b, in->bytes, ORC_VAR_S1, 0, 1, 1), 0);
+  }
+  if (n_pixels == 2) {
+    for (o = 1; o < 3; o++) {
+      int t = cs_get_temp (b, cs_work_size (b));
+
+      b->lanes = 1;
+      cs_emit (b, cs_work_size (b) == 2 ? "mergewl" : "mergelq", t, uv[o],
+          uv[o], -1);
+      b->lanes = 2;
+      cs_release (b, uv[o]);
+      uv[o] = t;
+    }
+  }
+
+  /* chroma is shared by the pixels */
+  for (o = 0; o < 3; o++) {
+    partial[o] = cs_add_terms (b, o, uv, 0x6, -1);
+  }
+  cs_clear_products (b);
+  cs_release (b, uv[1]);
+  cs_release (b, uv[2]);
+
+  if (out->n_planes == 1) {
+    comp[0] = comp[1] = comp[2] = comp[3] = -1;
+    cs_pack_component (b, out, ORC_VAR_D1, comp, half, out->alpha,
+        cs_get_alpha (b, in, alpha, out));
+  }
+
+  /* the luma term is usually the same for R, G and B */
+  b->share_products = TRUE;
+  for (o = 0; o < 3; o++) {
+    int sample;
+
+    sample = cs_store_sample (b, cs_add_terms (b, o, luma, 0x1, partial[o]),
+        out->depth, out->n_planes == 3 ? ORC_VAR_D1 + out->pos[o] : -1);
+    cs_release (b, partial[o]);
+    if (out->n_planes == 1) {
+      cs_pack_component (b, out, ORC_VAR_D1, comp, half, out->pos[o], sample);
+    }
+  }
+  b->share_products = FALSE;
+  cs_clear_products (b);
+  cs_release (b, luma[0]);
+  b->lanes = 1;
+}
+
+/* One program to YUV.  Each iteration reads n_rows rows of n_pixels
+ * pixels and writes the components selected by output; the chroma of
+ * subsampled formats is made from the sum of the pixels. */
+static void
+cs_build_from_rgb (CsBuilder *b, const OrcColorFormatInfo *in,
+    const OrcColorFormatInfo *out, int output, int log2_x, int log2_y)
+{
+  int n_pixels = 1 << log2_x;
+  int acc[3];
+  int rgb[3];
+  int partial[3] = { -1, -1, -1 };
+  int comp[4] = { -1, -1, -1, -1 };
+  int half[2] = { -1, -1 };
+  int outputs;
+  int alpha = -1;
+  int o, j;
+
+  switch (output) {
+    case CS_OUTPUT_YUV:
+      cs_add_arrays (b, out, 1, TRUE, 1, 0, out->n_planes);
+      break;
+    case CS_OUTPUT_Y:
+      cs_add_arrays (b, out, 1, TRUE, 1, 0, 1);
+      break;
+    default:
+      cs_add_arrays (b, out, 1, TRUE, 1, 1, 2);
+      break;
+  }
+  outputs = output == CS_OUTPUT_Y ? 0x1 : output == CS_OUTPUT_UV ? 0x6 : 0x7;
+  cs_add_arrays (b, in, n_pixels, FALSE, 1 << log2_y, 0, in->n_planes);
+
+  if (in->n_planes == 1) {
+    int px[4];
+
+    cs_fetch_packed (b, in, ORC_VAR_S1, 1 << log2_y, n_pixels, px);
+    for (j = 0; j < 3; j++) acc[j] = px[in->pos[j]];
+    if (output == CS_OUTPUT_YUV && out->alpha >= 0) {
+      alpha = px[in->alpha];
+    } else {
+      cs_release (b, px[in->alpha]);
+    }
+  }
+
+  /* an input at a time, so that planes are only loaded when they are
+   * needed and few values are live */
+  for (j = 0; j < 3; j++) {
+    if (in->n_planes == 3) {
+      acc[j] = cs_fetch_planar (b, in->bytes, ORC_VAR_S1 + in->pos[j],
+          in->n_planes, 1 << log2_y, n_pixels);
+    }
+    rgb[j] = cs_convert_sum (b, acc[j], log2_x + log2_y);
+    for (o = 0; o < 3; o++) {
+      int t;
+
+      if (!(outputs & (1 << o))) continue;
+      t = cs_add_terms (b, o, rgb, 1 << j, partial[o]);
+      cs_release (b, partial[o]);
+      partial[o] = t;
+    }
+    cs_release (b, rgb[j]);
+  }
+
+  if (output == CS_OUTPUT_YUV && out->n_planes == 1) {
+    cs_pack_component (b, out, ORC_VAR_D1, comp, half, out->alpha,
+        cs_get_alpha (b, in, alpha, out));
+  }
+
+  for (o = 0; o < 3; o++) {
+    int dest = -1;
+    int sample;
+
+    if (!(outputs & (1 << o))) continue;
+    if (output == CS_OUTPUT_UV) {
+      dest = ORC_VAR_D1 + o - 1;
+    } else if (out->n_planes == 3) {
+      dest = ORC_VAR_D1 + out->pos[o];
+    }
+    sample = cs_store_sample (b, partial[o], out->depth, dest);
+    if (output == CS_OUTPUT_YUV && out->n_planes == 1) {
+      cs_pack_component (b, out, ORC_VAR_D1, comp, half, out->pos[o], sample);
+    }
+  }
+}
+
+/* The matrix from input to output samples, for the depths of the formats.
+ * YUV components are Y, U, V and RGB components R, G, B. */
+static void
+cs_get_matrix (const OrcColorFormatInfo *in, const OrcColorFormatInfo *out,
+    OrcColorMatrix matrix, OrcColorRange range, double m[3][3],
+    double bias[3])
+{
+  static const double kr_kb[][2] = {
+    { 0.299, 0.114 }, { 0.2126, 0.0722 }, { 0.2627, 0.0593 }
+  };
+  const OrcColorFormatInfo *yuv = in->is_yuv ? in : out;
+  const OrcColorFormatInfo *rgb = in->is_yuv ? out : in;
+  double kr = kr_kb[matrix][0];
+  double kb = kr_kb[matrix][1];
+  double kg = 1 - kr - kb;
+  double rgb_max = (1 << rgb->depth) - 1;
+  double offset[3], scale[3];
+  int o, j;
+
+  if (range == ORC_COLOR_RANGE_LIMITED) {
+    offset[0] = ldexp (16, yuv->depth - 8);
+    scale[0] = ldexp (219, yuv->depth - 8);
+    scale[1] = scale[2] = ldexp (224, yuv->depth - 8);
+  } else {
+    offset[0] = 0;
+    scale[0] = scale[1] = scale[2] = (1 << yuv->depth) - 1;
+  }
+  offset[1] = offset[2] = 1 << (yuv->depth - 1);
+
+  if (in->is_yuv) {
+    const double a[3][3] = {
+      { 1, 0, 2 * (1 - kr) },
+      { 1, -2 * kb * (1 - kb) / kg, -2 * kr * (1 - kr) / kg },
+      { 1, 2 * (1 - kb), 0 }
+    };
+
+    for (o = 0; o < 3; o++) {
+      bias[o] = 0;
+      for (j = 0; j < 3; j++) {
+        m[o][j] = a[o][j] * rgb_max / scale[j];
+        bias[o] -= m[o][j] * offset[j];
+      }
+    }
+  } else {
+    const double a[3][3] = {
+      { kr, kg, kb },
+      { -kr / (2 * (1 - kb)), -kg / (2 * (1 - kb)), 0.5 },
+      { 0.5, -kg / (2 * (1 - kr)), -kb / (2 * (1 - kr)) }
+    };
+
+    for (o = 0; o < 3; o++) {
+      bias[o] = offset[o];
+      for (j = 0; j < 3; j++) {
+        m[o][j] = a[o][j] * scale[o] / rgb_max;
+      }
+    }
+  }
+}
+
+static OrcProgram *
+cs_build_program (CsBuilder *b, const OrcColorFormatInfo *in,
+    const OrcColorFormatInfo *out, const double m[3][3],
+    const double bias[3], int output)
+{
+  const OrcColorFormatInfo *yuv = in->is_yuv ? in : out;
+  int log2_k[3] = { 0, 0, 0 };
+  int log2_x = 0, log2_y = 0;
+  char name[64];
+
+  b->program = orc_program_new ();
+  b->error = FALSE;
+  b->n_insns = 0;
+  b->n_vars = 0;
+  b->lanes = 1;
+  memset (b->loaded, 0, sizeof (b->loaded));
+  b->n_temps = 0;
+  b->share_products = FALSE;
+  b->n_products = 0;
+
+  if (output == CS_OUTPUT_UV) {
+    log2_x = yuv->h_shift;
+    log2_y = yuv->v_shift;
+    log2_k[0] = log2_k[1] = log2_k[2] = log2_x + log2_y;
+  }
+
+  if (cs_setup_matrix (b, m, bias, log2_k, in->depth,
+          output == CS_OUTPUT_Y ? 0x1 : output == CS_OUTPUT_UV ? 0x6 : 0x7)) {
+    if (in->is_yuv) {
+      cs_build_from_yuv (b, in, out);
+    } else {
+      cs_build_from_rgb (b, in, out, output, log2_x, log2_y);
+    }
+  } else {
+    b->error = TRUE;
+  }
+
+  if (b->error || b->program->error_msg) {
+    ORC_INFO ("could not build %s to %s with precision %d: %d instructions, "
+        "%d variables", in->name, out->name, b->precision, b->n_insns,
+        b->n_vars);
+    orc_program_free (b->program);
+    return NULL;
+  }
+
+  sprintf (name, "color_%s_%s%s", in->name, out->name,
+      output == CS_OUTPUT_Y ? "_Y" : output == CS_OUTPUT_UV ? "_UV" : "");
+  orc_program_set_name (b->program, name);
+  orc_program_set_2d (b->program);
+  if (b->precision == ORC_COLOR_PRECISION_FLOAT) {
+    orc_program_set_fast_math (b->program);
+  }
+
+  return b->program;
+}
+
+static void
+cs_free_programs (OrcColorConverter *conv)
+{
+  int i;
+
+  for (i = 0; i < conv->n_programs; i++) {
+    orc_program_free (conv->programs[i]);
+  }
+  conv->n_programs = 0;
+}
+
+/* builds the programs of conv, with a luma and a chroma program if split
+ * is set */
+static int
+cs_build_programs (OrcColorConverter *conv, const OrcColorFormatInfo *in,
+    const OrcColorFormatInfo *out, const double m[3][3],
+    const double bias[3], OrcColorPrecision precision, int split)
+{
+  static const int outputs[2][2] = {
+    { CS_OUTPUT_YUV, -1 }, { CS_OUTPUT_Y, CS_OUTPUT_UV }
+  };
+  CsBuilder b;
+  int i;
+
+  memset (&b, 0, sizeof (b));
+  b.precision = precision;
+
+  conv->n_programs = 0;
+  for (i = 0; i < 2 && outputs[split][i] >= 0; i++) {
+    b.params = conv->params[i];
+    conv->programs[i] = cs_build_program (&b, in, out, m, bias,
+        outputs[split][i]);
+    if (conv->programs[i] == NULL) {
+      cs_free_programs (conv);
+      return FALSE;
+    }
+    conv->n_programs++;
+  }
+  return TRUE;
+}
+
+/* Returns FALSE if a program of conv will be emulated. */
+static int
+cs_compile_programs (OrcColorConverter *conv)
+{
+  int ret = TRUE;
+  int i;
+
+  for (i = 0; i < conv->n_programs; i++) {
+    OrcCompileResult result;
+
+    result = orc_program_compile (conv->programs[i]);
+    if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL (result)) {
+      ORC_INFO ("%s not compiled", conv->programs[i]->name);
+      ret = FALSE;
+    }
+  }
+  return ret;
+}
+
+/**
+ * orc_color_format_get_name:
+ * @format: an #OrcColorFormat
+ *
+ * Returns: the name of @format, for example "I420", or NULL
+ */
+const char *
+orc_color_format_get_name (OrcColorFormat format)
+{
+  if ((unsigned int)format >= ORC_COLOR_FORMAT_N_FORMATS) return NULL;
+  return formats[format].name;
+}
+
+/**
+ * orc_color_converter_new:
+ * @in_format: the format of the source images
+ * @out_format: the format of the destination images
+ * @matrix: the YUV matrix
+ * @range: the range of the YUV format
+ * @precision: the precision of the arithmetic
+ *
+ * Creates a converter from @in_format to @out_format and compiles its
+ * programs.  One of the formats has to be a YUV format and the other one
+ * an RGB format.  Converting between a chroma subsampled format and a
+ * packed 16 bit format is not supported.  #ORC_COLOR_PRECISION_FAST is
+ * only available when both formats have 8 bit components,
+ * #ORC_COLOR_PRECISION_EXACT is used otherwise.
+ *
+ * Returns: a new #OrcColorConverter, or NULL if the conversion is not
+ * supported
+ */
+OrcColorConverter *
+orc_color_converter_new (OrcColorFormat in_format, OrcColorFormat out_format,
+    OrcColorMatrix matrix, OrcColorRange range, OrcColorPrecision precision)
+{
+  const OrcColorFormatInfo *in, *out, *yuv, *rgb;
+  OrcColorConverter *conv;
+  double m[3][3], bias[3];
+  int must_split, can_split;
+  int pass, p, split;
+
+  if ((unsigned int)in_format >= ORC_COLOR_FORMAT_N_FORMATS ||
+      (unsigned int)out_format >= ORC_COLOR_FORMAT_N_FORMATS ||
+      (unsigned int)matrix > ORC_COLOR_MATRIX_BT2020 ||
+      (unsigned int)range > ORC_COLOR_RANGE_FULL ||
+      (unsigned int)precision > ORC_COLOR_PRECISION_FLOAT) {
+    return NULL;
+  }
+
+  in = formats + in_format;
+  out = formats + out_format;
+  if (in->is_yuv == out->is_yuv) return NULL;
+
+  /* a pair of 16 bit pixels doesn't fit in a variable */
+  yuv = in->is_yuv ? in : out;
+  rgb = in->is_yuv ? out : in;
+  if (yuv->h_shift && rgb->n_planes == 1 && rgb->bytes == 2) return NULL;
+
+  if (in->depth != 8 || out->depth != 8) {
+    precision = MAX (precision, ORC_COLOR_PRECISION_EXACT);
+  }
+
+  /* RGB to subsampled formats needs a program for luma and one for
+   * chroma, the planar formats can be done that way too */
+  must_split = !in->is_yuv && (yuv->h_shift || yuv->v_shift);
+  can_split = !in->is_yuv && out->n_planes == 3;
+
+  conv = malloc (sizeof (OrcColorConverter));
+  memset (conv, 0, sizeof (OrcColorConverter));
+  conv->in_format = in_format;
+  conv->out_format = out_format;
+
+  cs_get_matrix (in, out, matrix, range, m, bias);
+
+  /* Programs with many coefficients can need more registers than the
+   * target has.  Smaller programs and other precisions are tried before
+   * settling for emulation. */
+  for (pass = 0; pass < 2; pass++) {
+    for (p = precision; p <= ORC_COLOR_PRECISION_FLOAT; p++) {
+      for (split = must_split; split <= can_split; split++) {
+        if (!cs_build_programs (conv, in, out, m, bias, p, split)) continue;
+        if (cs_compile_programs (conv) || pass == 1) {
+          conv->precision = p;
+          return conv;
+        }
+        cs_free_programs (conv);
+      }
+    }
+  }
+
+  free (conv);
+  return NULL;
+}
+
+/**
+ * orc_color_converter_free:
+ * @conv: an #OrcColorConverter
+ *
+ * Frees @conv and its programs.
+ */
+void
+orc_color_converter_free (OrcColorConverter *conv)
+{
+  cs_free_programs (conv);
+  free (conv);
+}
+
+/**
+ * orc_color_converter_get_precision:
+ * @conv: an #OrcColorConverter
+ *
+ * Returns: the precision @conv converts with, which can be higher than
+ * the one requested
+ */
+OrcColorPrecision
+orc_color_converter_get_precision (OrcColorConverter *conv)
+{
+  return conv->precision;
+}
+
+/**
+ * orc_color_converter_get_n_programs:
+ * @conv: an #OrcColorConverter
+ *
+ * Conversions from RGB to chroma subsampled formats are done by a program
+ * writing the luma plane and a program writing the chroma planes, and so
+ * are conversions from RGB to other planar formats when a single program
+ * doesn't compile.  All other conversions are done by a single program.
+ *
+ * Returns: the number of programs of @conv
+ */
+int
+orc_color_converter_get_n_programs (OrcColorConverter *conv)
+{
+  return conv->n_programs;
+}
+
+/**
+ * orc_color_converter_get_program:
+ * @conv: an #OrcColorConverter
+ * @i: the index of the program
+ *
+ * The programs are 2D.  The destinations of a program are the planes it
+ * writes, in order.  Its sources are the planes it reads, one set per
+ * row for programs that combine rows.
+ *
+ * Returns: program @i of @conv, owned by @conv
+ */
+OrcProgram *
+orc_color_converter_get_program (OrcColorConverter *conv, int i)
+{
+  if (i < 0 || i >= conv->n_programs) return NULL;
+  return conv->programs[i];
+}
+
+/**
+ * orc_color_converter_get_param:
+ * @conv: an #OrcColorConverter
+ * @i: the index of the program
+ * @var: a parameter variable of the program
+ *
+ * Coefficients that don't fit in the constants of a program are passed
+ * as parameters.
+ *
+ * Returns: the value of parameter @var of program @i, as the bits of a
+ * float for float parameters
+ */
+int
+orc_color_converter_get_param (OrcColorConverter *conv, int i, int var)
+{
+  if (i < 0 || i >= conv->n_programs) return 0;
+  if (var < ORC_VAR_P1 || var >= ORC_VAR_P1 + ORC_MAX_PARAM_VARS) return 0;
+  return conv->params[i][var - ORC_VAR_P1];
+}
+
+static void
+cs_run (OrcColorConverter *conv, int i, void *dest[], const int dest_stride[],
+    void *src[], const int src_stride[], int n, int m)
+{
+  OrcProgram *p = conv->programs[i];
+  OrcExecutor _ex, *ex = &_ex;
+  int j;
+
+  memset (ex, 0, sizeof (OrcExecutor));
+  orc_executor_set_program (ex, p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_m (ex, m);
+  for (j = 0; j < p->n_dest_vars; j++) {
+    orc_executor_set_array (ex, ORC_VAR_D1 + j, dest[j]);
+    orc_executor_set_stride (ex, ORC_VAR_D1 + j, dest_stride[j]);
+  }
+  for (j = 0; j < p->n_src_vars; j++) {
+    orc_executor_set_array (ex, ORC_VAR_S1 + j, src[j]);
+    orc_executor_set_stride (ex, ORC_VAR_S1 + j, src_stride[j]);
+  }
+  for (j = 0; j < p->n_param_vars; j++) {
+    orc_executor_set_param (ex, ORC_VAR_P1 + j, conv->params[i][j]);
+  }
+  orc_executor_run (ex);
+}
+
+/**
+ * orc_color_converter_convert:
+ * @conv: an #OrcColorConverter
+ * @dest: the planes of the destination image
+ * @dest_stride: the strides of @dest, in bytes
+ * @src: the planes of the source image
+ * @src_stride: the strides of @src, in bytes
+ * @width: the width of the image
+ * @height: the height of the image
+ *
+ * Converts an image.  Packed formats only use the first plane.
+ *
+ * Returns: FALSE if the size of the image doesn't suit the chroma
+ * subsampling of the formats
+ */
+int
+orc_color_converter_convert (OrcColorConverter *conv, void *dest[],
+    const int dest_stride[], const void *src[], const int src_stride[],
+    int width, int height)
+{
+  const OrcColorFormatInfo *in = formats + conv->in_format;
+  const OrcColorFormatInfo *out = formats + conv->out_format;
+  const OrcColorFormatInfo *yuv = in->is_yuv ? in : out;
+  void *d[ORC_MAX_DEST_VARS];
+  void *s[ORC_MAX_SRC_VARS];
+  int ds[ORC_MAX_DEST_VARS];
+  int ss[ORC_MAX_SRC_VARS];
+  int rows = 1 << yuv->v_shift;
+  int r, i;
+
+  if (width < 0 || height < 0) return FALSE;
+  if ((width & ((1 << yuv->h_shift) - 1)) ||
+      (height & ((1 << yuv->v_shift) - 1))) {
+    return FALSE;
+  }
+  if (width == 0 || height == 0) return TRUE;
+
+  if (in->is_yuv) {
+    /* even rows, then odd rows with the same chroma */
+    for (r = 0; r < rows; r++) {
+      for (i = 0; i < out->n_planes; i++) {
+        d[i] = (orc_uint8 *)dest[i] + r * dest_stride[i];
+        ds[i] = dest_stride[i] * rows;
+      }
+      for (i = 0; i < in->n_planes; i++) {
+        s[i] = (orc_uint8 *)src[i] + (i == 0 ? r * src_stride[i] : 0);
+        ss[i] = i == 0 ? src_stride[i] * rows : src_stride[i];
+      }
+      cs_run (conv, 0, d, ds, s, ss, width >> yuv->h_shift, height / rows);
+    }
+    return TRUE;
+  }
+
+  for (i = 0; i < in->n_planes; i++) {
+    s[i] = (void *)src[i];
+    ss[i] = src_stride[i];
+  }
+  if (conv->n_programs == 1) {
+    cs_run (conv, 0, dest, dest_stride, s, ss, width, height);
+    return TRUE;
+  }
+
+  cs_run (conv, 0, dest, dest_stride, s, ss, width, height);
+
+  for (r = 0; r < rows; r++) {
+    for (i = 0; i < in->n_planes; i++) {
+      s[r * in->n_planes + i] = (orc_uint8 *)src[i] + r * src_stride[i];
+      ss[r * in->n_planes + i] = src_stride[i] * rows;
+    }
+  }
+  cs_run (conv, 1, dest + 1, dest_stride + 1, s, ss, width >> yuv->h_shift,
+      height / rows);
+
+  return TRUE;
+}
@@ -0,0 +1,83 @@
+
+#ifndef _ORC_COLORSPACE_H_
+#define _ORC_COLORSPACE_H_
+
+#include <orc/orcutils.h>
+#include <orc/orcprogram.h>
+
+ORC_BEGIN_DECLS
+
+/**
+ * OrcColorFormat:
+ *
+ * Pixel layouts handled by #OrcColorConverter.  Packed formats are named
+ * after the order of the components in memory, 16 bit components are in
+ * host byte order and 10 bit components are stored in the low bits of
+ * 16 bit words.  Planar YUV formats have the planes in Y, U, V order,
+ * planar RGB formats in G, B, R order.
+ */
+typedef enum {
+  ORC_COLOR_FORMAT_AYUV,
+  ORC_COLOR_FORMAT_AYUV64,
+  ORC_COLOR_FORMAT_Y444,
+  ORC_COLOR_FORMAT_Y42B,
+  ORC_COLOR_FORMAT_I420,
+  ORC_COLOR_FORMAT_Y444_10,
+  ORC_COLOR_FORMAT_I422_10,
+  ORC_COLOR_FORMAT_I420_10,
+  ORC_COLOR_FORMAT_Y444_16,
+  ORC_COLOR_FORMAT_ARGB,
+  ORC_COLOR_FORMAT_BGRA,
+  ORC_COLOR_FORMAT_RGBA,
+  ORC_COLOR_FORMAT_ABGR,
+  ORC_COLOR_FORMAT_ARGB64,
+  ORC_COLOR_FORMAT_GBR,
+  ORC_COLOR_FORMAT_GBR_10,
+  ORC_COLOR_FORMAT_GBR_16,
+  ORC_COLOR_FORMAT_N_FORMATS
+} OrcColorFormat;
+
+typedef enum {
+  ORC_COLOR_MATRIX_BT601,
+  ORC_COLOR_MATRIX_BT709,
+  ORC_COLOR_MATRIX_BT2020
+} OrcColorMatrix;
+
+typedef enum {
+  ORC_COLOR_RANGE_LIMITED,
+  ORC_COLOR_RANGE_FULL
+} OrcColorRange;
+
+/**
+ * OrcColorPrecision:
+ * @ORC_COLOR_PRECISION_FAST: 16 bit arithmetic with 12 bit coefficients,
+ *   for 8 bit formats only
+ * @ORC_COLOR_PRECISION_EXACT: 32 bit fixed point arithmetic
+ * @ORC_COLOR_PRECISION_FLOAT: single precision floating point
+ */
+typedef enum {
+  ORC_COLOR_PRECISION_FAST,
+  ORC_COLOR_PRECISION_EXACT,
+  ORC_COLOR_PRECISION_FLOAT
+} OrcColorPrecision;
+
+typedef struct _OrcColorConverter OrcColorConverter;
+
+ORC_API const char * orc_color_format_get_name (OrcColorFormat format);
+
+ORC_API OrcColorConverter * orc_color_converter_new (OrcColorFormat in_format,
+    OrcColorFormat out_format, OrcColorMatrix matrix, OrcColorRange range,
+    OrcColorPrecision precision);
+ORC_API void orc_color_converter_free (OrcColorConverter *conv);
+ORC_API OrcColorPrecision orc_color_converter_get_precision (OrcColorConverter *conv);
+ORC_API int orc_color_converter_get_n_programs (OrcColorConverter *conv);
+ORC_API OrcProgram * orc_color_converter_get_program (OrcColorConverter *conv, int i);
+ORC_API int orc_color_converter_get_param (OrcColorConverter *conv, int i, int var);
+ORC_API int orc_color_converter_convert (OrcColorConverter *conv,
+    void *dest[], const int dest_stride[], const void *src[],
+    const int src_stride[], int width, int height);
+
+ORC_END_DECLS
+
+#endif
+
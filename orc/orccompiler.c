@@ -101,8 +101,11 @@ typedef struct {
 static void orc_compiler_assign_rules (OrcCompiler *compiler);
 static void orc_compiler_global_reg_alloc (OrcCompiler *compiler);
 static void orc_compiler_rewrite_insns (OrcCompiler *compiler);
+static void orc_compiler_narrow_widths (OrcCompiler *compiler);
+static void orc_compiler_contract_fma (OrcCompiler *compiler);
 static void orc_compiler_rewrite_vars (OrcCompiler *compiler);
 static void orc_compiler_rewrite_vars2 (OrcCompiler *compiler);
+static void orc_compiler_hoist_invariants (OrcCompiler *compiler);
 static int orc_compiler_dup_temporary (OrcCompiler *compiler, int var, int j);
 static int orc_compiler_new_temporary (OrcCompiler *compiler, int size);
 static void orc_compiler_check_sizes (OrcCompiler *compiler);
@@ -151,6 +154,10 @@ _orc_compiler_init (void)
   _orc_compiler_flag_debug = orc_compiler_flag_check ("debug");
   _orc_compiler_flag_randomize = orc_compiler_flag_check ("randomize");
 
+  if (orc_compiler_flag_check ("stats")) {
+    atexit (orc_stats_dump);
+  }
+
 #ifdef HAVE_CODEMEM_VIRTUALALLOC
   GetNativeSystemInfo(&info);
   page_size = info.dwPageSize;
@@ -309,12 +316,51 @@ _set_virtual_protect (void * mem, size_t size, int code_protect)
 }
 #endif
 
+/* Whether code compiled with these flags can be shared with identical
+ * programs and compiled in tiers.  Code that isn't executed here, code
+ * whose assembly is compared against a reference and code compiled under
+ * debugging flags stays with its program and is optimised right away. */
+static orc_bool
+orc_compiler_can_share_code (OrcTarget *target, unsigned int flags)
+{
+  if (target == NULL || !target->executable) return FALSE;
+  if (flags & (ORC_TARGET_PRIVATE_CODE | ORC_TARGET_CLEAN_COMPILE))
+    return FALSE;
+  if (_orc_compiler_flag_backup || _orc_compiler_flag_emulate ||
+      _orc_compiler_flag_debug || _orc_compiler_flag_randomize)
+    return FALSE;
+  return !orc_compiler_flag_check ("-share");
+}
+
+/* The relaxation runs as part of the emission, its time is moved from one
+ * phase to the other */
+static void
+orc_compiler_merge_stats (OrcCompiler *compiler, OrcStats *stats)
+{
+  stats->n_programs = 1;
+  stats->n_insns = compiler->n_insns;
+  stats->n_machine_insns = compiler->n_output_insns;
+  if (compiler->n_relaxation_iterations > 0) {
+    stats->time[ORC_STATS_PHASE_RELAXATION] = compiler->relaxation_time;
+    stats->count[ORC_STATS_PHASE_RELAXATION] = 1;
+    stats->n_relaxation_iterations = compiler->n_relaxation_iterations;
+    if (stats->time[ORC_STATS_PHASE_EMIT] >= compiler->relaxation_time) {
+      stats->time[ORC_STATS_PHASE_EMIT] -= compiler->relaxation_time;
+    }
+  }
+  orc_stats_merge (stats);
+}
+
 OrcCompileResult
 orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTarget *target, unsigned int flags)
 {
   int i;
   OrcCompileResult result;
   const char *error_msg;
+  orc_bool share;
+  orc_bool tier;
+  OrcStats stats;
+  orc_uint64 start;
 
   ORC_INFO("initializing compiler for program \"%s\"", program->name);
   error_msg = orc_program_get_error (program);
@@ -343,6 +389,29 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   compiler->program = program;
   compiler->target = target;
   compiler->target_flags = flags;
+  if (program->is_fast_math) {
+    compiler->target_flags |= ORC_TARGET_FAST_MATH;
+  }
+
+  share = orc_compiler_can_share_code (target, compiler->target_flags);
+  tier = share && !(compiler->target_flags & ORC_TARGET_BASELINE) &&
+      !orc_compiler_flag_check ("-tier");
+  if (tier) {
+    compiler->target_flags |= ORC_TARGET_BASELINE;
+  }
+  if (share) {
+    OrcCode *code = orc_code_lookup_shared (program, target,
+        compiler->target_flags);
+
+    if (code) {
+      ORC_INFO ("program \"%s\" shares the code of an identical program",
+          program->name);
+      program->orccode = code;
+      program->code_exec = code->exec;
+      free (compiler);
+      return code->result;
+    }
+  }
 
   {
     ORC_LOG("Program variables");
@@ -368,6 +437,9 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
     }
   }
 
+  memset (&stats, 0, sizeof(OrcStats));
+  start = orc_stats_get_time ();
+
   memcpy (compiler->insns, program->insns,
       program->n_insns * sizeof(OrcInstruction));
   compiler->n_insns = program->n_insns;
@@ -393,9 +465,19 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   orc_compiler_rewrite_insns (compiler);
   if (compiler->error) goto error;
 
+  if (!(compiler->target_flags &
+          (ORC_TARGET_BASELINE | ORC_TARGET_NO_NARROW)) &&
+      !orc_compiler_flag_check ("-narrow"))
+    orc_compiler_narrow_widths (compiler);
+
+  if (compiler->target_flags & ORC_TARGET_FAST_MATH)
+    orc_compiler_contract_fma (compiler);
+
   orc_compiler_rewrite_vars (compiler);
   if (compiler->error) goto error;
 
+  orc_stats_add_time (&stats, ORC_STATS_PHASE_REWRITE, start);
+
   {
     ORC_LOG("Compiler variables");
     for(i=0;i<ORC_N_VARIABLES;i++){
@@ -424,6 +506,7 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   program->orccode = orc_code_new ();
 
   program->orccode->is_2d = program->is_2d;
+  program->orccode->target_name = target ? target->name : NULL;
   program->orccode->constant_n = program->constant_n;
   program->orccode->constant_m = program->constant_m;
   program->orccode->exec = program->code_exec;
@@ -456,6 +539,7 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
     goto error;
   }
 
+  start = orc_stats_get_time ();
   if (compiler->target) {
     orc_compiler_global_reg_alloc (compiler);
 
@@ -466,6 +550,8 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   orc_compiler_assign_rules (compiler);
   if (compiler->error) goto error;
 
+  orc_stats_add_time (&stats, ORC_STATS_PHASE_REGISTER_ALLOCATION, start);
+
   ORC_INFO("allocating code memory");
   compiler->code = malloc(65536);
   compiler->codeptr = compiler->code;
@@ -473,11 +559,14 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   if (compiler->error) goto error;
 
   ORC_INFO("compiling for target \"%s\"", compiler->target->name);
+  start = orc_stats_get_time ();
   compiler->target->compile (compiler);
   if (compiler->error) {
     compiler->result = ORC_COMPILE_RESULT_UNKNOWN_COMPILE;
     goto error;
   }
+  orc_stats_add_time (&stats, ORC_STATS_PHASE_EMIT, start);
+  stats.n_code_bytes = compiler->codeptr - compiler->code;
 
 #if defined(_WIN64) && defined(ORC_SUPPORTS_BACKTRACE_FROM_JIT)
   OrcUnwindInfo table;
@@ -646,9 +735,20 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
    program->orccode->exec = (void *)orc_executor_emulate;
 #endif
   program->code_exec = program->orccode->exec;
+  program->orccode->result = compiler->result;
 
   program->asm_code = compiler->asm_code;
 
+  if (share && program->code_exec != (void *)orc_executor_emulate) {
+    if (tier) {
+      orc_code_start_tiering (program->orccode, program, target,
+          compiler->target_flags & ~ORC_TARGET_BASELINE);
+      program->code_exec = program->orccode->exec;
+    }
+    orc_code_add_shared (program->orccode, program, target,
+        compiler->target_flags);
+  }
+
   result = compiler->result;
   for (i=0;i<compiler->n_dup_vars;i++){
     free(compiler->vars[ORC_VAR_T1 + compiler->n_temp_vars + i].name);
@@ -656,6 +756,7 @@ orc_compiler_compile_program (OrcCompiler *compiler, OrcProgram *program, OrcTar
   }
   free (compiler->code);
   compiler->code = NULL;
+  orc_compiler_merge_stats (compiler, &stats);
   if (compiler->output_insns) free (compiler->output_insns);
   free (compiler);
   ORC_INFO("finished compiling (success)");
@@ -686,6 +787,7 @@ error:
   }
   free (compiler->code);
   compiler->code = NULL;
+  orc_compiler_merge_stats (compiler, &stats);
   if (compiler->output_insns) free (compiler->output_insns);
   free (compiler);
   ORC_INFO("finished compiling (fail)");
@@ -720,6 +822,8 @@ orc_compiler_check_sizes (OrcCompiler *compiler)
         compiler->result = ORC_COMPILE_RESULT_UNKNOWN_PARSE;
         return;
       }
+      /* only the low lane of a CRC accumulator is used */
+      if (opcode->flags & ORC_STATIC_OPCODE_CRC) continue;
       max_size = MAX(max_size, multiplier * opcode->dest_size[j]);
     }
     for(j=0;j<ORC_STATIC_OPCODE_N_SRC;j++){
@@ -742,6 +846,7 @@ orc_compiler_check_sizes (OrcCompiler *compiler)
         compiler->result = ORC_COMPILE_RESULT_UNKNOWN_PARSE;
         return;
       }
+      if (opcode->flags & ORC_STATIC_OPCODE_TABLE && j >= 1) continue;
       max_size = MAX(max_size, multiplier * opcode->src_size[j]);
     }
     if (opcode->flags & ORC_STATIC_OPCODE_SCALAR &&
@@ -811,6 +916,18 @@ get_store_opcode_for_size (int size)
   return NULL;
 }
 
+/* loads and stores are added to the instructions of the program, which
+ * can make them overflow */
+static OrcInstruction *
+orc_compiler_add_insn (OrcCompiler *compiler)
+{
+  if (compiler->n_insns >= ORC_N_INSNS) {
+    ORC_COMPILER_ERROR (compiler, "too many instructions");
+    return NULL;
+  }
+  return compiler->insns + compiler->n_insns++;
+}
+
 static void
 orc_compiler_rewrite_insns (OrcCompiler *compiler)
 {
@@ -835,6 +952,7 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
         var = compiler->vars + insn.src_args[i];
 
         if (i > 0 && (opcode->flags & ORC_STATIC_OPCODE_SCALAR) &&
+            !(opcode->flags & ORC_STATIC_OPCODE_TABLE) &&
             (!compiler->load_params || var->vartype != ORC_VAR_TYPE_PARAM))
           continue;
 
@@ -842,8 +960,8 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
             var->vartype == ORC_VAR_TYPE_DEST) {
           OrcInstruction *cinsn;
 
-          cinsn = compiler->insns + compiler->n_insns;
-          compiler->n_insns++;
+          cinsn = orc_compiler_add_insn (compiler);
+          if (cinsn == NULL) return;
 
           cinsn->flags = insn.flags;
           cinsn->flags |= ORC_INSN_FLAG_ADDED;
@@ -879,8 +997,8 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
             insn.src_args[i] = loaded;
             continue;
           }
-          cinsn = compiler->insns + compiler->n_insns;
-          compiler->n_insns++;
+          cinsn = orc_compiler_add_insn (compiler);
+          if (cinsn == NULL) return;
 
           cinsn->flags = insn.flags;
           cinsn->flags |= ORC_INSN_FLAG_ADDED;
@@ -899,9 +1017,9 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
       }
     }
 
-    xinsn = compiler->insns + compiler->n_insns;
+    xinsn = orc_compiler_add_insn (compiler);
+    if (xinsn == NULL) return;
     memcpy (xinsn, &insn, sizeof(OrcInstruction));
-    compiler->n_insns++;
 
     if (!(opcode->flags & ORC_STATIC_OPCODE_STORE)) {
       for(i=0;i<ORC_STATIC_OPCODE_N_DEST;i++){
@@ -913,8 +1031,8 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
         if (var->vartype == ORC_VAR_TYPE_DEST) {
           OrcInstruction *cinsn;
 
-          cinsn = compiler->insns + compiler->n_insns;
-          compiler->n_insns++;
+          cinsn = orc_compiler_add_insn (compiler);
+          if (cinsn == NULL) return;
 
           cinsn->flags = xinsn->flags;
           cinsn->flags |= ORC_INSN_FLAG_ADDED;
@@ -930,6 +1048,746 @@ orc_compiler_rewrite_insns (OrcCompiler *compiler)
   }
 }
 
+/* Value-range narrowing
+ *
+ * Programs often widen to the next element size only to narrow again
+ * at the end, e.g. mulswl followed by convlw.  The low bits of an add,
+ * sub, mul or logic op only depend on the low bits of its operands, so
+ * such a chain can be computed at the narrow size directly whenever the
+ * final conversion is a truncation, or a saturation that provably never
+ * clamps.  A forward pass computes a value range for every temporary
+ * from the element sizes, constants and opcode semantics, and the
+ * rewrites below use it. */
+
+typedef struct _OrcRange OrcRange;
+struct _OrcRange {
+  int known;
+  orc_int64 min;
+  orc_int64 max;
+};
+
+enum {
+  ORC_NARROW_NONE,
+  ORC_NARROW_COPY,
+  ORC_NARROW_LOADP,
+  ORC_NARROW_CONVS,
+  ORC_NARROW_CONVU,
+  ORC_NARROW_TRUNC,
+  ORC_NARROW_SAT_SS,
+  ORC_NARROW_SAT_SU,
+  ORC_NARROW_SAT_US,
+  ORC_NARROW_SAT_UU,
+  ORC_NARROW_MULS,
+  ORC_NARROW_MULU,
+  ORC_NARROW_MULL,
+  ORC_NARROW_ADD,
+  ORC_NARROW_SUB,
+  ORC_NARROW_AND,
+  ORC_NARROW_LOGIC,
+  ORC_NARROW_SHRS,
+  ORC_NARROW_SHRU
+};
+
+static const struct {
+  const char *name;
+  int kind;
+  /* same operation at half the element size, if any */
+  const char *narrow;
+} orc_narrow_opcodes[] = {
+  { "copyb", ORC_NARROW_COPY, NULL },
+  { "copyw", ORC_NARROW_COPY, NULL },
+  { "copyl", ORC_NARROW_COPY, NULL },
+  { "loadpb", ORC_NARROW_LOADP, NULL },
+  { "loadpw", ORC_NARROW_LOADP, NULL },
+  { "loadpl", ORC_NARROW_LOADP, NULL },
+  { "convsbw", ORC_NARROW_CONVS, NULL },
+  { "convswl", ORC_NARROW_CONVS, NULL },
+  { "convubw", ORC_NARROW_CONVU, NULL },
+  { "convuwl", ORC_NARROW_CONVU, NULL },
+  { "convwb", ORC_NARROW_TRUNC, NULL },
+  { "convlw", ORC_NARROW_TRUNC, NULL },
+  { "convssswb", ORC_NARROW_SAT_SS, NULL },
+  { "convssslw", ORC_NARROW_SAT_SS, NULL },
+  { "convsuswb", ORC_NARROW_SAT_SU, NULL },
+  { "convsuslw", ORC_NARROW_SAT_SU, NULL },
+  { "convusswb", ORC_NARROW_SAT_US, NULL },
+  { "convusslw", ORC_NARROW_SAT_US, NULL },
+  { "convuuswb", ORC_NARROW_SAT_UU, NULL },
+  { "convuuslw", ORC_NARROW_SAT_UU, NULL },
+  { "mulsbw", ORC_NARROW_MULS, "mullb" },
+  { "mulswl", ORC_NARROW_MULS, "mullw" },
+  { "mulubw", ORC_NARROW_MULU, "mullb" },
+  { "muluwl", ORC_NARROW_MULU, "mullw" },
+  { "mullb", ORC_NARROW_MULL, NULL },
+  { "mullw", ORC_NARROW_MULL, "mullb" },
+  { "mulll", ORC_NARROW_MULL, "mullw" },
+  { "addb", ORC_NARROW_ADD, NULL },
+  { "addw", ORC_NARROW_ADD, "addb" },
+  { "addl", ORC_NARROW_ADD, "addw" },
+  { "subb", ORC_NARROW_SUB, NULL },
+  { "subw", ORC_NARROW_SUB, "subb" },
+  { "subl", ORC_NARROW_SUB, "subw" },
+  { "andb", ORC_NARROW_AND, NULL },
+  { "andw", ORC_NARROW_AND, "andb" },
+  { "andl", ORC_NARROW_AND, "andw" },
+  { "orw", ORC_NARROW_LOGIC, "orb" },
+  { "orl", ORC_NARROW_LOGIC, "orw" },
+  { "xorw", ORC_NARROW_LOGIC, "xorb" },
+  { "xorl", ORC_NARROW_LOGIC, "xorw" },
+  { "shrsb", ORC_NARROW_SHRS, NULL },
+  { "shrsw", ORC_NARROW_SHRS, "shrsb" },
+  { "shrsl", ORC_NARROW_SHRS, "shrsw" },
+  { "shrub", ORC_NARROW_SHRU, NULL },
+  { "shruw", ORC_NARROW_SHRU, "shrub" },
+  { "shrul", ORC_NARROW_SHRU, "shruw" },
+  { NULL, ORC_NARROW_NONE, NULL }
+};
+
+static int
+orc_narrow_lookup (OrcStaticOpcode *opcode)
+{
+  int i;
+
+  for (i = 0; orc_narrow_opcodes[i].name; i++) {
+    if (strcmp (orc_narrow_opcodes[i].name, opcode->name) == 0)
+      return i;
+  }
+  return -1;
+}
+
+static int
+orc_narrow_kind (OrcInstruction *insn)
+{
+  int i;
+
+  if (insn->opcode == NULL) return ORC_NARROW_NONE;
+  i = orc_narrow_lookup (insn->opcode);
+  return (i < 0) ? ORC_NARROW_NONE : orc_narrow_opcodes[i].kind;
+}
+
+static orc_int64
+orc_range_smin (int size)
+{
+  return -((orc_int64)1 << (size * 8 - 1));
+}
+
+static orc_int64
+orc_range_smax (int size)
+{
+  return ((orc_int64)1 << (size * 8 - 1)) - 1;
+}
+
+static orc_int64
+orc_range_umax (int size)
+{
+  return ((orc_int64)1 << (size * 8)) - 1;
+}
+
+static OrcRange
+orc_range_make (int size, orc_int64 min, orc_int64 max)
+{
+  OrcRange r = { FALSE, 0, 0 };
+
+  if (size > 4) return r;
+  if (min < orc_range_smin (size) || max > orc_range_umax (size)) return r;
+  if (min < 0 && max > orc_range_smax (size)) return r;
+
+  r.known = TRUE;
+  r.min = min;
+  r.max = max;
+  return r;
+}
+
+/* The range of the element read as a signed value. */
+static void
+orc_range_signed (OrcRange r, int size, orc_int64 *min, orc_int64 *max)
+{
+  if (r.known && r.max <= orc_range_smax (size)) {
+    *min = r.min;
+    *max = r.max;
+  } else {
+    *min = orc_range_smin (size);
+    *max = orc_range_smax (size);
+  }
+}
+
+/* The range of the element read as an unsigned value. */
+static void
+orc_range_unsigned (OrcRange r, int size, orc_int64 *min, orc_int64 *max)
+{
+  if (r.known && r.min >= 0) {
+    *min = r.min;
+    *max = r.max;
+  } else {
+    *min = 0;
+    *max = orc_range_umax (size);
+  }
+}
+
+static orc_int64
+orc_range_clamp (orc_int64 x, orc_int64 min, orc_int64 max)
+{
+  return ORC_CLAMP (x, min, max);
+}
+
+static OrcRange
+orc_range_of_var (OrcCompiler *compiler, OrcRange *ranges, int var, int size)
+{
+  OrcVariable *v = compiler->vars + var;
+  OrcRange r = { FALSE, 0, 0 };
+
+  if (size > 4) return r;
+
+  if (v->vartype == ORC_VAR_TYPE_CONST) {
+    orc_int64 x = v->value.i;
+    int shift = 64 - size * 8;
+
+    /* sign-extend the low bits of the constant */
+    x = (orc_int64)((orc_uint64)x << shift) >> shift;
+    return orc_range_make (size, x, x);
+  }
+  if (v->vartype == ORC_VAR_TYPE_TEMP) {
+    return ranges[var];
+  }
+  return r;
+}
+
+/* The range of the unsigned product of @a and @b, unknown when it does
+ * not fit the destination. */
+static OrcRange
+orc_range_mul_unsigned (OrcRange a, OrcRange b, int ssize, int dsize)
+{
+  OrcRange r = { FALSE, 0, 0 };
+  orc_int64 amin, amax, bmin, bmax;
+
+  orc_range_unsigned (a, ssize, &amin, &amax);
+  orc_range_unsigned (b, ssize, &bmin, &bmax);
+  /* without forming the product, which overflows for 32-bit values */
+  if (amax > 0 && bmax > orc_range_umax (dsize) / amax)
+    return r;
+  return orc_range_make (dsize, amin * bmin, amax * bmax);
+}
+
+static int
+orc_range_shift_amount (OrcCompiler *compiler, OrcInstruction *insn, int size)
+{
+  OrcVariable *v = compiler->vars + insn->src_args[1];
+
+  if (v->vartype != ORC_VAR_TYPE_CONST) return -1;
+  if (v->value.i < 0 || v->value.i >= size * 8) return -1;
+  return (int) v->value.i;
+}
+
+static OrcRange
+orc_range_of_insn (OrcCompiler *compiler, OrcRange *ranges, OrcInstruction *insn)
+{
+  OrcStaticOpcode *opcode = insn->opcode;
+  int dsize = opcode->dest_size[0];
+  int ssize = opcode->src_size[0];
+  OrcRange r = { FALSE, 0, 0 };
+  OrcRange a;
+  OrcRange b;
+  orc_int64 amin, amax, bmin, bmax;
+  orc_int64 p[4];
+  int shift;
+  int i;
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4))
+    return r;
+
+  a = orc_range_of_var (compiler, ranges, insn->src_args[0], ssize);
+  if (opcode->src_size[1]) {
+    b = orc_range_of_var (compiler, ranges, insn->src_args[1],
+        opcode->src_size[1]);
+  } else {
+    b = r;
+  }
+
+  switch (orc_narrow_kind (insn)) {
+    case ORC_NARROW_COPY:
+      return a;
+    case ORC_NARROW_LOADP:
+      if (compiler->vars[insn->src_args[0]].vartype != ORC_VAR_TYPE_CONST)
+        return r;
+      return orc_range_of_var (compiler, ranges, insn->src_args[0], dsize);
+    case ORC_NARROW_CONVS:
+      orc_range_signed (a, ssize, &amin, &amax);
+      return orc_range_make (dsize, amin, amax);
+    case ORC_NARROW_CONVU:
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      return orc_range_make (dsize, amin, amax);
+    case ORC_NARROW_TRUNC:
+      orc_range_signed (a, ssize, &amin, &amax);
+      if (amin >= orc_range_smin (dsize) && amax <= orc_range_smax (dsize))
+        return orc_range_make (dsize, amin, amax);
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      return orc_range_make (dsize, amin, amax);
+    case ORC_NARROW_SAT_SS:
+      orc_range_signed (a, ssize, &amin, &amax);
+      return orc_range_make (dsize,
+          orc_range_clamp (amin, orc_range_smin (dsize), orc_range_smax (dsize)),
+          orc_range_clamp (amax, orc_range_smin (dsize), orc_range_smax (dsize)));
+    case ORC_NARROW_SAT_SU:
+      orc_range_signed (a, ssize, &amin, &amax);
+      return orc_range_make (dsize,
+          orc_range_clamp (amin, 0, orc_range_umax (dsize)),
+          orc_range_clamp (amax, 0, orc_range_umax (dsize)));
+    case ORC_NARROW_SAT_US:
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      return orc_range_make (dsize,
+          orc_range_clamp (amin, 0, orc_range_smax (dsize)),
+          orc_range_clamp (amax, 0, orc_range_smax (dsize)));
+    case ORC_NARROW_SAT_UU:
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      return orc_range_make (dsize,
+          orc_range_clamp (amin, 0, orc_range_umax (dsize)),
+          orc_range_clamp (amax, 0, orc_range_umax (dsize)));
+    case ORC_NARROW_MULS:
+    case ORC_NARROW_MULL:
+      /* signed products of 32-bit values fit in 63 bits */
+      orc_range_signed (a, ssize, &amin, &amax);
+      orc_range_signed (b, ssize, &bmin, &bmax);
+      p[0] = amin * bmin;
+      p[1] = amin * bmax;
+      p[2] = amax * bmin;
+      p[3] = amax * bmax;
+      amin = amax = p[0];
+      for (i = 1; i < 4; i++) {
+        amin = MIN (amin, p[i]);
+        amax = MAX (amax, p[i]);
+      }
+      r = orc_range_make (dsize, amin, amax);
+      if (r.known || orc_narrow_kind (insn) == ORC_NARROW_MULS)
+        return r;
+      /* the low bits are the unsigned product if that fits */
+      return orc_range_mul_unsigned (a, b, ssize, dsize);
+    case ORC_NARROW_MULU:
+      return orc_range_mul_unsigned (a, b, ssize, dsize);
+    case ORC_NARROW_ADD:
+      orc_range_signed (a, ssize, &amin, &amax);
+      orc_range_signed (b, ssize, &bmin, &bmax);
+      r = orc_range_make (dsize, amin + bmin, amax + bmax);
+      if (r.known) return r;
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      orc_range_unsigned (b, ssize, &bmin, &bmax);
+      return orc_range_make (dsize, amin + bmin, amax + bmax);
+    case ORC_NARROW_SUB:
+      orc_range_signed (a, ssize, &amin, &amax);
+      orc_range_signed (b, ssize, &bmin, &bmax);
+      return orc_range_make (dsize, amin - bmax, amax - bmin);
+    case ORC_NARROW_AND:
+      /* a non-negative operand bounds the result */
+      if (a.known && a.min >= 0) r = orc_range_make (dsize, 0, a.max);
+      if (b.known && b.min >= 0 && (!r.known || b.max < r.max))
+        r = orc_range_make (dsize, 0, b.max);
+      return r;
+    case ORC_NARROW_SHRS:
+      shift = orc_range_shift_amount (compiler, insn, ssize);
+      if (shift < 0) return r;
+      orc_range_signed (a, ssize, &amin, &amax);
+      return orc_range_make (dsize, amin >> shift, amax >> shift);
+    case ORC_NARROW_SHRU:
+      shift = orc_range_shift_amount (compiler, insn, ssize);
+      if (shift < 0) return r;
+      orc_range_unsigned (a, ssize, &amin, &amax);
+      return orc_range_make (dsize, amin >> shift, amax >> shift);
+    default:
+      return r;
+  }
+}
+
+/* Whether a narrowing conversion of a value in range @r returns the low
+ * bits of that value unchanged. */
+static int
+orc_narrow_conv_is_exact (int kind, OrcRange r, int ssize)
+{
+  int dsize = ssize / 2;
+  orc_int64 min, max;
+
+  switch (kind) {
+    case ORC_NARROW_TRUNC:
+      return TRUE;
+    case ORC_NARROW_SAT_SS:
+      orc_range_signed (r, ssize, &min, &max);
+      return min >= orc_range_smin (dsize) && max <= orc_range_smax (dsize);
+    case ORC_NARROW_SAT_SU:
+      orc_range_signed (r, ssize, &min, &max);
+      return min >= 0 && max <= orc_range_umax (dsize);
+    case ORC_NARROW_SAT_US:
+      orc_range_unsigned (r, ssize, &min, &max);
+      return max <= orc_range_smax (dsize);
+    case ORC_NARROW_SAT_UU:
+      orc_range_unsigned (r, ssize, &min, &max);
+      return max <= orc_range_umax (dsize);
+    default:
+      return FALSE;
+  }
+}
+
+static int
+orc_narrow_insn_reads (OrcInstruction *insn, int var)
+{
+  int k;
+
+  if (insn->opcode == NULL) return FALSE;
+  for (k = 0; k < ORC_STATIC_OPCODE_N_SRC; k++) {
+    if (insn->opcode->src_size[k] && insn->src_args[k] == var) return TRUE;
+  }
+  return FALSE;
+}
+
+static int
+orc_narrow_insn_writes (OrcInstruction *insn, int var)
+{
+  int k;
+
+  if (insn->opcode == NULL) return FALSE;
+  for (k = 0; k < ORC_STATIC_OPCODE_N_DEST; k++) {
+    if (insn->opcode->dest_size[k] && insn->dest_args[k] == var) return TRUE;
+  }
+  return FALSE;
+}
+
+/* Returns the only instruction reading the value that instruction @i
+ * writes to @var, or -1 if there is none or more than one. */
+static int
+orc_narrow_single_reader (OrcCompiler *compiler, int i, int var)
+{
+  int j;
+  int reader = -1;
+
+  if (compiler->vars[var].vartype != ORC_VAR_TYPE_TEMP) return -1;
+
+  for (j = i + 1; j < compiler->n_insns; j++) {
+    OrcInstruction *insn = compiler->insns + j;
+
+    if (orc_narrow_insn_reads (insn, var)) {
+      if (reader != -1) return -1;
+      reader = j;
+    }
+    if (orc_narrow_insn_writes (insn, var)) break;
+  }
+  return reader;
+}
+
+static int
+orc_narrow_written_between (OrcCompiler *compiler, int i, int j, int var)
+{
+  int k;
+
+  for (k = i + 1; k < j; k++) {
+    if (orc_narrow_insn_writes (compiler->insns + k, var)) return TRUE;
+  }
+  return FALSE;
+}
+
+static int
+orc_narrow_is_plain (OrcInstruction *insn)
+{
+  return insn->opcode != NULL &&
+      !(insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4));
+}
+
+static int
+orc_narrow_is_conv_down (OrcInstruction *insn)
+{
+  switch (orc_narrow_kind (insn)) {
+    case ORC_NARROW_TRUNC:
+    case ORC_NARROW_SAT_SS:
+    case ORC_NARROW_SAT_SU:
+    case ORC_NARROW_SAT_US:
+    case ORC_NARROW_SAT_UU:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Returns the instruction defining the value of @var read by instruction
+ * @j, or -1. */
+static int
+orc_narrow_definition (OrcCompiler *compiler, int j, int var)
+{
+  int k;
+
+  for (k = j - 1; k >= 0; k--) {
+    if (orc_narrow_insn_writes (compiler->insns + k, var)) return k;
+  }
+  return -1;
+}
+
+/* mul{s,u}{bw,wl} t, a, b; conv t2, t => mull{b,w} t2, a, b
+ * and the same with a constant right shift between the two. */
+static int
+orc_narrow_widening_mul (OrcCompiler *compiler, OrcRange *insn_ranges, int i)
+{
+  OrcInstruction *mul = compiler->insns + i;
+  OrcInstruction *next;
+  OrcInstruction *conv;
+  int size = mul->opcode->dest_size[0];
+  int idx = orc_narrow_lookup (mul->opcode);
+  int j;
+  int m;
+
+  j = orc_narrow_single_reader (compiler, i, mul->dest_args[0]);
+  if (j < 0) return FALSE;
+  next = compiler->insns + j;
+  if (!orc_narrow_is_plain (next)) return FALSE;
+
+  if (orc_narrow_is_conv_down (next) &&
+      next->opcode->src_size[0] == size) {
+    if (!orc_narrow_conv_is_exact (orc_narrow_kind (next), insn_ranges[i], size))
+      return FALSE;
+    if (orc_narrow_written_between (compiler, i, j, mul->src_args[0]) ||
+        orc_narrow_written_between (compiler, i, j, mul->src_args[1]))
+      return FALSE;
+
+    next->opcode = orc_opcode_find_by_name (orc_narrow_opcodes[idx].narrow);
+    next->src_args[0] = mul->src_args[0];
+    next->src_args[1] = mul->src_args[1];
+    mul->opcode = NULL;
+    return TRUE;
+  }
+
+  if (orc_narrow_kind (next) == ORC_NARROW_SHRS ||
+      orc_narrow_kind (next) == ORC_NARROW_SHRU) {
+    orc_int64 min, max;
+    const char *shift_name;
+    int half = size / 2;
+    int shift;
+    int tmp;
+
+    if (next->src_args[0] != mul->dest_args[0] ||
+        next->opcode->src_size[0] != size)
+      return FALSE;
+    shift = orc_range_shift_amount (compiler, next, half);
+    if (shift < 0) return FALSE;
+
+    m = orc_narrow_single_reader (compiler, j, next->dest_args[0]);
+    if (m < 0) return FALSE;
+    conv = compiler->insns + m;
+    if (!orc_narrow_is_plain (conv) || !orc_narrow_is_conv_down (conv))
+      return FALSE;
+    if (!orc_narrow_conv_is_exact (orc_narrow_kind (conv), insn_ranges[j], size))
+      return FALSE;
+
+    /* the product itself must be exact at the narrow size */
+    orc_range_signed (insn_ranges[i], size, &min, &max);
+    if (min >= 0 && max <= orc_range_umax (half)) {
+      shift_name = (half == 1) ? "shrub" : "shruw";
+    } else if (orc_narrow_kind (next) == ORC_NARROW_SHRS &&
+        min >= orc_range_smin (half) && max <= orc_range_smax (half)) {
+      shift_name = (half == 1) ? "shrsb" : "shrsw";
+    } else {
+      return FALSE;
+    }
+    if (ORC_VAR_T1 + compiler->n_temp_vars + compiler->n_dup_vars >=
+        ORC_N_COMPILER_VARIABLES)
+      return FALSE;
+
+    tmp = orc_compiler_new_temporary (compiler, half);
+    mul->opcode = orc_opcode_find_by_name (orc_narrow_opcodes[idx].narrow);
+    mul->dest_args[0] = tmp;
+    conv->opcode = orc_opcode_find_by_name (shift_name);
+    conv->src_args[0] = tmp;
+    conv->src_args[1] = next->src_args[1];
+    next->opcode = NULL;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* conv{s,u}{bw,wl} t1, a; conv{s,u}{bw,wl} t2, b; op t3, t1, t2;
+ * conv t4, t3 => op' t4, a, b */
+static int
+orc_narrow_widened_op (OrcCompiler *compiler, OrcRange *insn_ranges, int i)
+{
+  OrcInstruction *op = compiler->insns + i;
+  OrcInstruction *conv;
+  int size = op->opcode->dest_size[0];
+  int idx = orc_narrow_lookup (op->opcode);
+  int def[2];
+  int narrow_src[2];
+  int j;
+  int k;
+
+  if (idx < 0 || orc_narrow_opcodes[idx].narrow == NULL) return FALSE;
+  switch (orc_narrow_opcodes[idx].kind) {
+    case ORC_NARROW_MULL:
+    case ORC_NARROW_ADD:
+    case ORC_NARROW_SUB:
+    case ORC_NARROW_AND:
+    case ORC_NARROW_LOGIC:
+      break;
+    default:
+      return FALSE;
+  }
+
+  j = orc_narrow_single_reader (compiler, i, op->dest_args[0]);
+  if (j < 0) return FALSE;
+  conv = compiler->insns + j;
+  if (!orc_narrow_is_plain (conv) || !orc_narrow_is_conv_down (conv) ||
+      conv->opcode->src_size[0] != size)
+    return FALSE;
+  if (!orc_narrow_conv_is_exact (orc_narrow_kind (conv), insn_ranges[i], size))
+    return FALSE;
+
+  for (k = 0; k < 2; k++) {
+    OrcInstruction *widen;
+    int kind;
+
+    def[k] = orc_narrow_definition (compiler, i, op->src_args[k]);
+    if (def[k] < 0) return FALSE;
+    widen = compiler->insns + def[k];
+    kind = orc_narrow_kind (widen);
+    if (!orc_narrow_is_plain (widen) ||
+        (kind != ORC_NARROW_CONVS && kind != ORC_NARROW_CONVU) ||
+        widen->opcode->dest_size[0] != size)
+      return FALSE;
+    if (orc_narrow_single_reader (compiler, def[k], op->src_args[k]) != i)
+      return FALSE;
+    narrow_src[k] = widen->src_args[0];
+    if (orc_narrow_written_between (compiler, def[k], j, narrow_src[k]))
+      return FALSE;
+  }
+
+  conv->opcode = orc_opcode_find_by_name (orc_narrow_opcodes[idx].narrow);
+  conv->src_args[0] = narrow_src[0];
+  conv->src_args[1] = narrow_src[1];
+  compiler->insns[def[0]].opcode = NULL;
+  compiler->insns[def[1]].opcode = NULL;
+  op->opcode = NULL;
+  return TRUE;
+}
+
+static void
+orc_compiler_narrow_widths (OrcCompiler *compiler)
+{
+  OrcRange ranges[ORC_N_COMPILER_VARIABLES];
+  OrcRange insn_ranges[ORC_N_INSNS];
+  int n_narrowed = 0;
+  int i;
+  int j;
+
+  memset (ranges, 0, sizeof (ranges));
+  for (i = 0; i < compiler->n_insns; i++) {
+    OrcInstruction *insn = compiler->insns + i;
+
+    insn_ranges[i] = orc_range_of_insn (compiler, ranges, insn);
+    if (insn->opcode->dest_size[0] != 0) {
+      ranges[insn->dest_args[0]] = insn_ranges[i];
+    }
+    if (insn->opcode->dest_size[1] != 0) {
+      memset (&ranges[insn->dest_args[1]], 0, sizeof (OrcRange));
+    }
+  }
+
+  for (i = 0; i < compiler->n_insns; i++) {
+    OrcInstruction *insn = compiler->insns + i;
+    int kind;
+
+    if (!orc_narrow_is_plain (insn)) continue;
+    kind = orc_narrow_kind (insn);
+    if (kind == ORC_NARROW_MULS || kind == ORC_NARROW_MULU) {
+      if (orc_narrow_widening_mul (compiler, insn_ranges, i)) n_narrowed++;
+    } else if (orc_narrow_widened_op (compiler, insn_ranges, i)) {
+      n_narrowed++;
+    }
+  }
+
+  if (n_narrowed == 0) return;
+
+  for (i = 0, j = 0; i < compiler->n_insns; i++) {
+    if (compiler->insns[i].opcode == NULL) continue;
+    if (i != j) compiler->insns[j] = compiler->insns[i];
+    j++;
+  }
+  compiler->n_insns = j;
+
+  ORC_INFO ("narrowed %d widening sequences", n_narrowed);
+}
+
+/* mulf t, a, b; addf d, t, c => fmaf d, a, b, c (and the same for
+ * doubles) when nothing else reads t.  Only done under fast math, as
+ * the product is no longer rounded: the result differs from the
+ * unfused pair by at most half an ulp of a * b. */
+static void
+orc_compiler_contract_fma (OrcCompiler *compiler)
+{
+  static const char *pairs[][3] = {
+    { "mulf", "addf", "fmaf" },
+    { "muld", "addd", "fmad" },
+  };
+  OrcStaticOpcode *opcodes[2][3];
+  int n_contracted = 0;
+  int i;
+  int j;
+  int k;
+
+  if (compiler->target == NULL) return;
+
+  for (k = 0; k < 2; k++) {
+    for (i = 0; i < 3; i++) {
+      opcodes[k][i] = orc_opcode_find_by_name (pairs[k][i]);
+    }
+    if (orc_target_get_rule (compiler->target, opcodes[k][2],
+          compiler->target_flags) == NULL) {
+      opcodes[k][0] = NULL;
+    }
+  }
+
+  for (i = 0; i < compiler->n_insns; i++) {
+    OrcInstruction *mul = compiler->insns + i;
+    OrcInstruction *add;
+    int t;
+    int c;
+
+    if (!orc_narrow_is_plain (mul)) continue;
+    for (k = 0; k < 2; k++) {
+      if (mul->opcode == opcodes[k][0]) break;
+    }
+    if (k == 2) continue;
+
+    t = mul->dest_args[0];
+    j = orc_narrow_single_reader (compiler, i, t);
+    if (j < 0) continue;
+    add = compiler->insns + j;
+    if (!orc_narrow_is_plain (add) || add->opcode != opcodes[k][1]) continue;
+
+    if (add->src_args[0] == t && add->src_args[1] != t) {
+      c = add->src_args[1];
+    } else if (add->src_args[1] == t && add->src_args[0] != t) {
+      c = add->src_args[0];
+    } else {
+      continue;
+    }
+
+    /* the product moves down to the addition */
+    if (orc_narrow_written_between (compiler, i, j, mul->src_args[0]) ||
+        orc_narrow_written_between (compiler, i, j, mul->src_args[1]))
+      continue;
+
+    add->opcode = opcodes[k][2];
+    add->src_args[0] = mul->src_args[0];
+    add->src_args[1] = mul->src_args[1];
+    add->src_args[2] = c;
+    mul->opcode = NULL;
+    n_contracted++;
+  }
+
+  if (n_contracted == 0) return;
+
+  for (i = 0, j = 0; i < compiler->n_insns; i++) {
+    if (compiler->insns[i].opcode == NULL) continue;
+    if (i != j) compiler->insns[j] = compiler->insns[i];
+    j++;
+  }
+  compiler->n_insns = j;
+
+  ORC_INFO ("contracted %d multiply-add pairs", n_contracted);
+}
+
 static void
 orc_compiler_assign_rules (OrcCompiler *compiler)
 {
@@ -1168,6 +2026,14 @@ orc_compiler_global_reg_alloc (OrcCompiler *compiler)
     if (opcode->flags & ORC_STATIC_OPCODE_ITERATOR) {
       compiler->has_iterator_opcode = TRUE;
     }
+    if (opcode->flags & ORC_STATIC_OPCODE_INDEX) {
+      compiler->has_index_opcode = TRUE;
+    }
+  }
+
+  if (!compiler->error && !(compiler->target_flags & ORC_TARGET_BASELINE) &&
+      !orc_compiler_flag_check ("-licm")) {
+    orc_compiler_hoist_invariants (compiler);
   }
 
   if (compiler->alloc_loop_counter && !compiler->error) {
@@ -1181,12 +2047,166 @@ orc_compiler_global_reg_alloc (OrcCompiler *compiler)
   }
 }
 
+/* Vector registers kept free for the loop body when deciding how many
+ * invariant values may live in registers across the whole loop.  Rules
+ * grab temporaries and constants from this pool. */
+#define ORC_COMPILER_LICM_RESERVED_REGS 4
+
+static int
+orc_compiler_loop_pressure (OrcCompiler *compiler)
+{
+  int i;
+  int j;
+  int n;
+  int max = 0;
+
+  for(j=0;j<compiler->n_insns;j++){
+    n = 0;
+    for(i=0;i<ORC_N_COMPILER_VARIABLES;i++){
+      OrcVariable *var = compiler->vars + i;
+
+      if (var->name == NULL) continue;
+      if (var->vartype != ORC_VAR_TYPE_TEMP) continue;
+      if (var->first_use == -1) continue;
+      if (var->first_use <= j && var->last_use >= j) n++;
+    }
+    if (n > max) max = n;
+  }
+
+  return max;
+}
+
+static int
+orc_compiler_insn_is_invariant (OrcCompiler *compiler, OrcInstruction *insn)
+{
+  OrcStaticOpcode *opcode = insn->opcode;
+  OrcVariable *var;
+  int k;
+
+  if (opcode->flags & (ORC_STATIC_OPCODE_ACCUMULATOR | ORC_STATIC_OPCODE_LOAD |
+        ORC_STATIC_OPCODE_STORE | ORC_STATIC_OPCODE_ITERATOR))
+    return FALSE;
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4))
+    return FALSE;
+  if (opcode->dest_size[0] == 0 || opcode->dest_size[1] != 0)
+    return FALSE;
+  if (compiler->vars[insn->dest_args[0]].vartype != ORC_VAR_TYPE_TEMP)
+    return FALSE;
+
+  for(k=0;k<ORC_STATIC_OPCODE_N_SRC;k++){
+    if (opcode->src_size[k] == 0) continue;
+
+    var = compiler->vars + insn->src_args[k];
+    if (var->vartype == ORC_VAR_TYPE_CONST ||
+        var->vartype == ORC_VAR_TYPE_PARAM)
+      continue;
+    /* temps computed outside the loop have no live range */
+    if (var->vartype == ORC_VAR_TYPE_TEMP && var->first_use == -1 &&
+        var->alloc)
+      continue;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Loop-invariant code motion.  Instructions whose sources are all
+ * constants, parameters or values already computed before the loop are
+ * marked invariant, which makes the targets emit them once in the
+ * prologue like the loadp opcodes.  Each hoisted value holds a vector
+ * register for the whole loop, so hoisting stops once that would leave
+ * the loop body short of registers. */
+static void
+orc_compiler_hoist_invariants (OrcCompiler *compiler)
+{
+  int i;
+  int j;
+  int reg;
+  int n_free = 0;
+  int n_hoisted = 0;
+  int offset = compiler->target->data_register_offset;
+
+  for(i=0;i<64 && offset + i < ORC_N_REGS;i++){
+    reg = offset + i;
+    if (compiler->valid_regs[reg] && compiler->alloc_regs[reg] == 0)
+      n_free++;
+  }
+
+  for(j=0;j<compiler->n_insns;j++){
+    OrcInstruction *insn = compiler->insns + j;
+    OrcVariable *var;
+    int first_use;
+    int last_use;
+
+    if (insn->flags & ORC_INSN_FLAG_INVARIANT) continue;
+    if (!orc_compiler_insn_is_invariant (compiler, insn)) continue;
+
+    var = compiler->vars + insn->dest_args[0];
+    first_use = var->first_use;
+    last_use = var->last_use;
+
+    var->first_use = -1;
+    var->last_use = -1;
+    if (n_hoisted + 1 + orc_compiler_loop_pressure (compiler) +
+        ORC_COMPILER_LICM_RESERVED_REGS > n_free) {
+      var->first_use = first_use;
+      var->last_use = last_use;
+      break;
+    }
+
+    var->alloc = orc_compiler_allocate_register (compiler, TRUE);
+    if (compiler->error) break;
+    insn->flags |= ORC_INSN_FLAG_INVARIANT;
+    n_hoisted++;
+  }
+
+  if (n_hoisted > 0) {
+    ORC_INFO ("hoisted %d loop-invariant instructions", n_hoisted);
+  }
+}
+
+static const char *orc_compiler_commutative_opcodes[] = {
+  "addb", "addw", "addl", "addq",
+  "addssb", "addssw", "addssl",
+  "addusb", "addusw", "addusl",
+  "andb", "andw", "andl", "andq",
+  "orb", "orw", "orl", "orq",
+  "xorb", "xorw", "xorl", "xorq",
+  "avgsb", "avgub", "avgsw", "avguw", "avgsl", "avgul",
+  "maxsb", "maxub", "maxsw", "maxuw", "maxsl", "maxul",
+  "minsb", "minub", "minsw", "minuw", "minsl", "minul",
+  "mullb", "mullw", "mulll",
+  "mulhsb", "mulhub", "mulhsw", "mulhuw", "mulhsl", "mulhul",
+  "mulsbw", "mulubw", "mulswl", "muluwl", "mulslq", "mululq",
+  "cmpeqb", "cmpeqw", "cmpeql", "cmpeqq",
+  NULL
+};
+
+static int
+orc_compiler_opcode_is_commutative (OrcStaticOpcode *opcode)
+{
+  int i;
+
+  if (opcode->src_size[1] == 0 || opcode->src_size[0] != opcode->src_size[1])
+    return FALSE;
+
+  for (i = 0; orc_compiler_commutative_opcodes[i]; i++) {
+    if (strcmp (orc_compiler_commutative_opcodes[i], opcode->name) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
 static void
 orc_compiler_rewrite_vars2 (OrcCompiler *compiler)
 {
   int i;
   int j;
   int k;
+  int n_coalesced = 0;
+  int n_commuted = 0;
+  int coalesce = !(compiler->target_flags & ORC_TARGET_BASELINE) &&
+      !orc_compiler_flag_check ("-coalesce");
 
   for(j=0;j<compiler->n_insns;j++){
 #if 1
@@ -1197,6 +2217,26 @@ orc_compiler_rewrite_vars2 (OrcCompiler *compiler)
      */
     if (compiler->insns[j].flags & ORC_INSN_FLAG_INVARIANT) continue;
 
+    /* Two-operand targets copy src1 into dest before the operation
+     * unless both share a register.  If only src2 dies here and the
+     * opcode is commutative, swap the sources so that dest can take
+     * over the dying register instead. */
+    if (coalesce &&
+        !(compiler->insns[j].opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) &&
+        orc_compiler_opcode_is_commutative (compiler->insns[j].opcode)) {
+      int src1 = compiler->insns[j].src_args[0];
+      int src2 = compiler->insns[j].src_args[1];
+
+      if (src1 != src2 &&
+          compiler->vars[src2].vartype == ORC_VAR_TYPE_TEMP &&
+          compiler->vars[src2].last_use == j &&
+          compiler->vars[src1].last_use != j) {
+        compiler->insns[j].src_args[0] = src2;
+        compiler->insns[j].src_args[1] = src1;
+        n_commuted++;
+      }
+    }
+
     if (!(compiler->insns[j].opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR)) {
       int src1 = compiler->insns[j].src_args[0];
       int dest;
@@ -1213,6 +2253,7 @@ orc_compiler_rewrite_vars2 (OrcCompiler *compiler)
         }
         compiler->alloc_regs[compiler->vars[src1].alloc]++;
         compiler->vars[dest].alloc = compiler->vars[src1].alloc;
+        n_coalesced++;
       }
     }
 #endif
@@ -1245,6 +2286,8 @@ orc_compiler_rewrite_vars2 (OrcCompiler *compiler)
     }
   }
 
+  ORC_INFO ("coalesced %d destinations with their first source, "
+      "%d by commuting operands", n_coalesced, n_commuted);
 }
 
 static int
@@ -1252,6 +2295,11 @@ orc_compiler_dup_temporary (OrcCompiler *compiler, int var, int j)
 {
   int i = ORC_VAR_T1 + compiler->n_temp_vars + compiler->n_dup_vars;
 
+  if (i >= ORC_N_COMPILER_VARIABLES) {
+    ORC_COMPILER_ERROR (compiler, "too many temporary variables");
+    return var;
+  }
+
   compiler->vars[i].vartype = ORC_VAR_TYPE_TEMP;
   compiler->vars[i].size = compiler->vars[var].size;
   compiler->vars[i].name = malloc (strlen(compiler->vars[var].name) + 10);
@@ -1266,9 +2314,14 @@ orc_compiler_new_temporary (OrcCompiler *compiler, int size)
 {
   int i = ORC_VAR_T1 + compiler->n_temp_vars + compiler->n_dup_vars;
 
+  if (i >= ORC_N_COMPILER_VARIABLES) {
+    ORC_COMPILER_ERROR (compiler, "too many temporary variables");
+    return ORC_VAR_T1;
+  }
+
   compiler->vars[i].vartype = ORC_VAR_TYPE_TEMP;
   compiler->vars[i].size = size;
-  compiler->vars[i].name = malloc (10);
+  compiler->vars[i].name = malloc (16);
   sprintf(compiler->vars[i].name, "tmp%d", i);
   compiler->n_dup_vars++;
 
@@ -1390,12 +2443,22 @@ orc_compiler_get_constant_long (OrcCompiler *compiler,
     orc_uint32 a, orc_uint32 b, orc_uint32 c, orc_uint32 d)
 {
   int tmp;
+  int i;
 
   tmp = orc_compiler_try_get_constant_long (compiler, a, b, c, d);
   if (tmp == ORC_REG_INVALID) {
+    /* the constant is not necessarily the last one added */
+    for(i=0;i<compiler->n_constants;i++){
+      if (compiler->constants[i].is_long == TRUE &&
+          compiler->constants[i].full_value[0] == a &&
+          compiler->constants[i].full_value[1] == b &&
+          compiler->constants[i].full_value[2] == c &&
+          compiler->constants[i].full_value[3] == d) {
+        break;
+      }
+    }
     tmp = orc_compiler_get_temp_reg (compiler);
-    orc_compiler_load_constant_long (compiler, tmp,
-        &compiler->constants[compiler->n_constants - 1]);
+    orc_compiler_load_constant_long (compiler, tmp, &compiler->constants[i]);
   }
   return tmp;
 }
@@ -135,6 +135,13 @@ struct _OrcCompiler {
   void *output_insns;
   int n_output_insns;
   int n_output_insns_alloc;
+
+  /* for orc_stats_get_phase_time() and orc_stats_get_counter() */
+  orc_uint64 relaxation_time;
+  int n_relaxation_iterations;
+
+  /* Appended to keep the offsets of the fields above */
+  int has_index_opcode;
 };
 
 
@@ -29,6 +29,7 @@
 #include "config.h"
 #endif
 #include <orc/orcarm.h>
+#include <orc/orcsve.h>
 #include <orc/orcutils.h>
 #include <orc/orcdebug.h>
 #include <orc/orcutils-private.h>
@@ -195,6 +196,69 @@ orc_arm_get_cpu_flags (void)
 
   return neon_flags;
 }
+
+#if defined(__aarch64__)
+#if defined(__linux__)
+static unsigned long
+orc_check_sve_proc_auxv (void)
+{
+  unsigned long flags = 0;
+  unsigned long aux[2];
+  ssize_t count;
+  int fd;
+
+  fd = open("/proc/self/auxv", O_RDONLY);
+  if (fd < 0) {
+    ORC_LOG ("Failed to open /proc/self/auxv");
+    return 0;
+  }
+
+  while (1) {
+    count = read(fd, aux, sizeof(aux));
+    if (count < sizeof(aux)) {
+      break;
+    }
+
+    /* HWCAP_SVE is (1 << 22), HWCAP2_SVE2 is (1 << 1) */
+    if (aux[0] == AT_HWCAP) {
+      if (aux[1] & (1 << 22)) flags |= ORC_TARGET_SVE_SVE;
+#ifdef AT_HWCAP2
+    } else if (aux[0] == AT_HWCAP2) {
+      if (aux[1] & (1 << 1)) flags |= ORC_TARGET_SVE_SVE2;
+#endif
+    } else if (aux[0] == AT_NULL) {
+      break;
+    }
+  }
+
+  close(fd);
+
+  /* SVE2 is an extension of SVE */
+  if (!(flags & ORC_TARGET_SVE_SVE)) flags = 0;
+
+  return flags;
+}
+#endif
+
+unsigned long
+orc_sve_get_cpu_flags (void)
+{
+  unsigned long sve_flags = 0;
+
+#ifdef __linux__
+  sve_flags = orc_check_sve_proc_auxv ();
+#endif
+
+  if (orc_compiler_flag_check ("-sve")) {
+    sve_flags = 0;
+  }
+  if (orc_compiler_flag_check ("-sve2")) {
+    sve_flags &= ~ORC_TARGET_SVE_SVE2;
+  }
+
+  return sve_flags;
+}
+#endif
 #endif
 
 
@@ -0,0 +1,75 @@
+/*
+ * ORC - Oil Runtime Compiler
+ * Copyright (c) 2003,2004 David A. Schleef <ds@schleef.org>
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <orc/orcloongarch.h>
+#include <orc/orcutils.h>
+#include <orc/orcdebug.h>
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+/***** loongarch *****/
+
+#if defined(__loongarch__)
+
+/* HWCAP_LOONGARCH_LSX and HWCAP_LOONGARCH_LASX */
+#define LOONGARCH_HWCAP_LSX (1 << 4)
+#define LOONGARCH_HWCAP_LASX (1 << 5)
+
+unsigned long
+orc_loongarch_get_cpu_flags (void)
+{
+  unsigned long flags = 0;
+
+#if defined(__linux__)
+  unsigned long hwcap = getauxval (AT_HWCAP);
+
+  ORC_INFO ("loongarch hwcap %08lx", hwcap);
+  if (hwcap & LOONGARCH_HWCAP_LSX)
+    flags |= ORC_TARGET_LOONGARCH_LSX;
+  if (hwcap & LOONGARCH_HWCAP_LASX)
+    flags |= ORC_TARGET_LOONGARCH_LASX;
+#endif
+
+  if (orc_compiler_flag_check ("-lsx")) {
+    flags = 0;
+  }
+  if (orc_compiler_flag_check ("-lasx")) {
+    flags &= ~ORC_TARGET_LOONGARCH_LASX;
+  }
+
+  /* LASX extends LSX, the code uses both */
+  if (!(flags & ORC_TARGET_LOONGARCH_LSX)) flags = 0;
+
+  return flags;
+}
+#endif
@@ -273,6 +273,9 @@ orc_x86_detect_cpuid (void)
   if (orc_compiler_flag_check ("-avx2")) {
     orc_x86_sse_flags &= ~ORC_TARGET_AVX_AVX2;
   }
+  if (orc_compiler_flag_check ("-fma")) {
+    orc_x86_sse_flags &= ~ORC_TARGET_AVX_FMA;
+  }
 }
 
 static char orc_x86_processor_string[49];
@@ -347,6 +350,7 @@ orc_x86_cpuid_handle_standard_flags (void)
   // https://gitlab.freedesktop.org/gstreamer/orc/-/issues/65
   const int osxsave_enabled = ecx & (1 << 27);
   const int avx_instructions_supported = ecx & (1 << 28);
+  const int fma_instructions_supported = ecx & (1 << 12);
 
 
   get_cpuid (0x00000007, &eax, &ebx, &ecx, &edx);
@@ -361,6 +365,10 @@ orc_x86_cpuid_handle_standard_flags (void)
     if (avx2_instructions_supported) {
       orc_x86_sse_flags |= ORC_TARGET_AVX_AVX2;
     }
+
+    if (fma_instructions_supported) {
+      orc_x86_sse_flags |= ORC_TARGET_AVX_FMA;
+    }
   }
 }
 
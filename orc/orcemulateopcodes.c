@@ -5455,3 +5455,1006 @@ emulate_convwf (OrcOpcodeExecutor *ex, int offset, int n)
 
 }
 
+
+void
+emulate_fmaf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  const orc_union32 * ORC_RESTRICT ptr5;
+  const orc_union32 * ORC_RESTRICT ptr6;
+  orc_union32 var32;
+  orc_union32 var33;
+  orc_union32 var34;
+  orc_union32 var35;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+  ptr5 = (orc_union32 *)ex->src_ptrs[1];
+  ptr6 = (orc_union32 *)ex->src_ptrs[2];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: loadl */
+    var33 = ptr5[i];
+    /* 2: loadl */
+    var34 = ptr6[i];
+    /* 3: fmaf */
+    {
+       orc_union32 _src1;
+       orc_union32 _src2;
+       orc_union32 _src3;
+       orc_union32 _dest1;
+       _src1.i = ORC_DENORMAL(var32.i);
+       _src2.i = ORC_DENORMAL(var33.i);
+       _src3.i = ORC_DENORMAL(var34.i);
+       _dest1.f = fmaf(_src1.f, _src2.f, _src3.f);
+       var35.i = ORC_DENORMAL(_dest1.i);
+    }
+    /* 4: storel */
+    ptr0[i] = var35;
+  }
+
+}
+
+void
+emulate_fmad (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  const orc_union64 * ORC_RESTRICT ptr5;
+  const orc_union64 * ORC_RESTRICT ptr6;
+  orc_union64 var32;
+  orc_union64 var33;
+  orc_union64 var34;
+  orc_union64 var35;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+  ptr5 = (orc_union64 *)ex->src_ptrs[1];
+  ptr6 = (orc_union64 *)ex->src_ptrs[2];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: loadq */
+    var33 = ptr5[i];
+    /* 2: loadq */
+    var34 = ptr6[i];
+    /* 3: fmad */
+    {
+       orc_union64 _src1;
+       orc_union64 _src2;
+       orc_union64 _src3;
+       orc_union64 _dest1;
+       _src1.i = ORC_DENORMAL_DOUBLE(var32.i);
+       _src2.i = ORC_DENORMAL_DOUBLE(var33.i);
+       _src3.i = ORC_DENORMAL_DOUBLE(var34.i);
+       _dest1.f = fma(_src1.f, _src2.f, _src3.f);
+       var35.i = ORC_DENORMAL_DOUBLE(_dest1.i);
+    }
+    /* 4: storeq */
+    ptr0[i] = var35;
+  }
+
+}
+
+void
+emulate_mulcf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  const orc_union64 * ORC_RESTRICT ptr5;
+  orc_union64 var32;
+  orc_union64 var33;
+  orc_union64 var34;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+  ptr5 = (orc_union64 *)ex->src_ptrs[1];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: loadq */
+    var33 = ptr5[i];
+    /* 2: mulcf */
+    {
+       orc_union64 _src1;
+       orc_union64 _src2;
+       orc_union32 _rr, _ii, _ri, _ir;
+       orc_union32 _dest1, _dest2;
+       _src1.x2[0] = ORC_DENORMAL(var32.x2[0]);
+       _src1.x2[1] = ORC_DENORMAL(var32.x2[1]);
+       _src2.x2[0] = ORC_DENORMAL(var33.x2[0]);
+       _src2.x2[1] = ORC_DENORMAL(var33.x2[1]);
+       _rr.f = _src1.x2f[0] * _src2.x2f[0];
+       _ii.f = _src1.x2f[1] * _src2.x2f[1];
+       _ri.f = _src1.x2f[0] * _src2.x2f[1];
+       _ir.f = _src1.x2f[1] * _src2.x2f[0];
+       _rr.i = ORC_DENORMAL(_rr.i);
+       _ii.i = ORC_DENORMAL(_ii.i);
+       _ri.i = ORC_DENORMAL(_ri.i);
+       _ir.i = ORC_DENORMAL(_ir.i);
+       _dest1.f = _rr.f - _ii.f;
+       _dest2.f = _ir.f + _ri.f;
+       var34.x2[0] = ORC_DENORMAL(_dest1.i);
+       var34.x2[1] = ORC_DENORMAL(_dest2.i);
+    }
+    /* 3: storeq */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+emulate_mulcjf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  const orc_union64 * ORC_RESTRICT ptr5;
+  orc_union64 var32;
+  orc_union64 var33;
+  orc_union64 var34;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+  ptr5 = (orc_union64 *)ex->src_ptrs[1];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: loadq */
+    var33 = ptr5[i];
+    /* 2: mulcjf */
+    {
+       orc_union64 _src1;
+       orc_union64 _src2;
+       orc_union32 _rr, _ii, _ri, _ir;
+       orc_union32 _dest1, _dest2;
+       _src1.x2[0] = ORC_DENORMAL(var32.x2[0]);
+       _src1.x2[1] = ORC_DENORMAL(var32.x2[1]);
+       _src2.x2[0] = ORC_DENORMAL(var33.x2[0]);
+       _src2.x2[1] = ORC_DENORMAL(var33.x2[1]);
+       _rr.f = _src1.x2f[0] * _src2.x2f[0];
+       _ii.f = _src1.x2f[1] * _src2.x2f[1];
+       _ri.f = _src1.x2f[0] * _src2.x2f[1];
+       _ir.f = _src1.x2f[1] * _src2.x2f[0];
+       _rr.i = ORC_DENORMAL(_rr.i);
+       _ii.i = ORC_DENORMAL(_ii.i);
+       _ri.i = ORC_DENORMAL(_ri.i);
+       _ir.i = ORC_DENORMAL(_ir.i);
+       _dest1.f = _rr.f + _ii.f;
+       _dest2.f = _ir.f - _ri.f;
+       var34.x2[0] = ORC_DENORMAL(_dest1.i);
+       var34.x2[1] = ORC_DENORMAL(_dest2.i);
+    }
+    /* 3: storeq */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+emulate_magsqcf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: magsqcf */
+    {
+       orc_union64 _src1;
+       orc_union32 _rr, _ii;
+       orc_union32 _dest1;
+       _src1.x2[0] = ORC_DENORMAL(var32.x2[0]);
+       _src1.x2[1] = ORC_DENORMAL(var32.x2[1]);
+       _rr.f = _src1.x2f[0] * _src1.x2f[0];
+       _ii.f = _src1.x2f[1] * _src1.x2f[1];
+       _rr.i = ORC_DENORMAL(_rr.i);
+       _ii.i = ORC_DENORMAL(_ii.i);
+       _dest1.f = _rr.f + _ii.f;
+       var33.i = ORC_DENORMAL(_dest1.i);
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_addpb (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_union16 * ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_int8 var33;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union16 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: addpb */
+    {
+       orc_union16 _src;
+       _src.i = var32.i;
+       var33 = _src.x2[0] + _src.x2[1];
+    }
+    /* 2: storeb */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_addpw (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union16 * ORC_RESTRICT ptr0;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union16 var33;
+
+  ptr0 = (orc_union16 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: addpw */
+    {
+       orc_union32 _src;
+       _src.i = var32.i;
+       var33.i = ((orc_uint16)_src.x2[0]) + ((orc_uint16)_src.x2[1]);
+    }
+    /* 2: storew */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_addpl (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: addpl */
+    {
+       orc_union64 _src;
+       _src.i = var32.i;
+       var33.i = ((orc_uint32)_src.x2[0]) + ((orc_uint32)_src.x2[1]);
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_addpf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: addpf */
+    {
+       orc_union64 _src;
+       orc_union32 _dest1;
+       _src.i = var32.i;
+       _src.x2[0] = ORC_DENORMAL(_src.x2[0]);
+       _src.x2[1] = ORC_DENORMAL(_src.x2[1]);
+       _dest1.f = _src.x2f[0] + _src.x2f[1];
+       var33.i = ORC_DENORMAL(_dest1.i);
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_avgpub (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_union16 * ORC_RESTRICT ptr4;
+  orc_union16 var32;
+  orc_int8 var33;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union16 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: avgpub */
+    {
+       orc_union16 _src;
+       _src.i = var32.i;
+       var33 = ((orc_uint8)_src.x2[0] + (orc_uint8)_src.x2[1] + 1)>>1;
+    }
+    /* 2: storeb */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_avgpuw (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union16 * ORC_RESTRICT ptr0;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union16 var33;
+
+  ptr0 = (orc_union16 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: avgpuw */
+    {
+       orc_union32 _src;
+       _src.i = var32.i;
+       var33.i = ((orc_uint16)_src.x2[0] + (orc_uint16)_src.x2[1] + 1)>>1;
+    }
+    /* 2: storew */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_avgpul (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: avgpul */
+    {
+       orc_union64 _src;
+       _src.i = var32.i;
+       var33.i = ((orc_uint64)(orc_uint32)_src.x2[0] + (orc_uint64)(orc_uint32)_src.x2[1] + 1)>>1;
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_avgpf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: avgpf */
+    {
+       orc_union64 _src;
+       orc_union32 _dest1;
+       _src.i = var32.i;
+       _src.x2[0] = ORC_DENORMAL(_src.x2[0]);
+       _src.x2[1] = ORC_DENORMAL(_src.x2[1]);
+       _dest1.f = _src.x2f[0] + _src.x2f[1];
+       _dest1.i = ORC_DENORMAL(_dest1.i);
+       _dest1.f = _dest1.f * 0.5f;
+       var33.i = ORC_DENORMAL(_dest1.i);
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_randl (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  orc_union32 var32;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: randl */
+    {
+       orc_uint32 _x = (orc_uint32)((orc_union64 *)(ex->src_ptrs[0]))->i * 0x9e3779b9U + (orc_uint32)(ex->index + offset + i);
+       _x = (_x << 15) + ~_x;
+       _x ^= _x >> 12;
+       _x += _x << 2;
+       _x ^= _x >> 4;
+       _x += (_x << 3) + (_x << 11);
+       _x ^= _x >> 16;
+       var32.i = _x;
+    }
+    /* 1: storel */
+    ptr0[i] = var32;
+  }
+
+}
+
+void
+emulate_randf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  orc_union32 var32;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: randf */
+    {
+       orc_union32 _dest1;
+       orc_uint32 _x = (orc_uint32)((orc_union64 *)(ex->src_ptrs[0]))->i * 0x9e3779b9U + (orc_uint32)(ex->index + offset + i);
+       _x = (_x << 15) + ~_x;
+       _x ^= _x >> 12;
+       _x += _x << 2;
+       _x ^= _x >> 4;
+       _x += (_x << 3) + (_x << 11);
+       _x ^= _x >> 16;
+       _dest1.f = (float)(orc_int32)(_x >> 8) * (1.0f / 16777216);
+       var32.i = _dest1.i;
+    }
+    /* 1: storel */
+    ptr0[i] = var32;
+  }
+
+}
+
+void
+emulate_randtf (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  orc_union32 var32;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: randtf */
+    {
+       orc_union32 _dest1;
+       orc_uint32 _x = (orc_uint32)((orc_union64 *)(ex->src_ptrs[0]))->i * 0x9e3779b9U + (orc_uint32)(ex->index + offset + i);
+       _x = (_x << 15) + ~_x;
+       _x ^= _x >> 12;
+       _x += _x << 2;
+       _x ^= _x >> 4;
+       _x += (_x << 3) + (_x << 11);
+       _x ^= _x >> 16;
+       _dest1.f = (float)((orc_int32)(_x & 0xffff) - (orc_int32)(_x >> 16)) * (1.0f / 65536);
+       var32.i = _dest1.i;
+    }
+    /* 1: storel */
+    ptr0[i] = var32;
+  }
+
+}
+
+void
+emulate_unpack3x10 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  orc_union32 var32;
+  orc_union64 var33;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: unpack3x10 */
+    {
+       orc_union64 _dest;
+       orc_uint32 _w = var32.i;
+       _dest.x4[0] = _w & 0x3ff;
+       _dest.x4[1] = (_w >> 10) & 0x3ff;
+       _dest.x4[2] = (_w >> 20) & 0x3ff;
+       _dest.x4[3] = 0;
+       var33.i = _dest.i;
+    }
+    /* 2: storeq */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_pack3x10 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: pack3x10 */
+    {
+       orc_union64 _src;
+       _src.i = var32.i;
+       var33.i = (_src.x4[0] & 0x3ff) | ((_src.x4[1] & 0x3ff) << 10) | ((orc_uint32)(_src.x4[2] & 0x3ff) << 20);
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
+void
+emulate_ldunpack4x10 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_int8 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_int8 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: ldunpack4x10 */
+    {
+       const orc_uint8 *_p = (const orc_uint8 *)ptr4 + 5 * (offset + i);
+       orc_union64 _dest;
+       orc_uint64 _g = _p[0] | ((orc_uint32)_p[1] << 8) | ((orc_uint32)_p[2] << 16) | ((orc_uint32)_p[3] << 24) | ((orc_uint64)_p[4] << 32);
+       _dest.x4[0] = _g & 0x3ff;
+       _dest.x4[1] = (_g >> 10) & 0x3ff;
+       _dest.x4[2] = (_g >> 20) & 0x3ff;
+       _dest.x4[3] = (_g >> 30) & 0x3ff;
+       var32.i = _dest.i;
+    }
+    /* 1: storeq */
+    ptr0[i] = var32;
+  }
+
+}
+
+void
+emulate_stpack4x10 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: stpack4x10 */
+    {
+       orc_uint8 *_p = (orc_uint8 *)ptr0 + 5 * (offset + i);
+       orc_union64 _src;
+       orc_uint64 _g;
+       _src.i = var32.i;
+       _g = _src.x4[0] & 0x3ff;
+       _g |= (orc_uint64)(_src.x4[1] & 0x3ff) << 10;
+       _g |= (orc_uint64)(_src.x4[2] & 0x3ff) << 20;
+       _g |= (orc_uint64)(_src.x4[3] & 0x3ff) << 30;
+       _p[0] = _g;
+       _p[1] = _g >> 8;
+       _p[2] = _g >> 16;
+       _p[3] = _g >> 24;
+       _p[4] = _g >> 32;
+    }
+  }
+
+}
+
+void
+emulate_ldunpack2x12 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_int8 * ORC_RESTRICT ptr4;
+  orc_union32 var32;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_int8 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: ldunpack2x12 */
+    {
+       const orc_uint8 *_p = (const orc_uint8 *)ptr4 + 3 * (offset + i);
+       orc_union32 _dest;
+       orc_uint32 _g = _p[0] | ((orc_uint32)_p[1] << 8) | ((orc_uint32)_p[2] << 16);
+       _dest.x2[0] = _g & 0xfff;
+       _dest.x2[1] = (_g >> 12) & 0xfff;
+       var32.i = _dest.i;
+    }
+    /* 1: storel */
+    ptr0[i] = var32;
+  }
+
+}
+
+void
+emulate_stpack2x12 (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  orc_union32 var32;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: stpack2x12 */
+    {
+       orc_uint8 *_p = (orc_uint8 *)ptr0 + 3 * (offset + i);
+       orc_union32 _src;
+       orc_uint32 _g;
+       _src.i = var32.i;
+       _g = _src.x2[0] & 0xfff;
+       _g |= (orc_uint32)(_src.x2[1] & 0xfff) << 12;
+       _p[0] = _g;
+       _p[1] = _g >> 8;
+       _p[2] = _g >> 16;
+    }
+  }
+
+}
+
+void
+emulate_lut16b (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_int8 * ORC_RESTRICT ptr4;
+  orc_int8 var32;
+  orc_union64 var33;
+  orc_union64 var34;
+  orc_int8 var35;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_int8 *)ex->src_ptrs[0];
+
+    /* 1: loadpq */
+    var33.i = ((orc_union64 *)(ex->src_ptrs[1]))->i;
+    /* 2: loadpq */
+    var34.i = ((orc_union64 *)(ex->src_ptrs[2]))->i;
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var32 = ptr4[i];
+    /* 3: lut16b */
+    {
+       orc_uint8 _i = var32;
+       orc_uint64 _t = (_i & 8) ? (orc_uint64)var34.i : (orc_uint64)var33.i;
+       var35 = (_i < 16) ? (orc_uint8)(_t >> ((_i & 7) * 8)) : 0;
+    }
+    /* 4: storeb */
+    ptr0[i] = var35;
+  }
+
+}
+
+void
+emulate_acccrc32cb (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  const orc_int8 * ORC_RESTRICT ptr4;
+  orc_union32 var12 =  { ((orc_union32 *)ex->dest_ptrs[0])->i };
+  orc_int8 var32;
+
+  ptr4 = (orc_int8 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var32 = ptr4[i];
+    /* 1: acccrc32cb */
+    {
+       orc_uint8 _b[1];
+       _b[0] = (orc_uint8)((orc_uint8)var32 >> 0);
+       var12.i = orc_crc32c (var12.i, _b, 1);
+    }
+  }
+  ((orc_union32 *)ex->dest_ptrs[0])->i = var12.i;
+
+}
+
+void
+emulate_acccrc32cw (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  const orc_union16 * ORC_RESTRICT ptr4;
+  orc_union32 var12 =  { ((orc_union32 *)ex->dest_ptrs[0])->i };
+  orc_union16 var32;
+
+  ptr4 = (orc_union16 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: acccrc32cw */
+    {
+       orc_uint8 _b[2];
+       _b[0] = (orc_uint8)((orc_uint16)var32.i >> 0);
+       _b[1] = (orc_uint8)((orc_uint16)var32.i >> 8);
+       var12.i = orc_crc32c (var12.i, _b, 2);
+    }
+  }
+  ((orc_union32 *)ex->dest_ptrs[0])->i = var12.i;
+
+}
+
+void
+emulate_acccrc32cl (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  const orc_union32 * ORC_RESTRICT ptr4;
+  orc_union32 var12 =  { ((orc_union32 *)ex->dest_ptrs[0])->i };
+  orc_union32 var32;
+
+  ptr4 = (orc_union32 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadl */
+    var32 = ptr4[i];
+    /* 1: acccrc32cl */
+    {
+       orc_uint8 _b[4];
+       _b[0] = (orc_uint8)((orc_uint32)var32.i >> 0);
+       _b[1] = (orc_uint8)((orc_uint32)var32.i >> 8);
+       _b[2] = (orc_uint8)((orc_uint32)var32.i >> 16);
+       _b[3] = (orc_uint8)((orc_uint32)var32.i >> 24);
+       var12.i = orc_crc32c (var12.i, _b, 4);
+    }
+  }
+  ((orc_union32 *)ex->dest_ptrs[0])->i = var12.i;
+
+}
+
+void
+emulate_acccrc32cq (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union32 var12 =  { ((orc_union32 *)ex->dest_ptrs[0])->i };
+  orc_union64 var32;
+
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: acccrc32cq */
+    {
+       orc_uint8 _b[8];
+       _b[0] = (orc_uint8)((orc_uint64)var32.i >> 0);
+       _b[1] = (orc_uint8)((orc_uint64)var32.i >> 8);
+       _b[2] = (orc_uint8)((orc_uint64)var32.i >> 16);
+       _b[3] = (orc_uint8)((orc_uint64)var32.i >> 24);
+       _b[4] = (orc_uint8)((orc_uint64)var32.i >> 32);
+       _b[5] = (orc_uint8)((orc_uint64)var32.i >> 40);
+       _b[6] = (orc_uint8)((orc_uint64)var32.i >> 48);
+       _b[7] = (orc_uint8)((orc_uint64)var32.i >> 56);
+       var12.i = orc_crc32c (var12.i, _b, 8);
+    }
+  }
+  ((orc_union32 *)ex->dest_ptrs[0])->i = var12.i;
+
+}
+
+void
+emulate_absdiffub (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_int8 * ORC_RESTRICT ptr0;
+  const orc_int8 * ORC_RESTRICT ptr4;
+  const orc_int8 * ORC_RESTRICT ptr5;
+  orc_int8 var32;
+  orc_int8 var33;
+  orc_int8 var34;
+
+  ptr0 = (orc_int8 *)ex->dest_ptrs[0];
+  ptr4 = (orc_int8 *)ex->src_ptrs[0];
+  ptr5 = (orc_int8 *)ex->src_ptrs[1];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadb */
+    var32 = ptr4[i];
+    /* 1: loadb */
+    var33 = ptr5[i];
+    /* 2: absdiffub */
+    var34 = ORC_ABS((orc_int32)(orc_uint8)var32 - (orc_int32)(orc_uint8)var33);
+    /* 3: storeb */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+emulate_absdiffuw (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union16 * ORC_RESTRICT ptr0;
+  const orc_union16 * ORC_RESTRICT ptr4;
+  const orc_union16 * ORC_RESTRICT ptr5;
+  orc_union16 var32;
+  orc_union16 var33;
+  orc_union16 var34;
+
+  ptr0 = (orc_union16 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union16 *)ex->src_ptrs[0];
+  ptr5 = (orc_union16 *)ex->src_ptrs[1];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadw */
+    var32 = ptr4[i];
+    /* 1: loadw */
+    var33 = ptr5[i];
+    /* 2: absdiffuw */
+    var34.i = ORC_ABS((orc_int32)(orc_uint16)var32.i - (orc_int32)(orc_uint16)var33.i);
+    /* 3: storew */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+emulate_sadubq (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union64 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  const orc_union64 * ORC_RESTRICT ptr5;
+  orc_union64 var32;
+  orc_union64 var33;
+  orc_union64 var34;
+
+  ptr0 = (orc_union64 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+  ptr5 = (orc_union64 *)ex->src_ptrs[1];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: loadq */
+    var33 = ptr5[i];
+    /* 2: sadubq */
+    {
+       orc_uint32 _s = 0;
+       int _k;
+       for (_k = 0; _k < 64; _k += 8)
+         _s += ORC_ABS((orc_int32)(orc_uint8)((orc_uint64)var32.i >> _k) -
+             (orc_int32)(orc_uint8)((orc_uint64)var33.i >> _k));
+       var34.i = _s;
+    }
+    /* 3: storeq */
+    ptr0[i] = var34;
+  }
+
+}
+
+void
+emulate_minposuwl (OrcOpcodeExecutor *ex, int offset, int n)
+{
+  int i;
+  orc_union32 * ORC_RESTRICT ptr0;
+  const orc_union64 * ORC_RESTRICT ptr4;
+  orc_union64 var32;
+  orc_union32 var33;
+
+  ptr0 = (orc_union32 *)ex->dest_ptrs[0];
+  ptr4 = (orc_union64 *)ex->src_ptrs[0];
+
+
+  for (i = 0; i < n; i++) {
+    /* 0: loadq */
+    var32 = ptr4[i];
+    /* 1: minposuwl */
+    {
+       orc_uint32 _m = (orc_uint16)var32.i;
+       orc_uint32 _w;
+       int _k;
+       for (_k = 1; _k < 4; _k++) {
+         _w = (orc_uint16)((orc_uint64)var32.i >> (_k * 16));
+         if (_w < (_m & 0xffff)) _m = _w | (_k << 16);
+       }
+       var33.i = _m;
+    }
+    /* 2: storel */
+    ptr0[i] = var33;
+  }
+
+}
+
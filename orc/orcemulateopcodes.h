@@ -201,6 +201,37 @@ void emulate_convdf (OrcOpcodeExecutor *ex, int i, int n);
 void emulate_orf (OrcOpcodeExecutor *ex, int i, int n);
 void emulate_andf (OrcOpcodeExecutor *ex, int i, int n);
 void emulate_convwf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_fmaf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_fmad (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_mulcf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_mulcjf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_magsqcf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_addpb (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_addpw (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_addpl (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_addpf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_avgpub (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_avgpuw (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_avgpul (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_avgpf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_randl (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_randf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_randtf (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_unpack3x10 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_pack3x10 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_ldunpack4x10 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_stpack4x10 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_ldunpack2x12 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_stpack2x12 (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_lut16b (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_acccrc32cb (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_acccrc32cw (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_acccrc32cl (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_acccrc32cq (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_absdiffub (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_absdiffuw (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_sadubq (OrcOpcodeExecutor *ex, int offset, int n);
+void emulate_minposuwl (OrcOpcodeExecutor *ex, int offset, int n);
 
 #endif
 
@@ -1,4 +1,7 @@
 
+/* the probes of orc_executor_run() are guarded by semaphores */
+#define _SDT_HAS_SEMAPHORES 1
+
 #include "config.h"
 
 #include <stdio.h>
@@ -7,6 +10,7 @@
 
 #include <orc/orcprogram.h>
 #include <orc/orcdebug.h>
+#include <orc/orcinternal.h>
 
 /**
  * SECTION:orcexecutor
@@ -35,16 +39,67 @@ orc_executor_free (OrcExecutor *ex)
   free (ex);
 }
 
+#ifdef HAVE_SYS_SDT_H
+ORC_PROBE_SEMAPHORE (run_start);
+ORC_PROBE_SEMAPHORE (run_done);
+ORC_PROBE_SEMAPHORE (emulate);
+
+/* The backend that runs func, for the probes */
+static const char *
+orc_executor_get_backend (OrcExecutor *ex, OrcExecutorFunc func)
+{
+  OrcCode *code;
+
+  if (func == NULL || func == orc_executor_emulate) return "emulate";
+  if (ex->program) {
+    if ((void *)func == ex->program->backup_func) return "backup";
+    code = ex->program->orccode;
+  } else {
+    code = (OrcCode *)ex->arrays[ORC_VAR_A2];
+  }
+  if (code == NULL || code->target_name == NULL) return "unknown";
+
+  return code->target_name;
+}
+
+static int
+orc_executor_get_probe_m (OrcExecutor *ex)
+{
+  OrcCode *code;
+
+  if (ex->program) {
+    if (ex->program->is_2d) return ORC_EXECUTOR_M(ex);
+    return 1;
+  }
+  code = (OrcCode *)ex->arrays[ORC_VAR_A2];
+  return code && code->is_2d ? ORC_EXECUTOR_M(ex) : 1;
+}
+#endif
+
 void
 orc_executor_run (OrcExecutor *ex)
 {
   OrcExecutorFunc func = NULL;
 
+  /* the code may be replaced by another thread while it runs, see
+   * orc_code_replace() */
+  orc_code_enter ();
   if (ex->program) {
-    func = ex->program->code_exec;
+    OrcCode *code = ex->program->orccode;
+
+    /* the code of the program may be shared with programs that replaced it */
+    if (code) {
+      func = orc_atomic_load (&code->exec);
+    } else {
+      func = orc_atomic_load (&ex->program->code_exec);
+    }
   } else {
     OrcCode *code = (OrcCode *)ex->arrays[ORC_VAR_A2];
-    func = code->exec;
+    func = orc_atomic_load (&code->exec);
+  }
+  if (ORC_PROBE_ENABLED (run_start)) {
+    ORC_PROBE4 (run_start, ex->program ? ex->program->name : NULL, ex->n,
+        orc_executor_get_probe_m (ex), orc_executor_get_backend (ex, func));
   }
   if (func) {
     func (ex);
@@ -52,6 +107,11 @@ orc_executor_run (OrcExecutor *ex)
   } else {
     orc_executor_emulate (ex);
   }
+  if (ORC_PROBE_ENABLED (run_done)) {
+    ORC_PROBE4 (run_done, ex->program ? ex->program->name : NULL, ex->n,
+        orc_executor_get_probe_m (ex), orc_executor_get_backend (ex, func));
+  }
+  orc_code_leave ();
 }
 
 void
@@ -73,10 +133,250 @@ orc_executor_run_backup (OrcExecutor *ex)
   }
 }
 
+/* Smallest number of elements a non-final 1D chunk may cover, so that
+ * every chunk keeps the n_multiple and array alignment guarantees the
+ * program was compiled with. */
+static int
+orc_executor_get_chunk_granularity (OrcExecutor *ex)
+{
+  OrcProgram *p = ex->program;
+  int unit = 1;
+  int i;
+
+  if (p == NULL) return 1;
+
+  if (p->n_multiple > 1) unit = p->n_multiple;
+  for(i=ORC_VAR_D1;i<=ORC_VAR_S8;i++){
+    OrcVariable *var = p->vars + i;
+
+    if (var->size && var->alignment > var->size) {
+      unit = MAX (unit, var->alignment / var->size);
+    }
+  }
+
+  return unit;
+}
+
+/* The rand opcodes count elements from the start of each run, so a
+ * resumed run moves their seeds ahead by the elements already done.
+ * Constant seeds can't be moved, which is reported by returning FALSE. */
+static int
+orc_executor_skip_rand (OrcExecutor *ex, OrcCode *code, int skip)
+{
+  int done = 0;
+  int i;
+
+  for(i=0;i<code->n_insns;i++){
+    OrcInstruction *insn = code->insns + i;
+    int var = insn->src_args[0];
+
+    if (!(insn->opcode->flags & ORC_STATIC_OPCODE_INDEX)) continue;
+    if (code->vars[var].vartype != ORC_VAR_TYPE_PARAM) return FALSE;
+    if (done & (1 << (var - ORC_VAR_P1))) continue;
+    done |= 1 << (var - ORC_VAR_P1);
+
+    ex->params[var] = (orc_uint32)ex->params[var] +
+      (orc_uint32)skip * ORC_RAND_MULTIPLIER_INV;
+  }
+
+  return TRUE;
+}
+
+/* Packed arrays advance by more than their variable size per element,
+ * and the upsampling (loadupdb, loadupib) and resampling (ldres*) loads
+ * read their source at a position scaled from the element index, so a
+ * 1D run can't be resumed part way through programs using them. */
+static int
+orc_executor_has_unsplittable_opcode (OrcCode *code)
+{
+  int i;
+
+  for(i=0;i<code->n_insns;i++){
+    OrcStaticOpcode *opcode = code->insns[i].opcode;
+
+    if (opcode->flags & (ORC_STATIC_OPCODE_PACKED |
+          ORC_STATIC_OPCODE_ITERATOR)) return TRUE;
+    if (strncmp (opcode->name, "ldres", 5) == 0) return TRUE;
+  }
+
+  return FALSE;
+}
+
+/* CRC accumulators are chained rather than summed across parts; returns
+ * the element size of the CRC opcode writing var, or 0 if none does */
+static int
+orc_executor_get_crc_size (OrcCode *code, int var)
+{
+  int i;
+
+  for(i=0;i<code->n_insns;i++){
+    OrcInstruction *insn = code->insns + i;
+
+    if ((insn->opcode->flags & ORC_STATIC_OPCODE_CRC) &&
+        insn->dest_args[0] == var) {
+      return insn->opcode->src_size[0];
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * orc_executor_run_partial:
+ * @ex: an OrcExecutor
+ * @max: maximum number of rows (2D programs) or elements (1D programs)
+ *   to process, or 0 for all remaining
+ *
+ * Runs the next part of the program, starting where the previous call
+ * stopped.  The position is kept in the executor and accumulators are
+ * summed (CRC accumulators are chained) across calls, so a series of
+ * partial runs produces the same destinations and accumulators as a
+ * single orc_executor_run().
+ *
+ * Arrays, strides, n and m must not be changed until the run finishes;
+ * orc_executor_reset_position() abandons a run in progress.  Programs
+ * with a constant n (or a constant m for 2D programs), with rand
+ * opcodes seeded from a constant, or 1D programs with packed loads or
+ * stores or with upsampling or resampling loads, cannot be split and
+ * are run in one go.
+ *
+ * Returns: the number of rows or elements left; 0 when the run has
+ * finished, after which the next call starts a new run.
+ */
+int
+orc_executor_run_partial (OrcExecutor *ex, int max)
+{
+  OrcCode *code = (OrcCode *)ex->arrays[ORC_VAR_A2];
+  void *arrays[ORC_VAR_S8 + 1];
+  int params[ORC_VAR_P8 - ORC_VAR_P1 + 1];
+  int accumulators[4];
+  int pos = ORC_EXECUTOR_POSITION(ex);
+  int total;
+  int count;
+  int n = ex->n;
+  int m = ORC_EXECUTOR_M(ex);
+  int i;
+
+  if (code == NULL) {
+    ORC_ERROR("attempt to run program that failed to compile");
+    ORC_ASSERT(0);
+  }
+
+  if ((code->is_2d ? code->constant_m :
+        (code->constant_n || orc_executor_has_unsplittable_opcode (code))) ||
+      !orc_executor_skip_rand (ex, code, 0)) {
+    orc_executor_run (ex);
+    ORC_EXECUTOR_POSITION(ex) = 0;
+    return 0;
+  }
+
+  total = code->is_2d ? m : n;
+  if (pos <= 0 || pos >= total) pos = 0;
+  count = total - pos;
+  if (max > 0 && max < count) {
+    count = max;
+    if (!code->is_2d && ex->program) {
+      int unit = orc_executor_get_chunk_granularity (ex);
+
+      count = MAX (count - count % unit, unit);
+      count = MAX (count, ex->program->n_minimum);
+      if (total - pos - count < ex->program->n_minimum) {
+        count = total - pos;
+      }
+      count = MIN (count, total - pos);
+    }
+  }
+
+  if (pos == 0) {
+    memset (accumulators, 0, sizeof(accumulators));
+  } else {
+    memcpy (accumulators, ex->accumulators, sizeof(accumulators));
+  }
+
+  memcpy (arrays, ex->arrays, sizeof(arrays));
+  for(i=ORC_VAR_D1;i<=ORC_VAR_S8;i++){
+    OrcCodeVariable *var = code->vars + i;
+
+    if (var->vartype != ORC_VAR_TYPE_SRC &&
+        var->vartype != ORC_VAR_TYPE_DEST) continue;
+    if (code->is_2d) {
+      ex->arrays[i] = ORC_PTR_OFFSET (ex->arrays[i], ex->params[i] * pos);
+    } else {
+      ex->arrays[i] = ORC_PTR_OFFSET (ex->arrays[i], var->size * pos);
+    }
+  }
+  if (code->is_2d) {
+    ORC_EXECUTOR_M(ex) = count;
+  } else {
+    ex->n = count;
+  }
+  memcpy (params, ex->params + ORC_VAR_P1, sizeof(params));
+  orc_executor_skip_rand (ex, code, code->is_2d ? pos * n : pos);
+
+  orc_executor_run (ex);
+
+  memcpy (ex->params + ORC_VAR_P1, params, sizeof(params));
+  memcpy (ex->arrays, arrays, sizeof(arrays));
+  ex->n = n;
+  ORC_EXECUTOR_M(ex) = m;
+
+  for(i=0;i<4;i++){
+    OrcCodeVariable *var = code->vars + ORC_VAR_A1 + i;
+    int crc_size;
+
+    if (var->vartype != ORC_VAR_TYPE_ACCUMULATOR) continue;
+    crc_size = orc_executor_get_crc_size (code, ORC_VAR_A1 + i);
+    if (crc_size) {
+      ex->accumulators[i] = orc_crc32c_combine (accumulators[i],
+          ex->accumulators[i],
+          (orc_uint64)count * (code->is_2d ? n : 1) * crc_size);
+      continue;
+    }
+    ex->accumulators[i] = (orc_uint32)ex->accumulators[i] +
+      (orc_uint32)accumulators[i];
+    if (var->size == 2) {
+      ex->accumulators[i] &= 0xffff;
+    }
+  }
+
+  pos += count;
+  if (pos >= total) pos = 0;
+  ORC_EXECUTOR_POSITION(ex) = pos;
+
+  return pos ? total - pos : 0;
+}
+
+/**
+ * orc_executor_get_position:
+ * @ex: an OrcExecutor
+ *
+ * Returns: the row (2D programs) or element (1D programs) at which the
+ * next orc_executor_run_partial() call resumes.
+ */
+int
+orc_executor_get_position (OrcExecutor *ex)
+{
+  return ORC_EXECUTOR_POSITION(ex);
+}
+
+/**
+ * orc_executor_reset_position:
+ * @ex: an OrcExecutor
+ *
+ * Abandons a partial run, so that the next orc_executor_run_partial()
+ * call starts from the beginning.
+ */
+void
+orc_executor_reset_position (OrcExecutor *ex)
+{
+  ORC_EXECUTOR_POSITION(ex) = 0;
+}
+
 void
 orc_executor_set_program (OrcExecutor *ex, OrcProgram *program)
 {
   ex->program = program;
+  ORC_EXECUTOR_POSITION(ex) = 0;
   if (program->code_exec) {
     ex->arrays[ORC_VAR_A1] = (void *)program->code_exec;
   } else {
@@ -254,6 +554,11 @@ orc_executor_emulate (OrcExecutor *ex)
     sprintf(name_placeholder, "<unnamed source @ %p>", ex);
   }
 
+  if (ORC_PROBE_ENABLED (emulate)) {
+    ORC_PROBE3 (emulate, name, ex->n,
+        code && code->is_2d ? ORC_EXECUTOR_M(ex) : 1);
+  }
+
   ex->accumulators[0] = 0;
   ex->accumulators[1] = 0;
   ex->accumulators[2] = 0;
@@ -364,6 +669,7 @@ orc_executor_emulate (OrcExecutor *ex)
       insn = code->insns + j;
       opcode = insn->opcode;
 
+      opcode_ex[j].index = m_index * ex->n;
       for(k=0;k<ORC_STATIC_OPCODE_N_SRC;k++) {
         OrcCodeVariable *var = code->vars + insn->src_args[k];
         if (opcode->src_size[k] == 0) continue;
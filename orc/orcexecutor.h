@@ -34,6 +34,7 @@ struct _OrcOpcodeExecutor {
   void *src_ptrs[ORC_STATIC_OPCODE_N_SRC];
   void *dest_ptrs[ORC_STATIC_OPCODE_N_DEST];
   int shift;
+  int index;
 };
 
 /**
@@ -59,6 +60,8 @@ struct _OrcExecutor {
   /* m_index is stored in params[ORC_VAR_A2] */
   /* elapsed time is stored in params[ORC_VAR_A3] */
   /* high half of params is stored in params[ORC_VAR_T1..] */
+  /* resume position of orc_executor_run_partial() is stored in params[ORC_VAR_T9] */
+  /* element index of the rand opcodes is stored in params[ORC_VAR_T10] */
 };
 
 /* the alternate view of OrcExecutor */
@@ -82,13 +85,17 @@ struct _OrcExecutorAlt {
   int unused4[8];
   int params[ORC_N_PARAMS];
   int params_hi[ORC_N_PARAMS];
-  int unused3[ORC_N_VARIABLES - ORC_VAR_T9];
+  int position;
+  int index;
+  int unused3[ORC_N_VARIABLES - ORC_VAR_T11];
   int accumulators[4];
 };
 #define ORC_EXECUTOR_EXEC(ex) ((OrcExecutorFunc)((ex)->arrays[ORC_VAR_A1]))
 #define ORC_EXECUTOR_M(ex) ((ex)->params[ORC_VAR_A1])
 #define ORC_EXECUTOR_M_INDEX(ex) ((ex)->params[ORC_VAR_A2])
 #define ORC_EXECUTOR_TIME(ex) ((ex)->params[ORC_VAR_A3])
+#define ORC_EXECUTOR_POSITION(ex) ((ex)->params[ORC_VAR_T9])
+#define ORC_EXECUTOR_INDEX(ex) ((ex)->params[ORC_VAR_T10])
 
 
 
@@ -129,6 +136,12 @@ ORC_API void orc_executor_run (OrcExecutor *ex);
 
 ORC_API void orc_executor_run_backup (OrcExecutor *ex);
 
+ORC_API int orc_executor_run_partial (OrcExecutor *ex, int max);
+
+ORC_API int orc_executor_get_position (OrcExecutor *ex);
+
+ORC_API void orc_executor_reset_position (OrcExecutor *ex);
+
 
 ORC_END_DECLS
 
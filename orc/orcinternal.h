@@ -4,6 +4,8 @@
 
 #include <orc/orcutils.h>
 #include <orc/orclimits.h>
+#include <orc/orcbytecode.h>
+#include <orc/orcstats.h>
 
 ORC_BEGIN_DECLS
 
@@ -17,9 +19,12 @@ void orc_arm_init (void);
 void orc_powerpc_init (void);
 void orc_c_init (void);
 void orc_neon_init (void);
+void orc_sve_init (void);
 void orc_c64x_init (void);
 void orc_c64x_c_init (void);
 void orc_mips_init (void);
+void orc_lsx_init (void);
+void orc_lasx_init (void);
 
 typedef struct _OrcCodeRegion OrcCodeRegion;
 typedef struct _OrcCodeChunk OrcCodeChunk;
@@ -28,6 +33,47 @@ typedef struct _OrcCodeChunk OrcCodeChunk;
  */
 OrcCodeRegion * orc_code_region_alloc (void);
 void orc_code_chunk_free (OrcCodeChunk *chunk);
+void orc_code_chunk_retire (OrcCodeChunk *chunk);
+void _orc_code_epoch_init (void);
+
+/* USDT probes in the "orc" provider, listed in doc/running.xml */
+#ifdef HAVE_SYS_SDT_H
+#include <sys/sdt.h>
+#define ORC_PROBE2(name, a, b) DTRACE_PROBE2 (orc, name, a, b)
+#define ORC_PROBE3(name, a, b, c) DTRACE_PROBE3 (orc, name, a, b, c)
+#define ORC_PROBE4(name, a, b, c, d) DTRACE_PROBE4 (orc, name, a, b, c, d)
+/* Probes whose arguments cost something to compute are guarded with
+ * ORC_PROBE_ENABLED(), which reads the semaphore that the tracer sets
+ * while it is attached.  Files with such probes define
+ * _SDT_HAS_SEMAPHORES before including config.h and a semaphore with
+ * ORC_PROBE_SEMAPHORE() for each of their probes. */
+#define ORC_PROBE_SEMAPHORE(name) \
+  unsigned short orc_##name##_semaphore \
+  __attribute__ ((visibility ("hidden"), section (".probes")))
+#define ORC_PROBE_ENABLED(name) ORC_UNLIKELY (orc_##name##_semaphore)
+#else
+#define ORC_PROBE2(name, a, b)
+#define ORC_PROBE3(name, a, b, c)
+#define ORC_PROBE4(name, a, b, c, d)
+#define ORC_PROBE_ENABLED(name) 0
+#endif
+
+/* Accesses to code pointers and tiering state that change while other
+ * threads read them, see orccodemem.c.  orc_atomic_add() is unordered
+ * and returns the new value. */
+#if ORC_GNUC_PREREQ(4, 7) || ORC_CLANG_PREREQ(3, 1)
+#define ORC_HAVE_ATOMICS 1
+#define orc_atomic_load(p) __atomic_load_n ((p), __ATOMIC_ACQUIRE)
+#define orc_atomic_store(p, v) __atomic_store_n ((p), (v), __ATOMIC_RELEASE)
+#define orc_atomic_fence() __atomic_thread_fence (__ATOMIC_SEQ_CST)
+#define orc_atomic_add(p, v) __atomic_add_fetch ((p), (v), __ATOMIC_RELAXED)
+#else
+#define ORC_HAVE_ATOMICS 0
+#define orc_atomic_load(p) (*(p))
+#define orc_atomic_store(p, v) (*(p) = (v))
+#define orc_atomic_fence()
+#define orc_atomic_add(p, v) (*(p) += (v))
+#endif
 
 extern int _orc_data_cache_size_level1;
 extern int _orc_data_cache_size_level2;
@@ -40,6 +86,36 @@ extern const char *_orc_cpu_name;
 void orc_compiler_emit_invariants (OrcCompiler *compiler);
 int orc_program_has_float (OrcCompiler *compiler);
 
+OrcBytecode * orc_bytecode_from_program_body (OrcProgram *p);
+
+/* Collection of the numbers returned by orc_stats_get_phase_time() and
+ * friends, see orcstats.c.  Kept out of the public headers so that
+ * phases and counters can be added. */
+typedef struct _OrcStats {
+  orc_uint64 time[ORC_STATS_N_PHASES];
+  int count[ORC_STATS_N_PHASES];
+  int n_programs;
+  int n_insns;
+  int n_machine_insns;
+  orc_uint64 n_code_bytes;
+  int n_relaxation_iterations;
+  int n_regions;
+} OrcStats;
+
+orc_uint64 orc_stats_get_time (void);
+void orc_stats_add_time (OrcStats *stats, OrcStatsPhase phase,
+    orc_uint64 start);
+void orc_stats_merge (const OrcStats *stats);
+void orc_stats_add_phase (OrcStatsPhase phase, orc_uint64 start);
+
+/* Compiled code shared between programs with the same body, see orccode.c */
+OrcCode * orc_code_lookup_shared (OrcProgram *program, OrcTarget *target,
+    unsigned int flags);
+void orc_code_add_shared (OrcCode *code, OrcProgram *program,
+    OrcTarget *target, unsigned int flags);
+void orc_code_start_tiering (OrcCode *code, OrcProgram *program,
+    OrcTarget *target, unsigned int flags);
+
 char* _orc_getenv (const char *var);
 void orc_opcode_sys_init (void);
 
@@ -24,7 +24,7 @@ ORC_BEGIN_DECLS
 #define ORC_STATIC_OPCODE_N_DEST 2
 
 #define ORC_OPCODE_N_ARGS 4
-#define ORC_N_TARGETS 10
+#define ORC_N_TARGETS 16
 #define ORC_N_RULE_SETS 10
 
 #define ORC_MAX_VAR_SIZE 8
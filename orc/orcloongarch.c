@@ -0,0 +1,467 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcdebug.h>
+#include <orc/orcutils.h>
+#include <orc/orcloongarch.h>
+
+/* LASX instructions are the LSX ones with this bit set, except for
+ * loads, stores and element moves which are handled separately */
+#define LASX_BIT 0x04000000
+
+#define GP(r) ((r) - ORC_GP_REG_BASE)
+#define VR(r) ((r) - ORC_VEC_REG_BASE)
+
+enum {
+  FIXUP_1RI21,
+  FIXUP_2RI16
+};
+
+const char *
+orc_loongarch_reg_name (int reg)
+{
+  static const char *regs[] = {
+    "$zero", "$ra", "$tp", "$sp",
+    "$a0", "$a1", "$a2", "$a3", "$a4", "$a5", "$a6", "$a7",
+    "$t0", "$t1", "$t2", "$t3", "$t4", "$t5", "$t6", "$t7", "$t8",
+    "$r21", "$fp",
+    "$s0", "$s1", "$s2", "$s3", "$s4", "$s5", "$s6", "$s7", "$s8"
+  };
+
+  if (reg < ORC_GP_REG_BASE || reg >= ORC_GP_REG_BASE + 32)
+    return "ERROR";
+
+  return regs[reg - ORC_GP_REG_BASE];
+}
+
+static const char *
+loongarch_vec_name (int reg, int lasx)
+{
+  static const char *vregs[] = {
+    "$vr0", "$vr1", "$vr2", "$vr3", "$vr4", "$vr5", "$vr6", "$vr7",
+    "$vr8", "$vr9", "$vr10", "$vr11", "$vr12", "$vr13", "$vr14", "$vr15",
+    "$vr16", "$vr17", "$vr18", "$vr19", "$vr20", "$vr21", "$vr22", "$vr23",
+    "$vr24", "$vr25", "$vr26", "$vr27", "$vr28", "$vr29", "$vr30", "$vr31"
+  };
+  static const char *xregs[] = {
+    "$xr0", "$xr1", "$xr2", "$xr3", "$xr4", "$xr5", "$xr6", "$xr7",
+    "$xr8", "$xr9", "$xr10", "$xr11", "$xr12", "$xr13", "$xr14", "$xr15",
+    "$xr16", "$xr17", "$xr18", "$xr19", "$xr20", "$xr21", "$xr22", "$xr23",
+    "$xr24", "$xr25", "$xr26", "$xr27", "$xr28", "$xr29", "$xr30", "$xr31"
+  };
+
+  if (reg < ORC_VEC_REG_BASE || reg >= ORC_VEC_REG_BASE + 32)
+    return "ERROR";
+
+  if (lasx)
+    return xregs[reg - ORC_VEC_REG_BASE];
+  return vregs[reg - ORC_VEC_REG_BASE];
+}
+
+const char *
+orc_loongarch_vec_name (OrcCompiler *p, int reg)
+{
+  return loongarch_vec_name (reg, ORC_LOONGARCH_REG_SIZE (p) == 32);
+}
+
+static int
+loongarch_is_lasx (OrcCompiler *p)
+{
+  return ORC_LOONGARCH_REG_SIZE (p) == 32;
+}
+
+void
+orc_loongarch_emit (OrcCompiler *p, orc_uint32 insn)
+{
+  ORC_WRITE_UINT32_LE (p->codeptr, insn);
+  p->codeptr += 4;
+}
+
+void
+orc_loongarch_emit_label (OrcCompiler *p, int label)
+{
+  ORC_ASSERT (label < ORC_N_LABELS);
+
+  ORC_ASM_CODE (p, ".L%s%d:\n", p->program->name, label);
+  p->labels[label] = p->codeptr;
+}
+
+static void
+orc_loongarch_add_fixup (OrcCompiler *p, int label, int type)
+{
+  ORC_ASSERT (p->n_fixups < ORC_N_FIXUPS);
+
+  p->fixups[p->n_fixups].ptr = p->codeptr;
+  p->fixups[p->n_fixups].label = label;
+  p->fixups[p->n_fixups].type = type;
+  p->n_fixups++;
+}
+
+void
+orc_loongarch_do_fixups (OrcCompiler *p)
+{
+  int i;
+
+  for (i = 0; i < p->n_fixups; i++) {
+    unsigned char *label = p->labels[p->fixups[i].label];
+    unsigned char *ptr = p->fixups[i].ptr;
+    orc_uint32 code;
+    int offset;
+
+    /* branch offsets count instructions from the branch itself */
+    offset = (label - ptr) >> 2;
+    code = ORC_READ_UINT32_LE (ptr);
+    if (p->fixups[i].type == FIXUP_1RI21) {
+      if (offset < -(1 << 20) || offset >= (1 << 20)) {
+        ORC_COMPILER_ERROR (p, "branch out of range");
+      }
+      code |= ((offset & 0xffff) << 10) | ((offset >> 16) & 0x1f);
+    } else {
+      if (offset < -(1 << 15) || offset >= (1 << 15)) {
+        ORC_COMPILER_ERROR (p, "branch out of range");
+      }
+      code |= (offset & 0xffff) << 10;
+    }
+    ORC_WRITE_UINT32_LE (ptr, code);
+  }
+}
+
+void
+orc_loongarch_emit_branch (OrcCompiler *p, int cond, int rj, int rd,
+    int label)
+{
+  switch (cond) {
+    case ORC_LOONGARCH_BEQZ:
+    case ORC_LOONGARCH_BNEZ:
+      ORC_ASM_CODE (p, "  %s %s, .L%s%d\n",
+          cond == ORC_LOONGARCH_BEQZ ? "beqz" : "bnez",
+          orc_loongarch_reg_name (rj), p->program->name, label);
+      orc_loongarch_add_fixup (p, label, FIXUP_1RI21);
+      orc_loongarch_emit (p, (cond == ORC_LOONGARCH_BEQZ ? 0x40000000 :
+            0x44000000) | (GP (rj) << 5));
+      break;
+    case ORC_LOONGARCH_BGE:
+      ORC_ASM_CODE (p, "  bge %s, %s, .L%s%d\n", orc_loongarch_reg_name (rj),
+          orc_loongarch_reg_name (rd), p->program->name, label);
+      orc_loongarch_add_fixup (p, label, FIXUP_2RI16);
+      orc_loongarch_emit (p, 0x64000000 | (GP (rj) << 5) | GP (rd));
+      break;
+    default:
+      ORC_COMPILER_ERROR (p, "unknown branch type %d", cond);
+      break;
+  }
+}
+
+void
+orc_loongarch_emit_ret (OrcCompiler *p)
+{
+  ORC_ASM_CODE (p, "  ret\n");
+  /* jirl $zero, $ra, 0 */
+  orc_loongarch_emit (p, 0x4c000020);
+}
+
+void
+orc_loongarch_flush_cache (OrcCode *code)
+{
+#ifdef HAVE_LOONGARCH64
+  __builtin___clear_cache ((char *) code->code,
+      (char *) code->code + code->code_size);
+  if ((void *) code->exec != (void *) code->code)
+    __builtin___clear_cache ((char *) code->exec,
+        (char *) code->exec + code->code_size);
+#endif
+}
+
+/* general purpose instructions */
+
+void
+orc_loongarch_emit_add (OrcCompiler *p, int size, int rd, int rj, int rk)
+{
+  ORC_ASM_CODE (p, "  add.%c %s, %s, %s\n", size == 8 ? 'd' : 'w',
+      orc_loongarch_reg_name (rd), orc_loongarch_reg_name (rj),
+      orc_loongarch_reg_name (rk));
+  orc_loongarch_emit (p, (size == 8 ? 0x00108000 : 0x00100000) |
+      (GP (rk) << 10) | (GP (rj) << 5) | GP (rd));
+}
+
+void
+orc_loongarch_emit_or (OrcCompiler *p, int rd, int rj, int rk)
+{
+  if (rk == ORC_LOONGARCH_ZERO) {
+    ORC_ASM_CODE (p, "  move %s, %s\n", orc_loongarch_reg_name (rd),
+        orc_loongarch_reg_name (rj));
+  } else {
+    ORC_ASM_CODE (p, "  or %s, %s, %s\n", orc_loongarch_reg_name (rd),
+        orc_loongarch_reg_name (rj), orc_loongarch_reg_name (rk));
+  }
+  orc_loongarch_emit (p, 0x00150000 | (GP (rk) << 10) | (GP (rj) << 5) |
+      GP (rd));
+}
+
+void
+orc_loongarch_emit_addi (OrcCompiler *p, int size, int rd, int rj, int imm)
+{
+  ORC_ASSERT (imm >= -2048 && imm < 2048);
+
+  ORC_ASM_CODE (p, "  addi.%c %s, %s, %d\n", size == 8 ? 'd' : 'w',
+      orc_loongarch_reg_name (rd), orc_loongarch_reg_name (rj), imm);
+  orc_loongarch_emit (p, (size == 8 ? 0x02c00000 : 0x02800000) |
+      ((imm & 0xfff) << 10) | (GP (rj) << 5) | GP (rd));
+}
+
+void
+orc_loongarch_emit_andi (OrcCompiler *p, int rd, int rj, int imm)
+{
+  ORC_ASSERT (imm >= 0 && imm < 4096);
+
+  ORC_ASM_CODE (p, "  andi %s, %s, %d\n", orc_loongarch_reg_name (rd),
+      orc_loongarch_reg_name (rj), imm);
+  orc_loongarch_emit (p, 0x03400000 | (imm << 10) | (GP (rj) << 5) |
+      GP (rd));
+}
+
+void
+orc_loongarch_emit_shift_imm (OrcCompiler *p, const char *name,
+    orc_uint32 code, int rd, int rj, int imm)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s, %d\n", name, orc_loongarch_reg_name (rd),
+      orc_loongarch_reg_name (rj), imm);
+  orc_loongarch_emit (p, code | ((imm & 0x3f) << 10) | (GP (rj) << 5) |
+      GP (rd));
+}
+
+void
+orc_loongarch_emit_load_imm (OrcCompiler *p, int rd, orc_uint64 value)
+{
+  const orc_int64 v = (orc_int64) value;
+  const int lo = value & 0xfff;
+  const int hi = (value >> 12) & 0xfffff;
+
+  if (v >= -2048 && v < 2048) {
+    ORC_ASM_CODE (p, "  addi.w %s, $zero, %d\n", orc_loongarch_reg_name (rd),
+        (int) v);
+    orc_loongarch_emit (p, 0x02800000 | (lo << 10) | GP (rd));
+    return;
+  }
+
+  if (v >= 0 && v < 4096) {
+    ORC_ASM_CODE (p, "  ori %s, $zero, %d\n", orc_loongarch_reg_name (rd),
+        lo);
+    orc_loongarch_emit (p, 0x03800000 | (lo << 10) | GP (rd));
+    return;
+  }
+
+  /* lu12i.w sign extends bit 31 */
+  ORC_ASM_CODE (p, "  lu12i.w %s, %d\n", orc_loongarch_reg_name (rd),
+      (hi ^ 0x80000) - 0x80000);
+  orc_loongarch_emit (p, 0x14000000 | (hi << 5) | GP (rd));
+  if (lo) {
+    ORC_ASM_CODE (p, "  ori %s, %s, %d\n", orc_loongarch_reg_name (rd),
+        orc_loongarch_reg_name (rd), lo);
+    orc_loongarch_emit (p, 0x03800000 | (lo << 10) | (GP (rd) << 5) |
+        GP (rd));
+  }
+
+  if (v != (orc_int64) (orc_int32) value) {
+    const int hi32 = (value >> 32) & 0xfffff;
+    const int hi52 = (value >> 52) & 0xfff;
+
+    ORC_ASM_CODE (p, "  lu32i.d %s, %d\n", orc_loongarch_reg_name (rd),
+        (hi32 ^ 0x80000) - 0x80000);
+    orc_loongarch_emit (p, 0x16000000 | (hi32 << 5) | GP (rd));
+    ORC_ASM_CODE (p, "  lu52i.d %s, %s, %d\n", orc_loongarch_reg_name (rd),
+        orc_loongarch_reg_name (rd), (hi52 ^ 0x800) - 0x800);
+    orc_loongarch_emit (p, 0x03000000 | (hi52 << 10) | (GP (rd) << 5) |
+        GP (rd));
+  }
+}
+
+void
+orc_loongarch_emit_ld (OrcCompiler *p, int size, int is_unsigned, int rd,
+    int rj, int offset)
+{
+  static const char *names[] = { "ld.b", "ld.h", "ld.w", "ld.d" };
+  static const char *unames[] = { "ld.bu", "ld.hu", "ld.wu", "ld.d" };
+  static const orc_uint32 codes[] =
+      { 0x28000000, 0x28400000, 0x28800000, 0x28c00000 };
+  static const orc_uint32 ucodes[] =
+      { 0x2a000000, 0x2a400000, 0x2a800000, 0x28c00000 };
+  const int i = size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3;
+
+  ORC_ASSERT (offset >= -2048 && offset < 2048);
+
+  ORC_ASM_CODE (p, "  %s %s, %s, %d\n", is_unsigned ? unames[i] : names[i],
+      orc_loongarch_reg_name (rd), orc_loongarch_reg_name (rj), offset);
+  orc_loongarch_emit (p, (is_unsigned ? ucodes[i] : codes[i]) |
+      ((offset & 0xfff) << 10) | (GP (rj) << 5) | GP (rd));
+}
+
+void
+orc_loongarch_emit_st (OrcCompiler *p, int size, int rd, int rj, int offset)
+{
+  static const char *names[] = { "st.b", "st.h", "st.w", "st.d" };
+  static const orc_uint32 codes[] =
+      { 0x29000000, 0x29400000, 0x29800000, 0x29c00000 };
+  const int i = size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3;
+
+  ORC_ASSERT (offset >= -2048 && offset < 2048);
+
+  ORC_ASM_CODE (p, "  %s %s, %s, %d\n", names[i],
+      orc_loongarch_reg_name (rd), orc_loongarch_reg_name (rj), offset);
+  orc_loongarch_emit (p, codes[i] | ((offset & 0xfff) << 10) |
+      (GP (rj) << 5) | GP (rd));
+}
+
+/* vector instructions */
+
+void
+orc_loongarch_emit_3r (OrcCompiler *p, const char *name, orc_uint32 code,
+    int vd, int vj, int vk)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  ORC_ASM_CODE (p, "  %s%s %s, %s, %s\n", lasx ? "x" : "", name,
+      orc_loongarch_vec_name (p, vd), orc_loongarch_vec_name (p, vj),
+      orc_loongarch_vec_name (p, vk));
+  orc_loongarch_emit (p, code | (lasx ? LASX_BIT : 0) | (VR (vk) << 10) |
+      (VR (vj) << 5) | VR (vd));
+}
+
+void
+orc_loongarch_emit_2ri (OrcCompiler *p, const char *name, orc_uint32 code,
+    int vd, int vj, int imm, int imm_bits)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  ORC_ASM_CODE (p, "  %s%s %s, %s, %d\n", lasx ? "x" : "", name,
+      orc_loongarch_vec_name (p, vd), orc_loongarch_vec_name (p, vj), imm);
+  orc_loongarch_emit (p, code | (lasx ? LASX_BIT : 0) |
+      ((imm & ((1 << imm_bits) - 1)) << 10) | (VR (vj) << 5) | VR (vd));
+}
+
+void
+orc_loongarch_emit_vmov (OrcCompiler *p, int vd, int vj)
+{
+  if (vd == vj)
+    return;
+  orc_loongarch_emit_2ri (p, "vori.b", 0x73d40000, vd, vj, 0, 8);
+}
+
+void
+orc_loongarch_emit_vzero (OrcCompiler *p, int vd)
+{
+  orc_loongarch_emit_3r (p, "vxor.v", 0x71270000, vd, vd, vd);
+}
+
+/* Whole registers use vld/xvld, smaller chunks are loaded with
+ * vldrepl which fills every element with the data; only the low part of
+ * such a register is meaningful. */
+void
+orc_loongarch_emit_vload (OrcCompiler *p, int bytes, int vd, int rj,
+    int offset)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  if (bytes >= 16) {
+    const int x = bytes == 32;
+
+    ORC_ASSERT (bytes == 16 || lasx);
+    ORC_ASM_CODE (p, "  %s %s, %s, %d\n", x ? "xvld" : "vld",
+        loongarch_vec_name (vd, x), orc_loongarch_reg_name (rj), offset);
+    orc_loongarch_emit (p, (x ? 0x2c800000 : 0x2c000000) |
+        ((offset & 0xfff) << 10) | (GP (rj) << 5) | VR (vd));
+  } else {
+    static const char *names[] =
+        { "vldrepl.b", "vldrepl.h", "vldrepl.w", "vldrepl.d" };
+    static const orc_uint32 codes[] =
+        { 0x30800000, 0x30400000, 0x30200000, 0x30100000 };
+    const int shift = bytes == 1 ? 0 : bytes == 2 ? 1 : bytes == 4 ? 2 : 3;
+
+    ORC_ASM_CODE (p, "  %s%s %s, %s, %d\n", lasx ? "x" : "", names[shift],
+        orc_loongarch_vec_name (p, vd), orc_loongarch_reg_name (rj), offset);
+    orc_loongarch_emit (p, codes[shift] | (lasx ? 0x02000000 : 0) |
+        (((offset >> shift) & ((1 << (12 - shift)) - 1)) << 10) |
+        (GP (rj) << 5) | VR (vd));
+  }
+}
+
+void
+orc_loongarch_emit_vstore (OrcCompiler *p, int bytes, int vd, int rj,
+    int offset)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  if (bytes >= 16) {
+    const int x = bytes == 32;
+
+    ORC_ASSERT (bytes == 16 || lasx);
+    ORC_ASM_CODE (p, "  %s %s, %s, %d\n", x ? "xvst" : "vst",
+        loongarch_vec_name (vd, x), orc_loongarch_reg_name (rj), offset);
+    orc_loongarch_emit (p, (x ? 0x2cc00000 : 0x2c400000) |
+        ((offset & 0xfff) << 10) | (GP (rj) << 5) | VR (vd));
+  } else {
+    static const char *names[] =
+        { "vstelm.b", "vstelm.h", "vstelm.w", "vstelm.d" };
+    static const orc_uint32 codes[] =
+        { 0x31800000, 0x31400000, 0x31200000, 0x31100000 };
+    const int shift = bytes == 1 ? 0 : bytes == 2 ? 1 : bytes == 4 ? 2 : 3;
+
+    /* element 0, the offset is scaled by the element size */
+    ORC_ASM_CODE (p, "  %s%s %s, %s, %d, 0\n", lasx ? "x" : "", names[shift],
+        orc_loongarch_vec_name (p, vd), orc_loongarch_reg_name (rj), offset);
+    orc_loongarch_emit (p, codes[shift] | (lasx ? 0x02000000 : 0) |
+        (((offset >> shift) & 0xff) << 10) | (GP (rj) << 5) | VR (vd));
+  }
+}
+
+void
+orc_loongarch_emit_vreplgr2vr (OrcCompiler *p, int size, int vd, int rj)
+{
+  static const char *names[] =
+      { "vreplgr2vr.b", "vreplgr2vr.h", "vreplgr2vr.w", "vreplgr2vr.d" };
+  const int i = size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3;
+  const int lasx = loongarch_is_lasx (p);
+
+  ORC_ASM_CODE (p, "  %s%s %s, %s\n", lasx ? "x" : "", names[i],
+      orc_loongarch_vec_name (p, vd), orc_loongarch_reg_name (rj));
+  orc_loongarch_emit (p, (0x729f0000 | (i << 10)) | (lasx ? LASX_BIT : 0) |
+      (GP (rj) << 5) | VR (vd));
+}
+
+void
+orc_loongarch_emit_vinsgr2vr_d (OrcCompiler *p, int vd, int rj, int index)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  ORC_ASM_CODE (p, "  %s %s, %s, %d\n", lasx ? "xvinsgr2vr.d" : "vinsgr2vr.d",
+      orc_loongarch_vec_name (p, vd), orc_loongarch_reg_name (rj), index);
+  orc_loongarch_emit (p, (lasx ? 0x76ebe000 : 0x72ebf000) | (index << 10) |
+      (GP (rj) << 5) | VR (vd));
+}
+
+void
+orc_loongarch_emit_vpickve2gr_w (OrcCompiler *p, int rd, int vj, int index)
+{
+  const int lasx = loongarch_is_lasx (p);
+
+  ORC_ASM_CODE (p, "  %s %s, %s, %d\n",
+      lasx ? "xvpickve2gr.w" : "vpickve2gr.w", orc_loongarch_reg_name (rd),
+      orc_loongarch_vec_name (p, vj), index);
+  orc_loongarch_emit (p, (lasx ? 0x76efc000 : 0x72efe000) | (index << 10) |
+      (VR (vj) << 5) | GP (rd));
+}
+
+void
+orc_loongarch_emit_xvpermi_d (OrcCompiler *p, int vd, int vj, int imm)
+{
+  ORC_ASSERT (loongarch_is_lasx (p));
+
+  ORC_ASM_CODE (p, "  xvpermi.d %s, %s, %d\n", orc_loongarch_vec_name (p, vd),
+      orc_loongarch_vec_name (p, vj), imm);
+  orc_loongarch_emit (p, 0x77e80000 | ((imm & 0xff) << 10) | (VR (vj) << 5) |
+      VR (vd));
+}
@@ -0,0 +1,146 @@
+#ifndef _ORC_LOONGARCH_H_
+#define _ORC_LOONGARCH_H_
+
+#include <orc/orc.h>
+
+ORC_BEGIN_DECLS
+
+#ifdef ORC_ENABLE_UNSTABLE_API
+
+/* Common code of the LSX and LASX targets, in the same spirit as
+ * OrcX86Target: the loop is generated by orcprogram-loongarch.c and
+ * each vector width only provides what differs.
+ */
+typedef struct _OrcLoongArchTarget
+{
+  /* Same as OrcTarget */
+  const char *name;
+  unsigned int (*get_default_flags)(void);
+  const char * (*get_flag_name)(int shift);
+  int (*is_executable)(void);
+
+  /* LoongArch specific */
+  void (*reduce_accumulator)(OrcCompiler *c, int i, OrcVariable *var);
+  int register_size;
+} OrcLoongArchTarget;
+
+typedef enum {
+  ORC_LOONGARCH_ZERO = ORC_GP_REG_BASE,
+  ORC_LOONGARCH_RA,
+  ORC_LOONGARCH_TP,
+  ORC_LOONGARCH_SP,
+  ORC_LOONGARCH_A0,
+  ORC_LOONGARCH_A1,
+  ORC_LOONGARCH_A2,
+  ORC_LOONGARCH_A3,
+  ORC_LOONGARCH_A4,
+  ORC_LOONGARCH_A5,
+  ORC_LOONGARCH_A6,
+  ORC_LOONGARCH_A7,
+  ORC_LOONGARCH_T0,
+  ORC_LOONGARCH_T1,
+  ORC_LOONGARCH_T2,
+  ORC_LOONGARCH_T3,
+  ORC_LOONGARCH_T4,
+  ORC_LOONGARCH_T5,
+  ORC_LOONGARCH_T6,
+  ORC_LOONGARCH_T7,
+  ORC_LOONGARCH_T8,
+  ORC_LOONGARCH_R21,
+  ORC_LOONGARCH_FP,
+  ORC_LOONGARCH_S0,
+  ORC_LOONGARCH_S1,
+  ORC_LOONGARCH_S2,
+  ORC_LOONGARCH_S3,
+  ORC_LOONGARCH_S4,
+  ORC_LOONGARCH_S5,
+  ORC_LOONGARCH_S6,
+  ORC_LOONGARCH_S7,
+  ORC_LOONGARCH_S8
+} OrcLoongArchRegister;
+
+/* general purpose registers with a fixed role in the loop */
+#define ORC_LOONGARCH_COUNTER_REG ORC_LOONGARCH_A2
+#define ORC_LOONGARCH_TAIL_REG ORC_LOONGARCH_A3
+#define ORC_LOONGARCH_OUTER_REG ORC_LOONGARCH_A4
+#define ORC_LOONGARCH_TMP_REG ORC_LOONGARCH_A5
+
+/* width in bytes of the vector registers of the target being compiled */
+#define ORC_LOONGARCH_REG_SIZE(p) \
+  (((OrcLoongArchTarget *)(p)->target->target_data)->register_size)
+
+enum {
+  ORC_LOONGARCH_BEQZ,
+  ORC_LOONGARCH_BNEZ,
+  ORC_LOONGARCH_BGE
+};
+
+ORC_API unsigned long orc_loongarch_get_cpu_flags (void);
+
+ORC_API OrcTarget *orc_loongarch_register_target (OrcLoongArchTarget *t);
+ORC_API void orc_loongarch_lsx_register_rules (OrcTarget *target);
+ORC_API void orc_loongarch_lasx_register_rules (OrcTarget *target);
+
+ORC_API const char *orc_loongarch_reg_name (int reg);
+ORC_API const char *orc_loongarch_vec_name (OrcCompiler *p, int reg);
+
+ORC_API void orc_loongarch_emit (OrcCompiler *p, orc_uint32 insn);
+ORC_API void orc_loongarch_emit_label (OrcCompiler *p, int label);
+ORC_API void orc_loongarch_emit_branch (OrcCompiler *p, int cond, int rj,
+    int rd, int label);
+ORC_API void orc_loongarch_emit_ret (OrcCompiler *p);
+ORC_API void orc_loongarch_do_fixups (OrcCompiler *p);
+ORC_API void orc_loongarch_flush_cache (OrcCode *code);
+
+ORC_API void orc_loongarch_emit_add (OrcCompiler *p, int size, int rd,
+    int rj, int rk);
+ORC_API void orc_loongarch_emit_or (OrcCompiler *p, int rd, int rj, int rk);
+ORC_API void orc_loongarch_emit_addi (OrcCompiler *p, int size, int rd,
+    int rj, int imm);
+ORC_API void orc_loongarch_emit_andi (OrcCompiler *p, int rd, int rj,
+    int imm);
+ORC_API void orc_loongarch_emit_shift_imm (OrcCompiler *p, const char *name,
+    orc_uint32 code, int rd, int rj, int imm);
+ORC_API void orc_loongarch_emit_load_imm (OrcCompiler *p, int rd,
+    orc_uint64 value);
+ORC_API void orc_loongarch_emit_ld (OrcCompiler *p, int size, int is_unsigned,
+    int rd, int rj, int offset);
+ORC_API void orc_loongarch_emit_st (OrcCompiler *p, int size, int rd,
+    int rj, int offset);
+
+#define orc_loongarch_emit_slli_w(p,rd,rj,imm) \
+  orc_loongarch_emit_shift_imm (p, "slli.w", 0x00408000, rd, rj, imm)
+#define orc_loongarch_emit_srli_w(p,rd,rj,imm) \
+  orc_loongarch_emit_shift_imm (p, "srli.w", 0x00448000, rd, rj, imm)
+#define orc_loongarch_emit_srai_w(p,rd,rj,imm) \
+  orc_loongarch_emit_shift_imm (p, "srai.w", 0x00488000, rd, rj, imm)
+#define orc_loongarch_emit_slli_d(p,rd,rj,imm) \
+  orc_loongarch_emit_shift_imm (p, "slli.d", 0x00410000, rd, rj, imm)
+
+/* Vector instructions.  The codes are the LSX ones, the LASX form of an
+ * instruction is emitted when compiling for a 32 byte target. */
+ORC_API void orc_loongarch_emit_3r (OrcCompiler *p, const char *name,
+    orc_uint32 code, int vd, int vj, int vk);
+ORC_API void orc_loongarch_emit_2ri (OrcCompiler *p, const char *name,
+    orc_uint32 code, int vd, int vj, int imm, int imm_bits);
+ORC_API void orc_loongarch_emit_vmov (OrcCompiler *p, int vd, int vj);
+ORC_API void orc_loongarch_emit_vzero (OrcCompiler *p, int vd);
+ORC_API void orc_loongarch_emit_vload (OrcCompiler *p, int bytes, int vd,
+    int rj, int offset);
+ORC_API void orc_loongarch_emit_vstore (OrcCompiler *p, int bytes, int vd,
+    int rj, int offset);
+ORC_API void orc_loongarch_emit_vreplgr2vr (OrcCompiler *p, int size,
+    int vd, int rj);
+ORC_API void orc_loongarch_emit_vinsgr2vr_d (OrcCompiler *p, int vd, int rj,
+    int index);
+ORC_API void orc_loongarch_emit_vpickve2gr_w (OrcCompiler *p, int rd, int vj,
+    int index);
+ORC_API void orc_loongarch_emit_xvpermi_d (OrcCompiler *p, int vd, int vj,
+    int imm);
+
+#endif
+
+ORC_END_DECLS
+
+#endif
+
@@ -35,6 +35,26 @@ struct _OrcOpcodeSet {
 #define ORC_STATIC_OPCODE_INVARIANT (1<<6)
 #define ORC_STATIC_OPCODE_ITERATOR (1<<7)
 #define ORC_STATIC_OPCODE_COPY (1<<8)
+/* operands are interleaved (re,im) pairs of 32-bit floats */
+#define ORC_STATIC_OPCODE_COMPLEX (1<<9)
+/* result depends on the element index within the run (rand opcodes) */
+#define ORC_STATIC_OPCODE_INDEX (1<<10)
+/* the byte array operand holds several bytes per element (packed
+ * load/store opcodes) */
+#define ORC_STATIC_OPCODE_PACKED (1<<11)
+/* the scalar sources form a small lookup table; they are loaded into
+ * registers like other parameters and do not limit the vector width */
+#define ORC_STATIC_OPCODE_TABLE (1<<12)
+/* the accumulator holds a CRC-32C of the source bytes; partial results
+ * are chained with orc_crc32c_combine() instead of being added */
+#define ORC_STATIC_OPCODE_CRC (1<<13)
+
+/* The rand opcodes hash seed * ORC_RAND_MULTIPLIER + index, where index
+ * counts elements from the start of the run (row * n + i for 2D
+ * programs).  ORC_RAND_MULTIPLIER_INV is its inverse modulo 2^32, so
+ * adding index * ORC_RAND_MULTIPLIER_INV to the seed skips ahead. */
+#define ORC_RAND_MULTIPLIER 0x9e3779b9U
+#define ORC_RAND_MULTIPLIER_INV 0x144cbc89U
 
 
 struct _OrcStaticOpcode {
@@ -58,6 +78,11 @@ ORC_API int orc_opcode_set_find_by_name (OrcOpcodeSet *opcode_set, const char *n
 
 ORC_API int orc_opcode_register_static (OrcStaticOpcode *sopcode, char *prefix);
 
+ORC_API orc_uint32 orc_crc32c (orc_uint32 crc, const orc_uint8 *data, int n);
+
+ORC_API orc_uint32 orc_crc32c_combine (orc_uint32 crc1, orc_uint32 crc2,
+    orc_uint64 len2);
+
 #ifdef ORC_ENABLE_UNSTABLE_API
 ORC_API OrcOpcodeSet * orc_opcode_set_find_by_opcode (OrcStaticOpcode * opcode);
 #endif
@@ -225,6 +225,37 @@ static OrcStaticOpcode opcodes[] = {
   { "orf", ORC_STATIC_OPCODE_FLOAT, { 4 }, { 4, 4 }, emulate_orf },
   { "andf", ORC_STATIC_OPCODE_FLOAT, { 4 }, { 4, 4 }, emulate_andf },
   { "convwf", ORC_STATIC_OPCODE_FLOAT_DEST, { 4 }, { 2 }, emulate_convwf },
+  { "fmaf", ORC_STATIC_OPCODE_FLOAT, { 4 }, { 4, 4, 4 }, emulate_fmaf },
+  { "fmad", ORC_STATIC_OPCODE_FLOAT, { 8 }, { 8, 8, 8 }, emulate_fmad },
+  { "mulcf", ORC_STATIC_OPCODE_FLOAT|ORC_STATIC_OPCODE_COMPLEX, { 8 }, { 8, 8 }, emulate_mulcf },
+  { "mulcjf", ORC_STATIC_OPCODE_FLOAT|ORC_STATIC_OPCODE_COMPLEX, { 8 }, { 8, 8 }, emulate_mulcjf },
+  { "magsqcf", ORC_STATIC_OPCODE_FLOAT|ORC_STATIC_OPCODE_COMPLEX, { 4 }, { 8 }, emulate_magsqcf },
+  { "addpb", 0, { 1 }, { 2 }, emulate_addpb },
+  { "addpw", 0, { 2 }, { 4 }, emulate_addpw },
+  { "addpl", 0, { 4 }, { 8 }, emulate_addpl },
+  { "addpf", ORC_STATIC_OPCODE_FLOAT, { 4 }, { 8 }, emulate_addpf },
+  { "avgpub", 0, { 1 }, { 2 }, emulate_avgpub },
+  { "avgpuw", 0, { 2 }, { 4 }, emulate_avgpuw },
+  { "avgpul", 0, { 4 }, { 8 }, emulate_avgpul },
+  { "avgpf", ORC_STATIC_OPCODE_FLOAT, { 4 }, { 8 }, emulate_avgpf },
+  { "randl", ORC_STATIC_OPCODE_LOAD|ORC_STATIC_OPCODE_SCALAR|ORC_STATIC_OPCODE_INDEX, { 4 }, { 4 }, emulate_randl },
+  { "randf", ORC_STATIC_OPCODE_LOAD|ORC_STATIC_OPCODE_SCALAR|ORC_STATIC_OPCODE_INDEX|ORC_STATIC_OPCODE_FLOAT_DEST, { 4 }, { 4 }, emulate_randf },
+  { "randtf", ORC_STATIC_OPCODE_LOAD|ORC_STATIC_OPCODE_SCALAR|ORC_STATIC_OPCODE_INDEX|ORC_STATIC_OPCODE_FLOAT_DEST, { 4 }, { 4 }, emulate_randtf },
+  { "unpack3x10", 0, { 8 }, { 4 }, emulate_unpack3x10 },
+  { "pack3x10", 0, { 4 }, { 8 }, emulate_pack3x10 },
+  { "ldunpack4x10", ORC_STATIC_OPCODE_LOAD|ORC_STATIC_OPCODE_PACKED, { 8 }, { 1 }, emulate_ldunpack4x10 },
+  { "stpack4x10", ORC_STATIC_OPCODE_STORE|ORC_STATIC_OPCODE_PACKED, { 1 }, { 8 }, emulate_stpack4x10 },
+  { "ldunpack2x12", ORC_STATIC_OPCODE_LOAD|ORC_STATIC_OPCODE_PACKED, { 4 }, { 1 }, emulate_ldunpack2x12 },
+  { "stpack2x12", ORC_STATIC_OPCODE_STORE|ORC_STATIC_OPCODE_PACKED, { 1 }, { 4 }, emulate_stpack2x12 },
+  { "lut16b", ORC_STATIC_OPCODE_SCALAR|ORC_STATIC_OPCODE_TABLE, { 1 }, { 1, 8, 8 }, emulate_lut16b },
+  { "acccrc32cb", ORC_STATIC_OPCODE_ACCUMULATOR|ORC_STATIC_OPCODE_CRC, { 4 }, { 1 }, emulate_acccrc32cb },
+  { "acccrc32cw", ORC_STATIC_OPCODE_ACCUMULATOR|ORC_STATIC_OPCODE_CRC, { 4 }, { 2 }, emulate_acccrc32cw },
+  { "acccrc32cl", ORC_STATIC_OPCODE_ACCUMULATOR|ORC_STATIC_OPCODE_CRC, { 4 }, { 4 }, emulate_acccrc32cl },
+  { "acccrc32cq", ORC_STATIC_OPCODE_ACCUMULATOR|ORC_STATIC_OPCODE_CRC, { 4 }, { 8 }, emulate_acccrc32cq },
+  { "absdiffub", 0, { 1 }, { 1, 1 }, emulate_absdiffub },
+  { "absdiffuw", 0, { 2 }, { 2, 2 }, emulate_absdiffuw },
+  { "sadubq", 0, { 8 }, { 8, 8 }, emulate_sadubq },
+  { "minposuwl", 0, { 4 }, { 8 }, emulate_minposuwl },
   { "" }
 };
 
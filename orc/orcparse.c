@@ -5,6 +5,7 @@
 
 #include <orc/orc.h>
 #include <orc/orcparse.h>
+#include <orc/orcinternal.h>
 #include <orc/orcutils-private.h>
 
 #include <string.h>
@@ -166,6 +167,8 @@ orc_parse_code (const char *code, OrcProgram ***programs, int *n_programs,
   OrcParser _parser;
   OrcParser *parser = &_parser;
   int enable_errors = (errors && n_errors);
+  orc_uint64 start = orc_stats_get_time ();
+  int ret;
 
   orc_parse_init (parser, code, enable_errors);
 
@@ -223,7 +226,11 @@ orc_parse_code (const char *code, OrcProgram ***programs, int *n_programs,
   if (n_programs) {
     *n_programs = orc_vector_length (&parser->programs);
   }
-  return orc_vector_has_data (&parser->errors) ?-1 :0;
+  ret = orc_vector_has_data (&parser->errors) ?-1 :0;
+
+  orc_stats_add_phase (ORC_STATS_PHASE_PARSE, start);
+
+  return ret;
 }
 
 static void
@@ -509,6 +516,8 @@ orc_parse_handle_flags (OrcParser *parser, const OrcLine *line)
   for (i=1;i<line->n_tokens;i++) {
     if (!strcmp (line->tokens[i], "2d")) {
       orc_program_set_2d (parser->program);
+    } else if (!strcmp (line->tokens[i], "fastmath")) {
+      orc_program_set_fast_math (parser->program);
     }
   }
   return 1;
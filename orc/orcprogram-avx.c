@@ -52,7 +52,8 @@ avx_get_flag_name (const int shift)
     "short_jumps",
     "64bit",
     "avx",
-    "avx2"
+    "avx2",
+    "fma"
   };
 
   if (shift >= 0 && shift < sizeof (flags) / sizeof (flags[0])) {
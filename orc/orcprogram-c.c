@@ -204,6 +204,23 @@ get_varname_stride (char *s, OrcCompiler *compiler, int var)
   }
 }
 
+static int
+c_accumulator_is_crc (OrcCompiler *compiler, int var)
+{
+  int j;
+
+  for(j=0;j<compiler->n_insns;j++){
+    OrcInstruction *insn = compiler->insns + j;
+
+    if ((insn->opcode->flags & ORC_STATIC_OPCODE_CRC) &&
+        insn->dest_args[0] == var) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
 static void
 orc_compiler_c_assemble (OrcCompiler *compiler)
 {
@@ -275,7 +292,14 @@ orc_compiler_c_assemble (OrcCompiler *compiler)
             i);
         break;
       case ORC_VAR_TYPE_ACCUMULATOR:
-        if (var->size >= 2) {
+        if ((compiler->target_flags & ORC_TARGET_C_OPCODE) &&
+            c_accumulator_is_crc (compiler, i)) {
+          /* a CRC can't be computed per chunk and added up, so carry
+           * it through the calls instead */
+          ORC_ASM_CODE(compiler,"  %s var%d =  { ((orc_union32 *)ex->dest_ptrs[%d])->i };\n",
+              c_get_type_name (var->size),
+              i, i - ORC_VAR_A1);
+        } else if (var->size >= 2) {
           ORC_ASM_CODE(compiler,"  %s var%d =  { 0 };\n",
               c_get_type_name (var->size),
               i);
@@ -447,6 +471,10 @@ orc_compiler_c_assemble (OrcCompiler *compiler)
           if (compiler->target_flags & ORC_TARGET_C_NOEXEC) {
             ORC_ASM_CODE(compiler,"  *%s = %s;\n",
                 varnames[i], varname);
+          } else if (compiler->target_flags & ORC_TARGET_C_OPCODE &&
+              c_accumulator_is_crc (compiler, i)) {
+            ORC_ASM_CODE(compiler,"  ((orc_union32 *)ex->dest_ptrs[%d])->i = %s;\n",
+                i - ORC_VAR_A1, varname);
           } else if (compiler->target_flags & ORC_TARGET_C_OPCODE) {
             ORC_ASM_CODE(compiler,"  ((orc_union32 *)ex->dest_ptrs[%d])->i += (orc_uint%d)%s;\n",
                 i - ORC_VAR_A1, var->size * 8, varname);
@@ -1174,6 +1202,340 @@ c_rule_select1wb (OrcCompiler *p, void *user, OrcInstruction *insn)
   ORC_ASM_CODE(p, "    }\n");
 }
 
+static void
+c_rule_addpX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+  int size = p->vars[insn->src_args[0]].size;
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p, "    {\n");
+  ORC_ASM_CODE(p,"       orc_union%d _src;\n", size * 8);
+  ORC_ASM_CODE(p,"       _src.i = %s;\n", src);
+  ORC_ASM_CODE(p,"       %s = ((orc_uint%d)_src.x2[0]) + ((orc_uint%d)_src.x2[1]);\n",
+      dest, size * 4, size * 4);
+  ORC_ASM_CODE(p, "    }\n");
+}
+
+static void
+c_rule_avgpuX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+  int size = p->vars[insn->src_args[0]].size;
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p, "    {\n");
+  ORC_ASM_CODE(p,"       orc_union%d _src;\n", size * 8);
+  ORC_ASM_CODE(p,"       _src.i = %s;\n", src);
+  if (size == 8) {
+    ORC_ASM_CODE(p,"       %s = ((orc_uint64)(orc_uint32)_src.x2[0] + (orc_uint64)(orc_uint32)_src.x2[1] + 1)>>1;\n",
+        dest);
+  } else {
+    ORC_ASM_CODE(p,"       %s = ((orc_uint%d)_src.x2[0] + (orc_uint%d)_src.x2[1] + 1)>>1;\n",
+        dest, size * 4, size * 4);
+  }
+  ORC_ASM_CODE(p, "    }\n");
+}
+
+static void
+c_rule_addpf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+  int is_avg = ORC_PTR_TO_INT (user);
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p, "    {\n");
+  ORC_ASM_CODE(p,"       orc_union64 _src;\n");
+  ORC_ASM_CODE(p,"       orc_union32 _dest1;\n");
+  ORC_ASM_CODE(p,"       _src.i = %s;\n", src);
+  ORC_ASM_CODE(p,"       _src.x2[0] = ORC_DENORMAL(_src.x2[0]);\n");
+  ORC_ASM_CODE(p,"       _src.x2[1] = ORC_DENORMAL(_src.x2[1]);\n");
+  ORC_ASM_CODE(p,"       _dest1.f = _src.x2f[0] + _src.x2f[1];\n");
+  if (is_avg) {
+    ORC_ASM_CODE(p,"       _dest1.i = ORC_DENORMAL(_dest1.i);\n");
+    ORC_ASM_CODE(p,"       _dest1.f = _dest1.f * 0.5f;\n");
+  }
+  ORC_ASM_CODE(p,"       %s = ORC_DENORMAL(_dest1.i);\n", dest);
+  ORC_ASM_CODE(p, "    }\n");
+}
+
+static void
+c_rule_randX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], seed[40];
+  const char *index;
+  int type = ORC_PTR_TO_INT (user);
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (seed, p, insn, insn->src_args[0]);
+
+  if (p->target_flags & ORC_TARGET_C_OPCODE &&
+      !(insn->flags & ORC_INSN_FLAG_ADDED)) {
+    index = "ex->index + offset + i";
+  } else if (p->program->is_2d) {
+    index = "j * n + i";
+  } else {
+    index = "i";
+  }
+
+  ORC_ASM_CODE(p, "    {\n");
+  if (type != 0) {
+    ORC_ASM_CODE(p,"       orc_union32 _dest1;\n");
+  }
+  ORC_ASM_CODE(p,"       orc_uint32 _x = (orc_uint32)%s * 0x%08xU + (orc_uint32)(%s);\n",
+      seed, ORC_RAND_MULTIPLIER, index);
+  ORC_ASM_CODE(p,"       _x = (_x << 15) + ~_x;\n");
+  ORC_ASM_CODE(p,"       _x ^= _x >> 12;\n");
+  ORC_ASM_CODE(p,"       _x += _x << 2;\n");
+  ORC_ASM_CODE(p,"       _x ^= _x >> 4;\n");
+  ORC_ASM_CODE(p,"       _x += (_x << 3) + (_x << 11);\n");
+  ORC_ASM_CODE(p,"       _x ^= _x >> 16;\n");
+  if (type == 0) {
+    ORC_ASM_CODE(p,"       %s = _x;\n", dest);
+  } else {
+    if (type == 1) {
+      ORC_ASM_CODE(p,"       _dest1.f = (float)(orc_int32)(_x >> 8) * (1.0f / 16777216);\n");
+    } else {
+      ORC_ASM_CODE(p,"       _dest1.f = (float)((orc_int32)(_x & 0xffff) - (orc_int32)(_x >> 16)) * (1.0f / 65536);\n");
+    }
+    ORC_ASM_CODE(p,"       %s = _dest1.i;\n", dest);
+  }
+  ORC_ASM_CODE(p, "    }\n");
+}
+
+static void
+c_rule_unpack3x10 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_union64 _dest;\n");
+  ORC_ASM_CODE(p,"       orc_uint32 _w = %s;\n", src);
+  ORC_ASM_CODE(p,"       _dest.x4[0] = _w & 0x3ff;\n");
+  ORC_ASM_CODE(p,"       _dest.x4[1] = (_w >> 10) & 0x3ff;\n");
+  ORC_ASM_CODE(p,"       _dest.x4[2] = (_w >> 20) & 0x3ff;\n");
+  ORC_ASM_CODE(p,"       _dest.x4[3] = 0;\n");
+  ORC_ASM_CODE(p,"       %s = _dest.i;\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+static void
+c_rule_pack3x10 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_union64 _src;\n");
+  ORC_ASM_CODE(p,"       _src.i = %s;\n", src);
+  ORC_ASM_CODE(p,"       %s = (_src.x4[0] & 0x3ff) | ((_src.x4[1] & 0x3ff) << 10) |"
+      " ((orc_uint32)(_src.x4[2] & 0x3ff) << 20);\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* user is the number of bits per sample: 10 for ldunpack4x10 (four
+ * samples in 5 bytes), 12 for ldunpack2x12 (two samples in 3 bytes).
+ * Samples are packed from the least significant bit of a little endian
+ * group. */
+static void
+c_rule_ldunpackX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40];
+  const int bits = ORC_PTR_TO_INT (user);
+  const int n_samples = (bits == 10) ? 4 : 2;
+  const int n_bytes = n_samples * bits / 8;
+  const char *index;
+  int k;
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+
+  if (p->target_flags & ORC_TARGET_C_OPCODE &&
+      !(insn->flags & ORC_INSN_FLAG_ADDED)) {
+    index = "offset + i";
+  } else {
+    index = "i";
+  }
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       const orc_uint8 *_p = (const orc_uint8 *)ptr%d + %d * (%s);\n",
+      insn->src_args[0], n_bytes, index);
+  if (n_samples == 4) {
+    ORC_ASM_CODE(p,"       orc_union64 _dest;\n");
+    ORC_ASM_CODE(p,"       orc_uint64 _g = _p[0] | ((orc_uint32)_p[1] << 8) |"
+        " ((orc_uint32)_p[2] << 16) | ((orc_uint32)_p[3] << 24) |"
+        " ((orc_uint64)_p[4] << 32);\n");
+  } else {
+    ORC_ASM_CODE(p,"       orc_union32 _dest;\n");
+    ORC_ASM_CODE(p,"       orc_uint32 _g = _p[0] | ((orc_uint32)_p[1] << 8) |"
+        " ((orc_uint32)_p[2] << 16);\n");
+  }
+  ORC_ASM_CODE(p,"       _dest.x%d[0] = _g & 0x%x;\n", n_samples, (1 << bits) - 1);
+  for (k = 1; k < n_samples; k++) {
+    ORC_ASM_CODE(p,"       _dest.x%d[%d] = (_g >> %d) & 0x%x;\n", n_samples, k,
+        k * bits, (1 << bits) - 1);
+  }
+  ORC_ASM_CODE(p,"       %s = _dest.i;\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+static void
+c_rule_stpackX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char src[40];
+  const int bits = ORC_PTR_TO_INT (user);
+  const int n_samples = (bits == 10) ? 4 : 2;
+  const int n_bytes = n_samples * bits / 8;
+  const char *index;
+  int k;
+
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  if (p->target_flags & ORC_TARGET_C_OPCODE &&
+      !(insn->flags & ORC_INSN_FLAG_ADDED)) {
+    index = "offset + i";
+  } else {
+    index = "i";
+  }
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_uint8 *_p = (orc_uint8 *)ptr%d + %d * (%s);\n",
+      insn->dest_args[0], n_bytes, index);
+  if (n_samples == 4) {
+    ORC_ASM_CODE(p,"       orc_union64 _src;\n");
+    ORC_ASM_CODE(p,"       orc_uint64 _g;\n");
+  } else {
+    ORC_ASM_CODE(p,"       orc_union32 _src;\n");
+    ORC_ASM_CODE(p,"       orc_uint32 _g;\n");
+  }
+  ORC_ASM_CODE(p,"       _src.i = %s;\n", src);
+  ORC_ASM_CODE(p,"       _g = _src.x%d[0] & 0x%x;\n", n_samples, (1 << bits) - 1);
+  for (k = 1; k < n_samples; k++) {
+    ORC_ASM_CODE(p,"       _g |= (%s)(_src.x%d[%d] & 0x%x) << %d;\n",
+        (n_samples == 4) ? "orc_uint64" : "orc_uint32", n_samples, k,
+        (1 << bits) - 1, k * bits);
+  }
+  ORC_ASM_CODE(p,"       _p[0] = _g;\n");
+  for (k = 1; k < n_bytes; k++) {
+    ORC_ASM_CODE(p,"       _p[%d] = _g >> %d;\n", k, k * 8);
+  }
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* the table is src1 (entries 0-7) followed by src2 (entries 8-15), one
+ * entry per byte starting from the least significant one; indices past
+ * the end give 0 so two lookups can cover a 32-entry table */
+static void
+c_rule_lut16b (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40], lo[40], hi[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+  c_get_name_int (lo, p, insn, insn->src_args[1]);
+  c_get_name_int (hi, p, insn, insn->src_args[2]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_uint8 _i = %s;\n", src);
+  ORC_ASM_CODE(p,"       orc_uint64 _t = (_i & 8) ? (orc_uint64)%s : (orc_uint64)%s;\n",
+      hi, lo);
+  ORC_ASM_CODE(p,"       %s = (_i < 16) ? (orc_uint8)(_t >> ((_i & 7) * 8)) : 0;\n",
+      dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* CRC-32C of the little-endian bytes of the source.  The emulation
+ * code uses the table-driven orc_crc32c(); generated code is bitwise so
+ * that it does not depend on the library. */
+static void
+c_rule_acccrc32cX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = p->vars[insn->src_args[0]].size;
+  char dest[40], src[40];
+  int k;
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  if (p->target_flags & ORC_TARGET_C_OPCODE) {
+    ORC_ASM_CODE(p,"       orc_uint8 _b[%d];\n", size);
+    for (k = 0; k < size; k++) {
+      ORC_ASM_CODE(p,"       _b[%d] = (orc_uint8)((orc_uint%d)%s >> %d);\n",
+          k, size * 8, src, k * 8);
+    }
+    ORC_ASM_CODE(p,"       %s = orc_crc32c (%s, _b, %d);\n", dest, dest, size);
+  } else {
+    ORC_ASM_CODE(p,"       orc_uint32 _c = %s;\n", dest);
+    ORC_ASM_CODE(p,"       int _k;\n");
+    for (k = 0; k < size; k += 4) {
+      if (size >= 4) {
+        ORC_ASM_CODE(p,"       _c ^= (orc_uint32)((orc_uint%d)%s >> %d);\n",
+            size * 8, src, k * 8);
+      } else {
+        ORC_ASM_CODE(p,"       _c ^= (orc_uint%d)%s;\n", size * 8, src);
+      }
+      ORC_ASM_CODE(p,"       for (_k = 0; _k < %d; _k++)\n", MIN (size, 4) * 8);
+      ORC_ASM_CODE(p,"         _c = (_c >> 1) ^ (0x82f63b78U & -(_c & 1));\n");
+    }
+    ORC_ASM_CODE(p,"       %s = _c;\n", dest);
+  }
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* sum of absolute differences of the 8 bytes of each source, as
+ * psadbw gives it */
+static void
+c_rule_sadubq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src1[40], src2[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src1, p, insn, insn->src_args[0]);
+  c_get_name_int (src2, p, insn, insn->src_args[1]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_uint32 _s = 0;\n");
+  ORC_ASM_CODE(p,"       int _k;\n");
+  ORC_ASM_CODE(p,"       for (_k = 0; _k < 64; _k += 8)\n");
+  ORC_ASM_CODE(p,"         _s += ORC_ABS((orc_int32)(orc_uint8)((orc_uint64)%s >> _k) -\n", src1);
+  ORC_ASM_CODE(p,"             (orc_int32)(orc_uint8)((orc_uint64)%s >> _k));\n", src2);
+  ORC_ASM_CODE(p,"       %s = _s;\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* the minimum of the 4 unsigned words in the low half, the position of
+ * its first occurrence in the high half, as phminposuw gives it */
+static void
+c_rule_minposuwl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"       orc_uint32 _m = (orc_uint16)%s;\n", src);
+  ORC_ASM_CODE(p,"       orc_uint32 _w;\n");
+  ORC_ASM_CODE(p,"       int _k;\n");
+  ORC_ASM_CODE(p,"       for (_k = 1; _k < 4; _k++) {\n");
+  ORC_ASM_CODE(p,"         _w = (orc_uint16)((orc_uint64)%s >> (_k * 16));\n", src);
+  ORC_ASM_CODE(p,"         if (_w < (_m & 0xffff)) _m = _w | (_k << 16);\n");
+  ORC_ASM_CODE(p,"       }\n");
+  ORC_ASM_CODE(p,"       %s = _m;\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
 static void
 c_rule_splatbw (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -1419,6 +1781,120 @@ c_rule_maxd (OrcCompiler *p, void *user, OrcInstruction *insn)
   ORC_ASM_CODE(p,"    }\n");
 }
 
+static void
+c_rule_fmaf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src1[40], src2[40], src3[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src1, p, insn, insn->src_args[0]);
+  c_get_name_int (src2, p, insn, insn->src_args[1]);
+  c_get_name_int (src3, p, insn, insn->src_args[2]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"      orc_union32 _src1;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _src2;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _src3;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _dest1;\n");
+  ORC_ASM_CODE(p,"      _src1.i = ORC_DENORMAL(%s);\n", src1);
+  ORC_ASM_CODE(p,"      _src2.i = ORC_DENORMAL(%s);\n", src2);
+  ORC_ASM_CODE(p,"      _src3.i = ORC_DENORMAL(%s);\n", src3);
+  ORC_ASM_CODE(p,"      _dest1.f = fmaf(_src1.f, _src2.f, _src3.f);\n");
+  ORC_ASM_CODE(p,"      %s = ORC_DENORMAL(_dest1.i);\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+static void
+c_rule_fmad (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src1[40], src2[40], src3[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src1, p, insn, insn->src_args[0]);
+  c_get_name_int (src2, p, insn, insn->src_args[1]);
+  c_get_name_int (src3, p, insn, insn->src_args[2]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src1;\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src2;\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src3;\n");
+  ORC_ASM_CODE(p,"      orc_union64 _dest1;\n");
+  ORC_ASM_CODE(p,"      _src1.i = ORC_DENORMAL_DOUBLE(%s);\n", src1);
+  ORC_ASM_CODE(p,"      _src2.i = ORC_DENORMAL_DOUBLE(%s);\n", src2);
+  ORC_ASM_CODE(p,"      _src3.i = ORC_DENORMAL_DOUBLE(%s);\n", src3);
+  ORC_ASM_CODE(p,"      _dest1.f = fma(_src1.f, _src2.f, _src3.f);\n");
+  ORC_ASM_CODE(p,"      %s = ORC_DENORMAL_DOUBLE(_dest1.i);\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+/* user selects the conjugate of the second source */
+static void
+c_rule_mulcX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src1[40], src2[40];
+  const int conj = ORC_PTR_TO_INT (user);
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src1, p, insn, insn->src_args[0]);
+  c_get_name_int (src2, p, insn, insn->src_args[1]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src1;\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src2;\n");
+  ORC_ASM_CODE(p,"      orc_union64 _dest;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _rr, _ii, _ri, _ir;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _dest1, _dest2;\n");
+  ORC_ASM_CODE(p,"      _src1.i = %s;\n", src1);
+  ORC_ASM_CODE(p,"      _src2.i = %s;\n", src2);
+  ORC_ASM_CODE(p,"      _src1.x2[0] = ORC_DENORMAL(_src1.x2[0]);\n");
+  ORC_ASM_CODE(p,"      _src1.x2[1] = ORC_DENORMAL(_src1.x2[1]);\n");
+  ORC_ASM_CODE(p,"      _src2.x2[0] = ORC_DENORMAL(_src2.x2[0]);\n");
+  ORC_ASM_CODE(p,"      _src2.x2[1] = ORC_DENORMAL(_src2.x2[1]);\n");
+  ORC_ASM_CODE(p,"      _rr.f = _src1.x2f[0] * _src2.x2f[0];\n");
+  ORC_ASM_CODE(p,"      _ii.f = _src1.x2f[1] * _src2.x2f[1];\n");
+  ORC_ASM_CODE(p,"      _ri.f = _src1.x2f[0] * _src2.x2f[1];\n");
+  ORC_ASM_CODE(p,"      _ir.f = _src1.x2f[1] * _src2.x2f[0];\n");
+  ORC_ASM_CODE(p,"      _rr.i = ORC_DENORMAL(_rr.i);\n");
+  ORC_ASM_CODE(p,"      _ii.i = ORC_DENORMAL(_ii.i);\n");
+  ORC_ASM_CODE(p,"      _ri.i = ORC_DENORMAL(_ri.i);\n");
+  ORC_ASM_CODE(p,"      _ir.i = ORC_DENORMAL(_ir.i);\n");
+  if (conj) {
+    ORC_ASM_CODE(p,"      _dest1.f = _rr.f + _ii.f;\n");
+    ORC_ASM_CODE(p,"      _dest2.f = _ir.f - _ri.f;\n");
+  } else {
+    ORC_ASM_CODE(p,"      _dest1.f = _rr.f - _ii.f;\n");
+    ORC_ASM_CODE(p,"      _dest2.f = _ir.f + _ri.f;\n");
+  }
+  ORC_ASM_CODE(p,"      _dest.x2[0] = ORC_DENORMAL(_dest1.i);\n");
+  ORC_ASM_CODE(p,"      _dest.x2[1] = ORC_DENORMAL(_dest2.i);\n");
+  ORC_ASM_CODE(p,"      %s = _dest.i;\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
+static void
+c_rule_magsqcf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  char dest[40], src[40];
+
+  c_get_name_int (dest, p, insn, insn->dest_args[0]);
+  c_get_name_int (src, p, insn, insn->src_args[0]);
+
+  ORC_ASM_CODE(p,"    {\n");
+  ORC_ASM_CODE(p,"      orc_union64 _src1;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _rr, _ii;\n");
+  ORC_ASM_CODE(p,"      orc_union32 _dest1;\n");
+  ORC_ASM_CODE(p,"      _src1.i = %s;\n", src);
+  ORC_ASM_CODE(p,"      _src1.x2[0] = ORC_DENORMAL(_src1.x2[0]);\n");
+  ORC_ASM_CODE(p,"      _src1.x2[1] = ORC_DENORMAL(_src1.x2[1]);\n");
+  ORC_ASM_CODE(p,"      _rr.f = _src1.x2f[0] * _src1.x2f[0];\n");
+  ORC_ASM_CODE(p,"      _ii.f = _src1.x2f[1] * _src1.x2f[1];\n");
+  ORC_ASM_CODE(p,"      _rr.i = ORC_DENORMAL(_rr.i);\n");
+  ORC_ASM_CODE(p,"      _ii.i = ORC_DENORMAL(_ii.i);\n");
+  ORC_ASM_CODE(p,"      _dest1.f = _rr.f + _ii.f;\n");
+  ORC_ASM_CODE(p,"      %s = ORC_DENORMAL(_dest1.i);\n", dest);
+  ORC_ASM_CODE(p,"    }\n");
+}
+
 static void
 c_rule_swapwl (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -1595,6 +2071,30 @@ orc_c_init (void)
   orc_rule_register (rule_set, "select1lw", c_rule_select1lw, NULL);
   orc_rule_register (rule_set, "select0wb", c_rule_select0wb, NULL);
   orc_rule_register (rule_set, "select1wb", c_rule_select1wb, NULL);
+  orc_rule_register (rule_set, "addpb", c_rule_addpX, NULL);
+  orc_rule_register (rule_set, "addpw", c_rule_addpX, NULL);
+  orc_rule_register (rule_set, "addpl", c_rule_addpX, NULL);
+  orc_rule_register (rule_set, "addpf", c_rule_addpf, (void *)0);
+  orc_rule_register (rule_set, "avgpub", c_rule_avgpuX, NULL);
+  orc_rule_register (rule_set, "avgpuw", c_rule_avgpuX, NULL);
+  orc_rule_register (rule_set, "avgpul", c_rule_avgpuX, NULL);
+  orc_rule_register (rule_set, "avgpf", c_rule_addpf, (void *)1);
+  orc_rule_register (rule_set, "randl", c_rule_randX, (void *)0);
+  orc_rule_register (rule_set, "randf", c_rule_randX, (void *)1);
+  orc_rule_register (rule_set, "randtf", c_rule_randX, (void *)2);
+  orc_rule_register (rule_set, "unpack3x10", c_rule_unpack3x10, NULL);
+  orc_rule_register (rule_set, "pack3x10", c_rule_pack3x10, NULL);
+  orc_rule_register (rule_set, "ldunpack4x10", c_rule_ldunpackX, (void *)10);
+  orc_rule_register (rule_set, "stpack4x10", c_rule_stpackX, (void *)10);
+  orc_rule_register (rule_set, "ldunpack2x12", c_rule_ldunpackX, (void *)12);
+  orc_rule_register (rule_set, "stpack2x12", c_rule_stpackX, (void *)12);
+  orc_rule_register (rule_set, "lut16b", c_rule_lut16b, NULL);
+  orc_rule_register (rule_set, "acccrc32cb", c_rule_acccrc32cX, NULL);
+  orc_rule_register (rule_set, "acccrc32cw", c_rule_acccrc32cX, NULL);
+  orc_rule_register (rule_set, "acccrc32cl", c_rule_acccrc32cX, NULL);
+  orc_rule_register (rule_set, "acccrc32cq", c_rule_acccrc32cX, NULL);
+  orc_rule_register (rule_set, "sadubq", c_rule_sadubq, NULL);
+  orc_rule_register (rule_set, "minposuwl", c_rule_minposuwl, NULL);
   orc_rule_register (rule_set, "splatbw", c_rule_splatbw, NULL);
   orc_rule_register (rule_set, "splatbl", c_rule_splatbl, NULL);
   orc_rule_register (rule_set, "splatw3q", c_rule_splatw3q, NULL);
@@ -1616,5 +2116,10 @@ orc_c_init (void)
   orc_rule_register (rule_set, "mergewl", c_rule_mergewl, NULL);
   orc_rule_register (rule_set, "mergelq", c_rule_mergelq, NULL);
   orc_rule_register (rule_set, "convwf", c_rule_convwf, NULL);
+  orc_rule_register (rule_set, "fmaf", c_rule_fmaf, NULL);
+  orc_rule_register (rule_set, "fmad", c_rule_fmad, NULL);
+  orc_rule_register (rule_set, "mulcf", c_rule_mulcX, (void *)0);
+  orc_rule_register (rule_set, "mulcjf", c_rule_mulcX, (void *)1);
+  orc_rule_register (rule_set, "magsqcf", c_rule_magsqcf, NULL);
 }
 
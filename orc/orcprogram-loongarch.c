@@ -0,0 +1,334 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcdebug.h>
+#include <orc/orcutils.h>
+#include <orc/orcinternal.h>
+#include <orc/orcloongarch.h>
+
+/* The loop code shared by the LSX and LASX targets.  n is split into a
+ * main loop working on whole registers and a tail that handles the
+ * remaining elements with smaller loop shifts, one power of two at a
+ * time, like region 3 of the x86 targets.  Unaligned vector accesses are
+ * cheap on LoongArch, so there is no peeling to an aligned region.
+ *
+ * Only caller-saved registers are used: $a0 holds the executor, $a1 is
+ * the scratch register, $a2-$a5 have fixed roles in the loop and the
+ * array pointers are allocated among $a6-$a7 and $t0-$t8.  Vector
+ * registers 24 to 31 alias the callee-saved floating point registers
+ * and are left alone. */
+
+#define LABEL_OUTER_LOOP 1
+#define LABEL_OUTER_LOOP_SKIP 2
+#define LABEL_INNER_LOOP 3
+#define LABEL_INNER_LOOP_SKIP 4
+#define LABEL_STEP_DOWN(i) (8 + (i))
+
+static void
+orc_loongarch_compiler_init (OrcCompiler *c)
+{
+  OrcLoongArchTarget *t = c->target->target_data;
+  int i;
+
+  c->is_64bit = TRUE;
+
+  for (i = ORC_LOONGARCH_A6; i <= ORC_LOONGARCH_T8; i++) {
+    c->valid_regs[i] = 1;
+  }
+  for (i = ORC_VEC_REG_BASE + 0; i < ORC_VEC_REG_BASE + 24; i++) {
+    c->valid_regs[i] = 1;
+  }
+  for (i = 0; i < ORC_N_REGS; i++) {
+    c->alloc_regs[i] = 0;
+    c->used_regs[i] = 0;
+  }
+
+  c->exec_reg = ORC_LOONGARCH_A0;
+  c->gp_tmpreg = ORC_LOONGARCH_A1;
+  c->tmpreg = ORC_VEC_REG_BASE + 0;
+  c->tmpreg2 = ORC_VEC_REG_BASE + 1;
+  c->valid_regs[c->tmpreg] = 0;
+  c->valid_regs[c->tmpreg2] = 0;
+
+  switch (c->max_var_size) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+      break;
+    default:
+      ORC_COMPILER_ERROR (c, "unhandled max var size %d", c->max_var_size);
+      break;
+  }
+
+  c->loop_shift = 0;
+  while ((c->max_var_size << (c->loop_shift + 1)) <= t->register_size) {
+    c->loop_shift++;
+  }
+  c->unroll_shift = 0;
+}
+
+static void
+orc_loongarch_load_constant (OrcCompiler *c, int reg, int size, int value)
+{
+  orc_loongarch_emit_load_imm (c, c->gp_tmpreg, value);
+  orc_loongarch_emit_vreplgr2vr (c, size, reg, c->gp_tmpreg);
+}
+
+static void
+orc_loongarch_init_accumulators (OrcCompiler *c)
+{
+  int i;
+
+  for (i = 0; i < ORC_N_COMPILER_VARIABLES; i++) {
+    OrcVariable *var = c->vars + i;
+
+    if (var->name == NULL)
+      continue;
+    if (var->vartype != ORC_VAR_TYPE_ACCUMULATOR)
+      continue;
+
+    orc_loongarch_emit_vzero (c, var->alloc);
+  }
+}
+
+static void
+orc_loongarch_save_accumulators (OrcLoongArchTarget *t, OrcCompiler *c)
+{
+  int i;
+
+  for (i = 0; i < ORC_N_COMPILER_VARIABLES; i++) {
+    OrcVariable *var = c->vars + i;
+
+    if (var->name == NULL)
+      continue;
+    if (var->vartype != ORC_VAR_TYPE_ACCUMULATOR)
+      continue;
+
+    t->reduce_accumulator (c, i, var);
+  }
+}
+
+static void
+orc_loongarch_load_pointers (OrcCompiler *c)
+{
+  int i;
+
+  for (i = 0; i < ORC_N_COMPILER_VARIABLES; i++) {
+    OrcVariable *var = c->vars + i;
+
+    if (var->name == NULL)
+      continue;
+    if (var->vartype != ORC_VAR_TYPE_SRC && var->vartype != ORC_VAR_TYPE_DEST)
+      continue;
+
+    if (var->ptr_register == 0) {
+      ORC_COMPILER_ERROR (c, "unimplemented: pointer stored in memory");
+      return;
+    }
+    orc_loongarch_emit_ld (c, 8, FALSE, var->ptr_register, c->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, arrays[i]));
+  }
+}
+
+static void
+orc_loongarch_add_strides (OrcCompiler *c)
+{
+  int i;
+
+  for (i = 0; i < ORC_N_COMPILER_VARIABLES; i++) {
+    OrcVariable *var = c->vars + i;
+
+    if (var->name == NULL)
+      continue;
+    if (var->vartype != ORC_VAR_TYPE_SRC && var->vartype != ORC_VAR_TYPE_DEST)
+      continue;
+
+    orc_loongarch_emit_ld (c, 8, FALSE, var->ptr_register, c->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, arrays[i]));
+    orc_loongarch_emit_ld (c, 4, FALSE, c->gp_tmpreg, c->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[i]));
+    orc_loongarch_emit_add (c, 8, var->ptr_register, var->ptr_register,
+        c->gp_tmpreg);
+    orc_loongarch_emit_st (c, 8, var->ptr_register, c->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, arrays[i]));
+  }
+}
+
+static void
+orc_loongarch_emit_loop (OrcCompiler *c, int update)
+{
+  int j;
+  int k;
+
+  for (j = 0; j < c->n_insns; j++) {
+    OrcInstruction *insn = c->insns + j;
+    OrcStaticOpcode *opcode = insn->opcode;
+    OrcRule *rule;
+
+    c->insn_index = j;
+
+    if (insn->flags & ORC_INSN_FLAG_INVARIANT)
+      continue;
+
+    ORC_ASM_CODE (c, "# %d: %s\n", j, opcode->name);
+
+    c->min_temp_reg = ORC_VEC_REG_BASE;
+
+    c->insn_shift = c->loop_shift;
+    if (insn->flags & ORC_INSTRUCTION_FLAG_X2) {
+      c->insn_shift += 1;
+    }
+    if (insn->flags & ORC_INSTRUCTION_FLAG_X4) {
+      c->insn_shift += 2;
+    }
+
+    rule = insn->rule;
+    if (rule && rule->emit) {
+      rule->emit (c, rule->emit_user, insn);
+    } else {
+      orc_compiler_error (c, "no code generation rule for %s", opcode->name);
+    }
+  }
+
+  for (k = 0; k < ORC_N_COMPILER_VARIABLES; k++) {
+    OrcVariable *var = c->vars + k;
+    int offset;
+
+    if (var->name == NULL)
+      continue;
+    if (var->vartype != ORC_VAR_TYPE_SRC && var->vartype != ORC_VAR_TYPE_DEST)
+      continue;
+
+    if (var->update_type == 0) {
+      offset = 0;
+    } else if (var->update_type == 1) {
+      offset = (var->size * update) >> 1;
+    } else {
+      offset = var->size * update;
+    }
+
+    if (offset != 0) {
+      orc_loongarch_emit_addi (c, 8, var->ptr_register, var->ptr_register,
+          offset);
+    }
+  }
+}
+
+static void
+orc_loongarch_compile (OrcCompiler *c)
+{
+  OrcLoongArchTarget *t = c->target->target_data;
+  const int loop_shift = c->loop_shift;
+  int l;
+
+  orc_compiler_append_code (c, ".global %s\n", c->program->name);
+  orc_compiler_append_code (c, "%s:\n", c->program->name);
+
+  orc_loongarch_init_accumulators (c);
+  orc_compiler_emit_invariants (c);
+
+  if (c->program->is_2d) {
+    if (c->program->constant_m > 0) {
+      orc_loongarch_emit_load_imm (c, ORC_LOONGARCH_OUTER_REG,
+          c->program->constant_m);
+    } else {
+      orc_loongarch_emit_ld (c, 4, FALSE, ORC_LOONGARCH_OUTER_REG,
+          c->exec_reg, (int)ORC_STRUCT_OFFSET (OrcExecutor,
+              params[ORC_VAR_A1]));
+      orc_loongarch_emit_branch (c, ORC_LOONGARCH_BGE, ORC_LOONGARCH_ZERO,
+          ORC_LOONGARCH_OUTER_REG, LABEL_OUTER_LOOP_SKIP);
+    }
+    orc_loongarch_emit_label (c, LABEL_OUTER_LOOP);
+  }
+
+  orc_loongarch_load_pointers (c);
+
+  orc_loongarch_emit_ld (c, 4, FALSE, ORC_LOONGARCH_TAIL_REG, c->exec_reg,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, n));
+  orc_loongarch_emit_srai_w (c, ORC_LOONGARCH_COUNTER_REG,
+      ORC_LOONGARCH_TAIL_REG, loop_shift);
+  if (loop_shift > 0) {
+    orc_loongarch_emit_andi (c, ORC_LOONGARCH_TAIL_REG,
+        ORC_LOONGARCH_TAIL_REG, (1 << loop_shift) - 1);
+  }
+  orc_loongarch_emit_branch (c, ORC_LOONGARCH_BEQZ, ORC_LOONGARCH_COUNTER_REG,
+      0, LABEL_INNER_LOOP_SKIP);
+
+  ORC_ASM_CODE (c, "# LOOP SHIFT %d\n", loop_shift);
+  orc_loongarch_emit_label (c, LABEL_INNER_LOOP);
+  orc_loongarch_emit_loop (c, 1 << loop_shift);
+  orc_loongarch_emit_addi (c, 4, ORC_LOONGARCH_COUNTER_REG,
+      ORC_LOONGARCH_COUNTER_REG, -1);
+  orc_loongarch_emit_branch (c, ORC_LOONGARCH_BNEZ, ORC_LOONGARCH_COUNTER_REG,
+      0, LABEL_INNER_LOOP);
+  orc_loongarch_emit_label (c, LABEL_INNER_LOOP_SKIP);
+
+  for (l = loop_shift - 1; l >= 0; l--) {
+    c->loop_shift = l;
+    ORC_ASM_CODE (c, "# LOOP SHIFT %d\n", c->loop_shift);
+
+    orc_loongarch_emit_andi (c, ORC_LOONGARCH_TMP_REG, ORC_LOONGARCH_TAIL_REG,
+        1 << l);
+    orc_loongarch_emit_branch (c, ORC_LOONGARCH_BEQZ, ORC_LOONGARCH_TMP_REG,
+        0, LABEL_STEP_DOWN (l));
+    orc_loongarch_emit_loop (c, 1 << l);
+    orc_loongarch_emit_label (c, LABEL_STEP_DOWN (l));
+  }
+  c->loop_shift = loop_shift;
+
+  if (c->program->is_2d) {
+    if (c->program->constant_m != 1) {
+      orc_loongarch_add_strides (c);
+      orc_loongarch_emit_addi (c, 4, ORC_LOONGARCH_OUTER_REG,
+          ORC_LOONGARCH_OUTER_REG, -1);
+      orc_loongarch_emit_branch (c, ORC_LOONGARCH_BNEZ,
+          ORC_LOONGARCH_OUTER_REG, 0, LABEL_OUTER_LOOP);
+    }
+    orc_loongarch_emit_label (c, LABEL_OUTER_LOOP_SKIP);
+  }
+
+  orc_loongarch_save_accumulators (t, c);
+
+  orc_loongarch_emit_ret (c);
+
+  orc_loongarch_do_fixups (c);
+}
+
+OrcTarget *
+orc_loongarch_register_target (OrcLoongArchTarget *lt)
+{
+  OrcTarget *t;
+#if defined(HAVE_LOONGARCH64)
+  char *backend;
+#endif
+
+  /* FIXME this needs to be freed */
+  t = calloc (1, sizeof(OrcTarget));
+  t->name = lt->name;
+#if defined(HAVE_LOONGARCH64)
+  /* the LoongArch targets are new, so like sve they don't become the
+   * default and only run code when selected with ORC_BACKEND */
+  backend = _orc_getenv ("ORC_BACKEND");
+  t->executable = backend && strcmp (backend, lt->name) == 0 &&
+      lt->is_executable ();
+  free (backend);
+#else
+  t->executable = FALSE;
+#endif
+  t->data_register_offset = ORC_VEC_REG_BASE;
+  t->get_default_flags = lt->get_default_flags;
+  t->compiler_init = orc_loongarch_compiler_init;
+  t->compile = orc_loongarch_compile;
+  t->load_constant = orc_loongarch_load_constant;
+  t->get_flag_name = lt->get_flag_name;
+  t->flush_cache = orc_loongarch_flush_cache;
+  t->target_data = lt;
+  orc_target_register (t);
+
+  return t;
+}
@@ -0,0 +1,85 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcdebug.h>
+#include <orc/orcutils.h>
+#include <orc/orcinternal.h>
+#include <orc/orcloongarch.h>
+
+static unsigned int
+lsx_get_default_flags (void)
+{
+#if defined(HAVE_LOONGARCH64)
+  return orc_loongarch_get_cpu_flags ();
+#else
+  return ORC_TARGET_LOONGARCH_LSX;
+#endif
+}
+
+static const char *
+lsx_get_flag_name (int shift)
+{
+  static const char *flags[] = { "lsx", "lasx" };
+
+  if (shift >= 0 && shift < sizeof(flags)/sizeof(flags[0])) {
+    return flags[shift];
+  }
+
+  return NULL;
+}
+
+static int
+lsx_is_executable (void)
+{
+#if defined(HAVE_LOONGARCH64)
+  if (orc_loongarch_get_cpu_flags () & ORC_TARGET_LOONGARCH_LSX) {
+    return TRUE;
+  }
+#endif
+  return FALSE;
+}
+
+static void
+lsx_reduce_accumulator (OrcCompiler *c, int i, OrcVariable *var)
+{
+  const int tmp = c->tmpreg;
+  int src = var->alloc;
+
+  if (var->size == 2) {
+    orc_loongarch_emit_3r (c, "vhaddw.w.h", 0x70548000, tmp, src, src);
+    src = tmp;
+  }
+  orc_loongarch_emit_3r (c, "vhaddw.d.w", 0x70550000, tmp, src, src);
+  orc_loongarch_emit_3r (c, "vhaddw.q.d", 0x70558000, tmp, tmp, tmp);
+  orc_loongarch_emit_vpickve2gr_w (c, c->gp_tmpreg, tmp, 0);
+
+  if (var->size == 2) {
+    orc_loongarch_emit_slli_w (c, c->gp_tmpreg, c->gp_tmpreg, 16);
+    orc_loongarch_emit_srli_w (c, c->gp_tmpreg, c->gp_tmpreg, 16);
+  }
+  orc_loongarch_emit_st (c, 4, c->gp_tmpreg, c->exec_reg,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, accumulators[i - ORC_VAR_A1]));
+}
+
+void
+orc_lsx_init (void)
+{
+  // clang-format off
+  static OrcLoongArchTarget target = {
+    "lsx",
+    lsx_get_default_flags,
+    lsx_get_flag_name,
+    lsx_is_executable,
+    lsx_reduce_accumulator,
+    16,
+  };
+  // clang-format on
+  OrcTarget *t;
+
+  t = orc_loongarch_register_target (&target);
+  orc_loongarch_lsx_register_rules (t);
+}
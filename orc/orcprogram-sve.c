@@ -0,0 +1,296 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <sys/types.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcarm.h>
+#include <orc/orcutils.h>
+#include <orc/orcdebug.h>
+#include <orc/orcinternal.h>
+
+#include <orc/orcsve.h>
+
+/* The loop never depends on the vector length: x2 counts the elements
+ * done so far and whilelt builds the predicate for the next chunk, so
+ * the tail of the array is handled by the same code with a partial
+ * predicate instead of a scalar remainder loop. */
+
+static void orc_sve_emit_loop (OrcCompiler *compiler);
+
+extern void orc_compiler_sve_register_rules (OrcTarget *target);
+static unsigned int orc_compiler_sve_get_default_flags (void);
+
+static void orc_compiler_sve_init (OrcCompiler *compiler);
+static void orc_compiler_sve_assemble (OrcCompiler *compiler);
+
+enum {
+  LABEL_LOOP = 1,
+  LABEL_LOOP_SKIP,
+  LABEL_OUTER_LOOP
+};
+
+static OrcTarget sve_target = {
+  "sve",
+#if defined(HAVE_AARCH64)
+  TRUE,
+#else
+  FALSE,
+#endif
+  ORC_VEC_REG_BASE,
+  orc_compiler_sve_get_default_flags,
+  orc_compiler_sve_init,
+  orc_compiler_sve_assemble,
+  { { 0 } }, 0,
+  NULL,
+  NULL,
+  NULL,
+  orc_arm_flush_cache
+};
+
+void
+orc_sve_init (void)
+{
+#if defined(HAVE_AARCH64)
+  if (!(orc_sve_get_cpu_flags () & ORC_TARGET_SVE_SVE)) {
+    ORC_INFO("marking sve backend non-executable");
+    sve_target.executable = FALSE;
+  }
+#endif
+
+  orc_target_register (&sve_target);
+
+  orc_compiler_sve_register_rules (&sve_target);
+}
+
+static unsigned int
+orc_compiler_sve_get_default_flags (void)
+{
+  unsigned int flags = 0;
+
+#if defined(HAVE_AARCH64)
+  flags = orc_sve_get_cpu_flags ();
+  if (!(flags & ORC_TARGET_SVE_SVE)) {
+    /* generate code for the full feature set when it can't run anyway */
+    flags = ORC_TARGET_SVE_SVE | ORC_TARGET_SVE_SVE2;
+  }
+#else
+  flags = ORC_TARGET_SVE_SVE | ORC_TARGET_SVE_SVE2;
+#endif
+
+  return flags;
+}
+
+static void
+orc_compiler_sve_init (OrcCompiler *compiler)
+{
+  int i;
+
+  compiler->is_64bit = TRUE;
+
+  /* x0-x3 have fixed roles, x16 and x17 are scratch for the prologue
+   * and the 2D loop; the rest above x15 is left alone so that nothing
+   * needs to be saved */
+  for(i=ORC_ARM64_R4;i<=ORC_ARM64_R15;i++){
+    compiler->valid_regs[i] = 1;
+  }
+  /* z8-z15 have callee-saved low halves */
+  for(i=ORC_VEC_REG_BASE+0;i<ORC_VEC_REG_BASE+32;i++){
+    compiler->valid_regs[i] = 1;
+  }
+  for(i=ORC_VEC_REG_BASE+8;i<ORC_VEC_REG_BASE+16;i++){
+    compiler->valid_regs[i] = 0;
+  }
+
+  for(i=0;i<ORC_N_REGS;i++){
+    compiler->alloc_regs[i] = 0;
+    compiler->used_regs[i] = 0;
+  }
+
+  compiler->exec_reg = ORC_ARM64_R0;
+  compiler->gp_tmpreg = ORC_ARM64_R1;
+  compiler->tmpreg = ORC_VEC_REG_BASE + 0;
+  compiler->tmpreg2 = ORC_VEC_REG_BASE + 1;
+  compiler->valid_regs[compiler->tmpreg] = 0;
+  compiler->valid_regs[compiler->tmpreg2] = 0;
+
+  switch (compiler->max_var_size) {
+    case 1:
+    case 2:
+    case 4:
+    case 8:
+      break;
+    default:
+      ORC_COMPILER_ERROR (compiler, "unhandled max var size %d",
+          compiler->max_var_size);
+      break;
+  }
+
+  /* the number of elements per iteration is only known at run time */
+  compiler->loop_shift = 0;
+  compiler->unroll_shift = 0;
+}
+
+static void
+orc_sve_load_pointers (OrcCompiler *compiler)
+{
+  int i;
+
+  for(i=0;i<ORC_N_COMPILER_VARIABLES;i++){
+    OrcVariable *var = compiler->vars + i;
+
+    if (var->name == NULL) continue;
+    if (var->vartype != ORC_VAR_TYPE_SRC &&
+        var->vartype != ORC_VAR_TYPE_DEST) continue;
+
+    orc_arm64_emit_load_reg (compiler, 64, var->ptr_register,
+        compiler->exec_reg, (int)ORC_STRUCT_OFFSET(OrcExecutor, arrays[i]));
+  }
+}
+
+static void
+orc_sve_add_strides (OrcCompiler *compiler)
+{
+  int i;
+
+  for(i=0;i<ORC_N_COMPILER_VARIABLES;i++){
+    OrcVariable *var = compiler->vars + i;
+
+    if (var->name == NULL) continue;
+    if (var->vartype != ORC_VAR_TYPE_SRC &&
+        var->vartype != ORC_VAR_TYPE_DEST) continue;
+
+    orc_arm64_emit_load_reg (compiler, 32, ORC_ARM64_IP0, compiler->exec_reg,
+        (int)ORC_STRUCT_OFFSET(OrcExecutor, params[i]));
+    orc_arm64_emit_add_sxtw (compiler, 64, var->ptr_register,
+        var->ptr_register, ORC_ARM64_IP0, 0);
+  }
+}
+
+static void
+orc_sve_init_accumulators (OrcCompiler *compiler)
+{
+  int i;
+
+  for(i=0;i<ORC_N_COMPILER_VARIABLES;i++){
+    OrcVariable *var = compiler->vars + i;
+
+    if (var->name == NULL) continue;
+    if (var->vartype != ORC_VAR_TYPE_ACCUMULATOR) continue;
+
+    orc_sve_emit_dup_imm (compiler, var->size, var->alloc, 0);
+  }
+}
+
+static void
+orc_sve_save_accumulators (OrcCompiler *compiler)
+{
+  int i;
+
+  for(i=0;i<ORC_N_COMPILER_VARIABLES;i++){
+    OrcVariable *var = compiler->vars + i;
+
+    if (var->name == NULL) continue;
+    if (var->vartype != ORC_VAR_TYPE_ACCUMULATOR) continue;
+
+    orc_sve_emit_save_accumulator (compiler, var,
+        (int)ORC_STRUCT_OFFSET(OrcExecutor, accumulators[i-ORC_VAR_A1]));
+  }
+}
+
+static void
+orc_compiler_sve_assemble (OrcCompiler *compiler)
+{
+  const int size = compiler->max_var_size;
+
+  orc_compiler_append_code(compiler,".global %s\n", compiler->program->name);
+  orc_compiler_append_code(compiler,"%s:\n", compiler->program->name);
+
+  orc_sve_emit_ptrue (compiler, 1, ORC_SVE_PRED_ALL);
+  orc_sve_init_accumulators (compiler);
+  orc_compiler_emit_invariants (compiler);
+  orc_sve_load_pointers (compiler);
+
+  if (compiler->program->is_2d) {
+    if (compiler->program->constant_m > 0) {
+      orc_arm64_emit_mov_imm (compiler, 32, ORC_ARM64_IP1,
+          compiler->program->constant_m);
+    } else {
+      orc_arm64_emit_load_reg (compiler, 32, ORC_ARM64_IP1,
+          compiler->exec_reg,
+          (int)ORC_STRUCT_OFFSET(OrcExecutor, params[ORC_VAR_A1]));
+    }
+  }
+
+  orc_arm64_emit_load_reg (compiler, 32, ORC_SVE_COUNT_REG,
+      compiler->exec_reg, (int)ORC_STRUCT_OFFSET(OrcExecutor, n));
+
+  if (compiler->program->is_2d) {
+    orc_arm_emit_label (compiler, LABEL_OUTER_LOOP);
+  }
+
+  orc_arm64_emit_movz (compiler, 64, 0, ORC_SVE_INDEX_REG, 0);
+  orc_sve_emit_whilelt (compiler, size, ORC_SVE_PRED_LOOP, ORC_SVE_INDEX_REG,
+      ORC_SVE_COUNT_REG);
+  /* b.none */
+  orc_arm_emit_branch (compiler, ORC_ARM_COND_EQ, LABEL_LOOP_SKIP);
+
+  orc_arm_emit_label (compiler, LABEL_LOOP);
+  orc_sve_emit_loop (compiler);
+  orc_sve_emit_inc (compiler, size, ORC_SVE_INDEX_REG);
+  orc_sve_emit_whilelt (compiler, size, ORC_SVE_PRED_LOOP, ORC_SVE_INDEX_REG,
+      ORC_SVE_COUNT_REG);
+  /* b.first */
+  orc_arm_emit_branch (compiler, ORC_ARM_COND_MI, LABEL_LOOP);
+  orc_arm_emit_label (compiler, LABEL_LOOP_SKIP);
+
+  if (compiler->program->is_2d) {
+    orc_sve_add_strides (compiler);
+    orc_arm64_emit_subs_imm (compiler, 32, ORC_ARM64_IP1, ORC_ARM64_IP1, 1);
+    orc_arm_emit_branch (compiler, ORC_ARM_COND_NE, LABEL_OUTER_LOOP);
+  }
+
+  orc_sve_save_accumulators (compiler);
+
+  orc_arm_emit_bx_lr (compiler);
+
+  orc_arm_do_fixups (compiler);
+}
+
+static void
+orc_sve_emit_loop (OrcCompiler *compiler)
+{
+  int j;
+  OrcInstruction *insn;
+  OrcStaticOpcode *opcode;
+  OrcRule *rule;
+
+  orc_compiler_append_code(compiler,"# LOOP shift %d\n", compiler->loop_shift);
+  for(j=0;j<compiler->n_insns;j++){
+    compiler->insn_index = j;
+    insn = compiler->insns + j;
+    opcode = insn->opcode;
+
+    if (insn->flags & ORC_INSN_FLAG_INVARIANT) continue;
+
+    orc_compiler_append_code(compiler,"# %d: %s\n", j, insn->opcode->name);
+
+    compiler->insn_shift = compiler->loop_shift;
+    if (insn->flags & ORC_INSTRUCTION_FLAG_X2) {
+      compiler->insn_shift += 1;
+    }
+    if (insn->flags & ORC_INSTRUCTION_FLAG_X4) {
+      compiler->insn_shift += 2;
+    }
+
+    rule = insn->rule;
+    if (rule && rule->emit) {
+      rule->emit (compiler, rule->emit_user, insn);
+    } else {
+      orc_compiler_append_code(compiler,"No rule for: %s\n", opcode->name);
+    }
+  }
+}
@@ -19,6 +19,8 @@
 // with the region 1 labels (LABEL_STEP_UP)
 #define LABEL_STEP_DOWN(x) (8 + (x))
 #define LABEL_STEP_UP(x) (t->label_step_up + (x))
+#define LABEL_REGION2_UNALIGNED 24
+#define LABEL_INNER_LOOP_START_UNALIGNED 25
 
 static void
 orc_x86_validate_registers (OrcX86Target *t, OrcCompiler *c)
@@ -56,13 +58,13 @@ static void
 orc_x86_compiler_max_loop_shift (OrcX86Target *t, OrcCompiler *c)
 {
   int i;
-  int n = 2;
+  int n = 1;
 
-  for (i = 1; i; i++) {
-    if ((t->register_size / c->max_var_size) == n)
-      break;
+  /* 0 when the widest variable fills a whole register (8-byte
+   * variables on MMX) */
+  for (i = 0; n < t->register_size / c->max_var_size; i++) {
     n *= 2;
-  } 
+  }
   c->loop_shift = i;
 }
 
@@ -150,7 +152,7 @@ orc_x86_compiler_init (OrcCompiler *c)
   if (c->n_insns <= 10 && c->loop_shift > 0) {
     c->unroll_shift = 1;
   }
-  if (!c->long_jumps) {
+  if (!c->long_jumps || (c->target_flags & ORC_TARGET_BASELINE)) {
     c->unroll_shift = 0;
   }
   c->alloc_loop_counter = TRUE;
@@ -262,6 +264,13 @@ orc_x86_load_constants_outer (OrcX86Target *t, OrcCompiler *c)
   orc_compiler_emit_invariants (c);
   orc_x86_init_constants (t, c);
 
+  if (c->has_index_opcode) {
+    orc_x86_emit_mov_imm_reg (c, 4, 0, c->gp_tmpreg);
+    orc_x86_emit_mov_reg_memoffset (c, 4, c->gp_tmpreg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[ORC_VAR_T10]),
+        c->exec_reg);
+  }
+
   /* FIXME ldreslinb, ldreslinl, ldresnearb, ldresnearl
    * are special opcodes that require more initialization
    * but their flags are shared among more opcodes. These
@@ -432,6 +441,24 @@ orc_x86_get_max_alignment_var (OrcX86Target *t, OrcCompiler *c)
 }
 
 
+/* Iterator opcodes read their source at half the rate of the loop, so
+ * that source can't be used to compute the peel. */
+static int
+orc_x86_is_iterator_var (OrcCompiler *c, int var)
+{
+  int i;
+
+  for (i = 0; i < c->n_insns; i++) {
+    OrcInstruction *insn = c->insns + i;
+
+    if ((insn->opcode->flags & ORC_STATIC_OPCODE_ITERATOR)
+        && insn->src_args[0] == var)
+      return TRUE;
+  }
+
+  return FALSE;
+}
+
 static int
 orc_x86_get_shift (OrcX86Target *t, int size)
 {
@@ -441,6 +468,36 @@ orc_x86_get_shift (OrcX86Target *t, int size)
   return t->get_shift(size);
 }
 
+static void
+orc_x86_emit_split_2_regions (OrcX86Target *t, OrcCompiler *compiler)
+{
+  int align_var;
+  int align_shift ORC_GNUC_UNUSED;
+  int var_size_shift;
+
+  align_var = orc_x86_get_max_alignment_var (t, compiler);
+  if (align_var < 0)
+    return;
+  var_size_shift = orc_x86_get_shift (t, compiler->vars[align_var].size);
+  align_shift = var_size_shift + compiler->loop_shift;
+
+  /* Calculate n2 */
+  orc_x86_emit_mov_memoffset_reg (compiler, 4,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, n), compiler->exec_reg,
+      compiler->gp_tmpreg);
+  orc_x86_emit_mov_reg_reg (compiler, 4, compiler->gp_tmpreg, X86_EAX);
+  orc_x86_emit_sar_imm_reg (compiler, 4,
+      compiler->loop_shift + compiler->unroll_shift, compiler->gp_tmpreg);
+  orc_x86_emit_mov_reg_memoffset (compiler, 4, compiler->gp_tmpreg,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
+
+  /* Calculate n3 */
+  orc_x86_emit_and_imm_reg (compiler, 4,
+      (1 << (compiler->loop_shift + compiler->unroll_shift)) - 1, X86_EAX);
+  orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter3), compiler->exec_reg);
+}
+
 static void
 orc_x86_emit_split_3_regions (OrcX86Target *t, OrcCompiler *compiler)
 {
@@ -466,6 +523,13 @@ orc_x86_emit_split_3_regions (OrcX86Target *t, OrcCompiler *compiler)
   // Undo the shift to determine number of ELEMENTS
   orc_x86_emit_sar_imm_reg (compiler, 4, var_size_shift, X86_EAX);
 
+  /* Iterator opcodes advance their source pointer at half rate, so
+   * region 1 can only run for an even number of elements. */
+  if (compiler->has_iterator_opcode) {
+    orc_x86_emit_test_imm_reg (compiler, 4, 1, X86_EAX);
+    orc_x86_emit_jne (compiler, 6);
+  }
+
   /* check if n1 is greater than n. */
   orc_x86_emit_cmp_reg_memoffset (compiler, 4, X86_EAX,
       (int)ORC_STRUCT_OFFSET (OrcExecutor, n), compiler->exec_reg);
@@ -497,52 +561,32 @@ orc_x86_emit_split_3_regions (OrcX86Target *t, OrcCompiler *compiler)
 
   orc_x86_emit_jmp (compiler, 7);
 
-  /* else, iterations are all unaligned: n1=n, n2=0, n3=0 */
   orc_x86_emit_label (compiler, 6);
 
-  orc_x86_emit_mov_memoffset_reg (compiler, 4,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, n), compiler->exec_reg, X86_EAX);
-  orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter1), compiler->exec_reg);
-  orc_x86_emit_mov_imm_reg (compiler, 4, 0, X86_EAX);
-  orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
-  orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter3), compiler->exec_reg);
+  if (compiler->has_iterator_opcode) {
+    /* else, the array cannot be aligned with an even peel: skip region 1
+     * and run the unaligned copy of region 2. An odd counter1 flags this
+     * case, region 1 only tests the even bits. */
+    orc_x86_emit_mov_imm_reg (compiler, 4, 1, X86_EAX);
+    orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter1), compiler->exec_reg);
+    orc_x86_emit_split_2_regions (t, compiler);
+  } else {
+    /* else, iterations are all unaligned: n1=n, n2=0, n3=0 */
+    orc_x86_emit_mov_memoffset_reg (compiler, 4,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, n), compiler->exec_reg, X86_EAX);
+    orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter1), compiler->exec_reg);
+    orc_x86_emit_mov_imm_reg (compiler, 4, 0, X86_EAX);
+    orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
+    orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter3), compiler->exec_reg);
+  }
 
   orc_x86_emit_label (compiler, 7);
 }
 
-static void
-orc_x86_emit_split_2_regions (OrcX86Target *t, OrcCompiler *compiler)
-{
-  int align_var;
-  int align_shift ORC_GNUC_UNUSED;
-  int var_size_shift;
-
-  align_var = orc_x86_get_max_alignment_var (t, compiler);
-  if (align_var < 0)
-    return;
-  var_size_shift = orc_x86_get_shift (t, compiler->vars[align_var].size);
-  align_shift = var_size_shift + compiler->loop_shift;
-
-  /* Calculate n2 */
-  orc_x86_emit_mov_memoffset_reg (compiler, 4,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, n), compiler->exec_reg,
-      compiler->gp_tmpreg);
-  orc_x86_emit_mov_reg_reg (compiler, 4, compiler->gp_tmpreg, X86_EAX);
-  orc_x86_emit_sar_imm_reg (compiler, 4,
-      compiler->loop_shift + compiler->unroll_shift, compiler->gp_tmpreg);
-  orc_x86_emit_mov_reg_memoffset (compiler, 4, compiler->gp_tmpreg,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
-
-  /* Calculate n3 */
-  orc_x86_emit_and_imm_reg (compiler, 4,
-      (1 << (compiler->loop_shift + compiler->unroll_shift)) - 1, X86_EAX);
-  orc_x86_emit_mov_reg_memoffset (compiler, 4, X86_EAX,
-      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter3), compiler->exec_reg);
-}
-
 /*
  * The following code was ported from the MIPS backend,
  * and extended to allow for store reordering and the
@@ -683,7 +727,8 @@ get_optimised_instruction_order (OrcCompiler *compiler)
   for (int i=0; i<compiler->n_insns; i++)
     instruction_idx[i] = i;
 
-  optimise_order (compiler, instruction_idx);
+  if (!(compiler->target_flags & ORC_TARGET_BASELINE))
+    optimise_order (compiler, instruction_idx);
 
   return instruction_idx;
 }
@@ -758,11 +803,53 @@ orc_x86_emit_loop (OrcCompiler *compiler, int offset, int update)
         }
       }
     }
+    if (compiler->has_index_opcode) {
+      orc_x86_emit_add_imm_memoffset (compiler, 4, update,
+          (int)ORC_STRUCT_OFFSET (OrcExecutor, params[ORC_VAR_T10]),
+          compiler->exec_reg);
+    }
   }
 
   free (insn_idx);
 }
 
+static void
+orc_x86_emit_region2 (OrcCompiler *compiler, int label_loop, int label_skip)
+{
+  int ui, ui_max;
+
+  orc_x86_emit_cmp_imm_memoffset (compiler, 4, 0,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
+  orc_x86_emit_je (compiler, label_skip);
+
+  if (compiler->loop_counter != ORC_REG_INVALID) {
+    orc_x86_emit_mov_memoffset_reg (compiler, 4,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg,
+        compiler->loop_counter);
+  }
+
+  ORC_ASM_CODE (compiler, "# LOOP SHIFT %d\n", compiler->loop_shift);
+  // Instruction fetch windows are 16-byte aligned
+  // https://easyperf.net/blog/2018/01/18/Code_alignment_issues
+  orc_x86_emit_align (compiler, 4);
+  orc_x86_emit_label (compiler, label_loop);
+  ui_max = 1 << compiler->unroll_shift;
+  for (ui = 0; ui < ui_max; ui++) {
+    compiler->offset = ui << compiler->loop_shift;
+    orc_x86_emit_loop (compiler, compiler->offset,
+        (ui == ui_max - 1)
+            << (compiler->loop_shift + compiler->unroll_shift));
+  }
+  compiler->offset = 0;
+  if (compiler->loop_counter != ORC_REG_INVALID) {
+    orc_x86_emit_add_imm_reg (compiler, 4, -1, compiler->loop_counter, TRUE);
+  } else {
+    orc_x86_emit_dec_memoffset (compiler, 4,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
+  }
+  orc_x86_emit_jne (compiler, label_loop);
+}
+
 static void
 orc_x86_set_mxcsr (OrcX86Target *t, OrcCompiler *c)
 {
@@ -809,6 +896,7 @@ orc_x86_compile (OrcCompiler *compiler)
   int set_mxcsr = FALSE;
   int align_var;
   int is_aligned;
+  int peel_iterator;
 
   t = compiler->target->target_data;
   align_var = orc_x86_get_max_alignment_var (t, compiler);
@@ -821,6 +909,12 @@ orc_x86_compile (OrcCompiler *compiler)
   orc_x86_adjust_alignment (t, compiler);
 
   is_aligned = compiler->vars[align_var].is_aligned;
+
+  /* Programs with iterator opcodes can still be peeled, as long as
+   * region 1 covers an even number of elements. When that isn't possible
+   * at runtime, an unaligned copy of region 2 is used instead. */
+  peel_iterator = compiler->has_iterator_opcode && !is_aligned
+      && !orc_x86_is_iterator_var (compiler, align_var);
   {
     orc_x86_emit_loop (compiler, 0, 0);
 
@@ -873,7 +967,7 @@ orc_x86_compile (OrcCompiler *compiler)
       && compiler->program->constant_n <= ORC_X86_ALIGNED_DEST_CUTOFF) {
     /* don't need to load n */
   } else if (compiler->loop_shift > 0) {
-    if (compiler->has_iterator_opcode || is_aligned) {
+    if ((compiler->has_iterator_opcode && !peel_iterator) || is_aligned) {
       orc_x86_emit_split_2_regions (t, compiler);
     } else {
       /* split n into three regions, with center region being aligned */
@@ -917,17 +1011,24 @@ orc_x86_compile (OrcCompiler *compiler)
     }
     compiler->loop_shift = save_loop_shift;
 
+    if (compiler->has_index_opcode) {
+      orc_x86_emit_add_imm_memoffset (compiler, 4,
+          compiler->program->constant_n,
+          (int)ORC_STRUCT_OFFSET (OrcExecutor, params[ORC_VAR_T10]),
+          compiler->exec_reg);
+    }
+
   } else {
-    int ui, ui_max;
     int emit_region1 = TRUE;
     int emit_region3 = TRUE;
 
-    if (compiler->has_iterator_opcode || is_aligned) {
+    if ((compiler->has_iterator_opcode && !peel_iterator) || is_aligned) {
       emit_region1 = FALSE;
     }
     if (compiler->loop_shift == 0) {
       emit_region1 = FALSE;
       emit_region3 = FALSE;
+      peel_iterator = FALSE;
     }
 
     if (emit_region1) {
@@ -937,7 +1038,8 @@ orc_x86_compile (OrcCompiler *compiler)
       save_loop_shift = compiler->loop_shift;
       compiler->vars[align_var].is_aligned = FALSE;
 
-      for (l = 0; l < save_loop_shift; l++) {
+      /* the peel of an iterator program is always even */
+      for (l = peel_iterator ? 1 : 0; l < save_loop_shift; l++) {
         compiler->loop_shift = l;
         ORC_ASM_CODE (compiler, "# LOOP SHIFT %d\n", compiler->loop_shift);
 
@@ -954,36 +1056,23 @@ orc_x86_compile (OrcCompiler *compiler)
 
     orc_x86_emit_label (compiler, LABEL_REGION1_SKIP);
 
-    orc_x86_emit_cmp_imm_memoffset (compiler, 4, 0,
-        (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
-    orc_x86_emit_je (compiler, LABEL_REGION2_SKIP);
-
-    if (compiler->loop_counter != ORC_REG_INVALID) {
-      orc_x86_emit_mov_memoffset_reg (compiler, 4,
-          (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg,
-          compiler->loop_counter);
+    if (peel_iterator) {
+      orc_x86_emit_test_imm_memoffset (compiler, 4, 1,
+          (int)ORC_STRUCT_OFFSET (OrcExecutor, counter1), compiler->exec_reg);
+      orc_x86_emit_jne (compiler, LABEL_REGION2_UNALIGNED);
     }
 
-    ORC_ASM_CODE (compiler, "# LOOP SHIFT %d\n", compiler->loop_shift);
-    // Instruction fetch windows are 16-byte aligned
-    // https://easyperf.net/blog/2018/01/18/Code_alignment_issues
-    orc_x86_emit_align (compiler, 4);
-    orc_x86_emit_label (compiler, LABEL_INNER_LOOP_START);
-    ui_max = 1 << compiler->unroll_shift;
-    for (ui = 0; ui < ui_max; ui++) {
-      compiler->offset = ui << compiler->loop_shift;
-      orc_x86_emit_loop (compiler, compiler->offset,
-          (ui == ui_max - 1)
-              << (compiler->loop_shift + compiler->unroll_shift));
-    }
-    compiler->offset = 0;
-    if (compiler->loop_counter != ORC_REG_INVALID) {
-      orc_x86_emit_add_imm_reg (compiler, 4, -1, compiler->loop_counter, TRUE);
-    } else {
-      orc_x86_emit_dec_memoffset (compiler, 4,
-          (int)ORC_STRUCT_OFFSET (OrcExecutor, counter2), compiler->exec_reg);
+    orc_x86_emit_region2 (compiler, LABEL_INNER_LOOP_START,
+        LABEL_REGION2_SKIP);
+
+    if (peel_iterator) {
+      orc_x86_emit_jmp (compiler, LABEL_REGION2_SKIP);
+      orc_x86_emit_label (compiler, LABEL_REGION2_UNALIGNED);
+
+      compiler->vars[align_var].is_aligned = FALSE;
+      orc_x86_emit_region2 (compiler, LABEL_INNER_LOOP_START_UNALIGNED,
+          LABEL_REGION2_SKIP);
     }
-    orc_x86_emit_jne (compiler, LABEL_INNER_LOOP_START);
     orc_x86_emit_label (compiler, LABEL_REGION2_SKIP);
 
     if (emit_region3) {
@@ -1029,6 +1118,10 @@ orc_x86_compile (OrcCompiler *compiler)
 
   orc_x86_emit_epilogue (compiler);
 
+  if (!(compiler->target_flags & ORC_TARGET_BASELINE) &&
+      !orc_compiler_flag_check ("-peephole"))
+    orc_x86_peephole (compiler);
+
   orc_x86_calculate_offsets (compiler);
   orc_x86_output_insns (compiler);
 
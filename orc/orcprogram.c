@@ -242,6 +242,23 @@ orc_program_set_2d (OrcProgram *program)
   program->is_2d = TRUE;
 }
 
+/**
+ * orc_program_set_fast_math:
+ * @program: a pointer to an OrcProgram structure
+ *
+ * Sets a flag on the program allowing the compiler to relax the
+ * precision of floating point instructions.  This is equivalent to
+ * compiling the program with %ORC_TARGET_FAST_MATH.  The compiler
+ * may then contract a multiplication followed by an addition into a
+ * fused multiply-add, which rounds once instead of twice.  The error
+ * bounds are documented with the ".flags fastmath" directive.
+ */
+void
+orc_program_set_fast_math (OrcProgram *program)
+{
+  program->is_fast_math = TRUE;
+}
+
 void orc_program_set_constant_n (OrcProgram *program, int n)
 {
   program->constant_n = n;
@@ -1105,7 +1122,11 @@ orc_program_append_dds_str (OrcProgram *program, const char *name,
  *
  * Returns a character string containing the assembly code created
  * by compiling the program.  This string is valid until the program
- * is compiled again or the program is freed.
+ * is compiled again or the program is freed.  Programs that share the
+ * code of an identical program compiled before have no assembly code,
+ * and programs compiled in tiers have the assembly code of the baseline
+ * tier; compile with ORC_TARGET_PRIVATE_CODE to always generate the
+ * assembly code of the optimised program.
  * 
  * Returns: a character string
  */
@@ -1203,6 +1224,61 @@ orc_program_get_max_accumulator_size (OrcProgram *program)
   return max;
 }
 
+/* The cache geometry is not known on all systems, these are the common
+ * values.  CACHE_SET_SPAN is the distance after which addresses map to
+ * the same L1 set again (32 KiB 8-way, 48 KiB 12-way), which is also the
+ * distance of 4K aliasing. */
+#define CACHE_LINE_SIZE 64
+#define CACHE_SET_SPAN 4096
+
+/**
+ * orc_program_get_stride_padding:
+ * @program: a pointer to an OrcProgram structure
+ * @var: the source or destination array
+ * @n: the width of the rows, in elements
+ *
+ * Returns how many bytes to add to @n elements of @var to get a row
+ * stride that works well with the data cache.  Strides are rounded up to
+ * whole cache lines.  When the program streams more than one array,
+ * strides that are a multiple of a large power of two get one more cache
+ * line: rows with such strides all fall in a few sets of the L1 cache,
+ * and loads and stores in different arrays end up 4 KiB apart, which
+ * stalls the loads on x86.
+ *
+ * Returns: the padding in bytes, or 0 if @var is not an array
+ */
+int
+orc_program_get_stride_padding (OrcProgram *program, int var, int n)
+{
+  OrcVariable *v;
+  int n_arrays;
+  int stride;
+  int row;
+  int i;
+
+  if (var < ORC_VAR_D1 || var > ORC_VAR_S8) return 0;
+  v = program->vars + var;
+  if (v->size == 0) return 0;
+
+  n_arrays = 0;
+  for(i=ORC_VAR_D1;i<=ORC_VAR_S8;i++){
+    if (program->vars[i].size) n_arrays++;
+  }
+
+  row = n * v->size;
+  stride = (row + CACHE_LINE_SIZE - 1) & ~(CACHE_LINE_SIZE - 1);
+
+  if (n_arrays > 1) {
+    /* rows with such a stride only use an eighth of the sets or less;
+     * with an odd number of cache lines they go through all of them */
+    if (stride % (CACHE_SET_SPAN / 8) == 0) {
+      stride += CACHE_LINE_SIZE;
+    }
+  }
+
+  return stride - row;
+}
+
 void
 orc_program_reset (OrcProgram *program)
 {
@@ -1228,6 +1304,27 @@ orc_program_take_code (OrcProgram *program)
   return code;
 }
 
+/**
+ * orc_program_replace_code:
+ * @program: a compiled OrcProgram
+ * @code: code compiled for the same program with ORC_TARGET_PRIVATE_CODE
+ *
+ * Makes @program run @code, which is consumed.  Other threads may be
+ * running @program with orc_executor_run() meanwhile, see
+ * orc_code_replace().  If the code of @program is shared with other
+ * programs, they switch to @code as well.
+ */
+void
+orc_program_replace_code (OrcProgram *program, OrcCode *code)
+{
+  if (program->orccode) {
+    orc_code_replace (program->orccode, code);
+  } else {
+    program->orccode = code;
+  }
+  orc_atomic_store (&program->code_exec, (void *)program->orccode->exec);
+}
+
 int
 orc_program_has_float (OrcCompiler *compiler)
 {
@@ -1295,6 +1392,14 @@ orc_program_compile_for_target (OrcProgram *program, OrcTarget *target)
  * Compiles an Orc program for the given target, using the
  * given target flags.
  *
+ * Code for executable targets is shared with identical programs and
+ * compiled in tiers: baseline code first, optimised code once the
+ * program is hot.  ORC_TARGET_PRIVATE_CODE compiles the optimised code
+ * for this program alone, and ORC_TARGET_BASELINE compiles baseline code
+ * only.  ORC_TARGET_NO_NARROW keeps widening arithmetic at the width
+ * written in the program; optimised code compiled on tier-up always
+ * does.
+ *
  * Returns: an OrcCompileResult
  */
 OrcCompileResult
@@ -1302,8 +1407,17 @@ orc_program_compile_full (OrcProgram *program, OrcTarget *target,
     unsigned int flags)
 {
   OrcCompiler *compiler;
+  OrcCompileResult result;
+
+  ORC_PROBE3 (compile_start, program->name, target ? target->name : NULL,
+      flags);
 
   compiler = malloc (sizeof(OrcCompiler));
   memset (compiler, 0, sizeof(OrcCompiler));
-  return orc_compiler_compile_program (compiler, program, target, flags);
+  result = orc_compiler_compile_program (compiler, program, target, flags);
+
+  ORC_PROBE3 (compile_done, program->name, target ? target->name : NULL,
+      result);
+
+  return result;
 }
@@ -94,6 +94,9 @@ struct _OrcProgram {
   char *init_function;
   char *error_msg;
   unsigned int current_line;
+
+  /* Appended to keep the offsets of the fields above */
+  int is_fast_math;
 };
 
 #define ORC_SRC_ARG(p,i,n) ((p)->vars[(i)->src_args[(n)]].alloc)
@@ -115,6 +118,7 @@ ORC_API const char * orc_program_get_name (OrcProgram *program);
 ORC_API void orc_program_set_name (OrcProgram *program, const char *name);
 ORC_API void orc_program_set_line (OrcProgram *program, unsigned int line);
 ORC_API void orc_program_set_2d (OrcProgram *program);
+ORC_API void orc_program_set_fast_math (OrcProgram *program);
 ORC_API void orc_program_set_constant_n (OrcProgram *program, int n);
 ORC_API void orc_program_set_n_multiple (OrcProgram *ex, int n);
 ORC_API void orc_program_set_n_minimum (OrcProgram *ex, int n);
@@ -174,6 +178,7 @@ ORC_API int orc_program_allocate_register (OrcProgram *program, int is_data);
 
 ORC_API void orc_program_reset (OrcProgram *program);
 ORC_API OrcCode *orc_program_take_code (OrcProgram *program);
+ORC_API void orc_program_replace_code (OrcProgram *program, OrcCode *code);
 
 ORC_API const char *orc_program_get_asm_code (OrcProgram *program);
 ORC_API const char * orc_program_get_error (OrcProgram *program);
@@ -181,6 +186,8 @@ ORC_API void orc_program_set_error (OrcProgram *program, const char *error);
 
 ORC_API int orc_program_get_max_array_size (OrcProgram *program);
 ORC_API int orc_program_get_max_accumulator_size (OrcProgram *program);
+ORC_API int orc_program_get_stride_padding (OrcProgram *program, int var,
+    int n);
 
 
 ORC_END_DECLS
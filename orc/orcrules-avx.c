@@ -2688,6 +2688,637 @@ BINARY (muld, mulpd)
 BINARY (divd, divpd)
 UNARY (sqrtd, sqrtpd)
 
+/* d = s1 * s2 + s3, picking the FMA form that overwrites whichever
+ * source the destination was allocated to */
+static void
+avx_rule_fmaX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int src2 = p->vars[insn->src_args[2]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int opcodes_213[] = { ORC_X86_fmadd213ps_avx, ORC_X86_fmadd213pd_avx };
+  const int opcodes_231[] = { ORC_X86_fmadd231ps_avx, ORC_X86_fmadd231pd_avx };
+  const int type = ORC_PTR_TO_INT (user);
+
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int prefix = size >= 32 ? ORC_X86_AVX_VEX256_PREFIX
+      : ORC_X86_AVX_VEX128_PREFIX;
+
+  if (dest == src0) {
+    orc_vex_emit_cpuinsn_size (p, opcodes_213[type], 32, src1, src2, dest,
+        prefix);
+  } else if (dest == src1) {
+    orc_vex_emit_cpuinsn_size (p, opcodes_213[type], 32, src0, src2, dest,
+        prefix);
+  } else {
+    if (dest != src2) {
+      if (size >= 32) {
+        orc_avx_emit_movdqa (p, src2, dest);
+      } else {
+        orc_avx_sse_emit_movdqa (p, src2, dest);
+      }
+    }
+    orc_vex_emit_cpuinsn_size (p, opcodes_231[type], 32, src0, src1, dest,
+        prefix);
+  }
+}
+
+/* complex float ops on interleaved (re,im) pairs, see the SSE3 rules */
+static void
+avx_rule_mulcX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+  const int conj = ORC_PTR_TO_INT (user);
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int swap = ORC_AVX_SSE_SHUF (2, 3, 0, 1);
+
+  if (size >= 32) {
+    if (conj) {
+      orc_avx_emit_movshdup (p, src1, tmp);
+      orc_avx_emit_mulps (p, src0, tmp, tmp);
+      orc_avx_emit_movsldup (p, src1, tmp2);
+      orc_avx_emit_shufps_imm (p, swap, src0, src0, dest);
+      orc_avx_emit_mulps (p, dest, tmp2, dest);
+      orc_avx_emit_addsubps (p, dest, tmp, dest);
+      orc_avx_emit_shufps_imm (p, swap, dest, dest, dest);
+    } else {
+      orc_avx_emit_shufps_imm (p, swap, src0, src0, tmp);
+      orc_avx_emit_movshdup (p, src1, tmp2);
+      orc_avx_emit_mulps (p, tmp, tmp2, tmp);
+      orc_avx_emit_movsldup (p, src1, tmp2);
+      orc_avx_emit_mulps (p, src0, tmp2, dest);
+      orc_avx_emit_addsubps (p, dest, tmp, dest);
+    }
+  } else {
+    if (conj) {
+      orc_avx_sse_emit_movshdup (p, src1, tmp);
+      orc_avx_sse_emit_mulps (p, src0, tmp, tmp);
+      orc_avx_sse_emit_movsldup (p, src1, tmp2);
+      orc_avx_sse_emit_shufps_imm (p, swap, src0, src0, dest);
+      orc_avx_sse_emit_mulps (p, dest, tmp2, dest);
+      orc_avx_sse_emit_addsubps (p, dest, tmp, dest);
+      orc_avx_sse_emit_shufps_imm (p, swap, dest, dest, dest);
+    } else {
+      orc_avx_sse_emit_shufps_imm (p, swap, src0, src0, tmp);
+      orc_avx_sse_emit_movshdup (p, src1, tmp2);
+      orc_avx_sse_emit_mulps (p, tmp, tmp2, tmp);
+      orc_avx_sse_emit_movsldup (p, src1, tmp2);
+      orc_avx_sse_emit_mulps (p, src0, tmp2, dest);
+      orc_avx_sse_emit_addsubps (p, dest, tmp, dest);
+    }
+  }
+}
+
+static void
+avx_rule_magsqcf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+
+  if (size >= 32) {
+    const int tmp = orc_compiler_get_temp_reg (p);
+
+    /* hadd within each half, pairing the low half with the high one */
+    orc_avx_emit_mulps (p, src, src, dest);
+    orc_avx_emit_extractf128_si256 (p, 1, dest, tmp);
+    orc_avx_sse_emit_haddps (p, dest, tmp, dest);
+  } else {
+    orc_avx_sse_emit_mulps (p, src, src, dest);
+    orc_avx_sse_emit_haddps (p, dest, dest, dest);
+  }
+}
+
+/* pairwise ops; a full 256-bit source yields a 128-bit result, so the
+ * high half is extracted and both halves are narrowed together */
+
+static void
+avx_rule_addpb (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int mask = orc_compiler_get_constant (p, 2, 0xff);
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (size >= 32) {
+    if (ORC_PTR_TO_INT (user)) {
+      orc_avx_emit_psrlw_imm (p, 8, src, tmp);
+      orc_avx_emit_pavgb (p, src, tmp, dest);
+    } else {
+      orc_avx_emit_pmaddubsw (p, src, orc_compiler_get_constant (p, 1, 0x01),
+          dest);
+    }
+    orc_avx_emit_pand (p, dest, mask, dest);
+    orc_avx_emit_extractf128_si256 (p, 1, dest, tmp);
+    orc_avx_sse_emit_packuswb (p, dest, tmp, dest);
+  } else {
+    if (ORC_PTR_TO_INT (user)) {
+      orc_avx_sse_emit_psrlw_imm (p, 8, src, tmp);
+      orc_avx_sse_emit_pavgb (p, src, tmp, dest);
+    } else {
+      orc_avx_sse_emit_pmaddubsw (p, src,
+          orc_compiler_get_constant (p, 1, 0x01), dest);
+    }
+    orc_avx_sse_emit_pand (p, dest, mask, dest);
+    orc_avx_sse_emit_packuswb (p, dest, dest, dest);
+  }
+}
+
+static void
+avx_rule_addpw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (ORC_PTR_TO_INT (user)) {
+    if (size >= 32) {
+      orc_avx_emit_psrld_imm (p, 16, src, tmp);
+      orc_avx_emit_pavgw (p, src, tmp, dest);
+      orc_avx_emit_pslld_imm (p, 16, dest, dest);
+      orc_avx_emit_psrad_imm (p, 16, dest, dest);
+      orc_avx_emit_extractf128_si256 (p, 1, dest, tmp);
+      orc_avx_sse_emit_packssdw (p, dest, tmp, dest);
+    } else {
+      orc_avx_sse_emit_psrld_imm (p, 16, src, tmp);
+      orc_avx_sse_emit_pavgw (p, src, tmp, dest);
+      orc_avx_sse_emit_pslld_imm (p, 16, dest, dest);
+      orc_avx_sse_emit_psrad_imm (p, 16, dest, dest);
+      orc_avx_sse_emit_packssdw (p, dest, dest, dest);
+    }
+  } else {
+    if (size >= 32) {
+      orc_avx_emit_extractf128_si256 (p, 1, src, tmp);
+      orc_avx_sse_emit_phaddw (p, src, tmp, dest);
+    } else {
+      orc_avx_sse_emit_phaddw (p, src, src, dest);
+    }
+  }
+}
+
+static void
+avx_rule_addpl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  int hi = src;
+
+  if (size >= 32) {
+    orc_avx_emit_extractf128_si256 (p, 1, src, tmp);
+    hi = tmp;
+  }
+
+  if (ORC_PTR_TO_INT (user)) {
+    const int tmp2 = orc_compiler_get_temp_reg (p);
+
+    /* (a+b+1) >> 1 = (a|b) - ((a^b)>>1) */
+    orc_avx_sse_emit_shufps_imm (p, ORC_AVX_SSE_SHUF (3, 1, 3, 1), src, hi,
+        tmp2);
+    orc_avx_sse_emit_shufps_imm (p, ORC_AVX_SSE_SHUF (2, 0, 2, 0), src, hi,
+        dest);
+    orc_avx_sse_emit_pxor (p, dest, tmp2, tmp);
+    orc_avx_sse_emit_psrld_imm (p, 1, tmp, tmp);
+    orc_avx_sse_emit_por (p, dest, tmp2, dest);
+    orc_avx_sse_emit_psubd (p, dest, tmp, dest);
+  } else {
+    orc_avx_sse_emit_phaddd (p, src, hi, dest);
+  }
+}
+
+static void
+avx_rule_addpf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+
+  if (size >= 32) {
+    const int tmp = orc_compiler_get_temp_reg (p);
+
+    orc_avx_emit_extractf128_si256 (p, 1, src, tmp);
+    orc_avx_sse_emit_haddps (p, src, tmp, dest);
+  } else {
+    orc_avx_sse_emit_haddps (p, src, src, dest);
+  }
+  if (ORC_PTR_TO_INT (user)) {
+    orc_avx_sse_emit_mulps (p, dest,
+        orc_compiler_get_constant (p, 4, 0x3f000000), dest);
+  }
+}
+
+/* Same hash as the SSE rule; the upper lane starts at index + 4. */
+static void
+avx_rule_randX_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int type = ORC_PTR_TO_INT (user);
+  const int seed_var = insn->src_args[0];
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->dest_args[0]].size << p->loop_shift;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "rand opcodes cannot be used with x2 or x4");
+    return;
+  }
+
+  if (p->vars[seed_var].vartype == ORC_VAR_TYPE_CONST) {
+    orc_x86_emit_mov_imm_reg (p, 4,
+        (orc_uint32)p->vars[seed_var].value.i * ORC_RAND_MULTIPLIER +
+        p->offset, p->gp_tmpreg);
+  } else {
+    orc_x86_emit_mov_imm_reg (p, 4, ORC_RAND_MULTIPLIER, p->gp_tmpreg);
+    orc_x86_emit_imul_memoffset_reg (p, 4,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[seed_var]),
+        p->exec_reg, p->gp_tmpreg);
+    if (p->offset) {
+      orc_x86_emit_add_imm_reg (p, 4, p->offset, p->gp_tmpreg, FALSE);
+    }
+  }
+  orc_x86_emit_add_memoffset_reg (p, 4,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, params[ORC_VAR_T10]),
+      p->exec_reg, p->gp_tmpreg);
+  orc_avx_sse_emit_movd_load_register (p, p->gp_tmpreg, dest);
+  orc_avx_emit_pbroadcastd (p, dest, dest);
+  if (size >= 32) {
+    orc_x86_emit_add_imm_reg (p, 4, 4, p->gp_tmpreg, FALSE);
+    orc_avx_sse_emit_movd_load_register (p, p->gp_tmpreg, tmp);
+    orc_avx_emit_pbroadcastd (p, tmp, tmp);
+    orc_avx_emit_permute2i128 (p, ORC_AVX_PERMUTE (2, 0), dest, tmp, dest);
+  }
+  orc_avx_emit_paddd (p, dest,
+      orc_compiler_get_constant_long (p, 0, 1, 2, 3), dest);
+
+  orc_avx_emit_pslld_imm (p, 15, dest, tmp);
+  orc_avx_emit_pxor (p, dest, orc_compiler_get_constant (p, 4, 0xffffffff),
+      dest);
+  orc_avx_emit_paddd (p, dest, tmp, dest);
+  orc_avx_emit_psrld_imm (p, 12, dest, tmp);
+  orc_avx_emit_pxor (p, dest, tmp, dest);
+  orc_avx_emit_pslld_imm (p, 2, dest, tmp);
+  orc_avx_emit_paddd (p, dest, tmp, dest);
+  orc_avx_emit_psrld_imm (p, 4, dest, tmp);
+  orc_avx_emit_pxor (p, dest, tmp, dest);
+  orc_avx_emit_pslld_imm (p, 3, dest, tmp);
+  orc_avx_emit_paddd (p, dest, tmp, tmp);
+  orc_avx_emit_pslld_imm (p, 11, dest, dest);
+  orc_avx_emit_paddd (p, dest, tmp, dest);
+  orc_avx_emit_psrld_imm (p, 16, dest, tmp);
+  orc_avx_emit_pxor (p, dest, tmp, dest);
+
+  if (type == 1) {
+    orc_avx_emit_psrld_imm (p, 8, dest, dest);
+    orc_avx_emit_cvtdq2ps (p, dest, dest);
+    orc_avx_emit_mulps (p, dest, orc_compiler_get_constant (p, 4, 0x33800000),
+        dest);
+  } else if (type == 2) {
+    orc_avx_emit_psrld_imm (p, 16, dest, tmp);
+    orc_avx_emit_pslld_imm (p, 16, dest, dest);
+    orc_avx_emit_psrld_imm (p, 16, dest, dest);
+    orc_avx_emit_psubd (p, dest, tmp, dest);
+    orc_avx_emit_cvtdq2ps (p, dest, dest);
+    orc_avx_emit_mulps (p, dest, orc_compiler_get_constant (p, 4, 0x37800000),
+        dest);
+  }
+}
+
+static void
+avx_rule_unpack3x10_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->dest_args[0]].size << p->loop_shift;
+  const int mask = orc_compiler_get_constant (p, 4, 0x000003ff);
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+
+  orc_avx_sse_emit_pslld_imm (p, 6, src, tmp);
+  orc_avx_sse_emit_pand (p, tmp,
+      orc_compiler_get_constant (p, 4, 0x03ff0000), tmp);
+  orc_avx_sse_emit_psrld_imm (p, 20, src, tmp2);
+  orc_avx_sse_emit_pand (p, tmp2, mask, tmp2);
+  orc_avx_sse_emit_pand (p, src, mask, dest);
+  orc_avx_sse_emit_por (p, dest, tmp, dest);
+
+  if (size >= 32) {
+    orc_avx_sse_emit_punpckhdq (p, dest, tmp2, tmp);
+    orc_avx_sse_emit_punpckldq (p, dest, tmp2, dest);
+    orc_avx_emit_permute2i128 (p, ORC_AVX_PERMUTE (2, 0), dest, tmp, dest);
+  } else {
+    orc_avx_sse_emit_punpckldq (p, dest, tmp2, dest);
+  }
+}
+
+static void
+avx_rule_pack3x10_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int mask = orc_compiler_get_constant (p, 4, 0x03ff03ff);
+  const int mul = orc_compiler_get_constant_long (p, 0x04000001, 0x00000001,
+      0x04000001, 0x00000001);
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (size >= 32) {
+    orc_avx_emit_pand (p, src, mask, dest);
+    orc_avx_emit_pmaddwd (p, dest, mul, dest);
+    orc_avx_emit_psrlq_imm (p, 32, dest, tmp);
+    orc_avx_emit_psllq_imm (p, 20, tmp, tmp);
+    orc_avx_emit_por (p, dest, tmp, dest);
+    orc_avx_emit_pshufd (p, ORC_AVX_SSE_SHUF (2, 0, 2, 0), dest, dest);
+    orc_avx_emit_permute4x64_imm (p, ORC_AVX_PERMUTE_QUAD (3, 1, 2, 0),
+        dest, dest);
+  } else {
+    orc_avx_sse_emit_pand (p, src, mask, dest);
+    orc_avx_sse_emit_pmaddwd (p, dest, mul, dest);
+    orc_avx_sse_emit_psrlq_imm (p, 32, dest, tmp);
+    orc_avx_sse_emit_psllq_imm (p, 20, tmp, tmp);
+    orc_avx_sse_emit_por (p, dest, tmp, dest);
+    orc_avx_sse_emit_pshufd (p, ORC_AVX_SSE_SHUF (2, 0, 2, 0), dest, dest);
+  }
+}
+
+/* Loads exactly n_bytes at offset from ptr_reg into the low bytes of the
+ * xmm half of reg; the remaining bytes of that half are undefined. */
+static void
+avx_load_packed (OrcCompiler *p, int ptr_reg, int offset, int n_bytes,
+    int reg)
+{
+  int i = 0;
+
+  if (n_bytes >= 8) {
+    orc_x86_emit_mov_memoffset_avx (p, 8, offset, ptr_reg, reg, FALSE);
+    i = 8;
+  } else if (n_bytes >= 4) {
+    orc_x86_emit_mov_memoffset_avx (p, 4, offset, ptr_reg, reg, FALSE);
+    i = 4;
+  }
+  for (; i + 2 <= n_bytes; i += 2) {
+    orc_avx_sse_emit_pinsrw_memoffset (p, i / 2, offset + i, reg, ptr_reg,
+        reg);
+  }
+  if (i < n_bytes) {
+    orc_avx_sse_emit_pinsrb_memoffset (p, i, offset + i, reg, ptr_reg, reg);
+  }
+}
+
+static void
+avx_store_packed (OrcCompiler *p, int reg, int n_bytes, int offset,
+    int ptr_reg)
+{
+  int i = 0;
+
+  if (n_bytes >= 8) {
+    orc_x86_emit_mov_avx_memoffset (p, 8, reg, offset, ptr_reg, FALSE, FALSE);
+    i = 8;
+  } else if (n_bytes >= 4) {
+    orc_x86_emit_mov_avx_memoffset (p, 4, reg, offset, ptr_reg, FALSE, FALSE);
+    i = 4;
+  }
+  for (; i + 2 <= n_bytes; i += 2) {
+    orc_avx_sse_emit_pextrw_memoffset (p, i / 2, offset + i, reg, ptr_reg);
+  }
+  if (i < n_bytes) {
+    orc_avx_sse_emit_pextrb_memoffset (p, i, offset + i, reg, ptr_reg);
+  }
+}
+
+/* Same sequence as the SSE rule; with 256-bit registers each 128-bit
+ * lane starts on a group boundary, so vpshufb stays within its lane. */
+static void
+avx_rule_ldunpackX_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int bits = ORC_PTR_TO_INT (user);
+  OrcVariable *src = p->vars + insn->src_args[0];
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->dest_args[0]].size << p->loop_shift;
+  const int n_bytes = (bits == 10 ? 5 : 3) << p->loop_shift;
+  int shuf, mul;
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "packed opcodes cannot be used with x2 or x4");
+    return;
+  }
+  if (src->ptr_register == 0) {
+    orc_compiler_error (p, "packed opcodes need a pointer register");
+    return;
+  }
+
+  if (bits == 10) {
+    shuf = orc_compiler_get_constant_long (p, 0x02010100, 0x04030302,
+        0x07060605, 0x09080807);
+    mul = orc_compiler_get_constant_long (p, 0x00100040, 0x00010004,
+        0x00100040, 0x00010004);
+  } else {
+    shuf = orc_compiler_get_constant_long (p, 0x02010100, 0x05040403,
+        0x08070706, 0x0b0a0a09);
+    mul = orc_compiler_get_constant (p, 4, 0x00010010);
+  }
+
+  if (size >= 32) {
+    const int tmp = orc_compiler_get_temp_reg (p);
+
+    avx_load_packed (p, src->ptr_register, 0, n_bytes / 2, dest);
+    avx_load_packed (p, src->ptr_register, n_bytes / 2, n_bytes / 2, tmp);
+    orc_avx_emit_permute2i128 (p, ORC_AVX_PERMUTE (2, 0), dest, tmp, dest);
+    orc_avx_emit_pshufb (p, dest, shuf, dest);
+    orc_avx_emit_pmullw (p, dest, mul, dest);
+    orc_avx_emit_psrlw_imm (p, 16 - bits, dest, dest);
+  } else {
+    avx_load_packed (p, src->ptr_register, 0, n_bytes, dest);
+    orc_avx_sse_emit_pshufb (p, dest, shuf, dest);
+    orc_avx_sse_emit_pmullw (p, dest, mul, dest);
+    orc_avx_sse_emit_psrlw_imm (p, 16 - bits, dest, dest);
+  }
+
+  orc_x86_emit_add_imm_reg (p, p->is_64bit ? 8 : 4, n_bytes,
+      src->ptr_register, FALSE);
+  src->update_type = 0;
+}
+
+static void
+avx_rule_stpackX_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int bits = ORC_PTR_TO_INT (user);
+  const int src = p->vars[insn->src_args[0]].alloc;
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+  const int n_bytes = (bits == 10 ? 5 : 3) << p->loop_shift;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+  int shuf;
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "packed opcodes cannot be used with x2 or x4");
+    return;
+  }
+  if (dest->ptr_register == 0) {
+    orc_compiler_error (p, "packed opcodes need a pointer register");
+    return;
+  }
+
+  if (bits == 10) {
+    orc_avx_emit_pand (p, src, orc_compiler_get_constant (p, 4, 0x03ff03ff),
+        tmp);
+    orc_avx_emit_pmaddwd (p, tmp,
+        orc_compiler_get_constant (p, 4, 0x04000001), tmp);
+    orc_avx_emit_psrlq_imm (p, 32, tmp, tmp2);
+    orc_avx_emit_psllq_imm (p, 20, tmp2, tmp2);
+    orc_avx_emit_psllq_imm (p, 32, tmp, tmp);
+    orc_avx_emit_psrlq_imm (p, 32, tmp, tmp);
+    orc_avx_emit_por (p, tmp, tmp2, tmp);
+    shuf = orc_compiler_get_constant_long (p, 0x03020100, 0x0a090804,
+        0x80800c0b, 0x80808080);
+  } else {
+    orc_avx_emit_pand (p, src, orc_compiler_get_constant (p, 4, 0x0fff0fff),
+        tmp);
+    orc_avx_emit_pmaddwd (p, tmp,
+        orc_compiler_get_constant (p, 4, 0x10000001), tmp);
+    shuf = orc_compiler_get_constant_long (p, 0x04020100, 0x09080605,
+        0x0e0d0c0a, 0x80808080);
+  }
+  orc_avx_emit_pshufb (p, tmp, shuf, tmp);
+
+  if (size >= 32) {
+    orc_avx_emit_extractf128_si256 (p, 1, tmp, tmp2);
+    avx_store_packed (p, tmp, n_bytes / 2, 0, dest->ptr_register);
+    avx_store_packed (p, tmp2, n_bytes / 2, n_bytes / 2, dest->ptr_register);
+  } else {
+    avx_store_packed (p, tmp, n_bytes, 0, dest->ptr_register);
+  }
+
+  orc_x86_emit_add_imm_reg (p, p->is_64bit ? 8 : 4, n_bytes,
+      dest->ptr_register, FALSE);
+  dest->update_type = 0;
+}
+
+static void
+avx_rule_lut16b_avx2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int lo = p->vars[insn->src_args[1]].alloc;
+  const int hi = p->vars[insn->src_args[2]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "lut16b cannot be used with x2 or x4");
+    return;
+  }
+
+  /* vpshufb looks up within each 128-bit lane; the table parameters are
+   * broadcast to both lanes already, so interleaving them gives a copy of
+   * the table per lane */
+  orc_avx_emit_paddusb (p, src, orc_compiler_get_constant (p, 1, 0x70), tmp);
+  orc_avx_emit_punpcklqdq (p, lo, hi, dest);
+  orc_avx_emit_pshufb (p, dest, tmp, dest);
+}
+
+/* see sse_rule_acccrc32cX_sse42; every AVX CPU has SSE 4.2 */
+static void
+avx_rule_acccrc32cX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int n_bytes = p->vars[insn->src_args[0]].size << p->insn_shift;
+  const int offset = ORC_STRUCT_OFFSET (OrcExecutor, arrays[ORC_VAR_T1]);
+
+  orc_x86_emit_mov_avx_memoffset (p, MAX (n_bytes, 4), src, offset,
+      p->exec_reg, FALSE, FALSE);
+  orc_avx_sse_emit_movd_store_register (p, dest, p->gp_tmpreg);
+  orc_x86_emit_crc32c_memoffset (p, n_bytes, offset, p->exec_reg,
+      p->gp_tmpreg);
+  orc_avx_sse_emit_movd_load_register (p, p->gp_tmpreg, dest);
+}
+
+static void
+avx_rule_absdiffuX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+
+  if (size >= 32) {
+    if (ORC_PTR_TO_INT (user)) {
+      orc_avx_emit_psubusw (p, src1, src0, tmp);
+      orc_avx_emit_psubusw (p, src0, src1, dest);
+    } else {
+      orc_avx_emit_psubusb (p, src1, src0, tmp);
+      orc_avx_emit_psubusb (p, src0, src1, dest);
+    }
+    orc_avx_emit_por (p, dest, tmp, dest);
+  } else {
+    if (ORC_PTR_TO_INT (user)) {
+      orc_avx_sse_emit_psubusw (p, src1, src0, tmp);
+      orc_avx_sse_emit_psubusw (p, src0, src1, dest);
+    } else {
+      orc_avx_sse_emit_psubusb (p, src1, src0, tmp);
+      orc_avx_sse_emit_psubusb (p, src0, src1, dest);
+    }
+    orc_avx_sse_emit_por (p, dest, tmp, dest);
+  }
+}
+
+static void
+avx_rule_sadubq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int size = p->vars[insn->src_args[0]].size << p->loop_shift;
+
+  if (size >= 32) {
+    orc_avx_emit_psadbw (p, src0, src1, dest);
+  } else {
+    orc_avx_sse_emit_psadbw (p, src0, src1, dest);
+  }
+}
+
+/* two elements from the 128-bit src into the low two dwords of dest; see
+ * sse_rule_minposuwl_sse41 */
+static void
+avx_emit_minposuwl_pair (OrcCompiler *p, int src, int dest, int tmp)
+{
+  orc_avx_sse_emit_pshufd (p, ORC_AVX_SSE_SHUF (3, 2, 3, 2), src, tmp);
+  orc_avx_sse_emit_phminposuw (p, tmp, tmp);
+  orc_avx_sse_emit_pshufd (p, ORC_AVX_SSE_SHUF (1, 0, 1, 0), src, dest);
+  orc_avx_sse_emit_phminposuw (p, dest, dest);
+  orc_avx_sse_emit_punpckldq (p, dest, tmp, dest);
+}
+
+static void
+avx_rule_minposuwl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (p->insn_shift == 0) {
+    orc_avx_sse_emit_pshufd (p, ORC_AVX_SSE_SHUF (1, 0, 1, 0), src, dest);
+    orc_avx_sse_emit_phminposuw (p, dest, dest);
+  } else if (p->insn_shift == 1) {
+    avx_emit_minposuwl_pair (p, src, dest, tmp);
+  } else {
+    const int tmp2 = orc_compiler_get_temp_reg (p);
+
+    orc_avx_emit_extractf128_si256 (p, 1, src, tmp2);
+    avx_emit_minposuwl_pair (p, tmp2, tmp2, tmp);
+    avx_emit_minposuwl_pair (p, src, dest, tmp);
+    orc_avx_sse_emit_punpcklqdq (p, dest, tmp2, dest);
+  }
+}
+
 static void
 avx_rule_minf (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -3196,6 +3827,17 @@ orc_compiler_avx_register_rules (OrcTarget *target)
   REGISTER_RULE (splatbl);
   REGISTER_RULE (div255w);
   REGISTER_RULE (divluw);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (mulcf, mulcX, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (mulcjf, mulcX, 1);
+  REGISTER_RULE (magsqcf);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (addpb, addpb, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (addpw, addpw, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (addpl, addpl, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (addpf, addpf, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (avgpub, addpb, 1);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (avgpuw, addpw, 1);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (avgpul, addpl, 1);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (avgpf, addpf, 1);
 
   /* AVX2 comprises most post-SSE2 instructions */
   rule_set = orc_rule_set_new (orc_opcode_set_get ("sys"), target,
@@ -3291,6 +3933,24 @@ orc_compiler_avx_register_rules (OrcTarget *target)
   REGISTER_RULE_WITH_GENERIC (cmpeqq, cmpeqq_avx2);
 
   REGISTER_RULE_WITH_GENERIC (cmpgtsq, cmpgtsq_avx2);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (randl, randX_avx2, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (randf, randX_avx2, 1);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (randtf, randX_avx2, 2);
+  REGISTER_RULE_WITH_GENERIC (unpack3x10, unpack3x10_avx2);
+  REGISTER_RULE_WITH_GENERIC (pack3x10, pack3x10_avx2);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (ldunpack4x10, ldunpackX_avx2, 10);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (stpack4x10, stpackX_avx2, 10);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (ldunpack2x12, ldunpackX_avx2, 12);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (stpack2x12, stpackX_avx2, 12);
+  REGISTER_RULE_WITH_GENERIC (lut16b, lut16b_avx2);
+  REGISTER_RULE_WITH_GENERIC (acccrc32cb, acccrc32cX);
+  REGISTER_RULE_WITH_GENERIC (acccrc32cw, acccrc32cX);
+  REGISTER_RULE_WITH_GENERIC (acccrc32cl, acccrc32cX);
+  REGISTER_RULE_WITH_GENERIC (acccrc32cq, acccrc32cX);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (absdiffub, absdiffuX, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (absdiffuw, absdiffuX, 1);
+  REGISTER_RULE (sadubq);
+  REGISTER_RULE (minposuwl);
 
   // These rules require dropping into SSE to be implemented in straight AVX
   REGISTER_RULE_WITH_GENERIC (loadupdb, loadupdb_avx2);
@@ -3299,4 +3959,11 @@ orc_compiler_avx_register_rules (OrcTarget *target)
   // than their SSE counterparts, and even more wrt the scalar implementation
   // REGISTER_RULE_WITH_GENERIC (ldresnearl, ldresnearl_avx2);
   // REGISTER_RULE_WITH_GENERIC (ldreslinl, ldreslinl_avx2);
+
+  /* FMA3, only reached through fast math contraction or explicit use */
+  rule_set = orc_rule_set_new (orc_opcode_set_get ("sys"), target,
+      ORC_TARGET_AVX_AVX | ORC_TARGET_AVX_FMA);
+
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (fmaf, fmaX, 0);
+  REGISTER_RULE_WITH_GENERIC_AND_PAYLOAD (fmad, fmaX, 1);
 }
@@ -0,0 +1,709 @@
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcdebug.h>
+#include <orc/orcutils.h>
+#include <orc/orcloongarch.h>
+
+/* Rules shared by LSX and LASX.  LASX instructions mostly work on each
+ * 128 bit lane separately, so everything that moves data between the
+ * low and the high half of an element (widening, narrowing, interleaving)
+ * needs an extra xvpermi.d on that target to keep the elements in
+ * order.
+ *
+ * Registers that are only partly used (the tail of the loop, or smaller
+ * variables in the main loop) hold meaningful data in their low bytes
+ * only. */
+
+#define SIZE_INDEX(size) ((size) == 1 ? 0 : (size) == 2 ? 1 : (size) == 4 ? 2 : 3)
+
+static int
+la_is_lasx (OrcCompiler *p)
+{
+  return ORC_LOONGARCH_REG_SIZE (p) == 32;
+}
+
+/* codes are the ones of the byte form, the halfword, word and doubleword
+ * forms follow every 0x8000 */
+static void
+la_emit_binary (OrcCompiler *p, const char *name, int is_unsigned,
+    orc_uint32 code, int size, int dest, int src1, int src2)
+{
+  static const char *suffixes[] = { "b", "h", "w", "d" };
+  static const char *usuffixes[] = { "bu", "hu", "wu", "du" };
+  const int i = SIZE_INDEX (size);
+  char insn_name[40];
+
+  sprintf (insn_name, "%s.%s", name, is_unsigned ? usuffixes[i] : suffixes[i]);
+  orc_loongarch_emit_3r (p, insn_name, code + i * 0x8000, dest, src1, src2);
+}
+
+/* sign or zero extends the low half of src */
+static void
+la_emit_widen (OrcCompiler *p, int is_unsigned, int src_size, int dest,
+    int src)
+{
+  static const char *names[] = { "vsllwil.h.b", "vsllwil.w.h", "vsllwil.d.w" };
+  static const char *unames[] =
+      { "vsllwil.hu.bu", "vsllwil.wu.hu", "vsllwil.du.wu" };
+  static const orc_uint32 codes[] = { 0x73082000, 0x73084000, 0x73088000 };
+  static const int imm_bits[] = { 3, 4, 5 };
+  const int i = SIZE_INDEX (src_size);
+
+  if (la_is_lasx (p)) {
+    /* doublewords 0 and 1 to the bottom of each lane */
+    orc_loongarch_emit_xvpermi_d (p, dest, src, 0x10);
+    src = dest;
+  }
+  orc_loongarch_emit_2ri (p, is_unsigned ? unames[i] : names[i],
+      codes[i] + (is_unsigned ? 0x40000 : 0), dest, src, 0, imm_bits[i]);
+}
+
+/* gathers the low 64 bits of both lanes after a narrowing operation */
+static void
+la_emit_narrow_fixup (OrcCompiler *p, int dest)
+{
+  if (la_is_lasx (p)) {
+    orc_loongarch_emit_xvpermi_d (p, dest, dest, 0x08);
+  }
+}
+
+/* clears all but the low bytes of src so that partly used registers can
+ * be accumulated */
+static void
+la_emit_keep_low_bytes (OrcCompiler *p, int dest, int src, int bytes)
+{
+  const int reg_size = ORC_LOONGARCH_REG_SIZE (p);
+
+  if (bytes >= reg_size) {
+    orc_loongarch_emit_vmov (p, dest, src);
+    return;
+  }
+
+  if (la_is_lasx (p)) {
+    orc_loongarch_emit_vmov (p, dest, src);
+    orc_loongarch_emit_vinsgr2vr_d (p, dest, ORC_LOONGARCH_ZERO, 2);
+    orc_loongarch_emit_vinsgr2vr_d (p, dest, ORC_LOONGARCH_ZERO, 3);
+    src = dest;
+    if (bytes == 16)
+      return;
+  }
+  orc_loongarch_emit_2ri (p, "vbsll.v", 0x728e0000, dest, src, 16 - bytes, 5);
+}
+
+static void
+la_emit_load_param (OrcCompiler *p, int size, int dest, int param)
+{
+  if (size == 8) {
+    orc_loongarch_emit_ld (p, 4, TRUE, p->gp_tmpreg, p->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[param]));
+    orc_loongarch_emit_ld (p, 4, FALSE, ORC_LOONGARCH_TMP_REG, p->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor,
+            params[param + (ORC_VAR_T1 - ORC_VAR_P1)]));
+    orc_loongarch_emit_slli_d (p, ORC_LOONGARCH_TMP_REG,
+        ORC_LOONGARCH_TMP_REG, 32);
+    orc_loongarch_emit_or (p, p->gp_tmpreg, p->gp_tmpreg,
+        ORC_LOONGARCH_TMP_REG);
+  } else {
+    orc_loongarch_emit_ld (p, 4, FALSE, p->gp_tmpreg, p->exec_reg,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[param]));
+  }
+  orc_loongarch_emit_vreplgr2vr (p, size, dest, p->gp_tmpreg);
+}
+
+static void
+la_rule_loadpX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+  const int size = ORC_PTR_TO_INT (user);
+
+  if (src->vartype == ORC_VAR_TYPE_CONST) {
+    orc_loongarch_emit_load_imm (p, p->gp_tmpreg, src->value.i);
+    orc_loongarch_emit_vreplgr2vr (p, size, dest->alloc, p->gp_tmpreg);
+  } else if (src->vartype == ORC_VAR_TYPE_PARAM) {
+    la_emit_load_param (p, size, dest->alloc, insn->src_args[0]);
+  } else {
+    ORC_COMPILER_ERROR (p, "unimplemented");
+  }
+}
+
+static void
+la_rule_loadX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+
+  if (src->vartype != ORC_VAR_TYPE_SRC && src->vartype != ORC_VAR_TYPE_DEST) {
+    ORC_COMPILER_ERROR (p, "unimplemented");
+    return;
+  }
+  orc_loongarch_emit_vload (p, src->size << p->insn_shift, dest->alloc,
+      src->ptr_register, 0);
+}
+
+static void
+la_rule_storeX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+
+  orc_loongarch_emit_vstore (p, dest->size << p->insn_shift, src->alloc,
+      dest->ptr_register, 0);
+}
+
+static void
+la_rule_copyX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  orc_loongarch_emit_vmov (p, ORC_DEST_ARG (p, insn, 0),
+      ORC_SRC_ARG (p, insn, 0));
+}
+
+#define BINARY(opcode,insn_name,is_unsigned,code,size) \
+static void \
+la_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  la_emit_binary (p, insn_name, is_unsigned, code, size, \
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 1)); \
+}
+
+#define LOGIC(opcode,insn_name,code) \
+static void \
+la_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  orc_loongarch_emit_3r (p, insn_name, code, ORC_DEST_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1)); \
+}
+
+BINARY(addb, "vadd", FALSE, 0x700a0000, 1)
+BINARY(addssb, "vsadd", FALSE, 0x70460000, 1)
+BINARY(addusb, "vsadd", TRUE, 0x704a0000, 1)
+BINARY(subb, "vsub", FALSE, 0x700c0000, 1)
+BINARY(subssb, "vssub", FALSE, 0x70480000, 1)
+BINARY(subusb, "vssub", TRUE, 0x704c0000, 1)
+BINARY(maxsb, "vmax", FALSE, 0x70700000, 1)
+BINARY(maxub, "vmax", TRUE, 0x70740000, 1)
+BINARY(minsb, "vmin", FALSE, 0x70720000, 1)
+BINARY(minub, "vmin", TRUE, 0x70760000, 1)
+BINARY(mullb, "vmul", FALSE, 0x70840000, 1)
+BINARY(mulhsb, "vmuh", FALSE, 0x70860000, 1)
+BINARY(mulhub, "vmuh", TRUE, 0x70880000, 1)
+BINARY(avgsb, "vavgr", FALSE, 0x70680000, 1)
+BINARY(avgub, "vavgr", TRUE, 0x706a0000, 1)
+BINARY(absdiffub, "vabsd", TRUE, 0x70620000, 1)
+BINARY(cmpeqb, "vseq", FALSE, 0x70000000, 1)
+
+BINARY(addw, "vadd", FALSE, 0x700a0000, 2)
+BINARY(addssw, "vsadd", FALSE, 0x70460000, 2)
+BINARY(addusw, "vsadd", TRUE, 0x704a0000, 2)
+BINARY(subw, "vsub", FALSE, 0x700c0000, 2)
+BINARY(subssw, "vssub", FALSE, 0x70480000, 2)
+BINARY(subusw, "vssub", TRUE, 0x704c0000, 2)
+BINARY(maxsw, "vmax", FALSE, 0x70700000, 2)
+BINARY(maxuw, "vmax", TRUE, 0x70740000, 2)
+BINARY(minsw, "vmin", FALSE, 0x70720000, 2)
+BINARY(minuw, "vmin", TRUE, 0x70760000, 2)
+BINARY(mullw, "vmul", FALSE, 0x70840000, 2)
+BINARY(mulhsw, "vmuh", FALSE, 0x70860000, 2)
+BINARY(mulhuw, "vmuh", TRUE, 0x70880000, 2)
+BINARY(avgsw, "vavgr", FALSE, 0x70680000, 2)
+BINARY(avguw, "vavgr", TRUE, 0x706a0000, 2)
+BINARY(absdiffuw, "vabsd", TRUE, 0x70620000, 2)
+BINARY(cmpeqw, "vseq", FALSE, 0x70000000, 2)
+
+BINARY(addl, "vadd", FALSE, 0x700a0000, 4)
+BINARY(addssl, "vsadd", FALSE, 0x70460000, 4)
+BINARY(addusl, "vsadd", TRUE, 0x704a0000, 4)
+BINARY(subl, "vsub", FALSE, 0x700c0000, 4)
+BINARY(subssl, "vssub", FALSE, 0x70480000, 4)
+BINARY(subusl, "vssub", TRUE, 0x704c0000, 4)
+BINARY(maxsl, "vmax", FALSE, 0x70700000, 4)
+BINARY(maxul, "vmax", TRUE, 0x70740000, 4)
+BINARY(minsl, "vmin", FALSE, 0x70720000, 4)
+BINARY(minul, "vmin", TRUE, 0x70760000, 4)
+BINARY(mulll, "vmul", FALSE, 0x70840000, 4)
+BINARY(mulhsl, "vmuh", FALSE, 0x70860000, 4)
+BINARY(mulhul, "vmuh", TRUE, 0x70880000, 4)
+BINARY(avgsl, "vavgr", FALSE, 0x70680000, 4)
+BINARY(avgul, "vavgr", TRUE, 0x706a0000, 4)
+BINARY(cmpeql, "vseq", FALSE, 0x70000000, 4)
+
+BINARY(addq, "vadd", FALSE, 0x700a0000, 8)
+BINARY(subq, "vsub", FALSE, 0x700c0000, 8)
+BINARY(cmpeqq, "vseq", FALSE, 0x70000000, 8)
+
+LOGIC(andX, "vand.v", 0x71260000)
+LOGIC(orX, "vor.v", 0x71268000)
+LOGIC(xorX, "vxor.v", 0x71270000)
+/* vandn.v computes ~vj & vk, which matches andn */
+LOGIC(andnX, "vandn.v", 0x71280000)
+
+static void
+la_rule_cmpgtsX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  /* a > b is b < a */
+  la_emit_binary (p, "vslt", FALSE, 0x70060000, insn->opcode->dest_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1),
+      ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+la_rule_absX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  /* |x - 0|, -128 comes out as 128 which wraps to itself */
+  orc_loongarch_emit_vzero (p, p->tmpreg);
+  la_emit_binary (p, "vabsd", FALSE, 0x70600000, insn->opcode->dest_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0), p->tmpreg);
+}
+
+static void
+la_rule_signX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *maxi[] = { "vmaxi.b", "vmaxi.h", "vmaxi.w" };
+  static const char *mini[] = { "vmini.b", "vmini.h", "vmini.w" };
+  const int i = SIZE_INDEX (insn->opcode->dest_size[0]);
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  orc_loongarch_emit_2ri (p, maxi[i], 0x72900000 + i * 0x8000, dest,
+      ORC_SRC_ARG (p, insn, 0), -1, 5);
+  orc_loongarch_emit_2ri (p, mini[i], 0x72920000 + i * 0x8000, dest, dest,
+      1, 5);
+}
+
+static void
+la_rule_shift (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *imm_names[3][4] = {
+    { "vslli.b", "vslli.h", "vslli.w", "vslli.d" },
+    { "vsrai.b", "vsrai.h", "vsrai.w", "vsrai.d" },
+    { "vsrli.b", "vsrli.h", "vsrli.w", "vsrli.d" },
+  };
+  static const orc_uint32 imm_codes[] =
+      { 0x732c0000, 0x73340000, 0x73300000 };
+  static const orc_uint32 imm_sizes[] =
+      { 0x2000, 0x4000, 0x8000, 0x10000 };
+  static const char *names[] = { "vsll", "vsra", "vsrl" };
+  static const orc_uint32 codes[] = { 0x70e80000, 0x70ec0000, 0x70ea0000 };
+  const int type = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int i = SIZE_INDEX (size);
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src = ORC_SRC_ARG (p, insn, 0);
+  OrcVariable *shift = p->vars + insn->src_args[1];
+
+  if (shift->vartype == ORC_VAR_TYPE_CONST) {
+    orc_loongarch_emit_2ri (p, imm_names[type][i],
+        imm_codes[type] | imm_sizes[i], dest, src, shift->value.i, 3 + i);
+  } else if (shift->vartype == ORC_VAR_TYPE_PARAM) {
+    la_emit_load_param (p, size, p->tmpreg, insn->src_args[1]);
+    la_emit_binary (p, names[type], FALSE, codes[type], size, dest, src,
+        p->tmpreg);
+  } else {
+    ORC_COMPILER_ERROR (p, "shift rule only works with constants and params");
+  }
+}
+
+static void
+la_rule_convext (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_widen (p, ORC_PTR_TO_INT (user), insn->opcode->src_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+/* keeps the even (low) or odd (high) halves of each element */
+static void
+la_emit_pick (OrcCompiler *p, int odd, int dest_size, int dest, int src)
+{
+  la_emit_binary (p, odd ? "vpickod" : "vpickev", FALSE,
+      odd ? 0x71200000 : 0x711e0000, dest_size, dest, src, src);
+  la_emit_narrow_fixup (p, dest);
+}
+
+static void
+la_rule_convtrunc (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_pick (p, FALSE, insn->opcode->dest_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+la_rule_convhigh (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_pick (p, TRUE, insn->opcode->dest_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+la_rule_splitX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = insn->opcode->dest_size[0];
+
+  la_emit_pick (p, TRUE, size, p->tmpreg, ORC_SRC_ARG (p, insn, 0));
+  la_emit_pick (p, FALSE, size, ORC_DEST_ARG (p, insn, 1),
+      ORC_SRC_ARG (p, insn, 0));
+  orc_loongarch_emit_vmov (p, ORC_DEST_ARG (p, insn, 0), p->tmpreg);
+}
+
+/* the 3R forms narrow into the low half and clear the high half; a zero
+ * shift vector turns them into plain saturating conversions */
+static void
+la_rule_convsat (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[4][3] = {
+    { "vssran.b.h", "vssran.h.w", "vssran.w.d" },
+    { "vssran.bu.h", "vssran.hu.w", "vssran.wu.d" },
+    { "vssrln.b.h", "vssrln.h.w", "vssrln.w.d" },
+    { "vssrln.bu.h", "vssrln.hu.w", "vssrln.wu.d" },
+  };
+  static const orc_uint32 codes[] =
+      { 0x70fe8000, 0x71068000, 0x70fc8000, 0x71048000 };
+  const int type = ORC_PTR_TO_INT (user);
+  const int i = SIZE_INDEX (insn->opcode->dest_size[0]);
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  orc_loongarch_emit_vzero (p, p->tmpreg);
+  orc_loongarch_emit_3r (p, names[type][i], codes[type] + i * 0x8000, dest,
+      ORC_SRC_ARG (p, insn, 0), p->tmpreg);
+  la_emit_narrow_fixup (p, dest);
+}
+
+static void
+la_rule_mulX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int is_unsigned = ORC_PTR_TO_INT (user);
+  const int src_size = insn->opcode->src_size[0];
+
+  la_emit_widen (p, is_unsigned, src_size, p->tmpreg,
+      ORC_SRC_ARG (p, insn, 0));
+  la_emit_widen (p, is_unsigned, src_size, p->tmpreg2,
+      ORC_SRC_ARG (p, insn, 1));
+  la_emit_binary (p, "vmul", FALSE, 0x70840000, src_size * 2,
+      ORC_DEST_ARG (p, insn, 0), p->tmpreg, p->tmpreg2);
+}
+
+static void
+la_rule_mergeX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = insn->opcode->src_size[0];
+  int src1 = ORC_SRC_ARG (p, insn, 0);
+  int src2 = ORC_SRC_ARG (p, insn, 1);
+
+  if (la_is_lasx (p)) {
+    orc_loongarch_emit_xvpermi_d (p, p->tmpreg, src1, 0x10);
+    orc_loongarch_emit_xvpermi_d (p, p->tmpreg2, src2, 0x10);
+    src1 = p->tmpreg;
+    src2 = p->tmpreg2;
+  }
+  /* vilvl puts vk in the even elements */
+  la_emit_binary (p, "vilvl", FALSE, 0x711a0000, size,
+      ORC_DEST_ARG (p, insn, 0), src2, src1);
+}
+
+static void
+la_rule_splatbw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  int src = ORC_SRC_ARG (p, insn, 0);
+
+  if (la_is_lasx (p)) {
+    orc_loongarch_emit_xvpermi_d (p, p->tmpreg, src, 0x10);
+    src = p->tmpreg;
+  }
+  la_emit_binary (p, "vilvl", FALSE, 0x711a0000, 1,
+      ORC_DEST_ARG (p, insn, 0), src, src);
+}
+
+static void
+la_rule_splatbl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = ORC_SRC_ARG (p, insn, 0);
+
+  la_emit_binary (p, "vilvl", FALSE, 0x711a0000, 1, p->tmpreg, src, src);
+  if (la_is_lasx (p)) {
+    orc_loongarch_emit_xvpermi_d (p, p->tmpreg, p->tmpreg, 0x10);
+  }
+  la_emit_binary (p, "vilvl", FALSE, 0x711a0000, 2,
+      ORC_DEST_ARG (p, insn, 0), p->tmpreg, p->tmpreg);
+}
+
+static void
+la_emit_shuf4i (OrcCompiler *p, int size, int dest, int src, int imm)
+{
+  static const char *names[] = { "vshuf4i.b", "vshuf4i.h", "vshuf4i.w" };
+  const int i = SIZE_INDEX (size);
+
+  orc_loongarch_emit_2ri (p, names[i], 0x73900000 + i * 0x40000, dest, src,
+      imm, 8);
+}
+
+static void
+la_rule_swapw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_shuf4i (p, 1, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0),
+      0xb1);
+}
+
+static void
+la_rule_swapl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_shuf4i (p, 1, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0),
+      0x1b);
+}
+
+static void
+la_rule_swapq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  la_emit_shuf4i (p, 1, dest, ORC_SRC_ARG (p, insn, 0), 0x1b);
+  la_emit_shuf4i (p, 4, dest, dest, 0xb1);
+}
+
+static void
+la_rule_swapwl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_shuf4i (p, 2, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0),
+      0xb1);
+}
+
+static void
+la_rule_swaplq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  la_emit_shuf4i (p, 4, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0),
+      0xb1);
+}
+
+static void
+la_rule_accX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = insn->opcode->dest_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  int src = ORC_SRC_ARG (p, insn, 0);
+
+  if ((size << p->loop_shift) < ORC_LOONGARCH_REG_SIZE (p)) {
+    la_emit_keep_low_bytes (p, p->tmpreg, src, size << p->loop_shift);
+    src = p->tmpreg;
+  }
+  la_emit_binary (p, "vadd", FALSE, 0x700a0000, size, dest, dest, src);
+}
+
+static void
+la_rule_accsadubl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int tmp = p->tmpreg;
+
+  la_emit_binary (p, "vabsd", TRUE, 0x70620000, 1, tmp,
+      ORC_SRC_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1));
+  la_emit_keep_low_bytes (p, tmp, tmp, 1 << p->loop_shift);
+  orc_loongarch_emit_3r (p, "vhaddw.hu.bu", 0x70580000, tmp, tmp, tmp);
+  orc_loongarch_emit_3r (p, "vhaddw.wu.hu", 0x70588000, tmp, tmp, tmp);
+  la_emit_binary (p, "vadd", FALSE, 0x700a0000, 4, ORC_DEST_ARG (p, insn, 0),
+      ORC_DEST_ARG (p, insn, 0), tmp);
+}
+
+static void
+la_register_rules (OrcRuleSet *rule_set)
+{
+#define REG(x) \
+    orc_rule_register (rule_set, #x , la_rule_ ## x, NULL)
+
+  orc_rule_register (rule_set, "loadpb", la_rule_loadpX, (void *)1);
+  orc_rule_register (rule_set, "loadpw", la_rule_loadpX, (void *)2);
+  orc_rule_register (rule_set, "loadpl", la_rule_loadpX, (void *)4);
+  orc_rule_register (rule_set, "loadpq", la_rule_loadpX, (void *)8);
+  orc_rule_register (rule_set, "loadb", la_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadw", la_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadl", la_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadq", la_rule_loadX, NULL);
+  orc_rule_register (rule_set, "storeb", la_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storew", la_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storel", la_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storeq", la_rule_storeX, NULL);
+  orc_rule_register (rule_set, "copyb", la_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyw", la_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyl", la_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyq", la_rule_copyX, NULL);
+
+  REG(addb);
+  REG(addssb);
+  REG(addusb);
+  REG(subb);
+  REG(subssb);
+  REG(subusb);
+  REG(maxsb);
+  REG(maxub);
+  REG(minsb);
+  REG(minub);
+  REG(mullb);
+  REG(mulhsb);
+  REG(mulhub);
+  REG(avgsb);
+  REG(avgub);
+  REG(absdiffub);
+  REG(cmpeqb);
+
+  REG(addw);
+  REG(addssw);
+  REG(addusw);
+  REG(subw);
+  REG(subssw);
+  REG(subusw);
+  REG(maxsw);
+  REG(maxuw);
+  REG(minsw);
+  REG(minuw);
+  REG(mullw);
+  REG(mulhsw);
+  REG(mulhuw);
+  REG(avgsw);
+  REG(avguw);
+  REG(absdiffuw);
+  REG(cmpeqw);
+
+  REG(addl);
+  REG(addssl);
+  REG(addusl);
+  REG(subl);
+  REG(subssl);
+  REG(subusl);
+  REG(maxsl);
+  REG(maxul);
+  REG(minsl);
+  REG(minul);
+  REG(mulll);
+  REG(mulhsl);
+  REG(mulhul);
+  REG(avgsl);
+  REG(avgul);
+  REG(cmpeql);
+
+  REG(addq);
+  REG(subq);
+  REG(cmpeqq);
+
+  orc_rule_register (rule_set, "andb", la_rule_andX, NULL);
+  orc_rule_register (rule_set, "andw", la_rule_andX, NULL);
+  orc_rule_register (rule_set, "andl", la_rule_andX, NULL);
+  orc_rule_register (rule_set, "andq", la_rule_andX, NULL);
+  orc_rule_register (rule_set, "andnb", la_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnw", la_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnl", la_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnq", la_rule_andnX, NULL);
+  orc_rule_register (rule_set, "orb", la_rule_orX, NULL);
+  orc_rule_register (rule_set, "orw", la_rule_orX, NULL);
+  orc_rule_register (rule_set, "orl", la_rule_orX, NULL);
+  orc_rule_register (rule_set, "orq", la_rule_orX, NULL);
+  orc_rule_register (rule_set, "xorb", la_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorw", la_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorl", la_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorq", la_rule_xorX, NULL);
+
+  orc_rule_register (rule_set, "cmpgtsb", la_rule_cmpgtsX, NULL);
+  orc_rule_register (rule_set, "cmpgtsw", la_rule_cmpgtsX, NULL);
+  orc_rule_register (rule_set, "cmpgtsl", la_rule_cmpgtsX, NULL);
+  orc_rule_register (rule_set, "cmpgtsq", la_rule_cmpgtsX, NULL);
+
+  orc_rule_register (rule_set, "absb", la_rule_absX, NULL);
+  orc_rule_register (rule_set, "absw", la_rule_absX, NULL);
+  orc_rule_register (rule_set, "absl", la_rule_absX, NULL);
+  orc_rule_register (rule_set, "signb", la_rule_signX, NULL);
+  orc_rule_register (rule_set, "signw", la_rule_signX, NULL);
+  orc_rule_register (rule_set, "signl", la_rule_signX, NULL);
+
+  orc_rule_register (rule_set, "shlb", la_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsb", la_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shrub", la_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shlw", la_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsw", la_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shruw", la_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shll", la_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsl", la_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shrul", la_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shlq", la_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsq", la_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shruq", la_rule_shift, (void *)2);
+
+  orc_rule_register (rule_set, "convsbw", la_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convubw", la_rule_convext, (void *)1);
+  orc_rule_register (rule_set, "convswl", la_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convuwl", la_rule_convext, (void *)1);
+  orc_rule_register (rule_set, "convslq", la_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convulq", la_rule_convext, (void *)1);
+
+  orc_rule_register (rule_set, "convwb", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convlw", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convql", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0wb", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0lw", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0ql", la_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convhwb", la_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "convhlw", la_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1wb", la_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1lw", la_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1ql", la_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "splitwb", la_rule_splitX, NULL);
+  orc_rule_register (rule_set, "splitlw", la_rule_splitX, NULL);
+  orc_rule_register (rule_set, "splitql", la_rule_splitX, NULL);
+
+  orc_rule_register (rule_set, "convssswb", la_rule_convsat, (void *)0);
+  orc_rule_register (rule_set, "convsuswb", la_rule_convsat, (void *)1);
+  orc_rule_register (rule_set, "convusswb", la_rule_convsat, (void *)2);
+  orc_rule_register (rule_set, "convuuswb", la_rule_convsat, (void *)3);
+  orc_rule_register (rule_set, "convssslw", la_rule_convsat, (void *)0);
+  orc_rule_register (rule_set, "convsuslw", la_rule_convsat, (void *)1);
+  orc_rule_register (rule_set, "convusslw", la_rule_convsat, (void *)2);
+  orc_rule_register (rule_set, "convuuslw", la_rule_convsat, (void *)3);
+  orc_rule_register (rule_set, "convsssql", la_rule_convsat, (void *)0);
+  orc_rule_register (rule_set, "convsusql", la_rule_convsat, (void *)1);
+  orc_rule_register (rule_set, "convussql", la_rule_convsat, (void *)2);
+  orc_rule_register (rule_set, "convuusql", la_rule_convsat, (void *)3);
+
+  orc_rule_register (rule_set, "mulsbw", la_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "mulubw", la_rule_mulX, (void *)1);
+  orc_rule_register (rule_set, "mulswl", la_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "muluwl", la_rule_mulX, (void *)1);
+  orc_rule_register (rule_set, "mulslq", la_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "mululq", la_rule_mulX, (void *)1);
+
+  orc_rule_register (rule_set, "mergebw", la_rule_mergeX, NULL);
+  orc_rule_register (rule_set, "mergewl", la_rule_mergeX, NULL);
+  orc_rule_register (rule_set, "mergelq", la_rule_mergeX, NULL);
+  REG(splatbw);
+  REG(splatbl);
+
+  REG(swapw);
+  REG(swapl);
+  REG(swapq);
+  REG(swapwl);
+  REG(swaplq);
+
+  orc_rule_register (rule_set, "accw", la_rule_accX, NULL);
+  orc_rule_register (rule_set, "accl", la_rule_accX, NULL);
+  REG(accsadubl);
+
+#undef REG
+}
+
+void
+orc_loongarch_lsx_register_rules (OrcTarget *target)
+{
+  OrcRuleSet *rule_set;
+
+  rule_set = orc_rule_set_new (orc_opcode_set_get ("sys"), target,
+      ORC_TARGET_LOONGARCH_LSX);
+  la_register_rules (rule_set);
+}
+
+void
+orc_loongarch_lasx_register_rules (OrcTarget *target)
+{
+  OrcRuleSet *rule_set;
+
+  rule_set = orc_rule_set_new (orc_opcode_set_get ("sys"), target,
+      ORC_TARGET_LOONGARCH_LASX);
+  la_register_rules (rule_set);
+}
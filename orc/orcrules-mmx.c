@@ -898,6 +898,51 @@ mmx_rule_accsadubl (OrcCompiler *p, void *user, OrcInstruction *insn)
   orc_mmx_emit_paddd (p, tmp, dest);
 }
 
+/* |a - b| is whichever of the two saturating differences is nonzero */
+static void
+mmx_rule_absdiffuX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  int src0 = p->vars[insn->src_args[0]].alloc;
+  int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (dest == src1) {
+    src1 = src0;
+    src0 = dest;
+  }
+
+  orc_mmx_emit_movq (p, src1, tmp);
+  if (src0 != dest) {
+    orc_mmx_emit_movq (p, src0, dest);
+  }
+  if (ORC_PTR_TO_INT (user)) {
+    orc_mmx_emit_psubusw (p, src0, tmp);
+    orc_mmx_emit_psubusw (p, src1, dest);
+  } else {
+    orc_mmx_emit_psubusb (p, src0, tmp);
+    orc_mmx_emit_psubusb (p, src1, dest);
+  }
+  orc_mmx_emit_por (p, tmp, dest);
+}
+
+static void
+mmx_rule_sadubq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (dest == src1) {
+    orc_mmx_emit_psadbw (p, src0, dest);
+  } else {
+    if (src0 != dest) {
+      orc_mmx_emit_movq (p, src0, dest);
+    }
+    orc_mmx_emit_psadbw (p, src1, dest);
+  }
+}
+
 #ifndef MMX
 static void
 mmx_rule_signX_ssse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
@@ -2010,6 +2055,111 @@ mmx_rule_splitwb (OrcCompiler *p, void *user, OrcInstruction *insn)
 #endif
 }
 
+/* pairwise ops: each source element holds two adjacent values, the
+ * result is their sum or average at half the width */
+
+static void
+mmx_rule_addpb (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int mask = orc_compiler_get_constant (p, 2, 0xff);
+
+  orc_mmx_emit_movq (p, src, tmp);
+  orc_mmx_emit_psrlw_imm (p, 8, tmp);
+  if (src != dest) {
+    orc_mmx_emit_movq (p, src, dest);
+  }
+  if (ORC_PTR_TO_INT (user)) {
+    orc_mmx_emit_pavgb (p, tmp, dest);
+  } else {
+    orc_mmx_emit_paddb (p, tmp, dest);
+  }
+  orc_mmx_emit_pand (p, mask, dest);
+  orc_mmx_emit_packuswb (p, dest, dest);
+}
+
+static void
+mmx_rule_addpw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (ORC_PTR_TO_INT (user)) {
+    const int tmp = orc_compiler_get_temp_reg (p);
+
+    orc_mmx_emit_movq (p, src, tmp);
+    orc_mmx_emit_psrld_imm (p, 16, tmp);
+    if (src != dest) {
+      orc_mmx_emit_movq (p, src, dest);
+    }
+    orc_mmx_emit_pavgw (p, tmp, dest);
+  } else {
+    const int ones = orc_compiler_get_constant (p, 2, 0x0001);
+
+    if (src != dest) {
+      orc_mmx_emit_movq (p, src, dest);
+    }
+    orc_mmx_emit_pmaddwd (p, ones, dest);
+  }
+
+  /* same as select0lw */
+  orc_mmx_emit_pslld_imm (p, 16, dest);
+  orc_mmx_emit_psrad_imm (p, 16, dest);
+  orc_mmx_emit_packssdw (p, dest, dest);
+}
+
+static void
+mmx_rule_addpl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+#ifndef MMX
+  orc_mmx_emit_pshufd (p, ORC_MMX_SHUF (3, 1, 3, 1), src, tmp);
+  orc_mmx_emit_pshufd (p, ORC_MMX_SHUF (2, 0, 2, 0), src, dest);
+#else
+  orc_mmx_emit_movq (p, src, tmp);
+  orc_mmx_emit_psrlq_imm (p, 32, tmp);
+  if (src != dest) {
+    orc_mmx_emit_movq (p, src, dest);
+  }
+#endif
+
+  if (ORC_PTR_TO_INT (user)) {
+    const int tmp2 = orc_compiler_get_temp_reg (p);
+
+    /* (a+b+1) >> 1 = (a|b) - ((a^b)>>1) */
+    orc_mmx_emit_movq (p, dest, tmp2);
+    orc_mmx_emit_pxor (p, tmp, tmp2);
+    orc_mmx_emit_psrld_imm (p, 1, tmp2);
+    orc_mmx_emit_por (p, tmp, dest);
+    orc_mmx_emit_psubd (p, tmp2, dest);
+  } else {
+    orc_mmx_emit_paddd (p, tmp, dest);
+  }
+}
+
+#ifndef MMX
+static void
+mmx_rule_addpf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  orc_mmx_emit_pshufd (p, ORC_MMX_SHUF (3, 1, 3, 1), src, tmp);
+  orc_mmx_emit_pshufd (p, ORC_MMX_SHUF (2, 0, 2, 0), src, dest);
+  orc_mmx_emit_addps (p, tmp, dest);
+  if (ORC_PTR_TO_INT (user)) {
+    orc_mmx_emit_mulps (p, orc_compiler_get_constant (p, 4, 0x3f000000),
+        dest);
+  }
+}
+#endif
+
 static void
 mmx_rule_mergebw (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -3336,6 +3486,9 @@ orc_compiler_mmx_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "accw", mmx_rule_accw, NULL);
   orc_rule_register (rule_set, "accl", mmx_rule_accl, NULL);
   orc_rule_register (rule_set, "accsadubl", mmx_rule_accsadubl, NULL);
+  orc_rule_register (rule_set, "absdiffub", mmx_rule_absdiffuX, (void *)0);
+  orc_rule_register (rule_set, "absdiffuw", mmx_rule_absdiffuX, (void *)1);
+  REG(sadubq);
 
 #ifndef MMX
   /* These require the SSE2 flag, although could be used with MMX.
@@ -3401,6 +3554,16 @@ orc_compiler_mmx_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "splitql", mmx_rule_splitql, NULL);
   orc_rule_register (rule_set, "splitlw", mmx_rule_splitlw, NULL);
   orc_rule_register (rule_set, "splitwb", mmx_rule_splitwb, NULL);
+  orc_rule_register (rule_set, "addpb", mmx_rule_addpb, (void *)0);
+  orc_rule_register (rule_set, "addpw", mmx_rule_addpw, (void *)0);
+  orc_rule_register (rule_set, "addpl", mmx_rule_addpl, (void *)0);
+  orc_rule_register (rule_set, "avgpub", mmx_rule_addpb, (void *)1);
+  orc_rule_register (rule_set, "avgpuw", mmx_rule_addpw, (void *)1);
+  orc_rule_register (rule_set, "avgpul", mmx_rule_addpl, (void *)1);
+#ifndef MMX
+  orc_rule_register (rule_set, "addpf", mmx_rule_addpf, (void *)0);
+  orc_rule_register (rule_set, "avgpf", mmx_rule_addpf, (void *)1);
+#endif
   orc_rule_register (rule_set, "avgsl", mmx_rule_avgsl, NULL);
   orc_rule_register (rule_set, "avgul", mmx_rule_avgul, NULL);
   orc_rule_register (rule_set, "shlb", mmx_rule_shlb, NULL);
@@ -2773,6 +2773,7 @@ BINARY(addssb,"vqadd.s8",0xf2000010, "sqadd", 0x0e200c00, 3)
 BINARY(addusb,"vqadd.u8",0xf3000010, "uqadd", 0x2e200c00, 3)
 BINARY(andb,"vand",0xf2000110, "and", 0x0e201c00, 3)
 /* BINARY(andnb,"vbic",0xf2100110, NULL, 0, 3) */
+BINARY(absdiffub,"vabd.u8",0xf3000700, "uabd", 0x2e207400, 3)
 BINARY(avgsb,"vrhadd.s8",0xf2000100, "srhadd", 0x0e201400, 3)
 BINARY(avgub,"vrhadd.u8",0xf3000100, "urhadd", 0x2e201400, 3)
 BINARY(cmpeqb,"vceq.i8",0xf3000810, "cmeq", 0x2e208c00, 3)
@@ -2798,6 +2799,7 @@ BINARY(addssw,"vqadd.s16",0xf2100010, "sqadd", 0x0e600c00, 2)
 BINARY(addusw,"vqadd.u16",0xf3100010, "uqadd", 0x2e600c00, 2)
 BINARY(andw,"vand",0xf2000110, "and", 0x0e201c00, 2)
 /* BINARY(andnw,"vbic",0xf2100110, NULL, 0, 2) */
+BINARY(absdiffuw,"vabd.u16",0xf3100700, "uabd", 0x2e607400, 2)
 BINARY(avgsw,"vrhadd.s16",0xf2100100, "srhadd", 0x0e601400, 2)
 BINARY(avguw,"vrhadd.u16",0xf3100100, "urhadd", 0x2e601400, 2)
 BINARY(cmpeqw,"vceq.i16",0xf3100810, "cmeq", 0x2e608c00, 2)
@@ -4243,6 +4245,210 @@ orc_neon_rule_splitwb (OrcCompiler *p, void *user, OrcInstruction *insn)
   }
 }
 
+/* Pairwise ops: each source element holds two dest-sized halves.  Both
+ * ISAs have a pairwise add (vpadd/addp) that takes them straight to the
+ * narrow width; the rounding averages widen with vpaddl/uaddlp and come
+ * back with a rounding narrow shift by one. */
+static void
+orc_neon_rule_addpX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[] = { "vpadd.i8", "vpadd.i16", "vpadd.i32" };
+  const OrcVariable dest = p->vars[insn->dest_args[0]];
+  const OrcVariable src = p->vars[insn->src_args[0]];
+  const int size_idx = (dest.size == 1) ? 0 : (dest.size == 2) ? 1 : 2;
+  const int vec_shift = 2 - size_idx;
+
+  if (p->is_64bit) {
+    const OrcVariable src_n = { .alloc = src.alloc, .size = dest.size };
+
+    orc_neon64_emit_binary (p, "addp", 0x0e20bc00 | (size_idx << 22),
+        dest, src_n, src_n, vec_shift);
+  } else {
+    if (p->insn_shift <= vec_shift + 1) {
+      orc_neon_emit_binary (p, names[size_idx], 0xf2000b10 | (size_idx << 20),
+          dest.alloc, src.alloc, src.alloc + 1);
+    } else {
+      ORC_COMPILER_ERROR(p, "shift too large");
+    }
+  }
+}
+
+static void
+orc_neon_rule_avgpuX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names_long[] = { "vpaddl.u8", "vpaddl.u16", "vpaddl.u32" };
+  static const char *names_narrow[] = { "vrshrn.i16", "vrshrn.i32", "vrshrn.i64" };
+  static const unsigned int codes_narrow[] = { 0xf28f0850, 0xf29f0850, 0xf2bf0850 };
+  static const unsigned int codes_narrow64[] = { 0x0f0f8c00, 0x0f1f8c00, 0x0f3f8c00 };
+  const OrcVariable dest = p->vars[insn->dest_args[0]];
+  const OrcVariable src = p->vars[insn->src_args[0]];
+  const int size_idx = (dest.size == 1) ? 0 : (dest.size == 2) ? 1 : 2;
+  const int vec_shift = 2 - size_idx;
+
+  if (p->is_64bit) {
+    const OrcVariable src_n = { .alloc = src.alloc, .size = dest.size };
+    const OrcVariable tmp = { .alloc = p->tmpreg, .size = src.size };
+    unsigned int code;
+
+    orc_neon64_emit_unary (p, "uaddlp", 0x2e202800 | (size_idx << 22),
+        tmp, src_n, vec_shift);
+
+    ORC_ASM_CODE (p, "  %s %s, %s, #%d\n", "rshrn",
+        orc_neon64_reg_name_vector (dest.alloc, dest.size, 0),
+        orc_neon64_reg_name_vector (tmp.alloc, tmp.size, 1), 1);
+    code = codes_narrow64[size_idx];
+    code |= (tmp.alloc & 0x1f) << 5;
+    code |= (dest.alloc & 0x1f);
+    orc_arm_emit (p, code);
+  } else {
+    if (p->insn_shift <= vec_shift + 1) {
+      orc_neon_emit_unary_quad (p, names_long[size_idx],
+          0xf3b00280 | (size_idx << 18), p->tmpreg, src.alloc);
+      ORC_ASM_CODE (p, "  %s %s, %s, #%d\n", names_narrow[size_idx],
+          orc_neon_reg_name (dest.alloc),
+          orc_neon_reg_name_quad (p->tmpreg), 1);
+      orc_arm_emit (p, NEON_BINARY (codes_narrow[size_idx], dest.alloc, 0,
+          p->tmpreg));
+    } else {
+      ORC_COMPILER_ERROR(p, "shift too large");
+    }
+  }
+}
+
+static void
+orc_neon_rule_addpf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const OrcVariable dest = p->vars[insn->dest_args[0]];
+  const OrcVariable src = p->vars[insn->src_args[0]];
+
+  if (p->is_64bit) {
+    const OrcVariable src_n = { .alloc = src.alloc, .size = dest.size };
+
+    orc_neon64_emit_binary (p, "faddp", 0x2e20d400, dest, src_n, src_n, 0);
+  } else {
+    if (p->insn_shift <= 1) {
+      orc_neon_emit_binary (p, "vpadd.f32", 0xf3000d00,
+          dest.alloc, src.alloc, src.alloc + 1);
+    } else {
+      ORC_COMPILER_ERROR(p, "shift too large");
+    }
+  }
+}
+
+/* The two 8-byte table halves are loaded like other 64-bit parameters;
+ * they are copied next to each other for tbl/vtbl, which give 0 for
+ * indices past the table just like lut16b. */
+static void
+orc_neon_rule_lut16b (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const OrcVariable dest = p->vars[insn->dest_args[0]];
+  const OrcVariable src = p->vars[insn->src_args[0]];
+  const OrcVariable lo = p->vars[insn->src_args[1]];
+  const OrcVariable hi = p->vars[insn->src_args[2]];
+  unsigned int code;
+
+  if (p->insn_shift > 4) {
+    ORC_COMPILER_ERROR(p, "shift too large");
+    return;
+  }
+
+  if (p->is_64bit) {
+    const OrcVariable tmp = { .alloc = p->tmpreg, .size = 8 };
+    const int is_quad = (p->insn_shift == 4);
+
+    orc_neon64_emit_binary (p, "zip1", 0x0ec03800, tmp, lo, hi,
+        p->insn_shift - 1);
+
+    ORC_ASM_CODE(p,"  tbl %s, { %s }, %s\n",
+        orc_neon64_reg_name_vector (dest.alloc, 1, is_quad),
+        orc_neon64_reg_name_vector (p->tmpreg, 1, 1),
+        orc_neon64_reg_name_vector (src.alloc, 1, is_quad));
+    code = 0x0e000000;
+    code |= (is_quad&0x1)<<30;
+    code |= (src.alloc&0x1f)<<16;
+    code |= (p->tmpreg&0x1f)<<5;
+    code |= (dest.alloc&0x1f);
+    orc_arm_emit (p, code);
+  } else {
+    const OrcVariable tmp_lo = { .alloc = p->tmpreg, .size = 8 };
+    const OrcVariable tmp_hi = { .alloc = p->tmpreg + 1, .size = 8 };
+
+    orc_neon_emit_mov (p, tmp_lo, lo);
+    orc_neon_emit_mov (p, tmp_hi, hi);
+
+    ORC_ASM_CODE(p,"  vtbl.8 %s, { %s, %s }, %s\n",
+        orc_neon_reg_name (dest.alloc),
+        orc_neon_reg_name (p->tmpreg),
+        orc_neon_reg_name (p->tmpreg + 1),
+        orc_neon_reg_name (src.alloc));
+    code = NEON_BINARY(0xf3b00900, dest.alloc, p->tmpreg, src.alloc);
+    orc_arm_emit (p, code);
+
+    if (p->insn_shift == 4) {
+      ORC_ASM_CODE(p,"  vtbl.8 %s, { %s, %s }, %s\n",
+          orc_neon_reg_name (dest.alloc + 1),
+          orc_neon_reg_name (p->tmpreg),
+          orc_neon_reg_name (p->tmpreg + 1),
+          orc_neon_reg_name (src.alloc + 1));
+      code = NEON_BINARY(0xf3b00900, dest.alloc + 1, p->tmpreg,
+          src.alloc + 1);
+      orc_arm_emit (p, code);
+    }
+  }
+}
+
+/* vabd, then three widening pairwise adds fold each 8 bytes into 64 bits */
+static void
+orc_neon_rule_sadubq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names_long[] = { "vpaddl.u8", "vpaddl.u16", "vpaddl.u32" };
+  const OrcVariable dest = p->vars[insn->dest_args[0]];
+  const OrcVariable src1 = p->vars[insn->src_args[0]];
+  const OrcVariable src2 = p->vars[insn->src_args[1]];
+  int i;
+
+  if (p->insn_shift > 1) {
+    ORC_COMPILER_ERROR(p, "shift too large");
+    return;
+  }
+
+  if (p->is_64bit) {
+    const OrcVariable src1_b = { .alloc = src1.alloc, .size = 1 };
+    const OrcVariable src2_b = { .alloc = src2.alloc, .size = 1 };
+    OrcVariable tmp = { .alloc = p->tmpreg, .size = 1 };
+    OrcVariable tmp2;
+
+    orc_neon64_emit_binary (p, "uabd", 0x2e207400, tmp, src1_b, src2_b, 0);
+    for (i = 0; i < 3; i++) {
+      tmp2 = tmp;
+      tmp2.size = tmp.size * 2;
+      if (i == 2) tmp2.alloc = dest.alloc;
+      orc_neon64_emit_unary (p, "uaddlp", 0x2e202800 | (i << 22), tmp2, tmp,
+          0);
+      tmp = tmp2;
+    }
+  } else {
+    if (p->insn_shift == 0) {
+      orc_neon_emit_binary (p, "vabd.u8", 0xf3000700, p->tmpreg,
+          src1.alloc, src2.alloc);
+    } else {
+      orc_neon_emit_binary_quad (p, "vabd.u8", 0xf3000700, p->tmpreg,
+          src1.alloc, src2.alloc);
+    }
+    for (i = 0; i < 3; i++) {
+      const int reg = (i == 2) ? dest.alloc : p->tmpreg;
+
+      if (p->insn_shift == 0) {
+        orc_neon_emit_unary (p, names_long[i], 0xf3b00280 | (i << 18),
+            reg, p->tmpreg);
+      } else {
+        orc_neon_emit_unary_quad (p, names_long[i], 0xf3b00280 | (i << 18),
+            reg, p->tmpreg);
+      }
+    }
+  }
+}
+
 static void
 orc_neon_rule_div255w (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -4450,6 +4656,18 @@ orc_compiler_neon_register_rules (OrcTarget *target)
   REG(splitlw);
   REG(splitwb);
 
+  orc_rule_register (rule_set, "addpb", orc_neon_rule_addpX, NULL);
+  orc_rule_register (rule_set, "addpw", orc_neon_rule_addpX, NULL);
+  orc_rule_register (rule_set, "addpl", orc_neon_rule_addpX, NULL);
+  orc_rule_register (rule_set, "avgpub", orc_neon_rule_avgpuX, NULL);
+  orc_rule_register (rule_set, "avgpuw", orc_neon_rule_avgpuX, NULL);
+  orc_rule_register (rule_set, "avgpul", orc_neon_rule_avgpuX, NULL);
+  REG(addpf);
+  REG(lut16b);
+  REG(absdiffub);
+  REG(absdiffuw);
+  REG(sadubq);
+
   REG(addf);
   REG(subf);
   REG(mulf);
@@ -2010,6 +2010,481 @@ sse_rule_splitwb (OrcCompiler *p, void *user, OrcInstruction *insn)
 #endif
 }
 
+/* pairwise ops: each source element holds two adjacent values, the
+ * result is their sum or average at half the width */
+
+static void
+sse_rule_addpb (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int mask = orc_compiler_get_constant (p, 2, 0xff);
+
+  orc_sse_emit_movdqa (p, src, tmp);
+  orc_sse_emit_psrlw_imm (p, 8, tmp);
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+  if (ORC_PTR_TO_INT (user)) {
+    orc_sse_emit_pavgb (p, tmp, dest);
+  } else {
+    orc_sse_emit_paddb (p, tmp, dest);
+  }
+  orc_sse_emit_pand (p, mask, dest);
+  orc_sse_emit_packuswb (p, dest, dest);
+}
+
+static void
+sse_rule_addpw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (ORC_PTR_TO_INT (user)) {
+    const int tmp = orc_compiler_get_temp_reg (p);
+
+    orc_sse_emit_movdqa (p, src, tmp);
+    orc_sse_emit_psrld_imm (p, 16, tmp);
+    if (src != dest) {
+      orc_sse_emit_movdqa (p, src, dest);
+    }
+    orc_sse_emit_pavgw (p, tmp, dest);
+  } else {
+    const int ones = orc_compiler_get_constant (p, 2, 0x0001);
+
+    if (src != dest) {
+      orc_sse_emit_movdqa (p, src, dest);
+    }
+    orc_sse_emit_pmaddwd (p, ones, dest);
+  }
+
+  /* same as select0lw */
+  orc_sse_emit_pslld_imm (p, 16, dest);
+  orc_sse_emit_psrad_imm (p, 16, dest);
+  orc_sse_emit_packssdw (p, dest, dest);
+}
+
+static void
+sse_rule_addpl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+#ifndef MMX
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (3, 1, 3, 1), src, tmp);
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 0, 2, 0), src, dest);
+#else
+  orc_sse_emit_movdqa (p, src, tmp);
+  orc_sse_emit_psrlq_imm (p, 32, tmp);
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+#endif
+
+  if (ORC_PTR_TO_INT (user)) {
+    const int tmp2 = orc_compiler_get_temp_reg (p);
+
+    /* (a+b+1) >> 1 = (a|b) - ((a^b)>>1) */
+    orc_sse_emit_movdqa (p, dest, tmp2);
+    orc_sse_emit_pxor (p, tmp, tmp2);
+    orc_sse_emit_psrld_imm (p, 1, tmp2);
+    orc_sse_emit_por (p, tmp, dest);
+    orc_sse_emit_psubd (p, tmp2, dest);
+  } else {
+    orc_sse_emit_paddd (p, tmp, dest);
+  }
+}
+
+#ifndef MMX
+static void
+sse_rule_addpf (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (3, 1, 3, 1), src, tmp);
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 0, 2, 0), src, dest);
+  orc_sse_emit_addps (p, tmp, dest);
+  if (ORC_PTR_TO_INT (user)) {
+    orc_sse_emit_mulps (p, orc_compiler_get_constant (p, 4, 0x3f000000),
+        dest);
+  }
+}
+
+/* randl, randf and randtf: each lane hashes seed * ORC_RAND_MULTIPLIER
+ * plus its element index with Wang's 32-bit integer hash.  The running
+ * index of the loop is kept in params[ORC_VAR_T10]. */
+static void
+sse_rule_randX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int type = ORC_PTR_TO_INT (user);
+  const int seed_var = insn->src_args[0];
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "rand opcodes cannot be used with x2 or x4");
+    return;
+  }
+
+  if (p->vars[seed_var].vartype == ORC_VAR_TYPE_CONST) {
+    orc_x86_emit_mov_imm_reg (p, 4,
+        (orc_uint32)p->vars[seed_var].value.i * ORC_RAND_MULTIPLIER +
+        p->offset, p->gp_tmpreg);
+  } else {
+    orc_x86_emit_mov_imm_reg (p, 4, ORC_RAND_MULTIPLIER, p->gp_tmpreg);
+    orc_x86_emit_imul_memoffset_reg (p, 4,
+        (int)ORC_STRUCT_OFFSET (OrcExecutor, params[seed_var]),
+        p->exec_reg, p->gp_tmpreg);
+    if (p->offset) {
+      orc_x86_emit_add_imm_reg (p, 4, p->offset, p->gp_tmpreg, FALSE);
+    }
+  }
+  orc_x86_emit_add_memoffset_reg (p, 4,
+      (int)ORC_STRUCT_OFFSET (OrcExecutor, params[ORC_VAR_T10]),
+      p->exec_reg, p->gp_tmpreg);
+  orc_sse_emit_movd_load_register (p, p->gp_tmpreg, dest);
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (0, 0, 0, 0), dest, dest);
+  orc_sse_emit_paddd (p, orc_compiler_get_constant_long (p, 0, 1, 2, 3),
+      dest);
+
+  /* x = ~x + (x << 15) */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_pslld_imm (p, 15, tmp);
+  orc_sse_emit_pxor (p, orc_compiler_get_constant (p, 4, 0xffffffff), dest);
+  orc_sse_emit_paddd (p, tmp, dest);
+  /* x ^= x >> 12 */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_psrld_imm (p, 12, tmp);
+  orc_sse_emit_pxor (p, tmp, dest);
+  /* x += x << 2 */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_pslld_imm (p, 2, tmp);
+  orc_sse_emit_paddd (p, tmp, dest);
+  /* x ^= x >> 4 */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_psrld_imm (p, 4, tmp);
+  orc_sse_emit_pxor (p, tmp, dest);
+  /* x += (x << 3) + (x << 11) */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_pslld_imm (p, 3, tmp);
+  orc_sse_emit_paddd (p, dest, tmp);
+  orc_sse_emit_pslld_imm (p, 11, dest);
+  orc_sse_emit_paddd (p, tmp, dest);
+  /* x ^= x >> 16 */
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_psrld_imm (p, 16, tmp);
+  orc_sse_emit_pxor (p, tmp, dest);
+
+  if (type == 1) {
+    /* uniform in [0,1) */
+    orc_sse_emit_psrld_imm (p, 8, dest);
+    orc_sse_emit_cvtdq2ps (p, dest, dest);
+    orc_sse_emit_mulps (p, orc_compiler_get_constant (p, 4, 0x33800000),
+        dest);
+  } else if (type == 2) {
+    /* triangular in (-1,1): difference of the two 16-bit halves */
+    orc_sse_emit_movdqa (p, dest, tmp);
+    orc_sse_emit_psrld_imm (p, 16, tmp);
+    orc_sse_emit_pslld_imm (p, 16, dest);
+    orc_sse_emit_psrld_imm (p, 16, dest);
+    orc_sse_emit_psubd (p, tmp, dest);
+    orc_sse_emit_cvtdq2ps (p, dest, dest);
+    orc_sse_emit_mulps (p, orc_compiler_get_constant (p, 4, 0x37800000),
+        dest);
+  }
+}
+
+static void
+sse_rule_unpack3x10 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int mask = orc_compiler_get_constant (p, 4, 0x000003ff);
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+
+  /* low dword of each result: sample 0 | sample 1 << 16 */
+  orc_sse_emit_movdqa (p, src, tmp);
+  orc_sse_emit_pslld_imm (p, 6, tmp);
+  orc_sse_emit_pand (p, orc_compiler_get_constant (p, 4, 0x03ff0000), tmp);
+  /* high dword: sample 2 */
+  orc_sse_emit_movdqa (p, src, tmp2);
+  orc_sse_emit_psrld_imm (p, 20, tmp2);
+  orc_sse_emit_pand (p, mask, tmp2);
+
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+  orc_sse_emit_pand (p, mask, dest);
+  orc_sse_emit_por (p, tmp, dest);
+  orc_sse_emit_punpckldq (p, tmp2, dest);
+}
+
+static void
+sse_rule_pack3x10 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  /* each qword becomes (s0 | s1 << 10, s2) */
+  orc_sse_emit_movdqa (p, src, dest);
+  orc_sse_emit_pand (p, orc_compiler_get_constant (p, 4, 0x03ff03ff), dest);
+  orc_sse_emit_pmaddwd (p, orc_compiler_get_constant_long (p, 0x04000001,
+          0x00000001, 0x04000001, 0x00000001), dest);
+  orc_sse_emit_movdqa (p, dest, tmp);
+  orc_sse_emit_psrlq_imm (p, 32, tmp);
+  orc_sse_emit_psllq_imm (p, 20, tmp);
+  orc_sse_emit_por (p, tmp, dest);
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 0, 2, 0), dest, dest);
+}
+
+/* Loads exactly n_bytes from ptr_reg into the low bytes of reg; the
+ * remaining bytes are left undefined. */
+static void
+sse_load_packed (OrcCompiler *p, int ptr_reg, int n_bytes, int reg)
+{
+  int offset = 0;
+
+  if (n_bytes >= 8) {
+    orc_x86_emit_mov_memoffset_sse (p, 8, 0, ptr_reg, reg, FALSE);
+    offset = 8;
+  } else if (n_bytes >= 4) {
+    orc_x86_emit_mov_memoffset_sse (p, 4, 0, ptr_reg, reg, FALSE);
+    offset = 4;
+  }
+  for (; offset + 2 <= n_bytes; offset += 2) {
+    orc_sse_emit_pinsrw_memoffset (p, offset / 2, offset, ptr_reg, reg);
+  }
+  if (offset < n_bytes) {
+    orc_sse_emit_pinsrb_memoffset (p, offset, offset, ptr_reg, reg);
+  }
+}
+
+static void
+sse_store_packed (OrcCompiler *p, int reg, int n_bytes, int ptr_reg)
+{
+  int offset = 0;
+
+  if (n_bytes >= 8) {
+    orc_x86_emit_mov_sse_memoffset (p, 8, reg, 0, ptr_reg, FALSE, FALSE);
+    offset = 8;
+  } else if (n_bytes >= 4) {
+    orc_x86_emit_mov_sse_memoffset (p, 4, reg, 0, ptr_reg, FALSE, FALSE);
+    offset = 4;
+  }
+  for (; offset + 2 <= n_bytes; offset += 2) {
+    orc_sse_emit_pextrw_memoffset (p, offset / 2, offset, reg, ptr_reg);
+  }
+  if (offset < n_bytes) {
+    orc_sse_emit_pextrb_memoffset (p, offset, offset, reg, ptr_reg);
+  }
+}
+
+/* user is the number of bits per sample, 10 (ldunpack4x10) or 12
+ * (ldunpack2x12).  pshufb moves the two bytes holding each sample into
+ * its 16-bit lane, pmullw shifts every sample up to the top of its lane
+ * and a single psrlw brings them all down. */
+static void
+sse_rule_ldunpackX_sse41 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int bits = ORC_PTR_TO_INT (user);
+  OrcVariable *src = p->vars + insn->src_args[0];
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int n_bytes = (bits == 10 ? 5 : 3) << p->loop_shift;
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "packed opcodes cannot be used with x2 or x4");
+    return;
+  }
+  if (src->ptr_register == 0) {
+    orc_compiler_error (p, "packed opcodes need a pointer register");
+    return;
+  }
+
+  sse_load_packed (p, src->ptr_register, n_bytes, dest);
+  if (bits == 10) {
+    orc_sse_emit_pshufb (p, orc_compiler_get_constant_long (p, 0x02010100,
+            0x04030302, 0x07060605, 0x09080807), dest);
+    orc_sse_emit_pmullw (p, orc_compiler_get_constant_long (p, 0x00100040,
+            0x00010004, 0x00100040, 0x00010004), dest);
+    orc_sse_emit_psrlw_imm (p, 6, dest);
+  } else {
+    orc_sse_emit_pshufb (p, orc_compiler_get_constant_long (p, 0x02010100,
+            0x05040403, 0x08070706, 0x0b0a0a09), dest);
+    orc_sse_emit_pmullw (p, orc_compiler_get_constant (p, 4, 0x00010010),
+        dest);
+    orc_sse_emit_psrlw_imm (p, 4, dest);
+  }
+
+  orc_x86_emit_add_imm_reg (p, p->is_64bit ? 8 : 4, n_bytes,
+      src->ptr_register, FALSE);
+  src->update_type = 0;
+}
+
+static void
+sse_rule_stpackX_sse41 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int bits = ORC_PTR_TO_INT (user);
+  const int src = p->vars[insn->src_args[0]].alloc;
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+  const int n_bytes = (bits == 10 ? 5 : 3) << p->loop_shift;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "packed opcodes cannot be used with x2 or x4");
+    return;
+  }
+  if (dest->ptr_register == 0) {
+    orc_compiler_error (p, "packed opcodes need a pointer register");
+    return;
+  }
+
+  orc_sse_emit_movdqa (p, src, tmp);
+  if (bits == 10) {
+    /* each qword becomes s0 | s1 << 10 | s2 << 20 | s3 << 30 */
+    orc_sse_emit_pand (p, orc_compiler_get_constant (p, 4, 0x03ff03ff), tmp);
+    orc_sse_emit_pmaddwd (p, orc_compiler_get_constant (p, 4, 0x04000001),
+        tmp);
+    orc_sse_emit_movdqa (p, tmp, tmp2);
+    orc_sse_emit_psrlq_imm (p, 32, tmp2);
+    orc_sse_emit_psllq_imm (p, 20, tmp2);
+    orc_sse_emit_psllq_imm (p, 32, tmp);
+    orc_sse_emit_psrlq_imm (p, 32, tmp);
+    orc_sse_emit_por (p, tmp2, tmp);
+    orc_sse_emit_pshufb (p, orc_compiler_get_constant_long (p, 0x03020100,
+            0x0a090804, 0x80800c0b, 0x80808080), tmp);
+  } else {
+    /* each dword becomes s0 | s1 << 12 */
+    orc_sse_emit_pand (p, orc_compiler_get_constant (p, 4, 0x0fff0fff), tmp);
+    orc_sse_emit_pmaddwd (p, orc_compiler_get_constant (p, 4, 0x10000001),
+        tmp);
+    orc_sse_emit_pshufb (p, orc_compiler_get_constant_long (p, 0x04020100,
+            0x09080605, 0x0e0d0c0a, 0x80808080), tmp);
+  }
+  sse_store_packed (p, tmp, n_bytes, dest->ptr_register);
+
+  orc_x86_emit_add_imm_reg (p, p->is_64bit ? 8 : 4, n_bytes,
+      dest->ptr_register, FALSE);
+  dest->update_type = 0;
+}
+
+static void
+sse_rule_lut16b_ssse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int lo = p->vars[insn->src_args[1]].alloc;
+  const int hi = p->vars[insn->src_args[2]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2 | ORC_INSTRUCTION_FLAG_X4)) {
+    orc_compiler_error (p, "lut16b cannot be used with x2 or x4");
+    return;
+  }
+
+  /* indices of 16 and up saturate into the top bit, which makes pshufb
+   * return 0 for them */
+  orc_sse_emit_movdqa (p, src, tmp);
+  orc_sse_emit_paddusb (p, orc_compiler_get_constant (p, 1, 0x70), tmp);
+  orc_sse_emit_movdqa (p, lo, dest);
+  orc_sse_emit_punpcklqdq (p, hi, dest);
+  orc_sse_emit_pshufb (p, tmp, dest);
+}
+#endif
+
+#ifndef MMX
+/* the elements go through memory so that crc32 can fold 8 bytes at a
+ * time; the CRC itself lives in the low lane of the accumulator */
+static void
+sse_rule_acccrc32cX_sse42 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int n_bytes = p->vars[insn->src_args[0]].size << p->insn_shift;
+  const int offset = ORC_STRUCT_OFFSET (OrcExecutor, arrays[ORC_VAR_T1]);
+
+  orc_x86_emit_mov_sse_memoffset (p, MAX (n_bytes, 4), src, offset,
+      p->exec_reg, FALSE, FALSE);
+  orc_sse_emit_movd_store_register (p, dest, p->gp_tmpreg);
+  orc_x86_emit_crc32c_memoffset (p, n_bytes, offset, p->exec_reg,
+      p->gp_tmpreg);
+  orc_sse_emit_movd_load_register (p, p->gp_tmpreg, dest);
+}
+#endif
+
+/* |a - b| is whichever of the two saturating differences is nonzero */
+static void
+sse_rule_absdiffuX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  int src0 = p->vars[insn->src_args[0]].alloc;
+  int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (dest == src1) {
+    src1 = src0;
+    src0 = dest;
+  }
+
+  orc_sse_emit_movdqa (p, src1, tmp);
+  if (src0 != dest) {
+    orc_sse_emit_movdqa (p, src0, dest);
+  }
+  if (ORC_PTR_TO_INT (user)) {
+    orc_sse_emit_psubusw (p, src0, tmp);
+    orc_sse_emit_psubusw (p, src1, dest);
+  } else {
+    orc_sse_emit_psubusb (p, src0, tmp);
+    orc_sse_emit_psubusb (p, src1, dest);
+  }
+  orc_sse_emit_por (p, tmp, dest);
+}
+
+static void
+sse_rule_sadubq (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (dest == src1) {
+    orc_sse_emit_psadbw (p, src0, dest);
+  } else {
+    if (src0 != dest) {
+      orc_sse_emit_movdqa (p, src0, dest);
+    }
+    orc_sse_emit_psadbw (p, src1, dest);
+  }
+}
+
+#ifndef MMX
+/* phminposuw looks at all 8 words, so each 4-word element is doubled up
+ * first; the first copy wins ties, which keeps the position in 0..3 */
+static void
+sse_rule_minposuwl_sse41 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+
+  if (p->insn_shift > 0) {
+    orc_sse_emit_pshufd (p, ORC_SSE_SHUF (3, 2, 3, 2), src, tmp);
+    orc_sse_emit_phminposuw (p, tmp, tmp);
+  }
+  orc_sse_emit_pshufd (p, ORC_SSE_SHUF (1, 0, 1, 0), src, dest);
+  orc_sse_emit_phminposuw (p, dest, dest);
+  if (p->insn_shift > 0) {
+    orc_sse_emit_punpckldq (p, tmp, dest);
+  }
+}
+#endif
+
 static void
 sse_rule_mergebw (OrcCompiler *p, void *user, OrcInstruction *insn)
 {
@@ -2352,6 +2827,44 @@ sse_rule_select1wb_ssse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
     sse_rule_select1wb (p, user, insn);
   }
 }
+
+static void
+sse_rule_addpb_ssse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int ones = orc_compiler_try_get_constant_long (p, 0x01010101,
+      0x01010101, 0x01010101, 0x01010101);
+  const int tmp = orc_compiler_try_get_constant_long (p, 0x06040200,
+      0x0e0c0a08, 0x06040200, 0x0e0c0a08);
+
+  if (ones != ORC_REG_INVALID && tmp != ORC_REG_INVALID) {
+    if (src != dest) {
+      orc_sse_emit_movdqa (p, src, dest);
+    }
+    /* unsigned bytes times 1, summed in pairs; then the low bytes */
+    orc_sse_emit_pmaddubsw (p, ones, dest);
+    orc_sse_emit_pshufb (p, tmp, dest);
+  } else {
+    sse_rule_addpb (p, user, insn);
+  }
+}
+
+static void
+sse_rule_addpX_ssse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+  if (p->vars[insn->src_args[0]].size == 4) {
+    orc_sse_emit_phaddw (p, dest, dest);
+  } else {
+    orc_sse_emit_phaddd (p, dest, dest);
+  }
+}
 #endif
 
 /* slow rules */
@@ -2852,6 +3365,72 @@ UNARY_F(sqrtf, sqrtps, 0x51)
 BINARY_F(orf, orps, 0x56)
 BINARY_F(andf, andps, 0x54)
 
+/* complex float ops on interleaved (re,im) pairs; the products and
+ * sums are formed in the same order as the emulation, so results are
+ * bit-exact */
+
+static void
+sse_rule_mulcX_sse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src0 = p->vars[insn->src_args[0]].alloc;
+  const int src1 = p->vars[insn->src_args[1]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+  const int tmp = orc_compiler_get_temp_reg (p);
+  const int tmp2 = orc_compiler_get_temp_reg (p);
+  const int conj = ORC_PTR_TO_INT (user);
+
+  if (conj) {
+    /* (im*re' - re*im', re*re' + im*im'), then swap the halves */
+    orc_sse_emit_movshdup (p, src1, tmp);
+    orc_sse_emit_mulps (p, src0, tmp);
+    orc_sse_emit_movsldup (p, src1, tmp2);
+    orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 3, 0, 1), src0, dest);
+    orc_sse_emit_mulps (p, tmp2, dest);
+    orc_sse_emit_addsubps (p, tmp, dest);
+    orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 3, 0, 1), dest, dest);
+  } else {
+    /* (re*re' - im*im', im*re' + re*im') */
+    orc_sse_emit_pshufd (p, ORC_SSE_SHUF (2, 3, 0, 1), src0, tmp);
+    orc_sse_emit_movshdup (p, src1, tmp2);
+    orc_sse_emit_mulps (p, tmp2, tmp);
+    orc_sse_emit_movsldup (p, src1, tmp2);
+    if (src0 != dest) {
+      orc_sse_emit_movdqa (p, src0, dest);
+    }
+    orc_sse_emit_mulps (p, tmp2, dest);
+    orc_sse_emit_addsubps (p, tmp, dest);
+  }
+}
+
+static void
+sse_rule_magsqcf_sse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+  orc_sse_emit_mulps (p, dest, dest);
+  orc_sse_emit_haddps (p, dest, dest);
+}
+
+static void
+sse_rule_addpf_sse3 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int src = p->vars[insn->src_args[0]].alloc;
+  const int dest = p->vars[insn->dest_args[0]].alloc;
+
+  if (src != dest) {
+    orc_sse_emit_movdqa (p, src, dest);
+  }
+  orc_sse_emit_haddps (p, dest, dest);
+  if (ORC_PTR_TO_INT (user)) {
+    orc_sse_emit_mulps (p, orc_compiler_get_constant (p, 4, 0x3f000000),
+        dest);
+  }
+}
+
 #define UNARY_D(opcode,insn_name,code) \
 static void \
 sse_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
@@ -3336,6 +3915,9 @@ orc_compiler_sse_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "accw", sse_rule_accw, NULL);
   orc_rule_register (rule_set, "accl", sse_rule_accl, NULL);
   orc_rule_register (rule_set, "accsadubl", sse_rule_accsadubl, NULL);
+  orc_rule_register (rule_set, "absdiffub", sse_rule_absdiffuX, (void *)0);
+  orc_rule_register (rule_set, "absdiffuw", sse_rule_absdiffuX, (void *)1);
+  REG(sadubq);
 
 #ifndef MMX
   /* These require the SSE2 flag, although could be used with MMX.
@@ -3401,6 +3983,21 @@ orc_compiler_sse_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "splitql", sse_rule_splitql, NULL);
   orc_rule_register (rule_set, "splitlw", sse_rule_splitlw, NULL);
   orc_rule_register (rule_set, "splitwb", sse_rule_splitwb, NULL);
+  orc_rule_register (rule_set, "addpb", sse_rule_addpb, (void *)0);
+  orc_rule_register (rule_set, "addpw", sse_rule_addpw, (void *)0);
+  orc_rule_register (rule_set, "addpl", sse_rule_addpl, (void *)0);
+  orc_rule_register (rule_set, "avgpub", sse_rule_addpb, (void *)1);
+  orc_rule_register (rule_set, "avgpuw", sse_rule_addpw, (void *)1);
+  orc_rule_register (rule_set, "avgpul", sse_rule_addpl, (void *)1);
+#ifndef MMX
+  orc_rule_register (rule_set, "addpf", sse_rule_addpf, (void *)0);
+  orc_rule_register (rule_set, "avgpf", sse_rule_addpf, (void *)1);
+  orc_rule_register (rule_set, "randl", sse_rule_randX, (void *)0);
+  orc_rule_register (rule_set, "randf", sse_rule_randX, (void *)1);
+  orc_rule_register (rule_set, "randtf", sse_rule_randX, (void *)2);
+  orc_rule_register (rule_set, "unpack3x10", sse_rule_unpack3x10, NULL);
+  orc_rule_register (rule_set, "pack3x10", sse_rule_pack3x10, NULL);
+#endif
   orc_rule_register (rule_set, "avgsl", sse_rule_avgsl, NULL);
   orc_rule_register (rule_set, "avgul", sse_rule_avgul, NULL);
   orc_rule_register (rule_set, "shlb", sse_rule_shlb, NULL);
@@ -3427,7 +4024,17 @@ orc_compiler_sse_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "div255w", sse_rule_div255w, NULL);
   orc_rule_register (rule_set, "divluw", sse_rule_divluw, NULL);
 
-  /* SSE 3 -- no rules */
+  /* SSE 3 */
+  rule_set = orc_rule_set_new (orc_opcode_set_get("sys"), target,
+      ORC_TARGET_SSE_SSE3);
+
+#ifndef MMX
+  orc_rule_register (rule_set, "mulcf", sse_rule_mulcX_sse3, (void *)0);
+  orc_rule_register (rule_set, "mulcjf", sse_rule_mulcX_sse3, (void *)1);
+  orc_rule_register (rule_set, "magsqcf", sse_rule_magsqcf_sse3, NULL);
+  orc_rule_register (rule_set, "addpf", sse_rule_addpf_sse3, (void *)0);
+  orc_rule_register (rule_set, "avgpf", sse_rule_addpf_sse3, (void *)1);
+#endif
 
   /* SSSE 3 */
   rule_set = orc_rule_set_new (orc_opcode_set_get("sys"), target,
@@ -3452,6 +4059,10 @@ orc_compiler_sse_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "select1lw", sse_rule_select1lw_ssse3, NULL);
   orc_rule_register (rule_set, "select0wb", sse_rule_select0wb_ssse3, NULL);
   orc_rule_register (rule_set, "select1wb", sse_rule_select1wb_ssse3, NULL);
+  orc_rule_register (rule_set, "addpb", sse_rule_addpb_ssse3, NULL);
+  orc_rule_register (rule_set, "addpw", sse_rule_addpX_ssse3, NULL);
+  orc_rule_register (rule_set, "addpl", sse_rule_addpX_ssse3, NULL);
+  orc_rule_register (rule_set, "lut16b", sse_rule_lut16b_ssse3, NULL);
 #endif
 
   /* SSE 4.1 */
@@ -3480,13 +4091,28 @@ orc_compiler_sse_register_rules (OrcTarget *target)
   orc_rule_register (rule_set, "mulhsl", sse_rule_mulhsl, NULL);
   orc_rule_register (rule_set, "convsssql", sse_rule_convsssql_sse41, NULL);
   REG(cmpeqq);
+  orc_rule_register (rule_set, "ldunpack4x10", sse_rule_ldunpackX_sse41,
+      (void *)10);
+  orc_rule_register (rule_set, "stpack4x10", sse_rule_stpackX_sse41,
+      (void *)10);
+  orc_rule_register (rule_set, "ldunpack2x12", sse_rule_ldunpackX_sse41,
+      (void *)12);
+  orc_rule_register (rule_set, "stpack2x12", sse_rule_stpackX_sse41,
+      (void *)12);
+  orc_rule_register (rule_set, "minposuwl", sse_rule_minposuwl_sse41, NULL);
 #endif
 
-  /* SSE 4.2 -- no rules */
+  /* SSE 4.2 */
   rule_set = orc_rule_set_new (orc_opcode_set_get("sys"), target,
       ORC_TARGET_SSE_SSE4_2);
 
   REG(cmpgtsq);
+#ifndef MMX
+  orc_rule_register (rule_set, "acccrc32cb", sse_rule_acccrc32cX_sse42, NULL);
+  orc_rule_register (rule_set, "acccrc32cw", sse_rule_acccrc32cX_sse42, NULL);
+  orc_rule_register (rule_set, "acccrc32cl", sse_rule_acccrc32cX_sse42, NULL);
+  orc_rule_register (rule_set, "acccrc32cq", sse_rule_acccrc32cX_sse42, NULL);
+#endif
 
   /* SSE 4a -- no rules */
 }
@@ -0,0 +1,1004 @@
+
+#include "config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <sys/types.h>
+
+#include <orc/orcprogram.h>
+#include <orc/orcarm.h>
+#include <orc/orcdebug.h>
+
+#include <orc/orcsve.h>
+
+/* Every variable lives unpacked in the vector registers: element i of a
+ * variable of size s is held in the low s bytes of container i, where
+ * the container size is the largest variable size of the program.  The
+ * loop predicate is created for the container size, so ops on smaller
+ * elements may run over the whole register and loads, stores and
+ * accumulations only touch the low element of each active container. */
+
+#define SVE_ZREGS(s) { \
+    "z0" s, "z1" s, "z2" s, "z3" s, "z4" s, "z5" s, "z6" s, "z7" s, \
+    "z8" s, "z9" s, "z10" s, "z11" s, "z12" s, "z13" s, "z14" s, "z15" s, \
+    "z16" s, "z17" s, "z18" s, "z19" s, "z20" s, "z21" s, "z22" s, "z23" s, \
+    "z24" s, "z25" s, "z26" s, "z27" s, "z28" s, "z29" s, "z30" s, "z31" s }
+
+#define SVE_PREGS(s) { \
+    "p0" s, "p1" s, "p2" s, "p3" s, "p4" s, "p5" s, "p6" s, "p7" s, \
+    "p8" s, "p9" s, "p10" s, "p11" s, "p12" s, "p13" s, "p14" s, "p15" s }
+
+static int
+sve_size_bits (int size)
+{
+  switch (size) {
+    case 1:
+      return 0;
+    case 2:
+      return 1;
+    case 4:
+      return 2;
+    case 8:
+      return 3;
+    default:
+      ORC_ERROR ("bad element size %d", size);
+      return 0;
+  }
+}
+
+const char *
+orc_sve_reg_name (int reg, int size)
+{
+  static const char *vec_regs[5][32] = {
+    SVE_ZREGS(""), SVE_ZREGS(".b"), SVE_ZREGS(".h"), SVE_ZREGS(".s"),
+    SVE_ZREGS(".d")
+  };
+
+  if (reg < ORC_VEC_REG_BASE || reg >= ORC_VEC_REG_BASE + 32) {
+    return "ERROR";
+  }
+  if (size == 0) return vec_regs[0][reg & 0x1f];
+  return vec_regs[1 + sve_size_bits (size)][reg & 0x1f];
+}
+
+const char *
+orc_sve_pred_name (int pred, int size)
+{
+  static const char *pred_regs[5][16] = {
+    SVE_PREGS(""), SVE_PREGS(".b"), SVE_PREGS(".h"), SVE_PREGS(".s"),
+    SVE_PREGS(".d")
+  };
+
+  if (size == 0) return pred_regs[0][pred & 0xf];
+  return pred_regs[1 + sve_size_bits (size)][pred & 0xf];
+}
+
+static const char *
+sve_x (int reg)
+{
+  return orc_arm64_reg_name (reg, ORC_ARM64_REG_64);
+}
+
+static const char *
+sve_w (int reg)
+{
+  return orc_arm64_reg_name (reg, ORC_ARM64_REG_32);
+}
+
+void
+orc_sve_emit_ptrue (OrcCompiler *p, int size, int pd)
+{
+  ORC_ASM_CODE (p, "  ptrue %s\n", orc_sve_pred_name (pd, size));
+  orc_arm_emit (p, 0x2518e3e0 | (sve_size_bits (size) << 22) | (pd & 0xf));
+}
+
+void
+orc_sve_emit_whilelt (OrcCompiler *p, int size, int pd, int rn, int rm)
+{
+  ORC_ASM_CODE (p, "  whilelt %s, %s, %s\n", orc_sve_pred_name (pd, size),
+      sve_w (rn), sve_w (rm));
+  orc_arm_emit (p, 0x25200400 | (sve_size_bits (size) << 22) |
+      ((rm & 0x1f) << 16) | ((rn & 0x1f) << 5) | (pd & 0xf));
+}
+
+void
+orc_sve_emit_inc (OrcCompiler *p, int size, int rd)
+{
+  static const char sizes[] = "bhwd";
+  const int bits = sve_size_bits (size);
+
+  ORC_ASM_CODE (p, "  inc%c %s\n", sizes[bits], sve_x (rd));
+  orc_arm_emit (p, 0x0430e3e0 | (bits << 22) | (rd & 0x1f));
+}
+
+static void
+sve_emit_memory (OrcCompiler *p, int store, int msize, int esize, int zt,
+    int rn)
+{
+  static const char sizes[] = "bhwd";
+  const int msz = sve_size_bits (msize);
+  const int dtype = msz * 4 + sve_size_bits (esize);
+  char shift[16] = "";
+
+  if (msz > 0) sprintf (shift, ", lsl #%d", msz);
+
+  ORC_ASM_CODE (p, "  %s1%c {%s}, %s%s, [%s, %s%s]\n", store ? "st" : "ld",
+      sizes[msz], orc_sve_reg_name (zt, esize),
+      orc_sve_pred_name (ORC_SVE_PRED_LOOP, 0), store ? "" : "/z",
+      sve_x (rn), sve_x (ORC_SVE_INDEX_REG), shift);
+  orc_arm_emit (p, (store ? 0xe4004000 : 0xa4004000) | (dtype << 21) |
+      ((ORC_SVE_INDEX_REG & 0x1f) << 16) | (ORC_SVE_PRED_LOOP << 10) |
+      ((rn & 0x1f) << 5) | (zt & 0x1f));
+}
+
+/* zd = zn op zm */
+static void
+sve_emit_binary (OrcCompiler *p, const char *name, orc_uint32 code, int size,
+    int zd, int zn, int zm)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s, %s\n", name, orc_sve_reg_name (zd, size),
+      orc_sve_reg_name (zn, size), orc_sve_reg_name (zm, size));
+  orc_arm_emit (p, code | (sve_size_bits (size) << 22) | ((zm & 0x1f) << 16) |
+      ((zn & 0x1f) << 5) | (zd & 0x1f));
+}
+
+/* bitwise ops have the opcode where the size usually goes */
+static void
+sve_emit_logic (OrcCompiler *p, const char *name, orc_uint32 code,
+    int zd, int zn, int zm)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s, %s\n", name, orc_sve_reg_name (zd, 8),
+      orc_sve_reg_name (zn, 8), orc_sve_reg_name (zm, 8));
+  orc_arm_emit (p, code | ((zm & 0x1f) << 16) | ((zn & 0x1f) << 5) |
+      (zd & 0x1f));
+}
+
+void
+orc_sve_emit_mov (OrcCompiler *p, int dest, int src)
+{
+  if (dest == src) return;
+
+  ORC_ASM_CODE (p, "  mov %s, %s\n", orc_sve_reg_name (dest, 8),
+      orc_sve_reg_name (src, 8));
+  orc_arm_emit (p, 0x04603000 | ((src & 0x1f) << 16) | ((src & 0x1f) << 5) |
+      (dest & 0x1f));
+}
+
+static void
+sve_emit_movprfx (OrcCompiler *p, int zd, int zn)
+{
+  ORC_ASM_CODE (p, "  movprfx %s, %s\n", orc_sve_reg_name (zd, 0),
+      orc_sve_reg_name (zn, 0));
+  orc_arm_emit (p, 0x0420bc00 | ((zn & 0x1f) << 5) | (zd & 0x1f));
+}
+
+/* zdn = zdn op zm, for the elements active in pg */
+static void
+sve_emit_pred_binary (OrcCompiler *p, const char *name, orc_uint32 code,
+    int size, int zdn, int pg, int zm)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s/m, %s, %s\n", name,
+      orc_sve_reg_name (zdn, size), orc_sve_pred_name (pg, 0),
+      orc_sve_reg_name (zdn, size), orc_sve_reg_name (zm, size));
+  orc_arm_emit (p, code | (sve_size_bits (size) << 22) | (pg << 10) |
+      ((zm & 0x1f) << 5) | (zdn & 0x1f));
+}
+
+/* zd = op zn; sizes differ for the extends, where size is the element
+ * size and the opcode picks how much of it is read */
+static void
+sve_emit_pred_unary (OrcCompiler *p, const char *name, orc_uint32 code,
+    int size, int zd, int zn)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s/m, %s\n", name, orc_sve_reg_name (zd, size),
+      orc_sve_pred_name (ORC_SVE_PRED_ALL, 0), orc_sve_reg_name (zn, size));
+  orc_arm_emit (p, code | (sve_size_bits (size) << 22) |
+      (ORC_SVE_PRED_ALL << 10) | ((zn & 0x1f) << 5) | (zd & 0x1f));
+}
+
+/* zdn = zdn op #imm, imm being an 8-bit value */
+static void
+sve_emit_binary_imm (OrcCompiler *p, const char *name, orc_uint32 code,
+    int size, int zdn, int imm)
+{
+  ORC_ASM_CODE (p, "  %s %s, %s, #%d\n", name, orc_sve_reg_name (zdn, size),
+      orc_sve_reg_name (zdn, size), imm);
+  orc_arm_emit (p, code | (sve_size_bits (size) << 22) | ((imm & 0xff) << 5) |
+      (zdn & 0x1f));
+}
+
+/* lsl, asr and lsr by an immediate; the shift is folded together with
+ * the element size into tsz:imm3 */
+static void
+sve_emit_shift_imm (OrcCompiler *p, int type, int size, int zd, int zn,
+    int shift)
+{
+  static const char *names[] = { "lsl", "asr", "lsr" };
+  static const orc_uint32 codes[] = { 0x04209c00, 0x04209000, 0x04209400 };
+  const int bits = size * 8;
+  int value;
+
+  if (type == 0) {
+    value = bits + shift;
+  } else {
+    value = 2 * bits - shift;
+  }
+
+  ORC_ASM_CODE (p, "  %s %s, %s, #%d\n", names[type],
+      orc_sve_reg_name (zd, size), orc_sve_reg_name (zn, size), shift);
+  orc_arm_emit (p, codes[type] | (((value >> 5) & 0x3) << 22) |
+      (((value >> 3) & 0x3) << 19) | ((value & 0x7) << 16) |
+      ((zn & 0x1f) << 5) | (zd & 0x1f));
+}
+
+void
+orc_sve_emit_dup_imm (OrcCompiler *p, int size, int dest, int value)
+{
+  ORC_ASM_CODE (p, "  dup %s, #%d\n", orc_sve_reg_name (dest, size), value);
+  orc_arm_emit (p, 0x2538c000 | (sve_size_bits (size) << 22) |
+      ((value & 0xff) << 5) | (dest & 0x1f));
+}
+
+static void
+sve_emit_dup_reg (OrcCompiler *p, int size, int dest, int rn)
+{
+  ORC_ASM_CODE (p, "  dup %s, %s\n", orc_sve_reg_name (dest, size),
+      size == 8 ? sve_x (rn) : sve_w (rn));
+  orc_arm_emit (p, 0x05203800 | (sve_size_bits (size) << 22) |
+      ((rn & 0x1f) << 5) | (dest & 0x1f));
+}
+
+void
+orc_sve_emit_load_imm (OrcCompiler *p, int size, int dest, orc_uint64 value)
+{
+  const int bits = (size == 8) ? 64 : 32;
+  orc_uint64 mask = (size == 8) ? ~(orc_uint64)0 :
+      (((orc_uint64)1 << (size * 8)) - 1);
+  int i;
+
+  value &= mask;
+  if (((orc_uint64)(orc_int64)(orc_int8)value & mask) == value) {
+    orc_sve_emit_dup_imm (p, size, dest, (orc_int8)value);
+    return;
+  }
+
+  orc_arm64_emit_movz (p, bits, 0, p->gp_tmpreg, value & 0xffff);
+  for (i = 16; i < size * 8; i += 16) {
+    if ((value >> i) & 0xffff) {
+      orc_arm64_emit_movk (p, bits, i, p->gp_tmpreg, (value >> i) & 0xffff);
+    }
+  }
+  sve_emit_dup_reg (p, size, dest, p->gp_tmpreg);
+}
+
+void
+orc_sve_emit_load_param (OrcCompiler *p, int size, int dest, int param)
+{
+  orc_arm64_emit_load_reg (p, 32, p->gp_tmpreg, p->exec_reg,
+      (int)ORC_STRUCT_OFFSET(OrcExecutor, params[param]));
+  if (size == 8) {
+    orc_arm64_emit_load_reg (p, 32, ORC_ARM64_IP0, p->exec_reg,
+        (int)ORC_STRUCT_OFFSET(OrcExecutor,
+            params[param + (ORC_VAR_T1 - ORC_VAR_P1)]));
+    orc_arm64_emit_orr_lsl (p, 64, p->gp_tmpreg, p->gp_tmpreg, ORC_ARM64_IP0,
+        32);
+  }
+  sve_emit_dup_reg (p, size, dest, p->gp_tmpreg);
+}
+
+void
+orc_sve_emit_save_accumulator (OrcCompiler *p, OrcVariable *var, int offset)
+{
+  const int tmp = p->tmpreg & 0x1f;
+
+  ORC_ASM_CODE (p, "  uaddv d%d, %s, %s\n", tmp,
+      orc_sve_pred_name (ORC_SVE_PRED_ALL, 0),
+      orc_sve_reg_name (var->alloc, var->size));
+  orc_arm_emit (p, 0x04012000 | (sve_size_bits (var->size) << 22) |
+      (ORC_SVE_PRED_ALL << 10) | ((var->alloc & 0x1f) << 5) | tmp);
+
+  ORC_ASM_CODE (p, "  fmov %s, s%d\n", sve_w (p->gp_tmpreg), tmp);
+  orc_arm_emit (p, 0x1e260000 | (tmp << 5) | (p->gp_tmpreg & 0x1f));
+
+  if (var->size == 2) {
+    orc_arm64_emit_and_imm (p, 32, p->gp_tmpreg, p->gp_tmpreg, 0xffff);
+  }
+  orc_arm64_emit_store_reg (p, 32, p->gp_tmpreg, p->exec_reg, offset);
+}
+
+/* dest = src1 op src2 for a destructive instruction predicated on all
+ * elements, going through movprfx or the temporary register when dest
+ * is not the first source */
+static void
+sve_emit_pred_binary_op (OrcCompiler *p, const char *name, orc_uint32 code,
+    int size, int dest, int src1, int src2, int commutative)
+{
+  if (dest == src1) {
+    sve_emit_pred_binary (p, name, code, size, dest, ORC_SVE_PRED_ALL, src2);
+  } else if (dest == src2 && commutative) {
+    sve_emit_pred_binary (p, name, code, size, dest, ORC_SVE_PRED_ALL, src1);
+  } else if (dest == src2) {
+    sve_emit_movprfx (p, p->tmpreg, src1);
+    sve_emit_pred_binary (p, name, code, size, p->tmpreg, ORC_SVE_PRED_ALL,
+        src2);
+    orc_sve_emit_mov (p, dest, p->tmpreg);
+  } else {
+    sve_emit_movprfx (p, dest, src1);
+    sve_emit_pred_binary (p, name, code, size, dest, ORC_SVE_PRED_ALL, src2);
+  }
+}
+
+/* the lane-wise rules work at the element size of the opcode and so
+ * also cover x2 and x4 instructions; the others don't */
+static int
+sve_check_single (OrcCompiler *p, OrcInstruction *insn)
+{
+  if (insn->flags & (ORC_INSTRUCTION_FLAG_X2|ORC_INSTRUCTION_FLAG_X4)) {
+    ORC_COMPILER_ERROR (p, "x2 and x4 %s are not supported on sve",
+        insn->opcode->name);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static void
+sve_rule_loadpX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+  const int size = ORC_PTR_TO_INT (user);
+
+  if (src->vartype == ORC_VAR_TYPE_CONST) {
+    orc_sve_emit_load_imm (p, size, dest->alloc, src->value.i);
+  } else if (src->vartype == ORC_VAR_TYPE_PARAM) {
+    orc_sve_emit_load_param (p, size, dest->alloc, insn->src_args[0]);
+  } else {
+    ORC_COMPILER_ERROR (p, "unimplemented");
+  }
+}
+
+static void
+sve_rule_loadX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+
+  if (src->vartype != ORC_VAR_TYPE_SRC && src->vartype != ORC_VAR_TYPE_DEST) {
+    ORC_COMPILER_ERROR (p, "unimplemented");
+    return;
+  }
+  sve_emit_memory (p, FALSE, src->size, p->max_var_size, dest->alloc,
+      src->ptr_register);
+}
+
+static void
+sve_rule_storeX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  OrcVariable *src = p->vars + insn->src_args[0];
+  OrcVariable *dest = p->vars + insn->dest_args[0];
+
+  sve_emit_memory (p, TRUE, dest->size, p->max_var_size, src->alloc,
+      dest->ptr_register);
+}
+
+static void
+sve_rule_copyX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  orc_sve_emit_mov (p, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+#define BINARY(opcode,insn_name,code,size) \
+static void \
+sve_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  sve_emit_binary (p, insn_name, code, size, ORC_DEST_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1)); \
+}
+
+#define LOGIC(opcode,insn_name,code) \
+static void \
+sve_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  sve_emit_logic (p, insn_name, code, ORC_DEST_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1)); \
+}
+
+#define PRED_BINARY(opcode,insn_name,code,size,commutative) \
+static void \
+sve_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  sve_emit_pred_binary_op (p, insn_name, code, size, \
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 1), commutative); \
+}
+
+#define PRED_UNARY(opcode,insn_name,code,size) \
+static void \
+sve_rule_ ## opcode (OrcCompiler *p, void *user, OrcInstruction *insn) \
+{ \
+  sve_emit_pred_unary (p, insn_name, code, size, ORC_DEST_ARG (p, insn, 0), \
+      ORC_SRC_ARG (p, insn, 0)); \
+}
+
+BINARY(addb, "add", 0x04200000, 1)
+BINARY(addssb, "sqadd", 0x04201000, 1)
+BINARY(addusb, "uqadd", 0x04201400, 1)
+BINARY(subb, "sub", 0x04200400, 1)
+BINARY(subssb, "sqsub", 0x04201800, 1)
+BINARY(subusb, "uqsub", 0x04201c00, 1)
+PRED_BINARY(maxsb, "smax", 0x04080000, 1, TRUE)
+PRED_BINARY(maxub, "umax", 0x04090000, 1, TRUE)
+PRED_BINARY(minsb, "smin", 0x040a0000, 1, TRUE)
+PRED_BINARY(minub, "umin", 0x040b0000, 1, TRUE)
+PRED_BINARY(mullb, "mul", 0x04100000, 1, TRUE)
+PRED_BINARY(mulhsb, "smulh", 0x04120000, 1, TRUE)
+PRED_BINARY(mulhub, "umulh", 0x04130000, 1, TRUE)
+PRED_BINARY(absdiffub, "uabd", 0x040d0000, 1, TRUE)
+PRED_UNARY(absb, "abs", 0x0416a000, 1)
+
+BINARY(addw, "add", 0x04200000, 2)
+BINARY(addssw, "sqadd", 0x04201000, 2)
+BINARY(addusw, "uqadd", 0x04201400, 2)
+BINARY(subw, "sub", 0x04200400, 2)
+BINARY(subssw, "sqsub", 0x04201800, 2)
+BINARY(subusw, "uqsub", 0x04201c00, 2)
+PRED_BINARY(maxsw, "smax", 0x04080000, 2, TRUE)
+PRED_BINARY(maxuw, "umax", 0x04090000, 2, TRUE)
+PRED_BINARY(minsw, "smin", 0x040a0000, 2, TRUE)
+PRED_BINARY(minuw, "umin", 0x040b0000, 2, TRUE)
+PRED_BINARY(mullw, "mul", 0x04100000, 2, TRUE)
+PRED_BINARY(mulhsw, "smulh", 0x04120000, 2, TRUE)
+PRED_BINARY(mulhuw, "umulh", 0x04130000, 2, TRUE)
+PRED_BINARY(absdiffuw, "uabd", 0x040d0000, 2, TRUE)
+PRED_UNARY(absw, "abs", 0x0416a000, 2)
+
+BINARY(addl, "add", 0x04200000, 4)
+BINARY(addssl, "sqadd", 0x04201000, 4)
+BINARY(addusl, "uqadd", 0x04201400, 4)
+BINARY(subl, "sub", 0x04200400, 4)
+BINARY(subssl, "sqsub", 0x04201800, 4)
+BINARY(subusl, "uqsub", 0x04201c00, 4)
+PRED_BINARY(maxsl, "smax", 0x04080000, 4, TRUE)
+PRED_BINARY(maxul, "umax", 0x04090000, 4, TRUE)
+PRED_BINARY(minsl, "smin", 0x040a0000, 4, TRUE)
+PRED_BINARY(minul, "umin", 0x040b0000, 4, TRUE)
+PRED_BINARY(mulll, "mul", 0x04100000, 4, TRUE)
+PRED_BINARY(mulhsl, "smulh", 0x04120000, 4, TRUE)
+PRED_BINARY(mulhul, "umulh", 0x04130000, 4, TRUE)
+PRED_UNARY(absl, "abs", 0x0416a000, 4)
+
+BINARY(addq, "add", 0x04200000, 8)
+BINARY(subq, "sub", 0x04200400, 8)
+
+LOGIC(andX, "and", 0x04203000)
+LOGIC(orX, "orr", 0x04603000)
+LOGIC(xorX, "eor", 0x04a03000)
+
+PRED_UNARY(swapw, "revb", 0x05248000, 2)
+PRED_UNARY(swapl, "revb", 0x05248000, 4)
+PRED_UNARY(swapq, "revb", 0x05248000, 8)
+PRED_UNARY(swapwl, "revh", 0x05258000, 4)
+PRED_UNARY(swaplq, "revw", 0x05268000, 8)
+
+static void
+sve_rule_andnX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  /* andn is ~src1 & src2 */
+  sve_emit_logic (p, "bic", 0x04e03000, ORC_DEST_ARG (p, insn, 0),
+      ORC_SRC_ARG (p, insn, 1), ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+sve_rule_shift (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[] = { "lsl", "asr", "lsr" };
+  static const orc_uint32 codes[] = { 0x04138000, 0x04108000, 0x04118000 };
+  const int type = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  OrcVariable *src2 = p->vars + insn->src_args[1];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src = ORC_SRC_ARG (p, insn, 0);
+
+  if (src2->vartype == ORC_VAR_TYPE_CONST) {
+    const int shift = src2->value.i;
+
+    if (shift < 0 || shift > size * 8 || (type == 0 && shift == size * 8)) {
+      ORC_COMPILER_ERROR (p, "shift %d out of range", shift);
+      return;
+    }
+    if (shift == 0) {
+      orc_sve_emit_mov (p, dest, src);
+      return;
+    }
+    sve_emit_shift_imm (p, type, size, dest, src, shift);
+  } else if (src2->vartype == ORC_VAR_TYPE_PARAM) {
+    orc_sve_emit_load_param (p, size, p->tmpreg, insn->src_args[1]);
+    if (dest != src) sve_emit_movprfx (p, dest, src);
+    sve_emit_pred_binary (p, names[type], codes[type], size, dest,
+        ORC_SVE_PRED_ALL, p->tmpreg);
+  } else {
+    ORC_COMPILER_ERROR (p, "shift rule only works with constants and params");
+  }
+}
+
+static void
+sve_rule_signX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = insn->opcode->dest_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  if (dest != ORC_SRC_ARG (p, insn, 0)) {
+    sve_emit_movprfx (p, dest, ORC_SRC_ARG (p, insn, 0));
+  }
+  sve_emit_binary_imm (p, "smax", 0x2528c000, size, dest, -1);
+  sve_emit_binary_imm (p, "smin", 0x252ac000, size, dest, 1);
+}
+
+static void
+sve_rule_cmpX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int gt = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src1 = ORC_SRC_ARG (p, insn, 0);
+  const int src2 = ORC_SRC_ARG (p, insn, 1);
+
+  ORC_ASM_CODE (p, "  %s %s, %s/z, %s, %s\n", gt ? "cmpgt" : "cmpeq",
+      orc_sve_pred_name (ORC_SVE_PRED_TMP, size),
+      orc_sve_pred_name (ORC_SVE_PRED_ALL, 0),
+      orc_sve_reg_name (src1, size), orc_sve_reg_name (src2, size));
+  orc_arm_emit (p, (gt ? 0x24008010 : 0x2400a000) |
+      (sve_size_bits (size) << 22) | ((src2 & 0x1f) << 16) |
+      (ORC_SVE_PRED_ALL << 10) | ((src1 & 0x1f) << 5) | ORC_SVE_PRED_TMP);
+
+  ORC_ASM_CODE (p, "  mov %s, %s/z, #-1\n", orc_sve_reg_name (dest, size),
+      orc_sve_pred_name (ORC_SVE_PRED_TMP, 0));
+  orc_arm_emit (p, 0x05100000 | (sve_size_bits (size) << 22) |
+      (ORC_SVE_PRED_TMP << 16) | (0xff << 5) | (dest & 0x1f));
+}
+
+/* (a | b) - ((a ^ b) >> 1) rounds up without overflowing */
+static void
+sve_rule_avgX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int is_signed = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src1 = ORC_SRC_ARG (p, insn, 0);
+  const int src2 = ORC_SRC_ARG (p, insn, 1);
+
+  sve_emit_logic (p, "eor", 0x04a03000, p->tmpreg, src1, src2);
+  sve_emit_shift_imm (p, is_signed ? 1 : 2, size, p->tmpreg, p->tmpreg, 1);
+  sve_emit_logic (p, "orr", 0x04603000, dest, src1, src2);
+  sve_emit_binary (p, "sub", 0x04200400, size, dest, dest, p->tmpreg);
+}
+
+/* the low part of the wider element already holds the narrowed value */
+static void
+sve_rule_convtrunc (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  if (!sve_check_single (p, insn)) return;
+  orc_sve_emit_mov (p, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+sve_rule_convhigh (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int size = insn->opcode->src_size[0];
+
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_shift_imm (p, 2, size, ORC_DEST_ARG (p, insn, 0),
+      ORC_SRC_ARG (p, insn, 0), size * 4);
+}
+
+/* extends the low half of each element in place */
+static void
+sve_rule_convext (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[] = { "sxtb", "uxtb", "sxth", "uxth", "sxtw",
+    "uxtw" };
+  const int is_unsigned = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int bits = sve_size_bits (insn->opcode->src_size[0]);
+
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_pred_unary (p, names[bits * 2 + is_unsigned],
+      0x0410a000 | ((bits * 2 + is_unsigned) << 16), size,
+      ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0));
+}
+
+/* clamps the wide element to the range of the narrow one */
+static void
+sve_rule_convsatb (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int type = ORC_PTR_TO_INT (user);
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  if (!sve_check_single (p, insn)) return;
+  if (dest != ORC_SRC_ARG (p, insn, 0)) {
+    sve_emit_movprfx (p, dest, ORC_SRC_ARG (p, insn, 0));
+  }
+  switch (type) {
+    case 0: /* convssswb */
+      sve_emit_binary_imm (p, "smax", 0x2528c000, 2, dest, -128);
+      sve_emit_binary_imm (p, "smin", 0x252ac000, 2, dest, 127);
+      break;
+    case 1: /* convsuswb */
+      sve_emit_binary_imm (p, "smax", 0x2528c000, 2, dest, 0);
+      sve_emit_binary_imm (p, "umin", 0x252bc000, 2, dest, 255);
+      break;
+    case 2: /* convusswb */
+      sve_emit_binary_imm (p, "umin", 0x252bc000, 2, dest, 127);
+      break;
+    case 3: /* convuuswb */
+      sve_emit_binary_imm (p, "umin", 0x252bc000, 2, dest, 255);
+      break;
+  }
+}
+
+/* extends both sources to the wide element before multiplying */
+static void
+sve_rule_mulX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[] = { "sxtb", "uxtb", "sxth", "uxth", "sxtw",
+    "uxtw" };
+  const int is_unsigned = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int ext = sve_size_bits (insn->opcode->src_size[0]) * 2 + is_unsigned;
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_pred_unary (p, names[ext], 0x0410a000 | (ext << 16), size,
+      p->tmpreg, ORC_SRC_ARG (p, insn, 1));
+  sve_emit_pred_unary (p, names[ext], 0x0410a000 | (ext << 16), size,
+      dest, ORC_SRC_ARG (p, insn, 0));
+  sve_emit_pred_binary (p, "mul", 0x04100000, size, dest, ORC_SVE_PRED_ALL,
+      p->tmpreg);
+}
+
+/* dest = src1 | src2 << half, where src1 may have junk in the high half */
+static void
+sve_emit_merge (OrcCompiler *p, int size, int dest, int src1, int src2)
+{
+  static const char *names[] = { "uxtb", "uxth", "uxtw" };
+  const int bits = sve_size_bits (size) - 1;
+
+  sve_emit_shift_imm (p, 0, size, p->tmpreg, src2, size * 4);
+  sve_emit_pred_unary (p, names[bits], 0x0411a000 | (bits << 17), size,
+      dest, src1);
+  sve_emit_logic (p, "orr", 0x04603000, dest, dest, p->tmpreg);
+}
+
+static void
+sve_rule_mergeX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_merge (p, insn->opcode->dest_size[0], ORC_DEST_ARG (p, insn, 0),
+      ORC_SRC_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 1));
+}
+
+static void
+sve_rule_splatbw (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_merge (p, 2, ORC_DEST_ARG (p, insn, 0), ORC_SRC_ARG (p, insn, 0),
+      ORC_SRC_ARG (p, insn, 0));
+}
+
+/* accumulators only add the elements active in the loop predicate, so
+ * the final reduction can sum the whole register */
+static void
+sve_rule_accX (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_pred_binary (p, "add", 0x04000000, insn->opcode->dest_size[0],
+      ORC_DEST_ARG (p, insn, 0), ORC_SVE_PRED_LOOP, ORC_SRC_ARG (p, insn, 0));
+}
+
+static void
+sve_rule_accsadubl (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  if (!sve_check_single (p, insn)) return;
+  sve_emit_movprfx (p, p->tmpreg, ORC_SRC_ARG (p, insn, 0));
+  sve_emit_pred_binary (p, "uabd", 0x040d0000, 1, p->tmpreg,
+      ORC_SVE_PRED_ALL, ORC_SRC_ARG (p, insn, 1));
+  sve_emit_pred_unary (p, "uxtb", 0x0411a000, 4, p->tmpreg, p->tmpreg);
+  sve_emit_pred_binary (p, "add", 0x04000000, 4, ORC_DEST_ARG (p, insn, 0),
+      ORC_SVE_PRED_LOOP, p->tmpreg);
+}
+
+/* SVE2 */
+
+BINARY(mullb_sve2, "mul", 0x04206000, 1)
+BINARY(mulhsb_sve2, "smulh", 0x04206800, 1)
+BINARY(mulhub_sve2, "umulh", 0x04206c00, 1)
+BINARY(mullw_sve2, "mul", 0x04206000, 2)
+BINARY(mulhsw_sve2, "smulh", 0x04206800, 2)
+BINARY(mulhuw_sve2, "umulh", 0x04206c00, 2)
+BINARY(mulll_sve2, "mul", 0x04206000, 4)
+BINARY(mulhsl_sve2, "smulh", 0x04206800, 4)
+BINARY(mulhul_sve2, "umulh", 0x04206c00, 4)
+PRED_BINARY(avgsb_sve2, "srhadd", 0x44148000, 1, TRUE)
+PRED_BINARY(avgub_sve2, "urhadd", 0x44158000, 1, TRUE)
+PRED_BINARY(avgsw_sve2, "srhadd", 0x44148000, 2, TRUE)
+PRED_BINARY(avguw_sve2, "urhadd", 0x44158000, 2, TRUE)
+PRED_BINARY(avgsl_sve2, "srhadd", 0x44148000, 4, TRUE)
+PRED_BINARY(avgul_sve2, "urhadd", 0x44158000, 4, TRUE)
+
+/* sshllb and ushllb widen the even (low) half of each element */
+static void
+sve_rule_convext_sve2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int is_unsigned = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int src_size = insn->opcode->src_size[0];
+  const int value = src_size * 8;
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src = ORC_SRC_ARG (p, insn, 0);
+
+  if (!sve_check_single (p, insn)) return;
+  ORC_ASM_CODE (p, "  %s %s, %s, #0\n", is_unsigned ? "ushllb" : "sshllb",
+      orc_sve_reg_name (dest, size), orc_sve_reg_name (src, src_size));
+  orc_arm_emit (p, (is_unsigned ? 0x4500a800 : 0x4500a000) |
+      (((value >> 5) & 0x1) << 22) | (((value >> 3) & 0x3) << 19) |
+      ((value & 0x7) << 16) | ((src & 0x1f) << 5) | (dest & 0x1f));
+}
+
+/* the saturating narrows write the even (low) half of each element and
+ * clear the odd one */
+static void
+sve_rule_convsat_sve2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  static const char *names[] = { "sqxtnb", "sqxtunb", "uqxtnb" };
+  static const orc_uint32 codes[] = { 0x45204000, 0x45205000, 0x45204800 };
+  const int type = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src = ORC_SRC_ARG (p, insn, 0);
+  static const orc_uint32 tsz[] = { 1 << 19, 1 << 20, 0, 1 << 22 };
+
+  if (!sve_check_single (p, insn)) return;
+  ORC_ASM_CODE (p, "  %s %s, %s\n", names[type],
+      orc_sve_reg_name (dest, size), orc_sve_reg_name (src, size * 2));
+  orc_arm_emit (p, codes[type] | tsz[size - 1] | ((src & 0x1f) << 5) |
+      (dest & 0x1f));
+}
+
+static void
+sve_rule_mulX_sve2 (OrcCompiler *p, void *user, OrcInstruction *insn)
+{
+  const int is_unsigned = ORC_PTR_TO_INT (user);
+  const int size = insn->opcode->dest_size[0];
+  const int src_size = insn->opcode->src_size[0];
+  const int dest = ORC_DEST_ARG (p, insn, 0);
+  const int src1 = ORC_SRC_ARG (p, insn, 0);
+  const int src2 = ORC_SRC_ARG (p, insn, 1);
+
+  if (!sve_check_single (p, insn)) return;
+  ORC_ASM_CODE (p, "  %s %s, %s, %s\n", is_unsigned ? "umullb" : "smullb",
+      orc_sve_reg_name (dest, size), orc_sve_reg_name (src1, src_size),
+      orc_sve_reg_name (src2, src_size));
+  orc_arm_emit (p, (is_unsigned ? 0x45007800 : 0x45007000) |
+      (sve_size_bits (size) << 22) | ((src2 & 0x1f) << 16) |
+      ((src1 & 0x1f) << 5) | (dest & 0x1f));
+}
+
+void
+orc_compiler_sve_register_rules (OrcTarget *target)
+{
+  OrcRuleSet *rule_set;
+
+#define REG(x) \
+    orc_rule_register (rule_set, #x , sve_rule_ ## x, NULL)
+
+  rule_set = orc_rule_set_new (orc_opcode_set_get("sys"), target,
+      ORC_TARGET_SVE_SVE);
+
+  orc_rule_register (rule_set, "loadpb", sve_rule_loadpX, (void *)1);
+  orc_rule_register (rule_set, "loadpw", sve_rule_loadpX, (void *)2);
+  orc_rule_register (rule_set, "loadpl", sve_rule_loadpX, (void *)4);
+  orc_rule_register (rule_set, "loadpq", sve_rule_loadpX, (void *)8);
+  orc_rule_register (rule_set, "loadb", sve_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadw", sve_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadl", sve_rule_loadX, NULL);
+  orc_rule_register (rule_set, "loadq", sve_rule_loadX, NULL);
+  orc_rule_register (rule_set, "storeb", sve_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storew", sve_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storel", sve_rule_storeX, NULL);
+  orc_rule_register (rule_set, "storeq", sve_rule_storeX, NULL);
+  orc_rule_register (rule_set, "copyb", sve_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyw", sve_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyl", sve_rule_copyX, NULL);
+  orc_rule_register (rule_set, "copyq", sve_rule_copyX, NULL);
+
+  REG(absb);
+  REG(addb);
+  REG(addssb);
+  REG(addusb);
+  REG(subb);
+  REG(subssb);
+  REG(subusb);
+  REG(maxsb);
+  REG(maxub);
+  REG(minsb);
+  REG(minub);
+  REG(mullb);
+  REG(mulhsb);
+  REG(mulhub);
+  REG(absdiffub);
+
+  REG(absw);
+  REG(addw);
+  REG(addssw);
+  REG(addusw);
+  REG(subw);
+  REG(subssw);
+  REG(subusw);
+  REG(maxsw);
+  REG(maxuw);
+  REG(minsw);
+  REG(minuw);
+  REG(mullw);
+  REG(mulhsw);
+  REG(mulhuw);
+  REG(absdiffuw);
+
+  REG(absl);
+  REG(addl);
+  REG(addssl);
+  REG(addusl);
+  REG(subl);
+  REG(subssl);
+  REG(subusl);
+  REG(maxsl);
+  REG(maxul);
+  REG(minsl);
+  REG(minul);
+  REG(mulll);
+  REG(mulhsl);
+  REG(mulhul);
+
+  REG(addq);
+  REG(subq);
+
+  orc_rule_register (rule_set, "andb", sve_rule_andX, NULL);
+  orc_rule_register (rule_set, "andw", sve_rule_andX, NULL);
+  orc_rule_register (rule_set, "andl", sve_rule_andX, NULL);
+  orc_rule_register (rule_set, "andq", sve_rule_andX, NULL);
+  orc_rule_register (rule_set, "andnb", sve_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnw", sve_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnl", sve_rule_andnX, NULL);
+  orc_rule_register (rule_set, "andnq", sve_rule_andnX, NULL);
+  orc_rule_register (rule_set, "orb", sve_rule_orX, NULL);
+  orc_rule_register (rule_set, "orw", sve_rule_orX, NULL);
+  orc_rule_register (rule_set, "orl", sve_rule_orX, NULL);
+  orc_rule_register (rule_set, "orq", sve_rule_orX, NULL);
+  orc_rule_register (rule_set, "xorb", sve_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorw", sve_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorl", sve_rule_xorX, NULL);
+  orc_rule_register (rule_set, "xorq", sve_rule_xorX, NULL);
+
+  orc_rule_register (rule_set, "shlb", sve_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsb", sve_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shrub", sve_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shlw", sve_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsw", sve_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shruw", sve_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shll", sve_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsl", sve_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shrul", sve_rule_shift, (void *)2);
+  orc_rule_register (rule_set, "shlq", sve_rule_shift, (void *)0);
+  orc_rule_register (rule_set, "shrsq", sve_rule_shift, (void *)1);
+  orc_rule_register (rule_set, "shruq", sve_rule_shift, (void *)2);
+
+  orc_rule_register (rule_set, "signb", sve_rule_signX, NULL);
+  orc_rule_register (rule_set, "signw", sve_rule_signX, NULL);
+  orc_rule_register (rule_set, "signl", sve_rule_signX, NULL);
+
+  orc_rule_register (rule_set, "cmpeqb", sve_rule_cmpX, (void *)0);
+  orc_rule_register (rule_set, "cmpeqw", sve_rule_cmpX, (void *)0);
+  orc_rule_register (rule_set, "cmpeql", sve_rule_cmpX, (void *)0);
+  orc_rule_register (rule_set, "cmpeqq", sve_rule_cmpX, (void *)0);
+  orc_rule_register (rule_set, "cmpgtsb", sve_rule_cmpX, (void *)1);
+  orc_rule_register (rule_set, "cmpgtsw", sve_rule_cmpX, (void *)1);
+  orc_rule_register (rule_set, "cmpgtsl", sve_rule_cmpX, (void *)1);
+  orc_rule_register (rule_set, "cmpgtsq", sve_rule_cmpX, (void *)1);
+
+  orc_rule_register (rule_set, "avgsb", sve_rule_avgX, (void *)1);
+  orc_rule_register (rule_set, "avgub", sve_rule_avgX, (void *)0);
+  orc_rule_register (rule_set, "avgsw", sve_rule_avgX, (void *)1);
+  orc_rule_register (rule_set, "avguw", sve_rule_avgX, (void *)0);
+  orc_rule_register (rule_set, "avgsl", sve_rule_avgX, (void *)1);
+  orc_rule_register (rule_set, "avgul", sve_rule_avgX, (void *)0);
+
+  orc_rule_register (rule_set, "convsbw", sve_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convubw", sve_rule_convext, (void *)1);
+  orc_rule_register (rule_set, "convswl", sve_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convuwl", sve_rule_convext, (void *)1);
+  orc_rule_register (rule_set, "convslq", sve_rule_convext, (void *)0);
+  orc_rule_register (rule_set, "convulq", sve_rule_convext, (void *)1);
+
+  orc_rule_register (rule_set, "convwb", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convlw", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convql", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0wb", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0lw", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "select0ql", sve_rule_convtrunc, NULL);
+  orc_rule_register (rule_set, "convhwb", sve_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "convhlw", sve_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1wb", sve_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1lw", sve_rule_convhigh, NULL);
+  orc_rule_register (rule_set, "select1ql", sve_rule_convhigh, NULL);
+
+  orc_rule_register (rule_set, "convssswb", sve_rule_convsatb, (void *)0);
+  orc_rule_register (rule_set, "convsuswb", sve_rule_convsatb, (void *)1);
+  orc_rule_register (rule_set, "convusswb", sve_rule_convsatb, (void *)2);
+  orc_rule_register (rule_set, "convuuswb", sve_rule_convsatb, (void *)3);
+
+  orc_rule_register (rule_set, "mulsbw", sve_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "mulubw", sve_rule_mulX, (void *)1);
+  orc_rule_register (rule_set, "mulswl", sve_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "muluwl", sve_rule_mulX, (void *)1);
+  orc_rule_register (rule_set, "mulslq", sve_rule_mulX, (void *)0);
+  orc_rule_register (rule_set, "mululq", sve_rule_mulX, (void *)1);
+
+  orc_rule_register (rule_set, "mergebw", sve_rule_mergeX, NULL);
+  orc_rule_register (rule_set, "mergewl", sve_rule_mergeX, NULL);
+  orc_rule_register (rule_set, "mergelq", sve_rule_mergeX, NULL);
+  REG(splatbw);
+
+  REG(swapw);
+  REG(swapl);
+  REG(swapq);
+  REG(swapwl);
+  REG(swaplq);
+
+  orc_rule_register (rule_set, "accw", sve_rule_accX, NULL);
+  orc_rule_register (rule_set, "accl", sve_rule_accX, NULL);
+  REG(accsadubl);
+
+  rule_set = orc_rule_set_new (orc_opcode_set_get("sys"), target,
+      ORC_TARGET_SVE_SVE2);
+
+  orc_rule_register (rule_set, "mullb", sve_rule_mullb_sve2, NULL);
+  orc_rule_register (rule_set, "mulhsb", sve_rule_mulhsb_sve2, NULL);
+  orc_rule_register (rule_set, "mulhub", sve_rule_mulhub_sve2, NULL);
+  orc_rule_register (rule_set, "mullw", sve_rule_mullw_sve2, NULL);
+  orc_rule_register (rule_set, "mulhsw", sve_rule_mulhsw_sve2, NULL);
+  orc_rule_register (rule_set, "mulhuw", sve_rule_mulhuw_sve2, NULL);
+  orc_rule_register (rule_set, "mulll", sve_rule_mulll_sve2, NULL);
+  orc_rule_register (rule_set, "mulhsl", sve_rule_mulhsl_sve2, NULL);
+  orc_rule_register (rule_set, "mulhul", sve_rule_mulhul_sve2, NULL);
+  orc_rule_register (rule_set, "avgsb", sve_rule_avgsb_sve2, NULL);
+  orc_rule_register (rule_set, "avgub", sve_rule_avgub_sve2, NULL);
+  orc_rule_register (rule_set, "avgsw", sve_rule_avgsw_sve2, NULL);
+  orc_rule_register (rule_set, "avguw", sve_rule_avguw_sve2, NULL);
+  orc_rule_register (rule_set, "avgsl", sve_rule_avgsl_sve2, NULL);
+  orc_rule_register (rule_set, "avgul", sve_rule_avgul_sve2, NULL);
+
+  orc_rule_register (rule_set, "convsbw", sve_rule_convext_sve2, (void *)0);
+  orc_rule_register (rule_set, "convubw", sve_rule_convext_sve2, (void *)1);
+  orc_rule_register (rule_set, "convswl", sve_rule_convext_sve2, (void *)0);
+  orc_rule_register (rule_set, "convuwl", sve_rule_convext_sve2, (void *)1);
+  orc_rule_register (rule_set, "convslq", sve_rule_convext_sve2, (void *)0);
+  orc_rule_register (rule_set, "convulq", sve_rule_convext_sve2, (void *)1);
+
+  orc_rule_register (rule_set, "convssswb", sve_rule_convsat_sve2, (void *)0);
+  orc_rule_register (rule_set, "convsuswb", sve_rule_convsat_sve2, (void *)1);
+  orc_rule_register (rule_set, "convuuswb", sve_rule_convsat_sve2, (void *)2);
+  orc_rule_register (rule_set, "convssslw", sve_rule_convsat_sve2, (void *)0);
+  orc_rule_register (rule_set, "convsuslw", sve_rule_convsat_sve2, (void *)1);
+  orc_rule_register (rule_set, "convuuslw", sve_rule_convsat_sve2, (void *)2);
+  orc_rule_register (rule_set, "convsssql", sve_rule_convsat_sve2, (void *)0);
+  orc_rule_register (rule_set, "convsusql", sve_rule_convsat_sve2, (void *)1);
+  orc_rule_register (rule_set, "convuusql", sve_rule_convsat_sve2, (void *)2);
+
+  orc_rule_register (rule_set, "mulsbw", sve_rule_mulX_sve2, (void *)0);
+  orc_rule_register (rule_set, "mulubw", sve_rule_mulX_sve2, (void *)1);
+  orc_rule_register (rule_set, "mulswl", sve_rule_mulX_sve2, (void *)0);
+  orc_rule_register (rule_set, "muluwl", sve_rule_mulX_sve2, (void *)1);
+  orc_rule_register (rule_set, "mulslq", sve_rule_mulX_sve2, (void *)0);
+  orc_rule_register (rule_set, "mululq", sve_rule_mulX_sve2, (void *)1);
+}
@@ -156,6 +156,10 @@ ORC_API void orc_sse_load_constant (OrcCompiler *compiler, int reg, int size,
 #define orc_sse_emit_sqrtps(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_sqrtps, 16, a, b)
 #define orc_sse_emit_andps(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_andps, 16, a, b)
 #define orc_sse_emit_orps(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_orps, 16, a, b)
+#define orc_sse_emit_addsubps(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_addsubps, 16, a, b)
+#define orc_sse_emit_haddps(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_haddps, 16, a, b)
+#define orc_sse_emit_movsldup(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_movsldup, 16, a, b)
+#define orc_sse_emit_movshdup(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_movshdup, 16, a, b)
 
 /* Double Precision Floating-Point Instructions */
 #define orc_sse_emit_addpd(p,a,b) orc_x86_emit_cpuinsn_size(p, ORC_X86_addpd, 16, a, b)
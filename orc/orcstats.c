@@ -0,0 +1,256 @@
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(HAVE_CLOCK_GETTIME) && defined(HAVE_MONOTONIC_CLOCK)
+#include <time.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#elif defined(HAVE_GETTIMEOFDAY)
+#include <sys/time.h>
+#endif
+
+#include <orc/orcinternal.h>
+#include <orc/orcstats.h>
+
+/**
+ * SECTION:orcstats
+ * @title: Statistics
+ * @short_description: Time spent compiling programs
+ *
+ * Orc keeps track of the time spent in each phase of turning Orc source
+ * into machine code, and counts what the phases produce.  The totals can
+ * be read with orc_stats_get_phase_time(), orc_stats_get_phase_count()
+ * and orc_stats_get_counter(), or printed with orc_stats_dump(), which
+ * happens when the program exits if the ORC_CODE environment variable
+ * contains the flag "stats".  Unlike the log of ORC_DEBUG, this works in
+ * any build and costs little, so that it can be used to find out where
+ * the startup time of an application goes.
+ *
+ * The totals cover all threads since the library was initialised or
+ * orc_stats_reset() was last called.
+ */
+
+static OrcStats orc_stats;
+
+static const char *orc_stats_phase_names[] = {
+  "parse",
+  "bytecode parse",
+  "rewrite",
+  "register allocation",
+  "emit",
+  "relaxation",
+  "codemem",
+};
+
+/* Monotonic time in nanoseconds */
+orc_uint64
+orc_stats_get_time (void)
+{
+#if defined(HAVE_CLOCK_GETTIME) && defined(HAVE_MONOTONIC_CLOCK)
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (orc_uint64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#elif defined(_WIN32)
+  static LARGE_INTEGER freq;
+  LARGE_INTEGER counter;
+
+  if (freq.QuadPart == 0) QueryPerformanceFrequency (&freq);
+  QueryPerformanceCounter (&counter);
+  return (orc_uint64)(counter.QuadPart / freq.QuadPart) * 1000000000 +
+      (orc_uint64)(counter.QuadPart % freq.QuadPart) * 1000000000 /
+      freq.QuadPart;
+#elif defined(HAVE_GETTIMEOFDAY)
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return (orc_uint64)tv.tv_sec * 1000000000 + (orc_uint64)tv.tv_usec * 1000;
+#else
+  return 0;
+#endif
+}
+
+/* Adds the time since start to phase */
+void
+orc_stats_add_time (OrcStats *stats, OrcStatsPhase phase, orc_uint64 start)
+{
+  stats->time[phase] += orc_stats_get_time () - start;
+  stats->count[phase]++;
+}
+
+/* Adds the numbers collected by one compilation or call to the totals.
+ * Must not be called with orc_global_mutex_lock() */
+void
+orc_stats_merge (const OrcStats *stats)
+{
+  int i;
+
+  orc_global_mutex_lock ();
+  for (i = 0; i < ORC_STATS_N_PHASES; i++) {
+    orc_stats.time[i] += stats->time[i];
+    orc_stats.count[i] += stats->count[i];
+  }
+  orc_stats.n_programs += stats->n_programs;
+  orc_stats.n_insns += stats->n_insns;
+  orc_stats.n_machine_insns += stats->n_machine_insns;
+  orc_stats.n_code_bytes += stats->n_code_bytes;
+  orc_stats.n_relaxation_iterations += stats->n_relaxation_iterations;
+  orc_stats.n_regions += stats->n_regions;
+  orc_global_mutex_unlock ();
+}
+
+/* Adds the time since start to phase in the totals */
+void
+orc_stats_add_phase (OrcStatsPhase phase, orc_uint64 start)
+{
+  OrcStats stats;
+
+  memset (&stats, 0, sizeof(OrcStats));
+  orc_stats_add_time (&stats, phase, start);
+  orc_stats_merge (&stats);
+}
+
+/* Copies the current totals to stats */
+static void
+orc_stats_get (OrcStats *stats)
+{
+  orc_global_mutex_lock ();
+  *stats = orc_stats;
+  orc_global_mutex_unlock ();
+}
+
+/**
+ * orc_stats_get_phase_time:
+ * @phase: an OrcStatsPhase
+ *
+ * Returns: the nanoseconds spent in @phase
+ */
+orc_uint64
+orc_stats_get_phase_time (OrcStatsPhase phase)
+{
+  orc_uint64 time;
+
+  if ((unsigned int)phase >= ORC_STATS_N_PHASES) return 0;
+
+  orc_global_mutex_lock ();
+  time = orc_stats.time[phase];
+  orc_global_mutex_unlock ();
+
+  return time;
+}
+
+/**
+ * orc_stats_get_phase_count:
+ * @phase: an OrcStatsPhase
+ *
+ * Returns: the number of times @phase ran
+ */
+int
+orc_stats_get_phase_count (OrcStatsPhase phase)
+{
+  int count;
+
+  if ((unsigned int)phase >= ORC_STATS_N_PHASES) return 0;
+
+  orc_global_mutex_lock ();
+  count = orc_stats.count[phase];
+  orc_global_mutex_unlock ();
+
+  return count;
+}
+
+/**
+ * orc_stats_get_counter:
+ * @counter: an OrcStatsCounter
+ *
+ * Returns: the total of @counter, or 0 for unknown counters
+ */
+orc_uint64
+orc_stats_get_counter (OrcStatsCounter counter)
+{
+  OrcStats stats;
+
+  orc_stats_get (&stats);
+
+  switch (counter) {
+    case ORC_STATS_COUNTER_PROGRAMS:
+      return stats.n_programs;
+    case ORC_STATS_COUNTER_INSNS:
+      return stats.n_insns;
+    case ORC_STATS_COUNTER_MACHINE_INSNS:
+      return stats.n_machine_insns;
+    case ORC_STATS_COUNTER_CODE_BYTES:
+      return stats.n_code_bytes;
+    case ORC_STATS_COUNTER_RELAXATION_ITERATIONS:
+      return stats.n_relaxation_iterations;
+    case ORC_STATS_COUNTER_REGIONS:
+      return stats.n_regions;
+    default:
+      return 0;
+  }
+}
+
+/**
+ * orc_stats_reset:
+ *
+ * Sets all totals to zero.
+ */
+void
+orc_stats_reset (void)
+{
+  orc_global_mutex_lock ();
+  memset (&orc_stats, 0, sizeof(OrcStats));
+  orc_global_mutex_unlock ();
+}
+
+/**
+ * orc_stats_get_phase_name:
+ * @phase: an OrcStatsPhase
+ *
+ * Returns: a short name for @phase, as used by orc_stats_dump()
+ */
+const char *
+orc_stats_get_phase_name (OrcStatsPhase phase)
+{
+  if ((unsigned int)phase >= ORC_STATS_N_PHASES) return NULL;
+  return orc_stats_phase_names[phase];
+}
+
+/**
+ * orc_stats_dump:
+ *
+ * Prints a summary of the totals to stderr.
+ */
+void
+orc_stats_dump (void)
+{
+  OrcStats stats;
+  orc_uint64 total = 0;
+  int i;
+
+  orc_stats_get (&stats);
+
+  fprintf (stderr, "Orc compiler statistics\n");
+  fprintf (stderr, "  %-20s %8s %12s %12s\n", "phase", "calls", "total ms",
+      "average us");
+  for (i = 0; i < ORC_STATS_N_PHASES; i++) {
+    fprintf (stderr, "  %-20s %8d %12.3f %12.3f\n", orc_stats_phase_names[i],
+        stats.count[i], stats.time[i] / 1e6,
+        stats.count[i] ? stats.time[i] / 1e3 / stats.count[i] : 0.0);
+    total += stats.time[i];
+  }
+  fprintf (stderr, "  %-20s %8s %12.3f\n", "total", "", total / 1e6);
+  fprintf (stderr, "  programs compiled        %d\n", stats.n_programs);
+  fprintf (stderr, "  Orc instructions         %d\n", stats.n_insns);
+  fprintf (stderr, "  x86 instructions         %d\n", stats.n_machine_insns);
+  fprintf (stderr, "  code bytes               %llu\n",
+      (unsigned long long)stats.n_code_bytes);
+  fprintf (stderr, "  relaxation iterations    %d\n",
+      stats.n_relaxation_iterations);
+  fprintf (stderr, "  code regions             %d\n", stats.n_regions);
+}
+
@@ -0,0 +1,71 @@
+
+#ifndef _ORC_STATS_H_
+#define _ORC_STATS_H_
+
+#include <orc/orcutils.h>
+
+ORC_BEGIN_DECLS
+
+/**
+ * OrcStatsPhase:
+ * @ORC_STATS_PHASE_PARSE: parsing Orc source with orc_parse_code()
+ * @ORC_STATS_PHASE_BYTECODE_PARSE: orc_bytecode_parse_function()
+ * @ORC_STATS_PHASE_REWRITE: checking and rewriting the instructions and
+ *   variables of a program
+ * @ORC_STATS_PHASE_REGISTER_ALLOCATION: register allocation and the
+ *   choice of rules
+ * @ORC_STATS_PHASE_EMIT: generating machine code with the rules of the
+ *   target, without the relaxation
+ * @ORC_STATS_PHASE_RELAXATION: choosing the sizes of x86 branches in
+ *   orc_x86_calculate_offsets()
+ * @ORC_STATS_PHASE_CODEMEM: orc_code_allocate_codemem(), including the
+ *   mapping of new regions of executable memory
+ */
+typedef enum {
+  ORC_STATS_PHASE_PARSE,
+  ORC_STATS_PHASE_BYTECODE_PARSE,
+  ORC_STATS_PHASE_REWRITE,
+  ORC_STATS_PHASE_REGISTER_ALLOCATION,
+  ORC_STATS_PHASE_EMIT,
+  ORC_STATS_PHASE_RELAXATION,
+  ORC_STATS_PHASE_CODEMEM,
+  ORC_STATS_N_PHASES
+} OrcStatsPhase;
+
+/**
+ * OrcStatsCounter:
+ * @ORC_STATS_COUNTER_PROGRAMS: programs compiled, including the ones that
+ *   failed
+ * @ORC_STATS_COUNTER_INSNS: Orc instructions compiled, after rewriting
+ * @ORC_STATS_COUNTER_MACHINE_INSNS: machine instructions emitted, counted
+ *   by the x86 targets only
+ * @ORC_STATS_COUNTER_CODE_BYTES: bytes of machine code generated
+ * @ORC_STATS_COUNTER_RELAXATION_ITERATIONS: passes over the branches
+ *   during relaxation
+ * @ORC_STATS_COUNTER_REGIONS: regions of executable memory created
+ *
+ * Numbers counted while compiling, read with orc_stats_get_counter().
+ * More phases and counters may be added, so ORC_STATS_N_PHASES and
+ * ORC_STATS_N_COUNTERS are only meant for iterating over them.
+ */
+typedef enum {
+  ORC_STATS_COUNTER_PROGRAMS,
+  ORC_STATS_COUNTER_INSNS,
+  ORC_STATS_COUNTER_MACHINE_INSNS,
+  ORC_STATS_COUNTER_CODE_BYTES,
+  ORC_STATS_COUNTER_RELAXATION_ITERATIONS,
+  ORC_STATS_COUNTER_REGIONS,
+  ORC_STATS_N_COUNTERS
+} OrcStatsCounter;
+
+ORC_API orc_uint64 orc_stats_get_phase_time (OrcStatsPhase phase);
+ORC_API int orc_stats_get_phase_count (OrcStatsPhase phase);
+ORC_API orc_uint64 orc_stats_get_counter (OrcStatsCounter counter);
+ORC_API void orc_stats_reset (void);
+ORC_API const char * orc_stats_get_phase_name (OrcStatsPhase phase);
+ORC_API void orc_stats_dump (void);
+
+ORC_END_DECLS
+
+#endif
+
@@ -0,0 +1,47 @@
+#ifndef _ORC_SVE_H_
+#define _ORC_SVE_H_
+
+#include <orc/orc.h>
+#include <orc/orcarm.h>
+
+ORC_BEGIN_DECLS
+
+#ifdef ORC_ENABLE_UNSTABLE_API
+
+/* Predicate registers used by the generated code.  They are not handed
+ * out by the register allocator: the loop predicate comes from whilelt
+ * and covers the elements of the current iteration, the all-true
+ * predicate governs everything that may not touch memory. */
+#define ORC_SVE_PRED_LOOP 0
+#define ORC_SVE_PRED_ALL 1
+#define ORC_SVE_PRED_TMP 2
+
+/* general purpose registers with a fixed role in the loop */
+#define ORC_SVE_INDEX_REG ORC_ARM64_R2
+#define ORC_SVE_COUNT_REG ORC_ARM64_R3
+
+ORC_API unsigned long orc_sve_get_cpu_flags (void);
+
+ORC_API const char *orc_sve_reg_name (int reg, int size);
+ORC_API const char *orc_sve_pred_name (int pred, int size);
+
+ORC_API void orc_sve_emit_ptrue (OrcCompiler *p, int size, int pd);
+ORC_API void orc_sve_emit_whilelt (OrcCompiler *p, int size, int pd,
+    int rn, int rm);
+ORC_API void orc_sve_emit_inc (OrcCompiler *p, int size, int rd);
+ORC_API void orc_sve_emit_mov (OrcCompiler *p, int dest, int src);
+ORC_API void orc_sve_emit_dup_imm (OrcCompiler *p, int size, int dest,
+    int value);
+ORC_API void orc_sve_emit_load_imm (OrcCompiler *p, int size, int dest,
+    orc_uint64 value);
+ORC_API void orc_sve_emit_load_param (OrcCompiler *p, int size, int dest,
+    int param);
+ORC_API void orc_sve_emit_save_accumulator (OrcCompiler *p, OrcVariable *var,
+    int offset);
+
+#endif
+
+ORC_END_DECLS
+
+#endif
+
@@ -6,6 +6,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <orc/orctarget.h>
+#include <orc/orcdebug.h>
 #include <orc/orcinternal.h>
 
 static OrcTarget *targets[ORC_N_TARGETS];
@@ -16,6 +17,7 @@ static OrcTarget *default_target;
 void
 orc_target_register (OrcTarget *target)
 {
+  ORC_ASSERT (n_targets < ORC_N_TARGETS);
   targets[n_targets] = target;
   n_targets++;
 
@@ -13,6 +13,10 @@ enum {
   ORC_TARGET_C_BARE = (1<<1),
   ORC_TARGET_C_NOEXEC = (1<<2),
   ORC_TARGET_C_OPCODE = (1<<3),
+  ORC_TARGET_NO_NARROW = (1<<25),
+  ORC_TARGET_BASELINE = (1<<26),
+  ORC_TARGET_PRIVATE_CODE = (1<<27),
+  ORC_TARGET_FAST_MATH = (1<<28),
   ORC_TARGET_CLEAN_COMPILE = (1<<29),
   ORC_TARGET_FAST_NAN = (1<<30),
   ORC_TARGET_FAST_DENORMAL = (1<<31)
@@ -38,6 +42,16 @@ enum {
   ORC_TARGET_ARM_ARM6 = (1<<3)
 };
 
+typedef enum {
+  ORC_TARGET_SVE_SVE = (1<<0),
+  ORC_TARGET_SVE_SVE2 = (1<<1)
+} OrcTargetSVEFlags;
+
+typedef enum {
+  ORC_TARGET_LOONGARCH_LSX = (1<<0),
+  ORC_TARGET_LOONGARCH_LASX = (1<<1)
+} OrcTargetLoongArchFlags;
+
 typedef enum {
   ORC_TARGET_MMX_MMX = (1<<0),
   ORC_TARGET_MMX_MMXEXT = (1<<1),
@@ -64,6 +78,7 @@ typedef enum {
   ORC_TARGET_SSE_64BIT = (1<<9),
   ORC_TARGET_AVX_AVX = (1<<10),
   ORC_TARGET_AVX_AVX2 = (1<<11),
+  ORC_TARGET_AVX_FMA = (1<<12),
 } OrcTargetSSEFlags;
 
 
@@ -279,6 +279,27 @@ orc_x86_emit_mov_memoffset_reg (OrcCompiler *compiler, int size, int offset,
   }
 }
 
+/* Folds n_bytes of memory at offset(reg1) into the CRC-32C in reg2, using
+ * the widest crc32 forms available */
+void
+orc_x86_emit_crc32c_memoffset (OrcCompiler *compiler, int n_bytes, int offset,
+    int reg1, int reg2)
+{
+  int i = 0;
+
+  if (compiler->is_64bit) {
+    for (; i + 8 <= n_bytes; i += 8) {
+      orc_x86_emit_crc32q_memoffset_reg (compiler, offset + i, reg1, reg2);
+    }
+  }
+  for (; i + 4 <= n_bytes; i += 4) {
+    orc_x86_emit_crc32l_memoffset_reg (compiler, offset + i, reg1, reg2);
+  }
+  for (; i < n_bytes; i++) {
+    orc_x86_emit_crc32b_memoffset_reg (compiler, offset + i, reg1, reg2);
+  }
+}
+
 void
 orc_x86_emit_mov_reg_memoffset (OrcCompiler *compiler, int size, int reg1, int offset,
     int reg2)
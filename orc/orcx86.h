@@ -137,6 +137,12 @@ ORC_API void orc_x86_emit_pop (OrcCompiler *compiler, int size, int reg);
   orc_x86_emit_cpuinsn_memoffset_reg(p, ORC_X86_sub_rm_r, size, offset, src, dest)
 #define orc_x86_emit_imul_memoffset_reg(p,size,offset,src,dest) \
   orc_x86_emit_cpuinsn_memoffset_reg(p, ORC_X86_imul_rm_r, size, offset, src, dest)
+#define orc_x86_emit_crc32b_memoffset_reg(p,offset,src,dest) \
+  orc_x86_emit_cpuinsn_memoffset_reg(p, ORC_X86_crc32b_rm_r, 4, offset, src, dest)
+#define orc_x86_emit_crc32l_memoffset_reg(p,offset,src,dest) \
+  orc_x86_emit_cpuinsn_memoffset_reg(p, ORC_X86_crc32l_rm_r, 4, offset, src, dest)
+#define orc_x86_emit_crc32q_memoffset_reg(p,offset,src,dest) \
+  orc_x86_emit_cpuinsn_memoffset_reg(p, ORC_X86_crc32q_rm_r, 8, offset, src, dest)
 
 #define orc_x86_emit_cmp_reg_memoffset(p,size,src,offset,dest) \
   orc_x86_emit_cpuinsn_reg_memoffset_s(p, ORC_X86_cmp_r_rm, size, src, offset, dest)
@@ -167,9 +173,12 @@ ORC_API void orc_x86_emit_pop (OrcCompiler *compiler, int size, int reg);
 #define orc_x86_emit_test_imm_memoffset(p,size,value,offset,dest) \
   orc_x86_emit_cpuinsn_imm_memoffset (p, ORC_X86_test_imm, size, value, \
       offset, dest)
+#define orc_x86_emit_test_imm_reg(p,size,value,reg) \
+  orc_x86_emit_cpuinsn_imm_reg (p, ORC_X86_test_imm, size, value, reg)
 
 ORC_API void orc_x86_emit_mov_memoffset_reg (OrcCompiler *compiler, int size, int offset, int reg1, int reg2);
 ORC_API void orc_x86_emit_mov_reg_memoffset (OrcCompiler *compiler, int size, int reg1, int offset, int reg2);
+void orc_x86_emit_crc32c_memoffset (OrcCompiler *compiler, int n_bytes, int offset, int reg1, int reg2);
 ORC_API void orc_x86_emit_dec_memoffset (OrcCompiler *compiler, int size, int offset, int reg);
 ORC_API void orc_x86_emit_add_imm_reg (OrcCompiler *compiler, int size, int value, int reg, orc_bool record);
 ORC_API void orc_x86_emit_add_reg_reg_shift (OrcCompiler *compiler, int size, int reg1, int reg2, int shift);
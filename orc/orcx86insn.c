@@ -304,6 +304,17 @@ static const OrcX86Opcode orc_x86_opcodes[] = {
   { "andps", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_SIMD_PREFIX_ESCAPE_ONLY, 0x54 },
   { "orps", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_SIMD_PREFIX_ESCAPE_ONLY, 0x56 },
   { "blendvpd", ORC_X86_INSN_TYPE_MMXM_MMX, ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_66, 0x15 },
+  { "fmadd213ps", ORC_X86_INSN_TYPE_MMXM_MMX, ORC_VEX_W0 | ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_66, 0xa8 },
+  { "fmadd213pd", ORC_X86_INSN_TYPE_MMXM_MMX, ORC_VEX_W1 | ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_66, 0xa8 },
+  { "fmadd231ps", ORC_X86_INSN_TYPE_MMXM_MMX, ORC_VEX_W0 | ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_66, 0xb8 },
+  { "fmadd231pd", ORC_X86_INSN_TYPE_MMXM_MMX, ORC_VEX_W1 | ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_66, 0xb8 },
+  { "addsubps", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_VEX_SIMD_PREFIX_F2, 0xd0 },
+  { "haddps", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_VEX_SIMD_PREFIX_F2, 0x7c },
+  { "movsldup", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_VEX_SIMD_PREFIX_F3, 0x12 },
+  { "movshdup", ORC_X86_INSN_TYPE_MMXM_MMX, 0, ORC_VEX_SIMD_PREFIX_F3, 0x16 },
+  { "crc32b", ORC_X86_INSN_TYPE_REGM_REG, ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_F2, 0xf0 },
+  { "crc32l", ORC_X86_INSN_TYPE_REGM_REG, ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_F2, 0xf1 },
+  { "crc32q", ORC_X86_INSN_TYPE_REGM_REG, ORC_VEX_ESCAPE_38, ORC_VEX_SIMD_PREFIX_F2, 0xf1 },
 };
 
 static void
@@ -601,24 +612,11 @@ orc_x86_insn_output_asm (OrcCompiler *p, OrcX86Insn *xinsn)
               orc_x86_get_simd_regname (operand2, ORC_X86_AVX_VEX128_PREFIX));
         break;
       case ORC_X86_INSN_TYPE_MMXM_MMX:
-        // In all cases it can be either a pointer to, or a XMM/YMM register
+        // VEX.vvvv is always a XMM/YMM register, only the r/m operand
+        // (the first one printed) may be a pointer
         // Intel Intrinsics Manual s.2.3.9
-        if (xinsn->type == ORC_X86_RM_REG) {
-          sprintf(src_2nd_op, "%%%s, ",
-              orc_x86_get_simd_regname (operand2, is_sse));
-        } else if (xinsn->type == ORC_X86_RM_MEMOFFSET) {
-          sprintf(src_2nd_op, "%d(%%%s), ", xinsn->offset,
-              orc_x86_get_regname_ptr (p, xinsn->src[2]));
-        } else if (xinsn->type == ORC_X86_RM_MEMINDEX) {
-          sprintf(src_2nd_op, "%d(%%%s,%%%s,%d), ", xinsn->offset,
-              orc_x86_get_regname_ptr (p, xinsn->src[2]),
-              orc_x86_get_regname_ptr (p, xinsn->index_reg),
-              1 << xinsn->shift);
-        } else {
-          ORC_COMPILER_ERROR(p, "Unhandled instruction type %d for 4th operand", xinsn->type);
-          ORC_ASSERT(0);
-          return;
-        }
+        sprintf(src_2nd_op, "%%%s, ",
+            orc_x86_get_simd_regname (operand2, is_sse));
         break;
       case ORC_X86_INSN_TYPE_REGM_MMX:
       case ORC_X86_INSN_TYPE_MMXM_MMX_REV:
@@ -1536,10 +1534,10 @@ output_3byte_vex_opcode (OrcCompiler *p, const OrcX86Insn *xinsn)
       break;
     case ORC_VEX_SIMD_PREFIX_66:
     case ORC_SIMD_PREFIX_MMX:
-    case ORC_SIMD_PREFIX_ESCAPE_ONLY:
       byte3 |= 0x1; 
       break;
     case ORC_VEX_SIMD_PREFIX_NONE:
+    case ORC_SIMD_PREFIX_ESCAPE_ONLY:
       break;
     default:
       ORC_COMPILER_ERROR(p, "unhandled VEX.pp for instruction type %x", xinsn->opcode->prefix);
@@ -1682,6 +1680,598 @@ orc_vex_insn_codegen (OrcCompiler *const p, OrcX86Insn *const xinsn)
   }
 }
 
+/* Peephole pass
+ *
+ * Rules emit one opcode at a time, so the stream carries patterns that
+ * only show up once the instructions are next to each other: a load
+ * whose single consumer could read memory directly, copies of a register
+ * onto itself, repeated zeroing of the same register and compares that
+ * restate the flags of the previous instruction.  All of this is cleaned
+ * up here, before the offsets are calculated.
+ */
+
+#define ORC_X86_PEEPHOLE_N_REGS 32
+
+/* Index of a vector register with xmmN and ymmN aliased, or -1 */
+static int
+orc_x86_peephole_simd_reg (int reg)
+{
+  if (reg >= X86_MM0 && reg < X86_XMM0)
+    return reg - X86_MM0;
+  if (reg >= X86_XMM0 && reg <= X86_XMM15)
+    return 16 + reg - X86_XMM0;
+  if (reg >= X86_YMM0 && reg <= X86_YMM15)
+    return 16 + reg - X86_YMM0;
+  return -1;
+}
+
+static int
+orc_x86_peephole_mentions (const OrcX86Insn *xinsn, int reg)
+{
+  /* blendvpd without VEX takes its mask from xmm0 */
+  if (xinsn->opcode_index == ORC_X86_blendvpd_sse && reg == 16)
+    return TRUE;
+
+  return orc_x86_peephole_simd_reg (xinsn->src[0]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->src[1]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->src[2]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->dest) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->index_reg) == reg;
+}
+
+static int
+orc_x86_peephole_is_vex (const OrcX86Insn *xinsn)
+{
+  return xinsn->prefix == ORC_X86_AVX_VEX128_PREFIX ||
+      xinsn->prefix == ORC_X86_AVX_VEX256_PREFIX;
+}
+
+/* Returns the register cleared by a pxor zeroing idiom, or -1 */
+static int
+orc_x86_peephole_zero_reg (const OrcX86Insn *xinsn)
+{
+  if (xinsn->opcode_index != ORC_X86_pxor || xinsn->type != ORC_X86_RM_REG)
+    return -1;
+  if (xinsn->src[0] != xinsn->dest)
+    return -1;
+  if (orc_x86_peephole_is_vex (xinsn) && xinsn->src[1] != xinsn->dest)
+    return -1;
+
+  return orc_x86_peephole_simd_reg (xinsn->dest);
+}
+
+/* TRUE if the instruction overwrites all of reg without reading it */
+static int
+orc_x86_peephole_defines (const OrcX86Insn *xinsn, int reg, int has_vex256)
+{
+  if (orc_x86_peephole_zero_reg (xinsn) == reg)
+    return TRUE;
+  if (orc_x86_peephole_simd_reg (xinsn->dest) != reg)
+    return FALSE;
+  if (orc_x86_peephole_simd_reg (xinsn->src[0]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->src[1]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->src[2]) == reg ||
+      orc_x86_peephole_simd_reg (xinsn->index_reg) == reg)
+    return FALSE;
+
+  /* FMA accumulates into its destination */
+  switch (xinsn->opcode_index) {
+    case ORC_X86_fmadd213ps_avx:
+    case ORC_X86_fmadd213pd_avx:
+    case ORC_X86_fmadd231ps_avx:
+    case ORC_X86_fmadd231pd_avx:
+      return FALSE;
+    default:
+      break;
+  }
+
+  if (orc_x86_peephole_is_vex (xinsn)) {
+    /* VEX writes are non-destructive and clear the upper bits */
+    switch (xinsn->opcode->type) {
+      case ORC_X86_INSN_TYPE_MMXM_MMX:
+      case ORC_X86_INSN_TYPE_SSEM_SSE:
+      case ORC_X86_INSN_TYPE_SSEM_AVX:
+      case ORC_X86_INSN_TYPE_REGM_MMX:
+      case ORC_X86_INSN_TYPE_IMM8_MMXM_MMX:
+      case ORC_X86_INSN_TYPE_IMM8_SSEM_AVX:
+      case ORC_X86_INSN_TYPE_IMM8_REGM_MMX:
+      case ORC_X86_INSN_TYPE_IMM8_MMX_SHIFT:
+        return TRUE;
+      default:
+        return FALSE;
+    }
+  }
+
+  /* Legacy SSE encodings keep the upper half of the ymm register */
+  if (has_vex256)
+    return FALSE;
+
+  switch (xinsn->opcode_index) {
+    case ORC_X86_movdqa:
+    case ORC_X86_movdqa_load:
+    case ORC_X86_movdqu_load:
+    case ORC_X86_movd_load:
+    case ORC_X86_movq_sse_load:
+    case ORC_X86_movq_mmx_load:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Walks every path from start and returns TRUE if reg can be read
+ * before it is overwritten. */
+static int
+orc_x86_peephole_is_live (OrcCompiler *p, int start, int reg, int has_vex256,
+    unsigned char *visited, int *stack)
+{
+  OrcX86Insn *insns = (OrcX86Insn *)p->output_insns;
+  int n_stack = 0;
+
+  memset (visited, 0, p->n_output_insns);
+  stack[n_stack++] = start;
+
+  while (n_stack > 0) {
+    int i;
+
+    for (i = stack[--n_stack]; i < p->n_output_insns; i++) {
+      OrcX86Insn *xinsn = insns + i;
+
+      if (visited[i])
+        break;
+      visited[i] = TRUE;
+
+      if (orc_x86_peephole_defines (xinsn, reg, has_vex256))
+        break;
+      if (orc_x86_peephole_mentions (xinsn, reg))
+        return TRUE;
+
+      if (xinsn->opcode->type == ORC_X86_INSN_TYPE_BRANCH) {
+        stack[n_stack++] = p->labels_int[xinsn->label];
+        if (xinsn->opcode_index == ORC_X86_jmp)
+          break;
+      }
+      if (xinsn->opcode_index == ORC_X86_ret ||
+          xinsn->opcode_index == ORC_X86_retq)
+        break;
+    }
+  }
+
+  return FALSE;
+}
+
+static int
+orc_x86_peephole_is_commutative (int opcode_index)
+{
+  switch (opcode_index) {
+    case ORC_X86_paddb:
+    case ORC_X86_paddw:
+    case ORC_X86_paddd:
+    case ORC_X86_paddq:
+    case ORC_X86_paddsb:
+    case ORC_X86_paddsw:
+    case ORC_X86_paddusb:
+    case ORC_X86_paddusw:
+    case ORC_X86_pmullw:
+    case ORC_X86_pmulhw:
+    case ORC_X86_pmulhuw:
+    case ORC_X86_pmulld:
+    case ORC_X86_pmuludq:
+    case ORC_X86_pmuldq:
+    case ORC_X86_pmaddwd:
+    case ORC_X86_psadbw:
+    case ORC_X86_pand:
+    case ORC_X86_por:
+    case ORC_X86_pxor:
+    case ORC_X86_pavgb:
+    case ORC_X86_pavgw:
+    case ORC_X86_pminub:
+    case ORC_X86_pminuw:
+    case ORC_X86_pminud:
+    case ORC_X86_pminsb:
+    case ORC_X86_pminsw:
+    case ORC_X86_pminsd:
+    case ORC_X86_pmaxub:
+    case ORC_X86_pmaxuw:
+    case ORC_X86_pmaxud:
+    case ORC_X86_pmaxsb:
+    case ORC_X86_pmaxsw:
+    case ORC_X86_pmaxsd:
+    case ORC_X86_pcmpeqb:
+    case ORC_X86_pcmpeqw:
+    case ORC_X86_pcmpeqd:
+    case ORC_X86_pcmpeqq:
+    case ORC_X86_addps:
+    case ORC_X86_addpd:
+    case ORC_X86_mulps:
+    case ORC_X86_mulpd:
+    case ORC_X86_andps:
+    case ORC_X86_orps:
+    case ORC_X86_cmpeqps:
+    case ORC_X86_cmpeqpd:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Two-operand instructions whose r/m source reads a full vector */
+static int
+orc_x86_peephole_can_fold (int opcode_index)
+{
+  if (orc_x86_peephole_is_commutative (opcode_index))
+    return TRUE;
+
+  switch (opcode_index) {
+    case ORC_X86_punpcklbw:
+    case ORC_X86_punpcklwd:
+    case ORC_X86_punpckldq:
+    case ORC_X86_punpcklqdq:
+    case ORC_X86_punpckhbw:
+    case ORC_X86_punpckhwd:
+    case ORC_X86_punpckhdq:
+    case ORC_X86_punpckhqdq:
+    case ORC_X86_packsswb:
+    case ORC_X86_packuswb:
+    case ORC_X86_packssdw:
+    case ORC_X86_packusdw:
+    case ORC_X86_pcmpgtb:
+    case ORC_X86_pcmpgtw:
+    case ORC_X86_pcmpgtd:
+    case ORC_X86_pcmpgtq:
+    case ORC_X86_psubb:
+    case ORC_X86_psubw:
+    case ORC_X86_psubd:
+    case ORC_X86_psubq:
+    case ORC_X86_psubsb:
+    case ORC_X86_psubsw:
+    case ORC_X86_psubusb:
+    case ORC_X86_psubusw:
+    case ORC_X86_pandn:
+    case ORC_X86_pshufb:
+    case ORC_X86_phaddw:
+    case ORC_X86_phaddd:
+    case ORC_X86_phaddsw:
+    case ORC_X86_phsubw:
+    case ORC_X86_phsubd:
+    case ORC_X86_phsubsw:
+    case ORC_X86_pmaddubsw:
+    case ORC_X86_psignb:
+    case ORC_X86_psignw:
+    case ORC_X86_psignd:
+    case ORC_X86_pmulhrsw:
+    case ORC_X86_subps:
+    case ORC_X86_subpd:
+    case ORC_X86_divps:
+    case ORC_X86_divpd:
+    case ORC_X86_minps:
+    case ORC_X86_minpd:
+    case ORC_X86_maxps:
+    case ORC_X86_maxpd:
+    case ORC_X86_cmpltps:
+    case ORC_X86_cmpltpd:
+    case ORC_X86_cmpleps:
+    case ORC_X86_cmplepd:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* Folds the load at i into the instruction at i + 1.  The caller drops
+ * the load when this returns TRUE. */
+static int
+orc_x86_peephole_fold_load (OrcCompiler *p, int i, int has_vex256,
+    unsigned char *visited, int *stack)
+{
+  OrcX86Insn *load = ((OrcX86Insn *)p->output_insns) + i;
+  OrcX86Insn *xinsn = load + 1;
+  int reg;
+  int swap = FALSE;
+  int check_live = TRUE;
+
+  if (load->type != ORC_X86_RM_MEMOFFSET || xinsn->type != ORC_X86_RM_REG)
+    return FALSE;
+  if (load->prefix != xinsn->prefix)
+    return FALSE;
+  if (!orc_x86_peephole_can_fold (xinsn->opcode_index))
+    return FALSE;
+
+  reg = orc_x86_peephole_simd_reg (load->dest);
+  if (reg < 16)
+    return FALSE;
+
+  if (orc_x86_peephole_is_vex (xinsn)) {
+    /* VEX memory operands do not need to be aligned */
+    if (load->opcode_index != ORC_X86_movdqu_load &&
+        load->opcode_index != ORC_X86_movdqa_load)
+      return FALSE;
+    if (xinsn->src[1] == 0 ||
+        orc_x86_peephole_simd_reg (xinsn->src[2]) == reg)
+      return FALSE;
+
+    if (orc_x86_peephole_simd_reg (xinsn->src[1]) != reg) {
+      if (orc_x86_peephole_simd_reg (xinsn->src[0]) != reg ||
+          !orc_x86_peephole_is_commutative (xinsn->opcode_index))
+        return FALSE;
+      swap = TRUE;
+    }
+    if (orc_x86_peephole_simd_reg (xinsn->src[swap ? 1 : 0]) == reg)
+      return FALSE;
+    if (orc_x86_peephole_simd_reg (xinsn->dest) == reg)
+      check_live = FALSE;
+  } else {
+    /* SSE memory operands fault when they are not aligned */
+    if (load->opcode_index != ORC_X86_movdqa_load)
+      return FALSE;
+    if (orc_x86_peephole_simd_reg (xinsn->src[0]) != reg ||
+        orc_x86_peephole_simd_reg (xinsn->dest) == reg)
+      return FALSE;
+  }
+
+  if (check_live && orc_x86_peephole_is_live (p, i + 2, reg, has_vex256,
+          visited, stack))
+    return FALSE;
+
+  if (orc_x86_peephole_is_vex (xinsn)) {
+    if (swap)
+      xinsn->src[0] = xinsn->src[1];
+    xinsn->src[1] = load->src[0];
+  } else {
+    xinsn->src[0] = load->src[0];
+  }
+  xinsn->type = ORC_X86_RM_MEMOFFSET;
+  xinsn->offset = load->offset;
+
+  return TRUE;
+}
+
+static int
+orc_x86_peephole_is_nop_move (const OrcX86Insn *xinsn)
+{
+  if (xinsn->type != ORC_X86_RM_REG || xinsn->src[0] != xinsn->dest)
+    return FALSE;
+
+  switch (xinsn->opcode_index) {
+    case ORC_X86_movdqa:
+    case ORC_X86_movdqu_load:
+    case ORC_X86_movq_mmx_load:
+      /* VEX.128 clears the upper half of the ymm register */
+      if (xinsn->prefix == ORC_X86_AVX_VEX256_PREFIX)
+        return xinsn->src[1] == 0;
+      return xinsn->prefix != ORC_X86_AVX_VEX128_PREFIX;
+    case ORC_X86_mov_r_rm:
+    case ORC_X86_mov_rm_r:
+      /* 32-bit moves zero the upper half of the register */
+      return xinsn->size == 8;
+    default:
+      return FALSE;
+  }
+}
+
+/* Instructions that leave ZF and SF as test would for their result */
+static int
+orc_x86_peephole_sets_zf_sf (const OrcX86Insn *xinsn, int reg, int size)
+{
+  if (xinsn->type != ORC_X86_RM_REG || xinsn->dest != reg ||
+      xinsn->size != size)
+    return FALSE;
+
+  switch (xinsn->opcode_index) {
+    case ORC_X86_add_imm8_rm:
+    case ORC_X86_add_imm32_rm:
+    case ORC_X86_add_rm_r:
+    case ORC_X86_add_r_rm:
+    case ORC_X86_sub_imm8_rm:
+    case ORC_X86_sub_imm32_rm:
+    case ORC_X86_sub_rm_r:
+    case ORC_X86_sub_r_rm:
+    case ORC_X86_and_imm8_rm:
+    case ORC_X86_and_imm32_rm:
+    case ORC_X86_and_rm_r:
+    case ORC_X86_and_r_rm:
+    case ORC_X86_or_imm8_rm:
+    case ORC_X86_or_imm32_rm:
+    case ORC_X86_or_rm_r:
+    case ORC_X86_or_r_rm:
+    case ORC_X86_xor_imm8_rm:
+    case ORC_X86_xor_imm32_rm:
+    case ORC_X86_xor_rm_r:
+    case ORC_X86_xor_r_rm:
+    case ORC_X86_inc:
+    case ORC_X86_dec:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+static int
+orc_x86_peephole_is_jcc (const OrcX86Insn *xinsn)
+{
+  return xinsn->opcode->type == ORC_X86_INSN_TYPE_BRANCH &&
+      xinsn->opcode_index != ORC_X86_jmp;
+}
+
+static void
+orc_x86_peephole_set_opcode (OrcX86Insn *xinsn, int index)
+{
+  xinsn->opcode_index = index;
+  xinsn->opcode = orc_x86_opcodes + index;
+}
+
+/* TRUE if only labels separate insn i from the definition of label */
+static int
+orc_x86_peephole_falls_to_label (OrcCompiler *p, int i, int label)
+{
+  OrcX86Insn *insns = (OrcX86Insn *)p->output_insns;
+
+  for (i = i + 1; i < p->n_output_insns; i++) {
+    if (insns[i].opcode->type != ORC_X86_INSN_TYPE_LABEL)
+      return FALSE;
+    if (insns[i].label == label && p->labels_int[label] == i)
+      return TRUE;
+  }
+  return FALSE;
+}
+
+void
+orc_x86_peephole (OrcCompiler *p)
+{
+  OrcX86Insn *insns = (OrcX86Insn *)p->output_insns;
+  const int n_insns = p->n_output_insns;
+  unsigned char *removed;
+  unsigned char *visited;
+  int *stack;
+  int zero_prefix[ORC_X86_PEEPHOLE_N_REGS];
+  int has_vex256 = FALSE;
+  int n_folded = 0;
+  int n_moves = 0;
+  int n_zeroes = 0;
+  int n_compares = 0;
+  int n_branches = 0;
+  int i, j;
+
+  if (n_insns == 0)
+    return;
+
+  removed = calloc (n_insns, 1);
+  visited = malloc (n_insns);
+  stack = malloc (sizeof(int) * n_insns);
+  if (!removed || !visited || !stack) {
+    free (removed);
+    free (visited);
+    free (stack);
+    return;
+  }
+
+  for (i = 0; i < n_insns; i++) {
+    if (insns[i].prefix == ORC_X86_AVX_VEX256_PREFIX)
+      has_vex256 = TRUE;
+  }
+
+  /* Loads and moves */
+  for (i = 0; i < n_insns; i++) {
+    if (orc_x86_peephole_is_nop_move (insns + i)) {
+      removed[i] = TRUE;
+      n_moves++;
+      continue;
+    }
+    if (i + 1 < n_insns &&
+        orc_x86_peephole_fold_load (p, i, has_vex256, visited, stack)) {
+      removed[i] = TRUE;
+      n_folded++;
+      i++;
+    }
+  }
+
+  /* Zeroing of registers that are already zero */
+  for (j = 0; j < ORC_X86_PEEPHOLE_N_REGS; j++)
+    zero_prefix[j] = -1;
+  for (i = 0; i < n_insns; i++) {
+    OrcX86Insn *xinsn = insns + i;
+    int reg;
+
+    if (removed[i])
+      continue;
+
+    if (xinsn->opcode->type == ORC_X86_INSN_TYPE_LABEL ||
+        (xinsn->opcode->type == ORC_X86_INSN_TYPE_NONE &&
+         xinsn->opcode_index != ORC_X86_nop)) {
+      for (j = 0; j < ORC_X86_PEEPHOLE_N_REGS; j++)
+        zero_prefix[j] = -1;
+      continue;
+    }
+
+    reg = orc_x86_peephole_zero_reg (xinsn);
+    if (reg >= 0) {
+      if (zero_prefix[reg] == (int)xinsn->prefix) {
+        removed[i] = TRUE;
+        n_zeroes++;
+      }
+      zero_prefix[reg] = xinsn->prefix;
+      continue;
+    }
+
+    reg = orc_x86_peephole_simd_reg (xinsn->dest);
+    if (reg >= 0)
+      zero_prefix[reg] = -1;
+  }
+
+  /* Compares and branches */
+  for (i = 0; i < n_insns; i++) {
+    OrcX86Insn *xinsn = insns + i;
+
+    if ((xinsn->opcode_index == ORC_X86_cmp_imm8_rm ||
+         xinsn->opcode_index == ORC_X86_cmp_imm32_rm) &&
+        xinsn->type == ORC_X86_RM_REG && xinsn->imm == 0) {
+      /* same flags, shorter encoding */
+      orc_x86_peephole_set_opcode (xinsn, ORC_X86_test);
+      xinsn->src[0] = xinsn->dest;
+      n_compares++;
+    }
+
+    if (xinsn->opcode_index == ORC_X86_test &&
+        xinsn->type == ORC_X86_RM_REG && xinsn->src[0] == xinsn->dest &&
+        i > 0 && i + 1 < n_insns && !removed[i - 1] &&
+        orc_x86_peephole_sets_zf_sf (insns + i - 1, xinsn->dest,
+            xinsn->size)) {
+      OrcX86Insn *next = insns + i + 1;
+
+      if ((next->opcode_index == ORC_X86_jz ||
+           next->opcode_index == ORC_X86_jnz ||
+           next->opcode_index == ORC_X86_js ||
+           next->opcode_index == ORC_X86_jns) &&
+          (i + 2 >= n_insns || !orc_x86_peephole_is_jcc (insns + i + 2))) {
+        removed[i] = TRUE;
+        n_compares++;
+        continue;
+      }
+    }
+
+    if (xinsn->opcode->type != ORC_X86_INSN_TYPE_BRANCH)
+      continue;
+
+    if (orc_x86_peephole_falls_to_label (p, i, xinsn->label)) {
+      removed[i] = TRUE;
+      n_branches++;
+      continue;
+    }
+
+    /* jcc 1f; jmp 2f; 1: becomes jncc 2f; 1: */
+    if (orc_x86_peephole_is_jcc (xinsn) && i + 1 < n_insns &&
+        insns[i + 1].opcode_index == ORC_X86_jmp &&
+        orc_x86_peephole_falls_to_label (p, i + 1, xinsn->label)) {
+      orc_x86_peephole_set_opcode (xinsn,
+          ORC_X86_jo + ((xinsn->opcode_index - ORC_X86_jo) ^ 1));
+      xinsn->label = insns[i + 1].label;
+      removed[i + 1] = TRUE;
+      n_branches++;
+      i++;
+    }
+  }
+
+  /* Compact the stream and point the labels at their new positions */
+  for (i = 0, j = 0; i < n_insns; i++) {
+    if (removed[i])
+      continue;
+    if (i != j)
+      insns[j] = insns[i];
+    if (insns[j].opcode->type == ORC_X86_INSN_TYPE_LABEL)
+      p->labels_int[insns[j].label] = j;
+    j++;
+  }
+  p->n_output_insns = j;
+
+  ORC_DEBUG ("peephole: %d loads folded, %d moves, %d zeroings, "
+      "%d compares and %d branches removed", n_folded, n_moves, n_zeroes,
+      n_compares, n_branches);
+
+  free (removed);
+  free (visited);
+  free (stack);
+}
+
 static void
 orc_x86_recalc_offsets (OrcCompiler *p)
 {
@@ -1739,12 +2329,15 @@ orc_x86_calculate_offsets (OrcCompiler *p)
   OrcX86Insn *xinsn;
   int i;
   int j;
+  orc_uint64 start = orc_stats_get_time ();
 
   orc_x86_recalc_offsets (p);
 
   for(j=0;j<3;j++){
     int change = FALSE;
 
+    p->n_relaxation_iterations++;
+
     for(i=0;i<p->n_output_insns;i++){
       OrcX86Insn *dinsn;
       int diff;
@@ -1780,6 +2373,8 @@ orc_x86_calculate_offsets (OrcCompiler *p)
 
     orc_x86_recalc_offsets (p);
   }
+
+  p->relaxation_time += orc_stats_get_time () - start;
 }
 
 void
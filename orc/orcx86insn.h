@@ -305,6 +305,17 @@ typedef enum
   ORC_X86_andps,
   ORC_X86_orps,
   ORC_X86_blendvpd_sse,
+  ORC_X86_fmadd213ps_avx,
+  ORC_X86_fmadd213pd_avx,
+  ORC_X86_fmadd231ps_avx,
+  ORC_X86_fmadd231pd_avx,
+  ORC_X86_addsubps,
+  ORC_X86_haddps,
+  ORC_X86_movsldup,
+  ORC_X86_movshdup,
+  ORC_X86_crc32b_rm_r,
+  ORC_X86_crc32l_rm_r,
+  ORC_X86_crc32q_rm_r,
 } OrcX86OpcodeIdx;
 
 typedef enum {
@@ -380,6 +391,7 @@ struct _OrcX86Insn {
 ORC_API OrcX86Insn * orc_x86_get_output_insn (OrcCompiler *p);
 ORC_API void orc_x86_output_insns (OrcCompiler *p);
 ORC_API void orc_x86_calculate_offsets (OrcCompiler *p);
+ORC_API void orc_x86_peephole (OrcCompiler *p);
 
 ORC_API void orc_vex_emit_cpuinsn_none (OrcCompiler *p, int index, OrcX86OpcodePrefix prefix);
 ORC_API void orc_vex_emit_cpuinsn_size (OrcCompiler *p, int opcode, int size,
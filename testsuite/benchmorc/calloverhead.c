@@ -0,0 +1,367 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc/orc.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcprofile.h>
+
+/* Measures the fixed cost of calling an Orc function next to its cost per
+ * element.  Each program is called the way orcc generated wrappers call
+ * it (executor on the stack, then an indirect call) through the JIT code
+ * and through a backup function written like the ones orcc emits, and
+ * the same operation is also timed as a plain C loop.  The minimum time
+ * of every n is fitted to fixed + slope * n.
+ *
+ * The fixed cost is then split up with programs that differ in a single
+ * part of the prologue, all run with n = 0 so that no loop body runs. */
+
+#define N_MAX 256
+#define N_CALLS 16
+#define N_RUNS 1000
+
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#define BENCH_BARRIER() __asm__ __volatile__ ("" : : : "memory")
+#else
+#define BENCH_NOINLINE
+#define BENCH_BARRIER()
+#endif
+
+#define ORC_DENORMAL(x) ((x) & ((((x)&0x7f800000) == 0) ? 0xff800000 : 0xffffffff))
+
+/* smallest time of N_CALLS runs of code, per call */
+#define MEASURE(result,code) do { \
+  OrcProfile prof; \
+  int _r, _c; \
+  orc_profile_init (&prof); \
+  for (_r = 0; _r < N_RUNS; _r++) { \
+    orc_profile_start (&prof); \
+    for (_c = 0; _c < N_CALLS; _c++) { \
+      code; \
+      BENCH_BARRIER (); \
+    } \
+    orc_profile_stop (&prof); \
+  } \
+  (result) = (double)prof.min / N_CALLS; \
+} while (0)
+
+typedef void (*ExecFunc) (OrcExecutor *ex);
+
+enum {
+  BENCH_COPY,
+  BENCH_ADD,
+  BENCH_CONVERT,
+  BENCH_MULF,
+  N_BENCHES
+};
+
+static const char *bench_names[N_BENCHES] = {
+  "copyb", "addw", "convsbw", "mulf"
+};
+
+static orc_uint8 dest[N_MAX * 4 + 64];
+static orc_uint8 src1[N_MAX * 4 + 64];
+static orc_uint8 src2[N_MAX * 4 + 64];
+
+static const int n_values[] = {
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+  24, 32, 48, 64, 96, 128, 160, 192, 224, 256
+};
+#define N_VALUES ((int)(sizeof(n_values) / sizeof(n_values[0])))
+
+static void
+backup_copyb (OrcExecutor *ex)
+{
+  int i;
+  int n = ex->n;
+  orc_int8 *ORC_RESTRICT ptr0 = (orc_int8 *) ex->arrays[ORC_VAR_D1];
+  const orc_int8 *ORC_RESTRICT ptr4 = (orc_int8 *) ex->arrays[ORC_VAR_S1];
+
+  for (i = 0; i < n; i++) {
+    ptr0[i] = ptr4[i];
+  }
+}
+
+static void
+backup_addw (OrcExecutor *ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0 = (orc_union16 *) ex->arrays[ORC_VAR_D1];
+  const orc_union16 *ORC_RESTRICT ptr4 = (orc_union16 *) ex->arrays[ORC_VAR_S1];
+  const orc_union16 *ORC_RESTRICT ptr5 = (orc_union16 *) ex->arrays[ORC_VAR_S2];
+
+  for (i = 0; i < n; i++) {
+    ptr0[i].i = ptr4[i].i + ptr5[i].i;
+  }
+}
+
+static void
+backup_convsbw (OrcExecutor *ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union16 *ORC_RESTRICT ptr0 = (orc_union16 *) ex->arrays[ORC_VAR_D1];
+  const orc_int8 *ORC_RESTRICT ptr4 = (orc_int8 *) ex->arrays[ORC_VAR_S1];
+
+  for (i = 0; i < n; i++) {
+    ptr0[i].i = ptr4[i];
+  }
+}
+
+static void
+backup_mulf (OrcExecutor *ex)
+{
+  int i;
+  int n = ex->n;
+  orc_union32 *ORC_RESTRICT ptr0 = (orc_union32 *) ex->arrays[ORC_VAR_D1];
+  const orc_union32 *ORC_RESTRICT ptr4 = (orc_union32 *) ex->arrays[ORC_VAR_S1];
+  const orc_union32 *ORC_RESTRICT ptr5 = (orc_union32 *) ex->arrays[ORC_VAR_S2];
+  orc_union32 var32;
+  orc_union32 var33;
+  orc_union32 var34;
+
+  for (i = 0; i < n; i++) {
+    var32 = ptr4[i];
+    var33 = ptr5[i];
+    {
+      orc_union32 _src1;
+      orc_union32 _src2;
+      _src1.i = ORC_DENORMAL (var32.i);
+      _src2.i = ORC_DENORMAL (var33.i);
+      var34.f = _src1.f * _src2.f;
+      var34.i = ORC_DENORMAL (var34.i);
+    }
+    ptr0[i] = var34;
+  }
+}
+
+static const ExecFunc backups[N_BENCHES] = {
+  backup_copyb, backup_addw, backup_convsbw, backup_mulf
+};
+
+static void
+noop_exec (OrcExecutor *ex)
+{
+}
+
+/* same as the body of an orcc generated function once the code is
+ * compiled */
+static BENCH_NOINLINE void
+call_wrapper (ExecFunc exec, OrcCode *code, void *d1, const void *s1,
+    const void *s2, int n)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  ExecFunc func;
+
+  ex->program = 0;
+  ex->n = n;
+  ex->arrays[ORC_VAR_D1] = d1;
+  ex->arrays[ORC_VAR_S1] = (void *)s1;
+  ex->arrays[ORC_VAR_S2] = (void *)s2;
+  ex->arrays[ORC_VAR_A2] = code;
+
+  func = exec;
+  func (ex);
+}
+
+static OrcProgram *
+create_program (const char *opcode, int dest_size, int src_size, int n_srcs)
+{
+  OrcProgram *p;
+
+  if (n_srcs == 2) {
+    p = orc_program_new_dss (dest_size, src_size, src_size);
+    orc_program_append_str (p, opcode, "d1", "s1", "s2");
+  } else {
+    p = orc_program_new_ds (dest_size, src_size);
+    orc_program_append_ds_str (p, opcode, "d1", "s1");
+  }
+  orc_program_set_name (p, opcode);
+
+  return p;
+}
+
+static OrcCode *
+compile (OrcProgram *p)
+{
+  OrcCompileResult result;
+
+  result = orc_program_compile (p);
+  if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL (result)) {
+    printf ("%s: not compiled, timing the fallback\n", p->name);
+  }
+  return orc_program_take_code (p);
+}
+
+static double
+time_inline (int bench, int n)
+{
+  double t = 0;
+  int i;
+
+  switch (bench) {
+    case BENCH_COPY:
+      MEASURE (t, {
+        orc_int8 *d = (orc_int8 *)dest;
+        const orc_int8 *s = (const orc_int8 *)src1;
+        for (i = 0; i < n; i++) d[i] = s[i];
+      });
+      break;
+    case BENCH_ADD:
+      MEASURE (t, {
+        orc_int16 *d = (orc_int16 *)dest;
+        const orc_int16 *a = (const orc_int16 *)src1;
+        const orc_int16 *b = (const orc_int16 *)src2;
+        for (i = 0; i < n; i++) d[i] = a[i] + b[i];
+      });
+      break;
+    case BENCH_CONVERT:
+      MEASURE (t, {
+        orc_int16 *d = (orc_int16 *)dest;
+        const orc_int8 *s = (const orc_int8 *)src1;
+        for (i = 0; i < n; i++) d[i] = s[i];
+      });
+      break;
+    case BENCH_MULF:
+      MEASURE (t, {
+        float *d = (float *)dest;
+        const float *a = (const float *)src1;
+        const float *b = (const float *)src2;
+        for (i = 0; i < n; i++) d[i] = a[i] * b[i];
+      });
+      break;
+  }
+
+  return t;
+}
+
+/* least squares fit of t = fixed + slope * n */
+static void
+fit (const double *t, double *fixed, double *slope)
+{
+  double sn = 0, st = 0, snn = 0, snt = 0;
+  int i;
+
+  for (i = 0; i < N_VALUES; i++) {
+    sn += n_values[i];
+    st += t[i];
+    snn += (double)n_values[i] * n_values[i];
+    snt += n_values[i] * t[i];
+  }
+  *slope = (N_VALUES * snt - sn * st) / (N_VALUES * snn - sn * sn);
+  *fixed = (st - *slope * sn) / N_VALUES;
+}
+
+static double
+time_code (ExecFunc exec, OrcCode *code, int n)
+{
+  double t;
+
+  MEASURE (t, call_wrapper (exec, code, dest, src1, src2, n));
+  return t;
+}
+
+static void
+time_bench (int bench, OrcCode *code)
+{
+  static const char *kinds[] = { "jit", "backup", "inline C" };
+  double t[3][N_VALUES];
+  int i, k;
+
+  for (i = 0; i < N_VALUES; i++) {
+    t[0][i] = time_code ((ExecFunc)code->exec, code, n_values[i]);
+    t[1][i] = time_code (backups[bench], code, n_values[i]);
+    t[2][i] = time_inline (bench, n_values[i]);
+  }
+
+  printf ("%s\n", bench_names[bench]);
+  printf ("  %5s %10s %10s %10s\n", "n", kinds[0], kinds[1], kinds[2]);
+  for (i = 0; i < N_VALUES; i++) {
+    printf ("  %5d %10.1f %10.1f %10.1f\n", n_values[i], t[0][i], t[1][i],
+        t[2][i]);
+  }
+  for (k = 0; k < 3; k++) {
+    double fixed, slope;
+
+    fit (t[k], &fixed, &slope);
+    printf ("  %-8s fixed %8.1f ticks, %6.2f ticks/element\n", kinds[k],
+        fixed, slope);
+  }
+}
+
+static double
+time_program_n0 (OrcProgram *p)
+{
+  OrcCode *code;
+  double t;
+
+  code = compile (p);
+  t = time_code ((ExecFunc)code->exec, code, 0);
+  orc_program_free (p);
+  orc_code_free (code);
+
+  return t;
+}
+
+static void
+time_prologue (void)
+{
+  OrcExecutor _ex, *ex = &_ex;
+  volatile ExecFunc func = noop_exec;
+  OrcProgram *p;
+  double call, wrapper, copy, constant, mull, mulf;
+
+  memset (ex, 0, sizeof (*ex));
+  MEASURE (call, func (ex));
+  MEASURE (wrapper, call_wrapper (func, NULL, dest, src1, src2, 0));
+
+  copy = time_program_n0 (create_program ("copyw", 2, 2, 1));
+
+  p = orc_program_new_ds (2, 2);
+  orc_program_add_constant (p, 2, 0x1234, "c1");
+  orc_program_append_str (p, "addw", "d1", "s1", "c1");
+  constant = time_program_n0 (p);
+
+  mull = time_program_n0 (create_program ("mulll", 4, 4, 2));
+  mulf = time_program_n0 (create_program ("mulf", 4, 4, 2));
+
+  printf ("fixed cost at n = 0\n");
+  printf ("  indirect call       %8.1f ticks\n", call);
+  printf ("  executor setup      %8.1f ticks\n", wrapper - call);
+  printf ("  entry and exit      %8.1f ticks (registers, pointers, "
+      "region split)\n", copy - wrapper);
+  printf ("  constant load       %8.1f ticks\n", constant - copy);
+  printf ("  float mode (MXCSR)  %8.1f ticks\n", mulf - mull);
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram *programs[N_BENCHES];
+  OrcCode *code;
+  int i;
+
+  orc_test_init ();
+
+  for (i = 0; i < (int)sizeof (src1); i++) {
+    src1[i] = i * 7;
+    src2[i] = i * 13;
+  }
+
+  programs[BENCH_COPY] = create_program ("copyb", 1, 1, 1);
+  programs[BENCH_ADD] = create_program ("addw", 2, 2, 2);
+  programs[BENCH_CONVERT] = create_program ("convsbw", 2, 1, 1);
+  programs[BENCH_MULF] = create_program ("mulf", 4, 4, 2);
+
+  for (i = 0; i < N_BENCHES; i++) {
+    code = compile (programs[i]);
+    time_bench (i, code);
+    orc_program_free (programs[i]);
+    orc_code_free (code);
+  }
+
+  time_prologue ();
+
+  return 0;
+}
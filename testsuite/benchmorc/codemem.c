@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <orc/orc.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcprofile.h>
+
+/* Measures how long it takes to set up a new executable code region.
+ * Regions are never released, so every allocation that asks for close
+ * to a full region forces the creation of a fresh one. */
+
+#define N_REGIONS 256
+#define REGION_FILL (60 * 1024)
+
+int
+main (int argc, char *argv[])
+{
+  OrcCode *codes[N_REGIONS];
+  OrcProfile prof;
+  double ave, std;
+  int i;
+
+  orc_test_init ();
+
+  orc_profile_init (&prof);
+  for (i = 0; i < N_REGIONS; i++) {
+    codes[i] = orc_code_new ();
+    orc_profile_start (&prof);
+    orc_code_allocate_codemem (codes[i], REGION_FILL);
+    orc_profile_stop (&prof);
+  }
+
+  orc_profile_get_ave_std (&prof, &ave, &std);
+  printf ("region creation: %g +/- %g ticks (%d regions)\n", ave, std,
+      N_REGIONS);
+
+  /* Once the chunks are free, allocations reuse the existing regions. */
+  for (i = 0; i < N_REGIONS; i++) {
+    orc_code_free (codes[i]);
+  }
+
+  orc_profile_init (&prof);
+  for (i = 0; i < N_REGIONS; i++) {
+    codes[i] = orc_code_new ();
+    orc_profile_start (&prof);
+    orc_code_allocate_codemem (codes[i], REGION_FILL);
+    orc_profile_stop (&prof);
+  }
+
+  orc_profile_get_ave_std (&prof, &ave, &std);
+  printf ("region reuse: %g +/- %g ticks\n", ave, std);
+
+  for (i = 0; i < N_REGIONS; i++) {
+    orc_code_free (codes[i]);
+  }
+
+  return 0;
+}
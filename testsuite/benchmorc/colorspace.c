@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc/orc.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcprofile.h>
+
+/* Times the colour converters for common pairs of formats with each
+ * precision and prints the time per pixel, with the precision the
+ * converter ended up using.  Converters whose programs don't compile for
+ * the target are emulated, which is marked in the output. */
+
+#define WIDTH 1920
+#define HEIGHT 1080
+#define N_RUNS 10
+
+static const OrcColorFormat pairs[][2] = {
+  { ORC_COLOR_FORMAT_I420, ORC_COLOR_FORMAT_BGRA },
+  { ORC_COLOR_FORMAT_BGRA, ORC_COLOR_FORMAT_I420 },
+  { ORC_COLOR_FORMAT_Y42B, ORC_COLOR_FORMAT_ARGB },
+  { ORC_COLOR_FORMAT_ARGB, ORC_COLOR_FORMAT_Y444 },
+  { ORC_COLOR_FORMAT_AYUV, ORC_COLOR_FORMAT_RGBA },
+  { ORC_COLOR_FORMAT_I420, ORC_COLOR_FORMAT_GBR },
+  { ORC_COLOR_FORMAT_I420_10, ORC_COLOR_FORMAT_GBR_10 },
+  { ORC_COLOR_FORMAT_GBR_10, ORC_COLOR_FORMAT_I420_10 },
+  { ORC_COLOR_FORMAT_Y444_16, ORC_COLOR_FORMAT_GBR_16 },
+  { ORC_COLOR_FORMAT_AYUV64, ORC_COLOR_FORMAT_ARGB64 },
+};
+
+static const char *precision_names[] = { "fast", "exact", "float" };
+
+/* bytes per row of each plane, 0 for the planes a format doesn't have */
+static void
+get_strides (OrcColorFormat format, int stride[3])
+{
+  switch (format) {
+    case ORC_COLOR_FORMAT_AYUV:
+    case ORC_COLOR_FORMAT_ARGB:
+    case ORC_COLOR_FORMAT_BGRA:
+    case ORC_COLOR_FORMAT_RGBA:
+    case ORC_COLOR_FORMAT_ABGR:
+      stride[0] = WIDTH * 4;
+      stride[1] = stride[2] = 0;
+      break;
+    case ORC_COLOR_FORMAT_AYUV64:
+    case ORC_COLOR_FORMAT_ARGB64:
+      stride[0] = WIDTH * 8;
+      stride[1] = stride[2] = 0;
+      break;
+    case ORC_COLOR_FORMAT_Y42B:
+    case ORC_COLOR_FORMAT_I420:
+      stride[0] = WIDTH;
+      stride[1] = stride[2] = WIDTH / 2;
+      break;
+    case ORC_COLOR_FORMAT_I422_10:
+    case ORC_COLOR_FORMAT_I420_10:
+      stride[0] = WIDTH * 2;
+      stride[1] = stride[2] = WIDTH;
+      break;
+    case ORC_COLOR_FORMAT_Y444_10:
+    case ORC_COLOR_FORMAT_Y444_16:
+    case ORC_COLOR_FORMAT_GBR_10:
+    case ORC_COLOR_FORMAT_GBR_16:
+      stride[0] = stride[1] = stride[2] = WIDTH * 2;
+      break;
+    default:
+      stride[0] = stride[1] = stride[2] = WIDTH;
+      break;
+  }
+}
+
+static void
+alloc_planes (OrcColorFormat format, void *planes[3], int stride[3])
+{
+  int i;
+
+  get_strides (format, stride);
+  for (i = 0; i < 3; i++) {
+    planes[i] = NULL;
+    if (stride[i] == 0) continue;
+    planes[i] = malloc (stride[i] * HEIGHT);
+    /* 10 bit samples have to stay in range */
+    memset (planes[i], 0x01, stride[i] * HEIGHT);
+  }
+}
+
+static int
+is_emulated (OrcColorConverter *conv)
+{
+  int i;
+
+  for (i = 0; i < orc_color_converter_get_n_programs (conv); i++) {
+    OrcProgram *p = orc_color_converter_get_program (conv, i);
+
+    if (p->code_exec == (void *)orc_executor_emulate) return TRUE;
+  }
+  return FALSE;
+}
+
+static void
+time_pair (OrcColorFormat in, OrcColorFormat out, OrcColorPrecision precision)
+{
+  OrcColorConverter *conv;
+  OrcProfile prof;
+  void *src[3], *dest[3];
+  int src_stride[3], dest_stride[3];
+  int i;
+
+  conv = orc_color_converter_new (in, out, ORC_COLOR_MATRIX_BT709,
+      ORC_COLOR_RANGE_LIMITED, precision);
+  if (conv == NULL) {
+    printf ("%-8s %-8s %-6s not supported\n", orc_color_format_get_name (in),
+        orc_color_format_get_name (out), precision_names[precision]);
+    return;
+  }
+  alloc_planes (in, src, src_stride);
+  alloc_planes (out, dest, dest_stride);
+
+  orc_profile_init (&prof);
+  for (i = 0; i < N_RUNS; i++) {
+    orc_profile_start (&prof);
+    orc_color_converter_convert (conv, dest, dest_stride,
+        (const void **)src, src_stride, WIDTH, HEIGHT);
+    orc_profile_stop (&prof);
+  }
+
+  printf ("%-8s %-8s %-6s %8.3f ticks/pixel, %s, %d program%s%s\n",
+      orc_color_format_get_name (in), orc_color_format_get_name (out),
+      precision_names[precision], (double)prof.min / (WIDTH * HEIGHT),
+      precision_names[orc_color_converter_get_precision (conv)],
+      orc_color_converter_get_n_programs (conv),
+      orc_color_converter_get_n_programs (conv) > 1 ? "s" : "",
+      is_emulated (conv) ? ", emulated" : "");
+
+  for (i = 0; i < 3; i++) {
+    free (src[i]);
+    free (dest[i]);
+  }
+  orc_color_converter_free (conv);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int i, precision;
+
+  orc_test_init ();
+
+  printf ("%d x %d, BT.709 limited range\n", WIDTH, HEIGHT);
+  for (i = 0; i < (int)(sizeof (pairs) / sizeof (pairs[0])); i++) {
+    for (precision = ORC_COLOR_PRECISION_FAST;
+        precision <= ORC_COLOR_PRECISION_FLOAT; precision++) {
+      time_pair (pairs[i][0], pairs[i][1], precision);
+    }
+  }
+
+  return 0;
+}
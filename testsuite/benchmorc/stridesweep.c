@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <orc/orc.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcarray.h>
+#include <orc-test/orcprofile.h>
+
+/* Sweeps the row stride of 2D programs with several sources and prints
+ * the time per element for each stride, in columns that can be fed to a
+ * plotting tool.  Strides that are a multiple of a large power of two
+ * show up as spikes from 4K aliasing between the arrays and from L1 set
+ * conflicts.  The stride suggested by orc_program_get_stride_padding()
+ * is timed at the end of each sweep. */
+
+#define WIDTH 512
+#define HEIGHT 64
+#define MIN_STRIDE 1024
+#define MAX_STRIDE 8256
+#define STRIDE_STEP 64
+#define N_RUNS 20
+
+static OrcProgram *
+create_add2 (void)
+{
+  OrcProgram *p;
+
+  p = orc_program_new_dss (2, 2, 2);
+  orc_program_set_name (p, "add2");
+  orc_program_set_2d (p);
+  orc_program_append_str (p, "addw", "d1", "s1", "s2");
+
+  return p;
+}
+
+static OrcProgram *
+create_avg4 (void)
+{
+  OrcProgram *p;
+
+  p = orc_program_new ();
+  orc_program_set_name (p, "avg4");
+  orc_program_set_2d (p);
+  orc_program_add_destination (p, 2, "d1");
+  orc_program_add_source (p, 2, "s1");
+  orc_program_add_source (p, 2, "s2");
+  orc_program_add_source (p, 2, "s3");
+  orc_program_add_source (p, 2, "s4");
+  orc_program_add_temporary (p, 2, "t1");
+  orc_program_add_temporary (p, 2, "t2");
+  orc_program_append_str (p, "avguw", "t1", "s1", "s2");
+  orc_program_append_str (p, "avguw", "t2", "s3", "s4");
+  orc_program_append_str (p, "avguw", "d1", "t1", "t2");
+
+  return p;
+}
+
+static int
+count_arrays (OrcProgram *p)
+{
+  int i;
+  int n = 0;
+
+  for (i = ORC_VAR_D1; i <= ORC_VAR_S8; i++) {
+    if (p->vars[i].size) n++;
+  }
+  return n;
+}
+
+/* ticks per element, dest misaligned by dest_misalignment elements */
+static double
+time_stride (OrcProgram *p, int stride, int dest_misalignment)
+{
+  OrcArray *arrays[ORC_VAR_S8 + 1] = { NULL };
+  OrcExecutor *ex;
+  OrcProfile prof;
+  int i, j;
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, WIDTH);
+  orc_executor_set_m (ex, HEIGHT);
+
+  for (i = ORC_VAR_D1; i <= ORC_VAR_S8; i++) {
+    if (p->vars[i].size == 0) continue;
+    arrays[i] = orc_array_new_with_stride (WIDTH, HEIGHT, p->vars[i].size,
+        stride, i == ORC_VAR_D1 ? dest_misalignment : 0, 0);
+    orc_array_set_pattern (arrays[i], 0x5a);
+    orc_executor_set_stride (ex, i, arrays[i]->stride);
+  }
+
+  orc_profile_init (&prof);
+  for (j = 0; j < N_RUNS; j++) {
+    /* 2D code advances the pointers in the executor */
+    for (i = ORC_VAR_D1; i <= ORC_VAR_S8; i++) {
+      if (arrays[i]) orc_executor_set_array (ex, i, arrays[i]->data);
+    }
+    orc_profile_start (&prof);
+    orc_executor_run (ex);
+    orc_profile_stop (&prof);
+  }
+
+  for (i = ORC_VAR_D1; i <= ORC_VAR_S8; i++) {
+    if (arrays[i]) orc_array_free (arrays[i]);
+  }
+  orc_executor_free (ex);
+
+  return (double)prof.min / (WIDTH * HEIGHT);
+}
+
+static void
+sweep (OrcProgram *p)
+{
+  OrcCompileResult result;
+  int stride;
+  int padding;
+
+  result = orc_program_compile (p);
+  if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL (result)) {
+    printf ("# %s: not compiled, timing the fallback\n", p->name);
+  }
+
+  printf ("# %s, %d arrays, %d x %d\n", p->name, count_arrays (p), WIDTH,
+      HEIGHT);
+  printf ("# stride  aligned  misaligned\n");
+  for (stride = MIN_STRIDE; stride <= MAX_STRIDE; stride += STRIDE_STEP) {
+    printf ("%8d %8.3f %8.3f\n", stride, time_stride (p, stride, 0),
+        time_stride (p, stride, 1));
+  }
+
+  padding = orc_program_get_stride_padding (p, ORC_VAR_D1, WIDTH);
+  stride = WIDTH * p->vars[ORC_VAR_D1].size + padding;
+  printf ("# suggested padding %d, stride %d: %.3f\n", padding, stride,
+      time_stride (p, stride, 0));
+  printf ("\n\n");
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram *p;
+
+  orc_test_init ();
+
+  p = create_add2 ();
+  sweep (p);
+  orc_program_free (p);
+
+  p = create_avg4 ();
+  sweep (p);
+  orc_program_free (p);
+
+  return 0;
+}
@@ -6,6 +6,8 @@
 
 #include <orc/orc.h>
 #include <orc-test/orctest.h>
+#include <orc-test/orcarray.h>
+#include <orc-test/orcrandom.h>
 
 #ifndef TARGET
 #define TARGET NULL
@@ -21,6 +23,7 @@ void test_opcode_inplace (OrcStaticOpcode *opcode);
 void test_opcode_src_2d (OrcStaticOpcode *opcode);
 void test_opcode_src_const_n (OrcStaticOpcode *opcode);
 void test_opcode_src_const_n_2d (OrcStaticOpcode *opcode);
+void test_opcode_iterator_misaligned (OrcStaticOpcode *opcode, int is_2d);
 
 static int passed_tests = 0;
 static int total_tests = 0;
@@ -107,6 +110,16 @@ main (int argc, char *argv[])
         opcode_set->opcodes[i].src_size[1]);
     test_opcode_src_const_n_2d (opcode_set->opcodes + i);
   }
+  for(i=0;i<opcode_set->n_opcodes;i++){
+    if (argc == 2 && strcmp(argv[1], opcode_set->opcodes[i].name) != 0)
+      continue;
+    if (verbose) printf("%s iterator misaligned %d,%d\n",
+        opcode_set->opcodes[i].name,
+        opcode_set->opcodes[i].dest_size[0],
+        opcode_set->opcodes[i].src_size[0]);
+    test_opcode_iterator_misaligned (opcode_set->opcodes + i, FALSE);
+    test_opcode_iterator_misaligned (opcode_set->opcodes + i, TRUE);
+  }
 
   printf ("Result: %d/%d tests passed, %f%%", passed_tests, total_tests,
       passed_tests * 100.f / total_tests);
@@ -126,6 +139,12 @@ test_opcode_src (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  /* packed stores write more than the destination size per element;
+   * test_packing covers them */
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -140,6 +159,9 @@ test_opcode_src (OrcStaticOpcode *opcode)
   if (opcode->src_size[1] != 0) {
     orc_program_add_source (p, opcode->src_size[1], "s2");
   }
+  if (opcode->src_size[2] != 0) {
+    orc_program_add_source (p, opcode->src_size[2], "s3");
+  }
 
   if (opcode->flags & ORC_STATIC_OPCODE_FLOAT) {
     flags = ORC_TEST_FLAGS_FLOAT;
@@ -151,7 +173,8 @@ test_opcode_src (OrcStaticOpcode *opcode)
   if (opcode->dest_size[1] != 0) {
     orc_program_append_dds_str (p, opcode->name, "d1", "d2", "s1");
   } else if (opcode->src_size[1] != 0) {
-    orc_program_append_str (p, opcode->name, "d1", "s1", "s2");
+    orc_program_append_str_2 (p, opcode->name, 0, "d1", "s1", "s2",
+        opcode->src_size[2] ? "s3" : NULL);
   } else {
     orc_program_append_str (p, opcode->name, "d1", "s1", NULL);
   }
@@ -365,6 +388,9 @@ test_opcode_inplace (OrcStaticOpcode *opcode)
   if (opcode->src_size[1] != 0) {
     orc_program_add_source (p, opcode->src_size[0], "s2");
   }
+  if (opcode->src_size[2] != 0) {
+    orc_program_add_source (p, opcode->src_size[2], "s3");
+  }
 
   if (opcode->flags & ORC_STATIC_OPCODE_FLOAT) {
     flags = ORC_TEST_FLAGS_FLOAT;
@@ -374,7 +400,8 @@ test_opcode_inplace (OrcStaticOpcode *opcode)
   orc_program_set_name (p, s);
 
   if (opcode->src_size[1] != 0) {
-    orc_program_append_str (p, opcode->name, "d1", "d1", "s2");
+    orc_program_append_str_2 (p, opcode->name, 0, "d1", "d1", "s2",
+        opcode->src_size[2] ? "s3" : NULL);
   } else {
     orc_program_append_str (p, opcode->name, "d1", "d1", NULL);
   }
@@ -410,6 +437,10 @@ test_opcode_src_2d (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -424,6 +455,9 @@ test_opcode_src_2d (OrcStaticOpcode *opcode)
   if (opcode->src_size[1] != 0) {
     orc_program_add_source (p, opcode->src_size[1], "s2");
   }
+  if (opcode->src_size[2] != 0) {
+    orc_program_add_source (p, opcode->src_size[2], "s3");
+  }
 
   if (opcode->flags & ORC_STATIC_OPCODE_FLOAT) {
     flags = ORC_TEST_FLAGS_FLOAT;
@@ -436,7 +470,8 @@ test_opcode_src_2d (OrcStaticOpcode *opcode)
   if (opcode->dest_size[1] != 0) {
     orc_program_append_dds_str (p, opcode->name, "d1", "d2", "s1");
   } else if (opcode->src_size[1] != 0) {
-    orc_program_append_str (p, opcode->name, "d1", "s1", "s2");
+    orc_program_append_str_2 (p, opcode->name, 0, "d1", "s1", "s2",
+        opcode->src_size[2] ? "s3" : NULL);
   } else {
     orc_program_append_str (p, opcode->name, "d1", "s1", NULL);
   }
@@ -472,6 +507,10 @@ test_opcode_src_const_n (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -486,6 +525,9 @@ test_opcode_src_const_n (OrcStaticOpcode *opcode)
   if (opcode->src_size[1] != 0) {
     orc_program_add_source (p, opcode->src_size[1], "s2");
   }
+  if (opcode->src_size[2] != 0) {
+    orc_program_add_source (p, opcode->src_size[2], "s3");
+  }
 
   if (opcode->flags & ORC_STATIC_OPCODE_FLOAT) {
     flags = ORC_TEST_FLAGS_FLOAT;
@@ -498,7 +540,8 @@ test_opcode_src_const_n (OrcStaticOpcode *opcode)
   if (opcode->dest_size[1] != 0) {
     orc_program_append_dds_str (p, opcode->name, "d1", "d2", "s1");
   } else if (opcode->src_size[1] != 0) {
-    orc_program_append_str (p, opcode->name, "d1", "s1", "s2");
+    orc_program_append_str_2 (p, opcode->name, 0, "d1", "s1", "s2",
+        opcode->src_size[2] ? "s3" : NULL);
   } else {
     orc_program_append_str (p, opcode->name, "d1", "s1", NULL);
   }
@@ -534,6 +577,10 @@ test_opcode_src_const_n_2d (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -548,6 +595,9 @@ test_opcode_src_const_n_2d (OrcStaticOpcode *opcode)
   if (opcode->src_size[1] != 0) {
     orc_program_add_source (p, opcode->src_size[1], "s2");
   }
+  if (opcode->src_size[2] != 0) {
+    orc_program_add_source (p, opcode->src_size[2], "s3");
+  }
 
   if (opcode->flags & ORC_STATIC_OPCODE_FLOAT) {
     flags = ORC_TEST_FLAGS_FLOAT;
@@ -561,7 +611,8 @@ test_opcode_src_const_n_2d (OrcStaticOpcode *opcode)
   if (opcode->dest_size[1] != 0) {
     orc_program_append_dds_str (p, opcode->name, "d1", "d2", "s1");
   } else if (opcode->src_size[1] != 0) {
-    orc_program_append_str (p, opcode->name, "d1", "s1", "s2");
+    orc_program_append_str_2 (p, opcode->name, 0, "d1", "s1", "s2",
+        opcode->src_size[2] ? "s3" : NULL);
   } else {
     orc_program_append_str (p, opcode->name, "d1", "s1", NULL);
   }
@@ -586,3 +637,131 @@ test_opcode_src_const_n_2d (OrcStaticOpcode *opcode)
   orc_program_free (p);
 }
 
+
+/* Iterator opcodes read their source at half rate, so the peel that
+ * aligns the destination has to cover an even number of elements.
+ * Sweep the destination misalignment and n so that both the even peel
+ * and the unaligned fallback are exercised. */
+void
+test_opcode_iterator_misaligned (OrcStaticOpcode *opcode, int is_2d)
+{
+  OrcProgram *p;
+  OrcExecutor *ex;
+  OrcCompileResult result;
+  OrcRandomContext context;
+  char s[40];
+  int misalignment;
+  int n;
+  int m;
+  int ret = ORC_TEST_OK;
+
+  if (!(opcode->flags & ORC_STATIC_OPCODE_ITERATOR)) {
+    return;
+  }
+
+  p = orc_program_new ();
+  orc_program_add_destination (p, opcode->dest_size[0], "d1");
+  orc_program_add_destination (p, opcode->dest_size[0], "d2");
+  orc_program_add_source (p, opcode->src_size[0], "s1");
+  orc_program_add_source (p, opcode->dest_size[0], "s2");
+  orc_program_add_temporary (p, opcode->dest_size[0], "t1");
+
+  sprintf(s, "test_iter_%s%s", opcode->name, is_2d ? "_2d" : "");
+  orc_program_set_name (p, s);
+  if (is_2d) {
+    orc_program_set_2d (p);
+  }
+
+  orc_program_append_str (p, opcode->name, "t1", "s1", NULL);
+  orc_program_append_str (p, "copyb", "d1", "t1", NULL);
+  orc_program_append_str (p, "avgub", "d2", "t1", "s2");
+
+  result = orc_program_compile_for_target (p, orc_target_get_by_name (TARGET));
+  total_tests++;
+  if (!ORC_COMPILE_RESULT_IS_SUCCESSFUL (result)) {
+    if (verbose)
+      printf ("    %24s: compiled function:   COMPILE FAILED (%s)\n", p->name,
+          p->error_msg);
+    passed_tests++;
+    orc_program_free (p);
+    return;
+  }
+
+  orc_random_init (&context, 0x12345678);
+  m = is_2d ? 3 : 1;
+
+  ex = orc_executor_new (p);
+  for (misalignment = 0; misalignment < 64 && ret == ORC_TEST_OK;
+      misalignment++) {
+    for (n = 0; n < 100; n += 1 + (n >> 3)) {
+      OrcArray *dest_exec, *dest_emul;
+      OrcArray *dest2_exec, *dest2_emul;
+      OrcArray *src1, *src2;
+
+      dest_exec = orc_array_new (n, m, opcode->dest_size[0], misalignment, 1);
+      dest_emul = orc_array_new (n, m, opcode->dest_size[0], misalignment, 1);
+      dest2_exec = orc_array_new (n, m, opcode->dest_size[0], 0, 0);
+      dest2_emul = orc_array_new (n, m, opcode->dest_size[0], 0, 0);
+      src1 = orc_array_new (n, m, opcode->src_size[0], 3, 0);
+      src2 = orc_array_new (n, m, opcode->dest_size[0], misalignment, 1);
+      orc_array_set_pattern (dest_exec, ORC_OOB_VALUE);
+      orc_array_set_pattern (dest_emul, ORC_OOB_VALUE);
+      orc_array_set_pattern (dest2_exec, ORC_OOB_VALUE);
+      orc_array_set_pattern (dest2_emul, ORC_OOB_VALUE);
+      orc_array_set_random (src1, &context);
+      orc_array_set_random (src2, &context);
+
+      orc_executor_set_n (ex, n);
+      orc_executor_set_m (ex, m);
+      orc_executor_set_array_str (ex, "s1", src1->data);
+      orc_executor_set_stride (ex, ORC_VAR_S1, src1->stride);
+      orc_executor_set_array_str (ex, "s2", src2->data);
+      orc_executor_set_stride (ex, ORC_VAR_S2, src2->stride);
+
+      orc_executor_set_array_str (ex, "d1", dest_exec->data);
+      orc_executor_set_stride (ex, ORC_VAR_D1, dest_exec->stride);
+      orc_executor_set_array_str (ex, "d2", dest2_exec->data);
+      orc_executor_set_stride (ex, ORC_VAR_D2, dest2_exec->stride);
+      orc_executor_run (ex);
+
+      orc_executor_set_array_str (ex, "s1", src1->data);
+      orc_executor_set_array_str (ex, "s2", src2->data);
+      orc_executor_set_array_str (ex, "d1", dest_emul->data);
+      orc_executor_set_stride (ex, ORC_VAR_D1, dest_emul->stride);
+      orc_executor_set_array_str (ex, "d2", dest2_emul->data);
+      orc_executor_set_stride (ex, ORC_VAR_D2, dest2_emul->stride);
+      orc_executor_emulate (ex);
+
+      if (!orc_array_compare (dest_exec, dest_emul, 0) ||
+          !orc_array_compare (dest2_exec, dest2_emul, 0) ||
+          !orc_array_check_out_of_bounds (dest_exec) ||
+          !orc_array_check_out_of_bounds (dest2_exec)) {
+        printf ("    %24s: misalignment %d n %d m %d\n", p->name,
+            misalignment, n, m);
+        ret = ORC_TEST_FAILED;
+      }
+
+      orc_array_free (dest_exec);
+      orc_array_free (dest_emul);
+      orc_array_free (dest2_exec);
+      orc_array_free (dest2_emul);
+      orc_array_free (src1);
+      orc_array_free (src2);
+
+      if (ret != ORC_TEST_OK)
+        break;
+    }
+  }
+  orc_executor_free (ex);
+
+  if (ret != ORC_TEST_OK) {
+    error = TRUE;
+    printf ("    %24s: compiled function:   FAILED\n", p->name);
+  } else {
+    if (verbose)
+      printf ("    %24s: compiled function:   PASSED\n", p->name);
+    passed_tests++;
+  }
+
+  orc_program_free (p);
+}
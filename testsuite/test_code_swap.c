@@ -0,0 +1,137 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <orc-test/orctest.h>
+
+#ifdef HAVE_THREAD_PTHREAD
+#include <pthread.h>
+#endif
+
+#define N 1000
+#define N_REPLACE 200
+
+static volatile int error = FALSE;
+static volatile int done = FALSE;
+
+static OrcProgram *
+new_program (const char *name, unsigned int flags)
+{
+  OrcProgram *p;
+  OrcTarget *target;
+
+  p = orc_program_new_ds (2, 2);
+  orc_program_set_name (p, name);
+  orc_program_add_constant (p, 2, 3, "c1");
+  orc_program_add_temporary (p, 2, "t1");
+  orc_program_append_str (p, "addw", "t1", "s1", "c1");
+  orc_program_append_str (p, "mullw", "d1", "t1", "t1");
+  target = orc_target_get_default ();
+  orc_program_compile_full (p, target,
+      orc_target_get_default_flags (target) | flags);
+
+  return p;
+}
+
+static void
+check_run (OrcProgram *p)
+{
+  OrcExecutor *ex;
+  orc_int16 src[N], dest[N];
+  int i;
+
+  for (i = 0; i < N; i++) src[i] = i;
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, N);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_run (ex);
+  orc_executor_free (ex);
+
+  for (i = 0; i < N; i++) {
+    if (dest[i] != (orc_int16)((i + 3) * (i + 3))) {
+      printf ("%s: dest[%d] is %d, expected %d\n", p->name, i, dest[i],
+          (orc_int16)((i + 3) * (i + 3)));
+      error = TRUE;
+      return;
+    }
+  }
+}
+
+static void
+replace (OrcProgram *p)
+{
+  OrcProgram *q;
+
+  q = new_program ("replacement", ORC_TARGET_PRIVATE_CODE);
+  orc_program_replace_code (p, orc_program_take_code (q));
+  orc_program_free (q);
+}
+
+#ifdef HAVE_THREAD_PTHREAD
+static void *
+run_thread (void *data)
+{
+  while (!done && !error) {
+    check_run (data);
+  }
+  return NULL;
+}
+#endif
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram *a, *b;
+  int i;
+
+  orc_init ();
+
+  a = new_program ("swap_a", 0);
+  if (a->code_exec == (void *)orc_executor_emulate) {
+    /* nothing compiled, nothing to replace */
+    orc_program_free (a);
+    return 0;
+  }
+
+  /* the program runs the new code */
+  check_run (a);
+  replace (a);
+  check_run (a);
+
+  /* programs sharing the code switch together */
+  b = new_program ("swap_b", 0);
+  replace (a);
+  check_run (b);
+  orc_program_free (b);
+
+  /* while another thread keeps running the program */
+#ifdef HAVE_THREAD_PTHREAD
+  {
+    pthread_t thread;
+
+    pthread_create (&thread, NULL, run_thread, a);
+    for (i = 0; i < N_REPLACE && !error; i++) {
+      replace (a);
+    }
+    done = TRUE;
+    pthread_join (thread, NULL);
+  }
+#else
+  for (i = 0; i < N_REPLACE && !error; i++) {
+    replace (a);
+    check_run (a);
+  }
+#endif
+  check_run (a);
+  orc_program_free (a);
+
+  if (error) return 1;
+  return 0;
+}
+
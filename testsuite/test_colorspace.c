@@ -0,0 +1,335 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <orc/orc.h>
+#include <orc-test/orctest.h>
+
+/* Converts random images with every supported pair of formats and
+ * compares the result with a double precision conversion. */
+
+#define WIDTH 34
+#define HEIGHT 6
+
+typedef struct {
+  int is_yuv;
+  int n_planes;
+  int bytes;
+  int depth;
+  int h_shift;
+  int v_shift;
+  int alpha;
+  int pos[3];
+} Format;
+
+static const Format formats[ORC_COLOR_FORMAT_N_FORMATS] = {
+  { 1, 1, 1, 8, 0, 0, 0, { 1, 2, 3 } },         /* AYUV */
+  { 1, 1, 2, 16, 0, 0, 0, { 1, 2, 3 } },        /* AYUV64 */
+  { 1, 3, 1, 8, 0, 0, -1, { 0, 1, 2 } },        /* Y444 */
+  { 1, 3, 1, 8, 1, 0, -1, { 0, 1, 2 } },        /* Y42B */
+  { 1, 3, 1, 8, 1, 1, -1, { 0, 1, 2 } },        /* I420 */
+  { 1, 3, 2, 10, 0, 0, -1, { 0, 1, 2 } },       /* Y444_10 */
+  { 1, 3, 2, 10, 1, 0, -1, { 0, 1, 2 } },       /* I422_10 */
+  { 1, 3, 2, 10, 1, 1, -1, { 0, 1, 2 } },       /* I420_10 */
+  { 1, 3, 2, 16, 0, 0, -1, { 0, 1, 2 } },       /* Y444_16 */
+  { 0, 1, 1, 8, 0, 0, 0, { 1, 2, 3 } },         /* ARGB */
+  { 0, 1, 1, 8, 0, 0, 3, { 2, 1, 0 } },         /* BGRA */
+  { 0, 1, 1, 8, 0, 0, 3, { 0, 1, 2 } },         /* RGBA */
+  { 0, 1, 1, 8, 0, 0, 0, { 3, 2, 1 } },         /* ABGR */
+  { 0, 1, 2, 16, 0, 0, 0, { 1, 2, 3 } },        /* ARGB64 */
+  { 0, 3, 1, 8, 0, 0, -1, { 2, 0, 1 } },        /* GBR */
+  { 0, 3, 2, 10, 0, 0, -1, { 2, 0, 1 } },       /* GBR_10 */
+  { 0, 3, 2, 16, 0, 0, -1, { 2, 0, 1 } },       /* GBR_16 */
+};
+
+typedef struct {
+  orc_uint8 *planes[3];
+  int stride[3];
+} Image;
+
+static int error = FALSE;
+static int verbose = FALSE;
+
+static orc_uint8 *
+get_address (const Format *f, Image *image, int c, int x, int y)
+{
+  int plane = 0;
+
+  if (f->n_planes == 1) {
+    x = x * 4 + (c == 3 ? f->alpha : f->pos[c]);
+  } else {
+    plane = f->pos[c];
+    if (f->is_yuv && c > 0) {
+      x >>= f->h_shift;
+      y >>= f->v_shift;
+    }
+  }
+  return image->planes[plane] + y * image->stride[plane] + x * f->bytes;
+}
+
+static int
+get_sample (const Format *f, Image *image, int c, int x, int y)
+{
+  orc_uint8 *ptr = get_address (f, image, c, x, y);
+
+  if (f->bytes == 1) return *ptr;
+  return *(orc_uint16 *)ptr;
+}
+
+static void
+image_init (Image *image, const Format *f)
+{
+  int i;
+
+  for (i = 0; i < f->n_planes; i++) {
+    image->stride[i] = (f->n_planes == 1 ? 4 : 1) * f->bytes * WIDTH + 16;
+    image->planes[i] = malloc (image->stride[i] * HEIGHT);
+  }
+}
+
+static void
+image_fill (Image *image, const Format *f)
+{
+  int i, j;
+
+  for (i = 0; i < f->n_planes; i++) {
+    for (j = 0; j < image->stride[i] * HEIGHT; j += f->bytes) {
+      if (f->bytes == 1) {
+        image->planes[i][j] = rand ();
+      } else {
+        *(orc_uint16 *)(image->planes[i] + j) = rand () & ((1 << f->depth) - 1);
+      }
+    }
+  }
+}
+
+static void
+image_free (Image *image, const Format *f)
+{
+  int i;
+
+  for (i = 0; i < f->n_planes; i++) free (image->planes[i]);
+}
+
+/* offsets and scales of Y, U, V */
+static void
+get_yuv_scale (const Format *yuv, OrcColorRange range, double offset[3],
+    double scale[3])
+{
+  double k = 1 << (yuv->depth - 8);
+
+  if (range == ORC_COLOR_RANGE_LIMITED) {
+    offset[0] = 16 * k;
+    scale[0] = 219 * k;
+    scale[1] = scale[2] = 224 * k;
+  } else {
+    offset[0] = 0;
+    scale[0] = scale[1] = scale[2] = (1 << yuv->depth) - 1;
+  }
+  offset[1] = offset[2] = 128 * k;
+}
+
+/* the expected value of component c of the output at x, y */
+static double
+reference (const Format *in, Image *src, const Format *out, int c, int x,
+    int y, OrcColorMatrix matrix, OrcColorRange range)
+{
+  static const double kr_kb[][2] = {
+    { 0.299, 0.114 }, { 0.2126, 0.0722 }, { 0.2627, 0.0593 }
+  };
+  double kr = kr_kb[matrix][0];
+  double kb = kr_kb[matrix][1];
+  double kg = 1 - kr - kb;
+  double offset[3], scale[3];
+  double out_max = (1 << out->depth) - 1;
+  double v;
+
+  if (c == 3) {
+    if (in->alpha < 0) return out_max;
+    v = get_sample (in, src, 3, x, y);
+    return v * out_max / ((1 << in->depth) - 1);
+  }
+
+  if (in->is_yuv) {
+    double yy, pb, pr;
+
+    get_yuv_scale (in, range, offset, scale);
+    yy = (get_sample (in, src, 0, x, y) - offset[0]) / scale[0];
+    pb = (get_sample (in, src, 1, x, y) - offset[1]) / scale[1];
+    pr = (get_sample (in, src, 2, x, y) - offset[2]) / scale[2];
+    switch (c) {
+      case 0:
+        v = yy + 2 * (1 - kr) * pr;
+        break;
+      case 1:
+        v = yy - 2 * kb * (1 - kb) / kg * pb - 2 * kr * (1 - kr) / kg * pr;
+        break;
+      default:
+        v = yy + 2 * (1 - kb) * pb;
+        break;
+    }
+    return v * out_max;
+  } else {
+    double rgb[3] = { 0, 0, 0 };
+    double in_max = (1 << in->depth) - 1;
+    double yy;
+    int w = 1, h = 1;
+    int i, j, k;
+
+    /* chroma is the average of the pixels it covers */
+    if (c > 0) {
+      w = 1 << out->h_shift;
+      h = 1 << out->v_shift;
+      x &= ~(w - 1);
+      y &= ~(h - 1);
+    }
+    for (j = 0; j < h; j++) {
+      for (i = 0; i < w; i++) {
+        for (k = 0; k < 3; k++) {
+          rgb[k] += get_sample (in, src, k, x + i, y + j) / in_max / (w * h);
+        }
+      }
+    }
+
+    get_yuv_scale (out, range, offset, scale);
+    yy = kr * rgb[0] + kg * rgb[1] + kb * rgb[2];
+    switch (c) {
+      case 0:
+        v = yy;
+        break;
+      case 1:
+        v = (rgb[2] - yy) / (2 * (1 - kb));
+        break;
+      default:
+        v = (rgb[0] - yy) / (2 * (1 - kr));
+        break;
+    }
+    return v * scale[c] + offset[c];
+  }
+}
+
+/* largest error allowed, in units of the output */
+static int
+get_tolerance (const Format *out, OrcColorPrecision precision)
+{
+  switch (precision) {
+    case ORC_COLOR_PRECISION_FAST:
+      return 2;
+    case ORC_COLOR_PRECISION_EXACT:
+      return out->depth == 16 ? 16 : 1;
+    default:
+      return 1;
+  }
+}
+
+static void
+test_conversion (OrcColorFormat in_format, OrcColorFormat out_format,
+    OrcColorMatrix matrix, OrcColorRange range, OrcColorPrecision precision)
+{
+  const Format *in = formats + in_format;
+  const Format *out = formats + out_format;
+  const Format *yuv = in->is_yuv ? in : out;
+  const Format *rgb = in->is_yuv ? out : in;
+  OrcColorConverter *conv;
+  Image src, dest;
+  int max_error = 0;
+  int tolerance;
+  int x, y, c;
+
+  conv = orc_color_converter_new (in_format, out_format, matrix, range,
+      precision);
+  if (conv == NULL) {
+    if (!(yuv->h_shift && rgb->n_planes == 1 && rgb->bytes == 2)) {
+      printf ("%s to %s: no converter\n", orc_color_format_get_name (in_format),
+          orc_color_format_get_name (out_format));
+      error = TRUE;
+    }
+    return;
+  }
+  precision = orc_color_converter_get_precision (conv);
+  tolerance = get_tolerance (out, precision);
+
+  image_init (&src, in);
+  image_init (&dest, out);
+  image_fill (&src, in);
+
+  if (!orc_color_converter_convert (conv, (void **)dest.planes, dest.stride,
+          (const void **)src.planes, src.stride, WIDTH, HEIGHT)) {
+    printf ("%s to %s: conversion failed\n",
+        orc_color_format_get_name (in_format),
+        orc_color_format_get_name (out_format));
+    error = TRUE;
+  }
+
+  for (y = 0; y < HEIGHT; y++) {
+    for (x = 0; x < WIDTH; x++) {
+      for (c = 0; c < 4; c++) {
+        double expected;
+        int e;
+
+        if (c == 3 && out->alpha < 0) continue;
+        expected = reference (in, &src, out, c, x, y, matrix, range);
+        expected = floor (expected + 0.5);
+        if (expected < 0) expected = 0;
+        if (expected > (1 << out->depth) - 1) expected = (1 << out->depth) - 1;
+        e = abs ((int)expected - get_sample (out, &dest, c, x, y));
+        if (e > max_error) max_error = e;
+        if (e > tolerance && !error) {
+          printf ("%s to %s, matrix %d, range %d, precision %d: "
+              "component %d at %d,%d is %d, expected %g\n",
+              orc_color_format_get_name (in_format),
+              orc_color_format_get_name (out_format), matrix, range,
+              precision, c, x, y, get_sample (out, &dest, c, x, y), expected);
+          error = TRUE;
+        }
+      }
+    }
+  }
+
+  if (verbose) {
+    printf ("%-8s to %-8s matrix %d range %d precision %d: max error %d\n",
+        orc_color_format_get_name (in_format),
+        orc_color_format_get_name (out_format), matrix, range, precision,
+        max_error);
+  }
+
+  image_free (&src, in);
+  image_free (&dest, out);
+  orc_color_converter_free (conv);
+}
+
+int
+main (int argc, char *argv[])
+{
+  int in, out, matrix, range, precision;
+
+  orc_test_init ();
+
+  if (argc > 1 && strcmp (argv[1], "-v") == 0) verbose = TRUE;
+
+  srand (1);
+  for (in = 0; in < ORC_COLOR_FORMAT_N_FORMATS; in++) {
+    for (out = 0; out < ORC_COLOR_FORMAT_N_FORMATS; out++) {
+      if (formats[in].is_yuv == formats[out].is_yuv) continue;
+      for (matrix = ORC_COLOR_MATRIX_BT601; matrix <= ORC_COLOR_MATRIX_BT2020;
+          matrix++) {
+        for (range = ORC_COLOR_RANGE_LIMITED; range <= ORC_COLOR_RANGE_FULL;
+            range++) {
+          for (precision = ORC_COLOR_PRECISION_FAST;
+              precision <= ORC_COLOR_PRECISION_FLOAT; precision++) {
+            test_conversion (in, out, matrix, range, precision);
+          }
+        }
+      }
+    }
+  }
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,132 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcrandom.h>
+
+#define M 3
+
+static int error = FALSE;
+static OrcRandomContext rand_context;
+
+static void
+test_crc_values (void)
+{
+  /* the standard CRC-32C check value */
+  const char *check = "123456789";
+  orc_uint32 crc;
+
+  crc = orc_crc32c (0, (const orc_uint8 *)check, 9);
+  crc ^= orc_crc32c_combine (0xffffffff, 0xffffffff, 9);
+  if (crc != 0xe3069283) {
+    printf ("crc32c check value: got 0x%08x\n", crc);
+    error = TRUE;
+  }
+
+  crc = orc_crc32c_combine (orc_crc32c (0, (const orc_uint8 *)check, 4),
+      orc_crc32c (0, (const orc_uint8 *)check + 4, 5), 5);
+  if (crc != orc_crc32c (0, (const orc_uint8 *)check, 9)) {
+    printf ("crc32c combine: got 0x%08x\n", crc);
+    error = TRUE;
+  }
+}
+
+/* copies s1 to d1 and checksums what was stored; with chunk set the
+ * program is run in parts of that many rows or elements */
+static void
+test_crc (const char *opcode, int size, int n, int is_2d, int chunk)
+{
+  static const char *copies[] = { NULL, "copyb", "copyw", NULL, "copyl",
+    NULL, NULL, NULL, "copyq" };
+  const char *copy = copies[size];
+  const int m = is_2d ? M : 1;
+  const int stride = n * size + 8;
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint8 *src, *dest;
+  orc_uint32 crc, ref;
+  char name[64];
+  int j;
+
+  p = orc_program_new ();
+  sprintf (name, "test_%s_%d%s_%d", opcode, n, is_2d ? "_2d" : "", chunk);
+  orc_program_set_name (p, name);
+  if (is_2d) orc_program_set_2d (p);
+  orc_program_add_destination (p, size, "d1");
+  orc_program_add_source (p, size, "s1");
+  orc_program_add_accumulator (p, 4, "a1");
+  orc_program_add_temporary (p, size, "t1");
+  orc_program_append_ds_str (p, copy, "t1", "s1");
+  orc_program_append_ds_str (p, copy, "d1", "t1");
+  orc_program_append_ds_str (p, opcode, "a1", "t1");
+  orc_program_compile (p);
+
+  src = malloc (stride * m);
+  dest = malloc (stride * m);
+  orc_random_bits (&rand_context, src, stride * m);
+  memset (dest, 0, stride * m);
+
+  ref = 0;
+  for (j = 0; j < m; j++) {
+    ref = orc_crc32c (ref, src + j * stride, n * size);
+  }
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  if (is_2d) {
+    orc_executor_set_m (ex, m);
+    orc_executor_set_stride (ex, ORC_VAR_D1, stride);
+    orc_executor_set_stride (ex, ORC_VAR_S1, stride);
+  }
+  if (chunk) {
+    while (orc_executor_run_partial (ex, chunk) > 0);
+  } else {
+    orc_executor_run (ex);
+  }
+  crc = orc_executor_get_accumulator (ex, ORC_VAR_A1);
+
+  if (crc != ref) {
+    printf ("%s: got 0x%08x, expected 0x%08x\n", name, crc, ref);
+    error = TRUE;
+  }
+
+  orc_executor_free (ex);
+  free (src);
+  free (dest);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const char *opcodes[] = { "acccrc32cb", "acccrc32cw",
+    "acccrc32cl", "acccrc32cq" };
+  static const int ns[] = { 1, 7, 15, 16, 17, 31, 32, 33, 64, 101, 1000 };
+  int i, j;
+
+  orc_init();
+  orc_test_init();
+  orc_random_init (&rand_context, 0x2a);
+
+  test_crc_values ();
+
+  for(i=0;i<4;i++){
+    for(j=0;j<(int)(sizeof(ns)/sizeof(ns[0]));j++){
+      test_crc (opcodes[i], 1 << i, ns[j], FALSE, 0);
+      test_crc (opcodes[i], 1 << i, ns[j], TRUE, 0);
+      test_crc (opcodes[i], 1 << i, ns[j], FALSE, 40);
+      test_crc (opcodes[i], 1 << i, ns[j], TRUE, 1);
+    }
+  }
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,144 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcrandom.h>
+
+#define M 3
+
+static int error = FALSE;
+static OrcRandomContext rand_context;
+
+static orc_uint64
+table_word (const orc_uint8 *table)
+{
+  orc_uint64 w = 0;
+  int k;
+
+  for (k = 0; k < 8; k++) {
+    w |= (orc_uint64)table[k] << (k * 8);
+  }
+  return w;
+}
+
+/* with wide set the table has 32 entries and is looked up in two halves:
+ * lut16b gives 0 past the end, so the two results can be or'ed together */
+static void
+test_lut (int n, int is_2d, int use_const, int wide)
+{
+  const int m = is_2d ? M : 1;
+  const int stride = n + 5;
+  const int n_entries = wide ? 32 : 16;
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint8 table[32];
+  orc_uint8 *src, *dest, *ref;
+  char name[64];
+  int d1, s1, t[4];
+  int i, j;
+
+  orc_random_bits (&rand_context, table, sizeof (table));
+
+  p = orc_program_new ();
+  sprintf (name, "test_lut16b_%d%s%s%s", n, is_2d ? "_2d" : "",
+      use_const ? "_const" : "", wide ? "_wide" : "");
+  orc_program_set_name (p, name);
+  if (is_2d) orc_program_set_2d (p);
+  d1 = orc_program_add_destination (p, 1, "d1");
+  s1 = orc_program_add_source (p, 1, "s1");
+  for (i = 0; i < n_entries / 8; i++) {
+    char tname[8];
+
+    sprintf (tname, "t%d", i);
+    if (use_const) {
+      t[i] = orc_program_add_constant_int64 (p, 8,
+          table_word (table + i * 8), tname);
+    } else {
+      t[i] = orc_program_add_parameter_int64 (p, 8, tname);
+    }
+  }
+  if (wide) {
+    const int c16 = orc_program_add_constant (p, 1, 16, "c16");
+    const int x1 = orc_program_add_temporary (p, 1, "x1");
+    const int x2 = orc_program_add_temporary (p, 1, "x2");
+    const int x3 = orc_program_add_temporary (p, 1, "x3");
+
+    orc_program_append_2 (p, "lut16b", 0, x1, s1, t[0], t[1]);
+    orc_program_append_2 (p, "subb", 0, x2, s1, c16, -1);
+    orc_program_append_2 (p, "lut16b", 0, x3, x2, t[2], t[3]);
+    orc_program_append_2 (p, "orb", 0, d1, x1, x3, -1);
+  } else {
+    orc_program_append_2 (p, "lut16b", 0, d1, s1, t[0], t[1]);
+  }
+  orc_program_compile (p);
+
+  src = malloc (stride * m);
+  dest = malloc (stride * m);
+  ref = malloc (stride * m);
+  orc_random_bits (&rand_context, src, stride * m);
+  memset (dest, 0xa5, stride * m);
+  memset (ref, 0xa5, stride * m);
+
+  for (j = 0; j < m; j++) {
+    for (i = 0; i < n; i++) {
+      const int idx = src[j * stride + i];
+      ref[j * stride + i] = (idx < n_entries) ? table[idx] : 0;
+    }
+  }
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  if (!use_const) {
+    for (i = 0; i < n_entries / 8; i++) {
+      orc_executor_set_param_int64 (ex, ORC_VAR_P1 + i,
+          table_word (table + i * 8));
+    }
+  }
+  if (is_2d) {
+    orc_executor_set_m (ex, m);
+    orc_executor_set_stride (ex, ORC_VAR_D1, stride);
+    orc_executor_set_stride (ex, ORC_VAR_S1, stride);
+  }
+  orc_executor_run (ex);
+
+  if (memcmp (dest, ref, stride * m) != 0) {
+    printf ("%s: mismatch\n", name);
+    error = TRUE;
+  }
+
+  orc_executor_free (ex);
+  free (src);
+  free (dest);
+  free (ref);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const int ns[] = { 1, 7, 15, 16, 17, 31, 32, 33, 64, 101, 1000 };
+  int j;
+
+  orc_init();
+  orc_test_init();
+  orc_random_init (&rand_context, 0x2a);
+
+  for(j=0;j<(int)(sizeof(ns)/sizeof(ns[0]));j++){
+    test_lut (ns[j], FALSE, FALSE, FALSE);
+    test_lut (ns[j], TRUE, FALSE, FALSE);
+    test_lut (ns[j], FALSE, TRUE, FALSE);
+    test_lut (ns[j], FALSE, FALSE, TRUE);
+    test_lut (ns[j], TRUE, TRUE, TRUE);
+  }
+
+  if (error) return 1;
+  return 0;
+}
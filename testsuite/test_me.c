@@ -0,0 +1,145 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcrandom.h>
+
+static int error = FALSE;
+static OrcRandomContext rand_context;
+
+/* each element is one 8x1 block compared against its reference block */
+static void
+test_sad (int n)
+{
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint8 *src, *ref_block;
+  orc_uint64 *dest, *ref;
+  char name[64];
+  int i, k;
+
+  p = orc_program_new ();
+  sprintf (name, "test_sadubq_%d", n);
+  orc_program_set_name (p, name);
+  orc_program_add_destination (p, 8, "d1");
+  orc_program_add_source (p, 8, "s1");
+  orc_program_add_source (p, 8, "s2");
+  orc_program_append_str (p, "sadubq", "d1", "s1", "s2");
+  orc_program_compile (p);
+
+  src = malloc (n * 8);
+  ref_block = malloc (n * 8);
+  dest = malloc (n * 8);
+  ref = malloc (n * 8);
+  orc_random_bits (&rand_context, src, n * 8);
+  orc_random_bits (&rand_context, ref_block, n * 8);
+  memset (dest, 0xa5, n * 8);
+
+  for (i = 0; i < n; i++) {
+    ref[i] = 0;
+    for (k = 0; k < 8; k++) {
+      ref[i] += abs (src[i * 8 + k] - ref_block[i * 8 + k]);
+    }
+  }
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_set_array (ex, ORC_VAR_S2, ref_block);
+  orc_executor_run (ex);
+
+  if (memcmp (dest, ref, n * 8) != 0) {
+    printf ("%s: mismatch\n", name);
+    error = TRUE;
+  }
+
+  orc_executor_free (ex);
+  free (src);
+  free (ref_block);
+  free (dest);
+  free (ref);
+  orc_program_free (p);
+}
+
+/* with few_values set the words are drawn from a tiny range so that
+ * ties are common and the lowest index has to win */
+static void
+test_minpos (int n, int few_values)
+{
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint16 *src;
+  orc_uint32 *dest, *ref;
+  char name[64];
+  int i, k;
+
+  p = orc_program_new ();
+  sprintf (name, "test_minposuwl_%d%s", n, few_values ? "_ties" : "");
+  orc_program_set_name (p, name);
+  orc_program_add_destination (p, 4, "d1");
+  orc_program_add_source (p, 8, "s1");
+  orc_program_append_ds_str (p, "minposuwl", "d1", "s1");
+  orc_program_compile (p);
+
+  src = malloc (n * 8);
+  dest = malloc (n * 4);
+  ref = malloc (n * 4);
+  orc_random_bits (&rand_context, src, n * 8);
+  memset (dest, 0xa5, n * 4);
+
+  for (i = 0; i < n; i++) {
+    int m = 0;
+
+    if (few_values) {
+      for (k = 0; k < 4; k++) src[i * 4 + k] &= 3;
+    }
+    for (k = 1; k < 4; k++) {
+      if (src[i * 4 + k] < src[i * 4 + m]) m = k;
+    }
+    ref[i] = src[i * 4 + m] | (m << 16);
+  }
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_run (ex);
+
+  if (memcmp (dest, ref, n * 4) != 0) {
+    printf ("%s: mismatch\n", name);
+    error = TRUE;
+  }
+
+  orc_executor_free (ex);
+  free (src);
+  free (dest);
+  free (ref);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const int ns[] = { 1, 7, 15, 16, 17, 31, 32, 33, 64, 101, 1000 };
+  int j;
+
+  orc_init();
+  orc_test_init();
+  orc_random_init (&rand_context, 0x2a);
+
+  for(j=0;j<(int)(sizeof(ns)/sizeof(ns[0]));j++){
+    test_sad (ns[j]);
+    test_minpos (ns[j], FALSE);
+    test_minpos (ns[j], TRUE);
+  }
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,228 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <orc/orcparse.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+
+#define N 1000
+
+/* Programs whose conversions the width narrowing pass may remove.  Those
+ * marked saturating only narrow when the range shows the saturation never
+ * clamps. */
+static const char *source =
+  /* saturating: the low half of a 32-bit product plus a 16-bit value */
+  ".function narrow_mulll_add\n"
+  ".dest 2 d1\n"
+  ".source 4 s1\n"
+  ".source 4 s2\n"
+  ".source 2 s3\n"
+  ".temp 4 t1\n"
+  ".temp 2 t2\n"
+  ".temp 4 t3\n"
+  ".temp 4 t4\n"
+  ".temp 4 t5\n"
+  "mulll t1, s1, s2\n"
+  "convlw t2, t1\n"
+  "convswl t3, t2\n"
+  "convswl t4, s3\n"
+  "addl t5, t3, t4\n"
+  "convssslw d1, t5\n"
+  /* saturating: an unsigned 16-bit product of small values */
+  ".function narrow_muluwl_sat\n"
+  ".dest 2 d1\n"
+  ".source 1 s1\n"
+  ".source 1 s2\n"
+  ".temp 2 t1\n"
+  ".temp 2 t2\n"
+  ".temp 4 t3\n"
+  "convubw t1, s1\n"
+  "convubw t2, s2\n"
+  "muluwl t3, t1, t2\n"
+  "convuuslw d1, t3\n"
+  /* saturating: a Q15 product */
+  ".function narrow_mulswl_shift\n"
+  ".dest 2 d1\n"
+  ".source 2 s1\n"
+  ".source 2 s2\n"
+  ".temp 4 t1\n"
+  "mulswl t1, s1, s2\n"
+  "shrsl t1, t1, 15\n"
+  "convssslw d1, t1\n"
+  /* saturating: a sum of two 16-bit values */
+  ".function narrow_add_sat\n"
+  ".dest 2 d1\n"
+  ".source 2 s1\n"
+  ".source 2 s2\n"
+  ".temp 4 t1\n"
+  ".temp 4 t2\n"
+  "convswl t1, s1\n"
+  "convswl t2, s2\n"
+  "addl t1, t1, t2\n"
+  "convssslw d1, t1\n"
+  /* saturating: a sum of two 8-bit values */
+  ".function narrow_add_u8_sat\n"
+  ".dest 1 d1\n"
+  ".source 1 s1\n"
+  ".source 1 s2\n"
+  ".temp 2 t1\n"
+  ".temp 2 t2\n"
+  "convubw t1, s1\n"
+  "convubw t2, s2\n"
+  "addw t1, t1, t2\n"
+  "convuuswb d1, t1\n"
+  /* truncating: a 32-bit product */
+  ".function narrow_mulll_trunc\n"
+  ".dest 2 d1\n"
+  ".source 4 s1\n"
+  ".source 4 s2\n"
+  ".temp 4 t1\n"
+  "mulll t1, s1, s2\n"
+  "convlw d1, t1\n";
+
+static int error = FALSE;
+static orc_uint8 arrays[ORC_N_VARIABLES][N * 8];
+static orc_uint8 dest[ORC_N_VARIABLES][N * 8];
+
+static void
+set_element (int var, int size, int i, orc_int64 value)
+{
+  switch (size) {
+    case 1:
+      ((orc_int8 *)arrays[var])[i] = (orc_int8)value;
+      break;
+    case 2:
+      ((orc_int16 *)arrays[var])[i] = (orc_int16)value;
+      break;
+    case 4:
+      ((orc_int32 *)arrays[var])[i] = (orc_int32)value;
+      break;
+    default:
+      ((orc_int64 *)arrays[var])[i] = value;
+      break;
+  }
+}
+
+/* random values, with the extremes of the type at the start */
+static void
+fill_sources (OrcProgram *p)
+{
+  int i, j;
+
+  for (i = ORC_VAR_S1; i <= ORC_VAR_S8; i++) {
+    int size = p->vars[i].size;
+    orc_int64 max;
+
+    if (size == 0) continue;
+    for (j = 0; j < N * 8; j++) arrays[i][j] = rand ();
+
+    max = (orc_int64)(((orc_uint64)1 << (size * 8 - 1)) - 1);
+    set_element (i, size, 0, 0);
+    set_element (i, size, 1, 1);
+    set_element (i, size, 2, -1);
+    set_element (i, size, 3, max);
+    set_element (i, size, 4, -max - 1);
+    set_element (i, size, 5, max >> (size * 4));
+  }
+  /* the narrow_mulll_add case that once lost its saturation */
+  set_element (ORC_VAR_S1, p->vars[ORC_VAR_S1].size, 6, 0x7fff);
+  set_element (ORC_VAR_S2, p->vars[ORC_VAR_S2].size, 6, 1);
+  if (p->vars[ORC_VAR_S3].size)
+    set_element (ORC_VAR_S3, p->vars[ORC_VAR_S3].size, 6, 0x7fff);
+}
+
+static void
+run (OrcProgram *p, int emulate)
+{
+  OrcExecutor *ex;
+  int i;
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, N);
+  for (i = ORC_VAR_S1; i <= ORC_VAR_S8; i++) {
+    if (p->vars[i].size) orc_executor_set_array (ex, i, arrays[i]);
+  }
+  for (i = ORC_VAR_D1; i <= ORC_VAR_D4; i++) {
+    if (p->vars[i].size) {
+      memset (arrays[i], 0, sizeof(arrays[i]));
+      orc_executor_set_array (ex, i, arrays[i]);
+    }
+  }
+  if (emulate) {
+    orc_executor_emulate (ex);
+  } else {
+    orc_executor_run (ex);
+  }
+  orc_executor_free (ex);
+}
+
+/* runs the program as compiled, which narrows, and emulates it as
+ * written, and compares the results */
+static void
+check (OrcProgram *p, OrcProgram *ref)
+{
+  OrcTarget *target = orc_target_get_default ();
+  unsigned int flags = orc_target_get_default_flags (target);
+  int i, j;
+
+  orc_program_compile_full (p, target, flags | ORC_TARGET_PRIVATE_CODE);
+  orc_program_compile_full (ref, target,
+      flags | ORC_TARGET_PRIVATE_CODE | ORC_TARGET_BASELINE);
+  if (p->orccode == NULL || ref->orccode == NULL) {
+    printf ("%s: not compiled\n", p->name);
+    return;
+  }
+
+  fill_sources (p);
+  run (p, FALSE);
+  for (i = ORC_VAR_D1; i <= ORC_VAR_D4; i++) {
+    memcpy (dest[i], arrays[i], sizeof(arrays[i]));
+  }
+  run (ref, TRUE);
+
+  for (i = ORC_VAR_D1; i <= ORC_VAR_D4; i++) {
+    int size = p->vars[i].size;
+
+    for (j = 0; j < N * size; j += size) {
+      if (memcmp (dest[i] + j, arrays[i] + j, size) != 0) {
+        printf ("%s: %s[%d] differs from the program as written\n", p->name,
+            p->vars[i].name, j / size);
+        error = TRUE;
+        break;
+      }
+    }
+  }
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram **programs;
+  OrcProgram **refs;
+  int n;
+  int i;
+
+  orc_init ();
+  orc_test_init ();
+
+  n = orc_parse (source, &programs);
+  if (orc_parse (source, &refs) != n) {
+    printf ("failed to parse the programs\n");
+    return 1;
+  }
+
+  for (i = 0; i < n; i++) {
+    check (programs[i], refs[i]);
+    orc_program_free (programs[i]);
+    orc_program_free (refs[i]);
+  }
+  free (programs);
+  free (refs);
+
+  if (error) return 1;
+  return 0;
+}
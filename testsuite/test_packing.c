@@ -0,0 +1,200 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcrandom.h>
+
+#define M 3
+#define GUARD 16
+
+static int error = FALSE;
+static OrcRandomContext rand_context;
+
+typedef struct {
+  const char *opcode;
+  int bits;          /* bits per sample */
+  int n_samples;     /* samples per element */
+  int packed_size;   /* bytes per element of the packed side */
+  int is_pack;
+} PackingTest;
+
+static const PackingTest tests[] = {
+  { "unpack3x10", 10, 3, 4, FALSE },
+  { "pack3x10", 10, 3, 4, TRUE },
+  { "ldunpack4x10", 10, 4, 5, FALSE },
+  { "stpack4x10", 10, 4, 5, TRUE },
+  { "ldunpack2x12", 12, 2, 3, FALSE },
+  { "stpack2x12", 12, 2, 3, TRUE },
+};
+
+/* samples are packed from the least significant bit of a little endian
+ * group; the v210 word leaves its top two bits zero */
+static void
+pack_ref (const PackingTest *t, orc_uint8 *dest, const orc_uint16 *src, int n)
+{
+  int i, k;
+
+  for (i = 0; i < n; i++) {
+    orc_uint64 g = 0;
+
+    for (k = 0; k < t->n_samples; k++) {
+      g |= (orc_uint64)(src[i * (t->n_samples == 3 ? 4 : t->n_samples) + k] &
+          ((1 << t->bits) - 1)) << (k * t->bits);
+    }
+    for (k = 0; k < t->packed_size; k++) {
+      dest[i * t->packed_size + k] = g >> (k * 8);
+    }
+  }
+}
+
+static void
+unpack_ref (const PackingTest *t, orc_uint16 *dest, const orc_uint8 *src,
+    int n)
+{
+  const int lanes = (t->n_samples == 3) ? 4 : t->n_samples;
+  int i, k;
+
+  for (i = 0; i < n; i++) {
+    orc_uint64 g = 0;
+
+    for (k = 0; k < t->packed_size; k++) {
+      g |= (orc_uint64)src[i * t->packed_size + k] << (k * 8);
+    }
+    for (k = 0; k < lanes; k++) {
+      dest[i * lanes + k] = (k < t->n_samples) ?
+        (g >> (k * t->bits)) & ((1 << t->bits) - 1) : 0;
+    }
+  }
+}
+
+static void
+test_packing (const PackingTest *t, int n, int is_2d, int wide)
+{
+  const int lanes = (t->n_samples == 3) ? 4 : t->n_samples;
+  const int unpacked_size = lanes * 2;
+  /* the ALU opcodes work on whole 32-bit words */
+  const int packed_var_size = (t->packed_size == 4) ? 4 : 1;
+  const int packed_stride = n * t->packed_size + (packed_var_size == 4 ? 4 : 7);
+  const int unpacked_stride = n * unpacked_size + 8;
+  const int m = is_2d ? M : 1;
+  const int src_stride = t->is_pack ? unpacked_stride : packed_stride;
+  const int dest_stride = t->is_pack ? packed_stride : unpacked_stride;
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint8 *src, *dest, *ref;
+  orc_uint64 *wsrc, *wdest;
+  char name[64];
+  int bad = FALSE;
+  int j;
+
+  p = orc_program_new ();
+  sprintf (name, "test_%s_%d%s%s", t->opcode, n, is_2d ? "_2d" : "",
+      wide ? "_wide" : "");
+  orc_program_set_name (p, name);
+  if (is_2d) orc_program_set_2d (p);
+  orc_program_add_destination (p,
+      t->is_pack ? packed_var_size : unpacked_size, "d1");
+  orc_program_add_source (p,
+      t->is_pack ? unpacked_size : packed_var_size, "s1");
+  orc_program_append_str (p, t->opcode, "d1", "s1", NULL);
+  if (wide) {
+    /* a second, wider array lowers the number of elements per loop */
+    orc_program_add_destination (p, 8, "d2");
+    orc_program_add_source (p, 8, "s2");
+    orc_program_append_str (p, "copyq", "d2", "s2", NULL);
+  }
+  orc_program_compile (p);
+
+  src = malloc (src_stride * m);
+  dest = malloc (dest_stride * m + GUARD);
+  ref = malloc (dest_stride * m + GUARD);
+  wsrc = malloc (8 * n * m);
+  wdest = malloc (8 * n * m);
+  orc_random_bits (&rand_context, src, src_stride * m);
+  memset (dest, 0xa5, dest_stride * m + GUARD);
+  memset (ref, 0xa5, dest_stride * m + GUARD);
+  orc_random_bits (&rand_context, wsrc, 8 * n * m);
+
+  for (j = 0; j < m; j++) {
+    if (t->is_pack) {
+      pack_ref (t, ref + j * dest_stride,
+          (orc_uint16 *)(src + j * src_stride), n);
+    } else {
+      unpack_ref (t, (orc_uint16 *)(ref + j * dest_stride),
+          src + j * src_stride, n);
+    }
+  }
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, n);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  if (wide) {
+    orc_executor_set_array (ex, ORC_VAR_D2, wdest);
+    orc_executor_set_array (ex, ORC_VAR_S2, wsrc);
+  }
+  if (is_2d) {
+    orc_executor_set_m (ex, m);
+    orc_executor_set_stride (ex, ORC_VAR_D1, dest_stride);
+    orc_executor_set_stride (ex, ORC_VAR_S1, src_stride);
+    orc_executor_set_stride (ex, ORC_VAR_D2, 8 * n);
+    orc_executor_set_stride (ex, ORC_VAR_S2, 8 * n);
+  }
+  orc_executor_run (ex);
+
+  for (j = 0; j < m; j++) {
+    /* only compare the elements; the row padding must stay untouched */
+    if (memcmp (dest + j * dest_stride, ref + j * dest_stride,
+            t->is_pack ? n * t->packed_size : n * unpacked_size) != 0) {
+      printf ("%s: row %d mismatch\n", name, j);
+      bad = TRUE;
+      break;
+    }
+  }
+  if (!bad && memcmp (dest, ref, dest_stride * m + GUARD) != 0) {
+    printf ("%s: wrote outside the destination\n", name);
+    bad = TRUE;
+  }
+  if (wide && memcmp (wdest, wsrc, 8 * n * m) != 0) {
+    printf ("%s: copy mismatch\n", name);
+    bad = TRUE;
+  }
+  if (bad) error = TRUE;
+
+  orc_executor_free (ex);
+  free (src);
+  free (dest);
+  free (ref);
+  free (wsrc);
+  free (wdest);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const int ns[] = { 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 64, 101, 1000 };
+  int i, j;
+
+  orc_init();
+  orc_test_init();
+  orc_random_init (&rand_context, 0x2a);
+
+  for(i=0;i<(int)(sizeof(tests)/sizeof(tests[0]));i++){
+    for(j=0;j<(int)(sizeof(ns)/sizeof(ns[0]));j++){
+      test_packing (tests + i, ns[j], FALSE, FALSE);
+      test_packing (tests + i, ns[j], TRUE, FALSE);
+      test_packing (tests + i, ns[j], FALSE, TRUE);
+      test_packing (tests + i, ns[j], TRUE, TRUE);
+    }
+  }
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,194 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+#include <orc-test/orcrandom.h>
+
+#define N 1001
+#define M 7
+#define STRIDE ((N + 5) * 2)
+
+static int error = FALSE;
+
+static OrcProgram *
+create_program (int is_2d)
+{
+  OrcProgram *p;
+
+  p = orc_program_new ();
+  orc_program_set_name (p, is_2d ? "partial_2d" : "partial_1d");
+  if (is_2d) orc_program_set_2d (p);
+  orc_program_add_destination (p, 2, "d1");
+  orc_program_add_destination (p, 4, "d2");
+  orc_program_add_source (p, 2, "s1");
+  orc_program_add_parameter (p, 4, "p1");
+  orc_program_add_accumulator (p, 2, "a1");
+  orc_program_add_accumulator (p, 4, "a2");
+  orc_program_add_temporary (p, 4, "t1");
+
+  orc_program_append_str (p, "addw", "d1", "s1", "s1");
+  orc_program_append_str (p, "accw", "a1", "s1", NULL);
+  orc_program_append_ds_str (p, "convuwl", "t1", "s1");
+  orc_program_append_str (p, "accl", "a2", "t1", NULL);
+  orc_program_append_str (p, "randl", "d2", "p1", NULL);
+
+  return p;
+}
+
+static void
+setup_executor (OrcExecutor *ex, int is_2d, void *dest, void *dest2,
+    void *src)
+{
+  orc_executor_set_n (ex, N);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_set_array (ex, ORC_VAR_D2, dest2);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_set_param (ex, ORC_VAR_P1, 0x1234);
+  if (is_2d) {
+    orc_executor_set_m (ex, M);
+    orc_executor_set_stride (ex, ORC_VAR_D1, STRIDE);
+    orc_executor_set_stride (ex, ORC_VAR_D2, STRIDE * 2);
+    orc_executor_set_stride (ex, ORC_VAR_S1, STRIDE);
+  }
+}
+
+static void
+test_partial (int is_2d, int max)
+{
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint16 *src, *dest_ref, *dest;
+  orc_uint32 *dest2_ref, *dest2;
+  int a1, a2;
+  int remaining;
+  int calls = 0;
+  OrcRandomContext rand;
+  int i;
+
+  p = create_program (is_2d);
+  orc_program_compile (p);
+
+  src = malloc (STRIDE * M);
+  dest_ref = malloc (STRIDE * M);
+  dest = malloc (STRIDE * M);
+  dest2_ref = malloc (STRIDE * 2 * M);
+  dest2 = malloc (STRIDE * 2 * M);
+  orc_random_init (&rand, max);
+  orc_random_bits (&rand, src, STRIDE * M);
+  memset (dest_ref, 0, STRIDE * M);
+  memset (dest, 0, STRIDE * M);
+  memset (dest2_ref, 0, STRIDE * 2 * M);
+  memset (dest2, 0, STRIDE * 2 * M);
+
+  ex = orc_executor_new (p);
+  setup_executor (ex, is_2d, dest_ref, dest2_ref, src);
+  orc_executor_run (ex);
+  a1 = orc_executor_get_accumulator (ex, ORC_VAR_A1);
+  a2 = orc_executor_get_accumulator (ex, ORC_VAR_A2);
+
+  /* the second pass checks that a finished run restarts cleanly */
+  for(i=0;i<2;i++){
+    setup_executor (ex, is_2d, dest, dest2, src);
+    do {
+      remaining = orc_executor_run_partial (ex, max);
+      calls++;
+    } while (remaining > 0 && calls < 10000);
+
+    if (remaining != 0 || orc_executor_get_position (ex) != 0) {
+      printf ("%s max %d: run did not finish\n", p->name, max);
+      error = TRUE;
+    }
+    if (memcmp (dest, dest_ref, STRIDE * M) != 0 ||
+        memcmp (dest2, dest2_ref, STRIDE * 2 * M) != 0) {
+      printf ("%s max %d: destination mismatch\n", p->name, max);
+      error = TRUE;
+    }
+    if (orc_executor_get_accumulator (ex, ORC_VAR_A1) != a1 ||
+        orc_executor_get_accumulator (ex, ORC_VAR_A2) != a2) {
+      printf ("%s max %d: accumulator mismatch %d/%d %d/%d\n", p->name, max,
+          orc_executor_get_accumulator (ex, ORC_VAR_A1), a1,
+          orc_executor_get_accumulator (ex, ORC_VAR_A2), a2);
+      error = TRUE;
+    }
+  }
+
+  orc_executor_free (ex);
+  free (src);
+  free (dest_ref);
+  free (dest);
+  free (dest2_ref);
+  free (dest2);
+  orc_program_free (p);
+}
+
+/* loadupdb and ldresnearb read their source at a position scaled from
+ * the element index, which a resumed 1D run can't pick up */
+static void
+test_partial_scaled (const char *opcode)
+{
+  OrcProgram *p;
+  OrcExecutor *ex;
+  orc_uint8 src[N], dest_ref[N], dest[N];
+  int calls = 0;
+  int i;
+
+  p = orc_program_new ();
+  orc_program_set_name (p, opcode);
+  orc_program_add_destination (p, 1, "d1");
+  orc_program_add_source (p, 1, "s1");
+  orc_program_add_parameter (p, 4, "p1");
+  orc_program_add_parameter (p, 4, "p2");
+  orc_program_append_str_2 (p, opcode, 0, "d1", "s1",
+      strcmp (opcode, "loadupdb") == 0 ? NULL : "p1",
+      strcmp (opcode, "loadupdb") == 0 ? NULL : "p2");
+  orc_program_compile (p);
+
+  for(i=0;i<N;i++) src[i] = i * 7;
+  memset (dest_ref, 0, N);
+  memset (dest, 0, N);
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, N);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_set_param (ex, ORC_VAR_P1, 0x8000);
+  orc_executor_set_param (ex, ORC_VAR_P2, 0x6000);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest_ref);
+  orc_executor_run (ex);
+
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  while (orc_executor_run_partial (ex, 64) > 0 && calls < 10000) calls++;
+
+  if (memcmp (dest, dest_ref, N) != 0) {
+    printf ("%s max 64: destination mismatch\n", opcode);
+    error = TRUE;
+  }
+
+  orc_executor_free (ex);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const int maxes[] = { 0, 1, 3, 16, 100, 5000 };
+  int i;
+
+  orc_init();
+  orc_test_init();
+
+  for(i=0;i<(int)(sizeof(maxes)/sizeof(maxes[0]));i++){
+    test_partial (FALSE, maxes[i]);
+    test_partial (TRUE, maxes[i]);
+  }
+  test_partial_scaled ("loadupdb");
+  test_partial_scaled ("ldresnearb");
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,132 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+
+static int error = FALSE;
+
+static OrcProgram *
+new_program (const char *name, const char *opcode, int constant)
+{
+  OrcProgram *p;
+
+  p = orc_program_new_ds (2, 2);
+  orc_program_set_name (p, name);
+  orc_program_add_constant (p, 2, constant, "c1");
+  orc_program_add_temporary (p, 2, "t1");
+  orc_program_append_str (p, opcode, "t1", "s1", "c1");
+  orc_program_append_str (p, "addw", "d1", "t1", "t1");
+  orc_program_compile (p);
+
+  return p;
+}
+
+static void
+check_run (OrcProgram *p, int expected)
+{
+  OrcExecutor *ex;
+  orc_int16 src[100], dest[100];
+  int i;
+
+  for (i = 0; i < 100; i++) src[i] = i;
+
+  ex = orc_executor_new (p);
+  orc_executor_set_n (ex, 100);
+  orc_executor_set_array (ex, ORC_VAR_S1, src);
+  orc_executor_set_array (ex, ORC_VAR_D1, dest);
+  orc_executor_run (ex);
+  orc_executor_free (ex);
+
+  for (i = 0; i < 100; i++) {
+    if (dest[i] != (orc_int16)(2 * (i + expected))) {
+      printf ("%s: dest[%d] is %d, expected %d\n", p->name, i, dest[i],
+          2 * (i + expected));
+      error = TRUE;
+      return;
+    }
+  }
+}
+
+static void
+check_shared (OrcProgram *p1, OrcProgram *p2, int shared)
+{
+  if ((p1->orccode == p2->orccode) != shared) {
+    printf ("%s and %s: code is %s, expected %s\n", p1->name, p2->name,
+        p1->orccode == p2->orccode ? "shared" : "not shared",
+        shared ? "shared" : "not shared");
+    error = TRUE;
+  }
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcTarget *target;
+  OrcProgram *a, *b, *c, *d, *e;
+
+  orc_init ();
+
+  a = new_program ("add_a", "addw", 3);
+  if (a->code_exec == (void *)orc_executor_emulate) {
+    /* nothing compiled, nothing to share */
+    orc_program_free (a);
+    return 0;
+  }
+
+  /* only the name differs */
+  b = new_program ("add_b", "addw", 3);
+  check_shared (a, b, TRUE);
+  if (orc_program_get_asm_code (b) == NULL ||
+      strcmp (orc_program_get_asm_code (a),
+        orc_program_get_asm_code (b)) != 0) {
+    printf ("add_b: assembly code not shared\n");
+    error = TRUE;
+  }
+  c = new_program ("add_c", "addw", 4);
+  check_shared (a, c, FALSE);
+  d = new_program ("sub_d", "subw", 3);
+  check_shared (a, d, FALSE);
+
+  /* the code stays valid while any program uses it */
+  orc_program_free (a);
+  check_run (b, 3);
+  check_run (c, 4);
+  check_run (d, -3);
+  orc_program_free (b);
+
+  /* a program compiled after all users are gone gets new code */
+  a = new_program ("add_a", "addw", 3);
+  check_run (a, 3);
+
+  /* private code is never shared */
+  e = orc_program_new_ds (2, 2);
+  orc_program_set_name (e, "add_e");
+  orc_program_add_constant (e, 2, 3, "c1");
+  orc_program_add_temporary (e, 2, "t1");
+  orc_program_append_str (e, "addw", "t1", "s1", "c1");
+  orc_program_append_str (e, "addw", "d1", "t1", "t1");
+  target = orc_target_get_default ();
+  orc_program_compile_full (e, target,
+      orc_target_get_default_flags (target) | ORC_TARGET_PRIVATE_CODE);
+  check_shared (a, e, FALSE);
+  if (orc_program_get_asm_code (e) == NULL) {
+    printf ("add_e: no assembly code\n");
+    error = TRUE;
+  }
+  check_run (e, 3);
+
+  orc_program_free (a);
+  orc_program_free (c);
+  orc_program_free (d);
+  orc_program_free (e);
+
+  if (error) return 1;
+  return 0;
+}
+
@@ -0,0 +1,98 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#define ORC_ENABLE_UNSTABLE_API
+#include <orc/orc.h>
+#include <orc/orcbytecode.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <orc-test/orctest.h>
+
+static int error = FALSE;
+
+static const char *source =
+  ".function stats_add_shift\n"
+  ".dest 2 d1\n"
+  ".source 2 s1\n"
+  ".source 2 s2\n"
+  ".temp 2 t1\n"
+  "addw t1, s1, s2\n"
+  "shrsw d1, t1, 1\n";
+
+static void
+check (int condition, const char *what)
+{
+  if (!condition) {
+    printf ("%s\n", what);
+    error = TRUE;
+  }
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram **programs;
+  OrcProgram *p;
+  OrcBytecode *bytecode;
+  int i;
+
+  orc_init ();
+  orc_stats_reset ();
+
+  for (i = 0; i < ORC_STATS_N_PHASES; i++) {
+    check (orc_stats_get_phase_count (i) == 0,
+        "phase counted before anything happened");
+    check (orc_stats_get_phase_name (i) != NULL, "phase without a name");
+  }
+  check (orc_stats_get_phase_count (ORC_STATS_N_PHASES) == 0 &&
+      orc_stats_get_phase_name (ORC_STATS_N_PHASES) == NULL,
+      "unknown phase accepted");
+  check (orc_stats_get_counter (ORC_STATS_COUNTER_PROGRAMS) == 0,
+      "program counted before compiling");
+
+  check (orc_parse (source, &programs) == 1, "source didn't parse");
+  check (orc_stats_get_phase_count (ORC_STATS_PHASE_PARSE) == 1,
+      "parse not counted");
+
+  /* the copy made through the bytecode is compiled */
+  bytecode = orc_bytecode_from_program (programs[0]);
+  p = orc_program_new ();
+  orc_bytecode_parse_function (p, bytecode->bytecode);
+  orc_bytecode_free (bytecode);
+  orc_program_free (programs[0]);
+  free (programs);
+  check (orc_stats_get_phase_count (ORC_STATS_PHASE_BYTECODE_PARSE) == 1,
+      "bytecode parse not counted");
+
+  orc_program_compile (p);
+  check (orc_stats_get_counter (ORC_STATS_COUNTER_PROGRAMS) == 1,
+      "compilation not counted");
+  check (orc_stats_get_phase_count (ORC_STATS_PHASE_REWRITE) == 1,
+      "rewrite not counted");
+  check (orc_stats_get_counter (ORC_STATS_COUNTER_INSNS) >= 2,
+      "instructions not counted");
+  if (p->code_exec != (void *)orc_executor_emulate) {
+    check (orc_stats_get_phase_count (ORC_STATS_PHASE_REGISTER_ALLOCATION) == 1,
+        "register allocation not counted");
+    check (orc_stats_get_phase_count (ORC_STATS_PHASE_EMIT) == 1,
+        "emission not counted");
+    check (orc_stats_get_phase_count (ORC_STATS_PHASE_CODEMEM) == 1,
+        "code memory allocation not counted");
+    check (orc_stats_get_counter (ORC_STATS_COUNTER_CODE_BYTES) > 0,
+        "code bytes not counted");
+  }
+  orc_program_free (p);
+
+  if (argc > 1) orc_stats_dump ();
+
+  orc_stats_reset ();
+  check (orc_stats_get_counter (ORC_STATS_COUNTER_PROGRAMS) == 0 &&
+      orc_stats_get_phase_count (ORC_STATS_PHASE_PARSE) == 0,
+      "reset didn't clear the totals");
+
+  if (error) return 1;
+  return 0;
+}
+
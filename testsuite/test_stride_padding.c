@@ -0,0 +1,58 @@
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <orc-test/orctest.h>
+
+static int error = FALSE;
+
+static void
+check (OrcProgram *p, int var, int n, int expected)
+{
+  int padding;
+
+  padding = orc_program_get_stride_padding (p, var, n);
+  if (padding != expected) {
+    printf ("%s: var %d, n %d: padding %d, expected %d\n", p->name, var, n,
+        padding, expected);
+    error = TRUE;
+  }
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram *p;
+
+  orc_init ();
+
+  /* a single array only needs whole cache lines */
+  p = orc_program_new ();
+  orc_program_set_name (p, "single");
+  orc_program_add_destination (p, 2, "d1");
+  orc_program_add_accumulator (p, 2, "a1");
+  check (p, ORC_VAR_D1, 1000, 48);
+  check (p, ORC_VAR_D1, 1024, 0);
+  check (p, ORC_VAR_S1, 1024, 0);
+  orc_program_free (p);
+
+  p = orc_program_new_dss (2, 1, 1);
+  orc_program_set_name (p, "multi");
+  check (p, ORC_VAR_D1, 1000, 112);
+  check (p, ORC_VAR_S1, 1000, 88);
+  check (p, ORC_VAR_S1, 1100, 52);
+  check (p, ORC_VAR_D1, 1024, 64);
+  check (p, ORC_VAR_S1, 1024, 64);
+  check (p, ORC_VAR_S1, 1920, 0);
+  check (p, ORC_VAR_S1, 2048, 64);
+  check (p, ORC_VAR_D1, 960, 0);
+  check (p, ORC_VAR_S2, 4090, 70);
+  check (p, ORC_VAR_A1, 1024, 0);
+  orc_program_free (p);
+
+  if (error) return 1;
+  return 0;
+}
@@ -0,0 +1,227 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <orc-test/orctest.h>
+
+#define N_ELEMENTS (1 << 20)
+
+static int error = FALSE;
+static orc_int16 src[N_ELEMENTS];
+static orc_int16 dest[N_ELEMENTS];
+static orc_int32 src32[N_ELEMENTS];
+static orc_int16 baseline_dest[N_ELEMENTS];
+
+static OrcProgram *
+new_program (const char *name, int constant)
+{
+  OrcProgram *p;
+
+  p = orc_program_new_ds (2, 2);
+  orc_program_set_name (p, name);
+  orc_program_add_constant (p, 2, constant, "c1");
+  orc_program_add_temporary (p, 2, "t1");
+  orc_program_append_str (p, "addw", "t1", "s1", "c1");
+  orc_program_append_str (p, "mullw", "d1", "t1", "t1");
+  orc_program_compile (p);
+
+  return p;
+}
+
+/* runs the program like the code generated by orcc does */
+static void
+run (OrcProgram *p, OrcCode *code, int n, int constant)
+{
+  OrcExecutor ex = { 0 };
+  void (*func) (OrcExecutor *);
+  int i;
+
+  ex.program = NULL;
+  ex.n = n;
+  ex.arrays[ORC_VAR_A2] = code;
+  ex.arrays[ORC_VAR_S1] = src;
+  ex.arrays[ORC_VAR_D1] = dest;
+  func = code->exec;
+  func (&ex);
+
+  for (i = 0; i < n; i++) {
+    orc_int16 expected = (orc_int16)((src[i] + constant) * (src[i] + constant));
+
+    if (dest[i] != expected) {
+      printf ("%s: dest[%d] is %d, expected %d\n", p->name, i, dest[i],
+          expected);
+      error = TRUE;
+      return;
+    }
+  }
+}
+
+/* runs the program until the optimised code replaces the baseline code */
+static void
+check_tier_up (OrcProgram *p, OrcCode *code, int n, int constant)
+{
+  void *baseline = (void *)code->exec;
+  int i;
+
+  for (i = 0; i < 10000000 && !error; i++) {
+    run (p, code, i == 0 ? n : 16, constant);
+    if ((void *)code->exec != baseline) break;
+  }
+  if ((void *)code->exec == baseline) {
+    printf ("%s: still running baseline code\n", p->name);
+    error = TRUE;
+  }
+
+  /* and the optimised code computes the same */
+  run (p, code, 1000, constant);
+}
+
+/* a saturating program whose convssslw the width narrowing pass used to
+ * drop */
+static OrcProgram *
+new_saturating_program (void)
+{
+  OrcProgram *p;
+
+  p = orc_program_new ();
+  orc_program_set_name (p, "saturating");
+  orc_program_add_destination (p, 2, "d1");
+  orc_program_add_source (p, 4, "s1");
+  orc_program_add_source (p, 4, "s2");
+  orc_program_add_source (p, 2, "s3");
+  orc_program_add_temporary (p, 4, "t1");
+  orc_program_add_temporary (p, 2, "t2");
+  orc_program_add_temporary (p, 4, "t3");
+  orc_program_add_temporary (p, 4, "t4");
+  orc_program_append_str (p, "mulll", "t1", "s1", "s2");
+  orc_program_append_ds_str (p, "convlw", "t2", "t1");
+  orc_program_append_ds_str (p, "convswl", "t3", "t2");
+  orc_program_append_ds_str (p, "convswl", "t4", "s3");
+  orc_program_append_str (p, "addl", "t1", "t3", "t4");
+  orc_program_append_ds_str (p, "convssslw", "d1", "t1");
+  orc_program_compile (p);
+
+  return p;
+}
+
+static void
+run_saturating (OrcCode *code, int n)
+{
+  OrcExecutor ex = { 0 };
+  void (*func) (OrcExecutor *);
+
+  ex.program = NULL;
+  ex.n = n;
+  ex.arrays[ORC_VAR_A2] = code;
+  ex.arrays[ORC_VAR_S1] = src32;
+  ex.arrays[ORC_VAR_S2] = src32 + 1;
+  ex.arrays[ORC_VAR_S3] = src;
+  ex.arrays[ORC_VAR_D1] = dest;
+  func = code->exec;
+  func (&ex);
+}
+
+/* the optimised code computes the same as the baseline code, saturation
+ * included */
+static void
+check_tier_up_saturating (void)
+{
+  OrcProgram *p;
+  OrcCode *code;
+  void *baseline;
+  int n = 1000;
+  int i, j;
+
+  p = new_saturating_program ();
+  code = orc_program_take_code (p);
+  baseline = (void *)code->exec;
+
+  run_saturating (code, n);
+  memcpy (baseline_dest, dest, n * sizeof(orc_int16));
+
+  for (i = 0; i < 10000000 && !error; i++) {
+    run_saturating (code, n);
+    for (j = 0; j < n; j++) {
+      if (dest[j] != baseline_dest[j]) {
+        printf ("%s: dest[%d] is %d, baseline code gave %d\n", p->name, j,
+            dest[j], baseline_dest[j]);
+        error = TRUE;
+        break;
+      }
+    }
+    if ((void *)code->exec != baseline) break;
+  }
+  if ((void *)code->exec == baseline) {
+    printf ("%s: still running baseline code\n", p->name);
+    error = TRUE;
+  }
+
+  run_saturating (code, n);
+  if (memcmp (dest, baseline_dest, n * sizeof(orc_int16)) != 0) {
+    printf ("%s: optimised code differs from baseline code\n", p->name);
+    error = TRUE;
+  }
+
+  orc_code_free (code);
+  orc_program_free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcProgram *p;
+  OrcCode *code;
+  int i;
+
+  orc_init ();
+
+  for (i = 0; i < N_ELEMENTS; i++) src[i] = rand ();
+  for (i = 0; i < N_ELEMENTS; i++) src32[i] = (orc_int16)rand ();
+
+  /* hot because it is called often */
+  p = new_program ("calls", 3);
+  if (p->code_exec == (void *)orc_executor_emulate) {
+    /* nothing compiled, nothing to tier */
+    orc_program_free (p);
+    return 0;
+  }
+  code = orc_program_take_code (p);
+  check_tier_up (p, code, 16, 3);
+  orc_code_free (code);
+  orc_program_free (p);
+
+  /* hot because of the number of elements of the first call */
+  p = new_program ("elements", 5);
+  code = orc_program_take_code (p);
+  check_tier_up (p, code, N_ELEMENTS, 5);
+  orc_code_free (code);
+  orc_program_free (p);
+
+  /* the program keeps working through the executor */
+  p = new_program ("executor", 7);
+  for (i = 0; i < 200 && !error; i++) {
+    OrcExecutor *ex = orc_executor_new (p);
+
+    orc_executor_set_n (ex, 100);
+    orc_executor_set_array (ex, ORC_VAR_S1, src);
+    orc_executor_set_array (ex, ORC_VAR_D1, dest);
+    orc_executor_run (ex);
+    orc_executor_free (ex);
+    if (dest[99] != (orc_int16)((src[99] + 7) * (src[99] + 7))) {
+      printf ("executor: wrong result in run %d\n", i);
+      error = TRUE;
+    }
+  }
+  orc_program_free (p);
+
+  check_tier_up_saturating ();
+
+  if (error) return 1;
+  return 0;
+}
+
@@ -217,6 +217,11 @@ test_opcode_src (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  /* packed stores write more than the destination size per element */
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -424,6 +429,10 @@ test_opcode_src_2d (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -476,6 +485,10 @@ test_opcode_src_const_n (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -528,6 +541,10 @@ test_opcode_src_const_n_2d (OrcStaticOpcode *opcode)
   if (opcode->flags & ORC_STATIC_OPCODE_SCALAR) {
     return;
   }
+  if ((opcode->flags & ORC_STATIC_OPCODE_STORE) &&
+      (opcode->flags & ORC_STATIC_OPCODE_PACKED)) {
+    return;
+  }
 
   p = orc_program_new ();
   if (opcode->flags & ORC_STATIC_OPCODE_ACCUMULATOR) {
@@ -0,0 +1,209 @@
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <orc/orc.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Writes the programs of a colour converter as Orc source, to be compiled
+ * ahead of time with orcc.  The values of the parameters are listed in a
+ * comment before each function; the generated functions have to be
+ * passed these values. */
+
+static void
+help (void)
+{
+  printf("Usage:\n");
+  printf("  orc-colorspace [OPTION...] IN_FORMAT OUT_FORMAT\n");
+  printf("\n");
+  printf("Options:\n");
+  printf("  --help                    Show help options\n");
+  printf("  --matrix=601|709|2020     YUV matrix (default 601)\n");
+  printf("  --range=limited|full      YUV range (default limited)\n");
+  printf("  --precision=fast|exact|float\n");
+  printf("                            Arithmetic of the programs (default fast)\n");
+  printf("  -o, --output FILE         Write output to FILE\n");
+  printf("\n");
+  printf("Formats:\n");
+  printf(" ");
+  {
+    int i;
+
+    for (i = 0; i < ORC_COLOR_FORMAT_N_FORMATS; i++) {
+      printf(" %s", orc_color_format_get_name (i));
+    }
+  }
+  printf("\n");
+  exit (0);
+}
+
+static int
+lookup_format (const char *name)
+{
+  int i;
+
+  for (i = 0; i < ORC_COLOR_FORMAT_N_FORMATS; i++) {
+    if (strcmp (name, orc_color_format_get_name (i)) == 0) return i;
+  }
+  fprintf (stderr, "orc-colorspace: unknown format %s\n", name);
+  exit (1);
+}
+
+static void
+write_program (FILE *output, OrcColorConverter *conv, int index)
+{
+  OrcProgram *p = orc_color_converter_get_program (conv, index);
+  int i;
+
+  fprintf (output, ".function %s\n", p->name);
+  fprintf (output, ".flags%s%s\n", p->is_2d ? " 2d" : "",
+      p->is_fast_math ? " fastmath" : "");
+  for (i = 0; i < ORC_N_VARIABLES; i++) {
+    OrcVariable *var = p->vars + i;
+
+    if (var->size == 0) continue;
+    switch (var->vartype) {
+      case ORC_VAR_TYPE_DEST:
+        fprintf (output, ".dest %d %s\n", var->size, var->name);
+        break;
+      case ORC_VAR_TYPE_SRC:
+        fprintf (output, ".source %d %s\n", var->size, var->name);
+        break;
+      case ORC_VAR_TYPE_CONST:
+        if (var->size == 8) {
+          fprintf (output, ".const 8 %s 0x%llxL\n", var->name,
+              (unsigned long long)var->value.i);
+        } else {
+          fprintf (output, ".const %d %s %d\n", var->size, var->name,
+              (int)var->value.i);
+        }
+        break;
+      case ORC_VAR_TYPE_PARAM:
+        fprintf (output, "# %s = 0x%08x\n", var->name,
+            (unsigned int)orc_color_converter_get_param (conv, index, i));
+        fprintf (output, ".%s %d %s\n",
+            var->param_type == ORC_PARAM_TYPE_FLOAT ? "floatparam" : "param",
+            var->size, var->name);
+        break;
+      case ORC_VAR_TYPE_TEMP:
+        fprintf (output, ".temp %d %s\n", var->size, var->name);
+        break;
+      default:
+        break;
+    }
+  }
+  fprintf (output, "\n");
+
+  for (i = 0; i < p->n_insns; i++) {
+    OrcInstruction *insn = p->insns + i;
+    OrcStaticOpcode *opcode = insn->opcode;
+    int args[4];
+    int n = 0;
+    int j;
+
+    for (j = 0; j < ORC_STATIC_OPCODE_N_DEST; j++) {
+      if (opcode->dest_size[j]) args[n++] = insn->dest_args[j];
+    }
+    for (j = 0; j < ORC_STATIC_OPCODE_N_SRC && n < 4; j++) {
+      if (opcode->src_size[j]) args[n++] = insn->src_args[j];
+    }
+
+    if (insn->flags & ORC_INSTRUCTION_FLAG_X2) fprintf (output, "x2 ");
+    fprintf (output, "%s", opcode->name);
+    for (j = 0; j < n; j++) {
+      fprintf (output, "%s %s", j ? "," : "", p->vars[args[j]].name);
+    }
+    fprintf (output, "\n");
+  }
+  fprintf (output, "\n");
+}
+
+int
+main (int argc, char *argv[])
+{
+  OrcColorMatrix matrix = ORC_COLOR_MATRIX_BT601;
+  OrcColorRange range = ORC_COLOR_RANGE_LIMITED;
+  OrcColorPrecision precision = ORC_COLOR_PRECISION_FAST;
+  OrcColorConverter *conv;
+  const char *formats[2] = { NULL, NULL };
+  const char *output_file = NULL;
+  FILE *output;
+  int n_formats = 0;
+  int i;
+
+  orc_init ();
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp (argv[i], "--help") == 0) {
+      help ();
+    } else if (strcmp (argv[i], "--matrix=601") == 0) {
+      matrix = ORC_COLOR_MATRIX_BT601;
+    } else if (strcmp (argv[i], "--matrix=709") == 0) {
+      matrix = ORC_COLOR_MATRIX_BT709;
+    } else if (strcmp (argv[i], "--matrix=2020") == 0) {
+      matrix = ORC_COLOR_MATRIX_BT2020;
+    } else if (strcmp (argv[i], "--range=limited") == 0) {
+      range = ORC_COLOR_RANGE_LIMITED;
+    } else if (strcmp (argv[i], "--range=full") == 0) {
+      range = ORC_COLOR_RANGE_FULL;
+    } else if (strcmp (argv[i], "--precision=fast") == 0) {
+      precision = ORC_COLOR_PRECISION_FAST;
+    } else if (strcmp (argv[i], "--precision=exact") == 0) {
+      precision = ORC_COLOR_PRECISION_EXACT;
+    } else if (strcmp (argv[i], "--precision=float") == 0) {
+      precision = ORC_COLOR_PRECISION_FLOAT;
+    } else if (strcmp (argv[i], "-o") == 0 ||
+        strcmp (argv[i], "--output") == 0) {
+      if (i + 1 < argc) {
+        output_file = argv[i + 1];
+        i++;
+      } else {
+        help ();
+      }
+    } else if (strncmp (argv[i], "-", 1) == 0) {
+      printf("Unknown option: %s\n", argv[i]);
+      exit (1);
+    } else if (n_formats < 2) {
+      formats[n_formats++] = argv[i];
+    } else {
+      printf("More than two formats given\n");
+      exit (1);
+    }
+  }
+  if (n_formats < 2) help ();
+
+  conv = orc_color_converter_new (lookup_format (formats[0]),
+      lookup_format (formats[1]), matrix, range, precision);
+  if (conv == NULL) {
+    fprintf (stderr, "orc-colorspace: %s to %s is not supported\n",
+        formats[0], formats[1]);
+    exit (1);
+  }
+
+  if (output_file) {
+    output = fopen (output_file, "w");
+    if (!output) {
+      fprintf (stderr, "orc-colorspace: could not open output file %s\n",
+          output_file);
+      exit (1);
+    }
+  } else {
+    output = stdout;
+  }
+
+  fprintf (output, "\n# %s to %s with precision %d, generated by "
+      "orc-colorspace\n\n", formats[0], formats[1],
+      orc_color_converter_get_precision (conv));
+  for (i = 0; i < orc_color_converter_get_n_programs (conv); i++) {
+    write_program (output, conv, i);
+  }
+
+  if (output != stdout) fclose (output);
+  orc_color_converter_free (conv);
+
+  return 0;
+}
@@ -319,6 +319,7 @@ main (int argc, char *argv[])
     fprintf(output, "#ifdef HAVE_CONFIG_H\n");
     fprintf(output, "#include \"config.h\"\n");
     fprintf(output, "#endif\n");
+    fprintf(output, "#include <math.h>\n");
     if (include_file) {
       fprintf(output, "#include <%s>\n", include_file);
     }
@@ -1145,6 +1146,10 @@ output_program_generation (OrcProgram *p, FILE *output, int is_inline)
           p->constant_m);
     }
   }
+  if (p->is_fast_math) {
+    REQUIRE(0,4,38,1);
+    fprintf(output, "    orc_program_set_fast_math (p);\n");
+  }
   fprintf(output, "    orc_program_set_name (p, \"%s\");\n", p->name);
   if (use_backup && !is_inline) {
     fprintf(output, "    orc_program_set_backup_function (p, _backup_%s);\n",
@@ -1342,6 +1347,9 @@ output_code_test (OrcProgram *p, FILE *output)
           p->constant_m);
     }
   }
+  if (p->is_fast_math) {
+    fprintf(output, "      orc_program_set_fast_math (p);\n");
+  }
   fprintf(output, "    orc_program_set_name (p, \"%s\");\n", p->name);
   if (use_backup) {
     fprintf(output, "    orc_program_set_backup_function (p, _backup_%s);\n",
@@ -1525,7 +1533,7 @@ output_code_assembly (OrcProgram *p, FILE *output)
     OrcTarget *t = orc_target_get_by_name(target);
 
     result = orc_program_compile_full (p, t,
-        orc_target_get_default_flags (t));
+        orc_target_get_default_flags (t) | ORC_TARGET_PRIVATE_CODE);
     if (ORC_COMPILE_RESULT_IS_SUCCESSFUL(result)) {
       fprintf(output, "%s\n", orc_program_get_asm_code (p));
     } else {
@@ -1542,7 +1550,8 @@ output_machine_code (OrcProgram *p, FILE *output)
 {
   OrcTarget *const t = orc_target_get_by_name(target);
 
-  const OrcCompileResult result = orc_program_compile_for_target (p, t);
+  const OrcCompileResult result = orc_program_compile_full (p, t,
+      orc_target_get_default_flags (t) | ORC_TARGET_PRIVATE_CODE);
   if (ORC_COMPILE_RESULT_IS_SUCCESSFUL(result)) {
     fwrite (p->orccode->code, sizeof(unsigned char), p->orccode->code_size, output);
   } else {